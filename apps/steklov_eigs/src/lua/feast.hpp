@@ -18,6 +18,7 @@ void register_feast_usertypes(sol::state& lua)
     fept["max_eigval"] = &fep_t::max_eigval;
     fept["subspace_size"] = &fep_t::subspace_size;
     fept["max_iter"] = &fep_t::max_iter;
+    fept["parallel_contour"] = &fep_t::parallel_contour;
 }
 
 } // namespace disk::lua
@@ -157,16 +157,23 @@ unsteady_laplacian_solver(const Mesh& msh, size_t degree, typename Mesh::coordin
 
     size_t freq_exp = 100;
 
+    /* LHS does not change in time: factorize it once */
+    disk::solvers::factorized_solver<scalar_type> solver;
+    if ( not solver.factorize(LHS) )
+    {
+        std::cout << "Factorization failed" << std::endl;
+        return false;
+    }
+
     // time loop
     for (size_t i = 0; t < 2.0; i++, t += dt)
     {
         if(i % freq_exp == 0)
             std::cout << "Step " << i << std::endl;
-        disk::solvers::pardiso_params<scalar_type> pparams;
         Matrix<scalar_type, Dynamic, 1> Mupp = Mu_prev;
         Mupp.tail(msh.faces_size() * fbs) = Matrix<scalar_type, Dynamic, 1>::Zero(msh.faces_size() * fbs);
         Mupp = Mupp + dt*RHS;
-        mkl_pardiso(pparams, LHS, Mupp, u);
+        u = solver.solve(Mupp);
 
         Matrix<scalar_type, Dynamic, 1> sol_silo = Matrix<scalar_type, Dynamic, 1>::Zero(msh.cells_size());
 
@@ -154,6 +154,19 @@ class scaled_monomial_abstract_basis<Mesh, typename Mesh::cell, ScalarType>
         return _scaling_factor;
     }
 
+    /* The basis functions are monomials in scaling_matrix() * (pt - scaling_origin()) */
+    matrix_type
+    scaling_matrix() const
+    {
+        return _passage;
+    }
+
+    point_type
+    scaling_origin() const
+    {
+        return _bar;
+    }
+
     bool
     is_orthonormal() const
     {
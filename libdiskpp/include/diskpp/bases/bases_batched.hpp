@@ -0,0 +1,99 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+#include "diskpp/common/eigen.hpp"
+
+namespace disk {
+
+/* Helpers to compute the integrals of the products of basis functions with
+ * one matrix-matrix product instead of a rank-1 update per quadrature
+ * point. The evaluations of a function at all the quadrature points are
+ * stored side by side in a single matrix: if f(pt) is an N x C matrix (for
+ * example N basis functions, C = 1 for values or C = DIM for gradients),
+ * the result is N x (C * number of points). Then
+ *
+ *      sum_q w_q test(x_q) trial(x_q)^T = weighted(test) * trial^T
+ *
+ * which is a single GEMM. */
+
+template<typename QuadPoints, typename Function>
+using batched_scalar_t =
+    typename std::decay_t<decltype( std::declval<Function>()(std::begin(std::declval<QuadPoints>())->point()) )>::Scalar;
+
+/* Evaluations of f at all the quadrature points, side by side */
+template<typename QuadPoints, typename Function>
+dynamic_matrix<batched_scalar_t<const QuadPoints&, const Function&>>
+batched_evaluations(const QuadPoints& qps, const Function& f)
+{
+    using T = batched_scalar_t<const QuadPoints&, const Function&>;
+
+    assert(std::size(qps) > 0);
+
+    dynamic_matrix<T> ret;
+    size_t pos = 0;
+    for (auto& qp : qps)
+    {
+        const auto val = f(qp.point()).eval();
+        if (pos == 0)
+            ret.resize(val.rows(), val.cols() * std::size(qps));
+
+        assert(ret.rows() == val.rows());
+        ret.middleCols(pos, val.cols()) = val;
+        pos += val.cols();
+    }
+
+    return ret;
+}
+
+/* Multiply each block of batched evaluations by the weight of its point */
+template<typename QuadPoints, typename T>
+dynamic_matrix<T>
+batched_weighted(const QuadPoints& qps, const dynamic_matrix<T>& evals)
+{
+    assert(evals.cols() % std::size(qps) == 0);
+    const size_t cols = evals.cols() / std::size(qps);
+
+    dynamic_matrix<T> ret = evals;
+    size_t pos = 0;
+    for (auto& qp : qps)
+    {
+        ret.middleCols(pos, cols) *= qp.weight();
+        pos += cols;
+    }
+
+    return ret;
+}
+
+/* sum_q w_q test(x_q) trial(x_q)^T */
+template<typename QuadPoints, typename TestFunction, typename TrialFunction>
+dynamic_matrix<batched_scalar_t<const QuadPoints&, const TestFunction&>>
+batched_product(const QuadPoints& qps, const TestFunction& test, const TrialFunction& trial)
+{
+    const auto test_evals = batched_weighted(qps, batched_evaluations(qps, test));
+    const auto trial_evals = batched_evaluations(qps, trial);
+    assert(test_evals.cols() == trial_evals.cols());
+    return test_evals * trial_evals.transpose();
+}
+
+/* sum_q w_q f(x_q) f(x_q)^T, f is evaluated only once per point */
+template<typename QuadPoints, typename Function>
+dynamic_matrix<batched_scalar_t<const QuadPoints&, const Function&>>
+batched_product(const QuadPoints& qps, const Function& f)
+{
+    const auto evals = batched_evaluations(qps, f);
+    return batched_weighted(qps, evals) * evals.transpose();
+}
+
+} // namespace disk
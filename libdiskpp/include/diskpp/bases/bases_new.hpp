@@ -11,6 +11,7 @@
 #pragma once
 
 #include "diskpp/common/eigen.hpp"
+#include "diskpp/bases/bases_batched.hpp"
 #include "diskpp/bases/bases_traits.hpp"
 #include "diskpp/quadratures/quadrature_point.hpp"
 #include "diskpp/quadratures/quadratures.hpp"
@@ -935,9 +936,8 @@ auto integrate(const Mesh& msh, const Element& elem, const Trial& trial, const T
 
     auto ideg = trial.integration_degree() + test.integration_degree();
     auto qps = integrate(msh, elem, ideg);
-    for (auto& qp : qps) {
-        ret += qp.weight() * ( test(qp.point()) * trial(qp.point()).transpose() );
-    };
+    if (qps.size() > 0)
+        ret = batched_product(qps, test, trial);
 
     return ret;
 }
@@ -0,0 +1,477 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "diskpp/bases/bases_scalar.hpp"
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/quadratures/quadratures.hpp"
+
+namespace disk {
+
+namespace priv {
+
+/* Reference elements of the meshes whose cells are affine images of a fixed
+ * element. Each specialization provides the positions in points(msh, cl) of
+ * the vertices mapped to the origin and to the unit vectors of the reference
+ * element, the coordinates of all the vertices on the reference element and
+ * a quadrature on the reference element. Other meshes have no reference
+ * element. */
+template<typename Mesh>
+struct reference_element
+{
+    static const bool available = false;
+};
+
+template<typename T>
+struct reference_element<simplicial_mesh<T, 2>>
+{
+    static const bool available = true;
+    static constexpr std::array<size_t, 3> vertices = {0, 1, 2};
+
+    static point<T, 2>
+    vertex(size_t i)
+    {
+        return point<T, 2>(i == 1, i == 2);
+    }
+
+    static std::vector<quadrature_point<T, 2>>
+    quadrature(size_t degree)
+    {
+        return quadrature::triangle_gauss(degree, point<T, 2>(0, 0), point<T, 2>(1, 0), point<T, 2>(0, 1));
+    }
+};
+
+template<typename T>
+struct reference_element<simplicial_mesh<T, 3>>
+{
+    static const bool available = true;
+    static constexpr std::array<size_t, 4> vertices = {0, 1, 2, 3};
+
+    static point<T, 3>
+    vertex(size_t i)
+    {
+        return point<T, 3>(i == 1, i == 2, i == 3);
+    }
+
+    static std::vector<quadrature_point<T, 3>>
+    quadrature(size_t degree)
+    {
+        return quadrature::arbq(degree, point<T, 3>(0, 0, 0), point<T, 3>(1, 0, 0),
+                                        point<T, 3>(0, 1, 0), point<T, 3>(0, 0, 1));
+    }
+};
+
+/* The cells of cartesian meshes are affine images of the reference element
+ * only if they are parallelograms and parallelepipeds, which is checked by
+ * tabulated_scalar_basis::is_affine(). The bits of the position of a vertex in
+ * points(msh, cl) are its coordinates, see quad_hexahedral.hpp */
+template<typename T>
+struct reference_element<cartesian_mesh<T, 2>>
+{
+    static const bool available = true;
+    static constexpr std::array<size_t, 3> vertices = {0, 1, 2};
+
+    static point<T, 2>
+    vertex(size_t i)
+    {
+        return point<T, 2>(i & 1, (i >> 1) & 1);
+    }
+
+    static std::vector<quadrature_point<T, 2>>
+    quadrature(size_t degree)
+    {
+        return quadrature::tensorized_gauss_legendre(degree, point<T, 2>(0, 0), point<T, 2>(1, 0),
+                                                             point<T, 2>(1, 1), point<T, 2>(0, 1));
+    }
+};
+
+template<typename T>
+struct reference_element<cartesian_mesh<T, 3>>
+{
+    static const bool available = true;
+    static constexpr std::array<size_t, 4> vertices = {0, 1, 2, 4};
+
+    static point<T, 3>
+    vertex(size_t i)
+    {
+        return point<T, 3>(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+    }
+
+    static std::vector<quadrature_point<T, 3>>
+    quadrature(size_t degree)
+    {
+        const auto qps = quadrature::gauss_legendre(degree, T(0), T(1));
+
+        std::vector<quadrature_point<T, 3>> ret;
+        ret.reserve(qps.size() * qps.size() * qps.size());
+        for (auto& qz : qps)
+            for (auto& qy : qps)
+                for (auto& qx : qps)
+                {
+                    point<T, 3> pt(qx.point().x(), qy.point().x(), qz.point().x());
+                    ret.push_back({pt, qx.weight() * qy.weight() * qz.weight()});
+                }
+
+        return ret;
+    }
+};
+
+/* Exponents of the monomials of degree up to k, in the same order used by
+ * scaled_monomial_scalar_basis */
+template<size_t DIM>
+std::vector<std::array<size_t, DIM>>
+monomial_exponents(size_t k);
+
+template<>
+inline std::vector<std::array<size_t, 2>>
+monomial_exponents<2>(size_t k)
+{
+    std::vector<std::array<size_t, 2>> ret;
+    for (size_t d = 0; d <= k; d++)
+        for (size_t i = 0; i <= d; i++)
+            ret.push_back({d - i, i});
+    return ret;
+}
+
+template<>
+inline std::vector<std::array<size_t, 3>>
+monomial_exponents<3>(size_t k)
+{
+    std::vector<std::array<size_t, 3>> ret;
+    for (size_t d = 0; d <= k; d++)
+        for (size_t pow_x = 0; pow_x <= d; pow_x++)
+            for (size_t pow_y = 0, pow_z = d - pow_x; pow_y <= d - pow_x; pow_y++, pow_z--)
+                ret.push_back({pow_x, pow_y, pow_z});
+    return ret;
+}
+
+} // namespace priv
+
+/* Tabulated evaluation of the scalar monomial basis of a given degree on the
+ * cells of simplicial and cartesian meshes. The monomials and their
+ * gradients are evaluated only once, at the quadrature points of the
+ * reference element. On a cell with affine map F(x) = A x + b, each basis
+ * function composed with F is a polynomial of the same degree, so the
+ * values on the cell are obtained by multiplying the reference tables by a
+ * small change-of-basis matrix C. Mass and stiffness matrices reduce to
+ *
+ *    M = |det A| C Mref C^T,   K = |det A| C (sum_de G_de Kref_de) C^T,
+ *
+ * with G = A^-1 A^-T and Mref, Kref computed once on the reference element.
+ * The object is immutable after construction and can be shared by threads. */
+template<typename Mesh>
+class tabulated_scalar_basis
+{
+public:
+    typedef Mesh                                        mesh_type;
+    typedef typename mesh_type::coordinate_type         coordinate_type;
+    typedef typename mesh_type::cell_type               cell_type;
+    typedef typename mesh_type::point_type              point_type;
+    typedef coordinate_type                             scalar_type;
+    typedef dynamic_matrix<scalar_type>                 matrix_type;
+
+    static const size_t dimension = mesh_type::dimension;
+
+private:
+    typedef priv::reference_element<mesh_type>                  refelem;
+    typedef static_matrix<coordinate_type, dimension, dimension> jacobian_type;
+    typedef std::array<size_t, dimension>                       exponent_type;
+
+    size_t                                  basis_degree;
+    size_t                                  basis_size;
+    std::vector<exponent_type>              exponents;
+    std::vector<size_t>                     exponent_to_index;
+
+    std::vector<quadrature_point<coordinate_type, dimension>>   ref_qps;
+    matrix_type                                                 ref_phi;
+    std::array<matrix_type, dimension>                          ref_dphi;
+    matrix_type                                                 ref_mass;
+    std::array<std::array<matrix_type, dimension>, dimension>   ref_stiff;
+
+    size_t
+    index_of(const exponent_type& e) const
+    {
+        size_t ofs = 0;
+        for (size_t d = 0; d < dimension; d++)
+            ofs = ofs * (basis_degree + 1) + e[d];
+        return exponent_to_index[ofs];
+    }
+
+    /* Affine map x -> A x + b from the reference element to the cell */
+    std::pair<jacobian_type, point_type>
+    affine_map(const mesh_type& msh, const cell_type& cl) const
+    {
+        const auto pts = points(msh, cl);
+        const auto& v = refelem::vertices;
+
+        jacobian_type A;
+        for (size_t d = 0; d < dimension; d++)
+            A.col(d) = (pts[v[d+1]] - pts[v[0]]).to_vector();
+
+        return std::pair(A, pts[v[0]]);
+    }
+
+    /* Matrix C such that phi_i(F(x)) = sum_j C(i,j) x^(e_j). The rows are
+     * built by degree: phi_i = y_d * phi_p, where y = P(F(x) - bar) is affine
+     * in x and the exponents of phi_p are those of phi_i minus e_d. */
+    template<typename Basis>
+    matrix_type
+    change_of_basis(const jacobian_type& A, const point_type& b, const Basis& basis) const
+    {
+        const jacobian_type P = basis.scaling_matrix();
+        const jacobian_type At = P * A;
+        const static_vector<coordinate_type, dimension> bt = P * (b - basis.scaling_origin()).to_vector();
+
+        matrix_type C = matrix_type::Zero(basis_size, basis_size);
+        C(0, 0) = 1.0;
+
+        for (size_t i = 1; i < basis_size; i++)
+        {
+            auto ei = exponents[i];
+            size_t d = 0;
+            while (ei[d] == 0)
+                d++;
+            ei[d]--;
+            const auto p = index_of(ei);
+            assert(p < i);
+
+            for (size_t j = 0; j < basis_size; j++)
+            {
+                const auto c = C(p, j);
+                if (c == 0.0)
+                    continue;
+
+                C(i, j) += bt(d) * c;
+                for (size_t e = 0; e < dimension; e++)
+                {
+                    auto ej = exponents[j];
+                    ej[e]++;
+                    C(i, index_of(ej)) += At(d, e) * c;
+                }
+            }
+        }
+
+        return C;
+    }
+
+public:
+    tabulated_scalar_basis(size_t degree)
+        : basis_degree(degree)
+    {
+        basis_size = scalar_basis_size(degree, dimension);
+        exponents = priv::monomial_exponents<dimension>(degree);
+        assert(exponents.size() == basis_size);
+
+        size_t num_ofs = 1;
+        for (size_t d = 0; d < dimension; d++)
+            num_ofs *= basis_degree + 1;
+        exponent_to_index.resize(num_ofs, basis_size);
+        for (size_t i = 0; i < basis_size; i++)
+        {
+            size_t ofs = 0;
+            for (size_t d = 0; d < dimension; d++)
+                ofs = ofs * (basis_degree + 1) + exponents[i][d];
+            exponent_to_index[ofs] = i;
+        }
+
+        ref_qps = refelem::quadrature(2 * basis_degree);
+        const auto nqp = ref_qps.size();
+
+        ref_phi = matrix_type::Zero(nqp, basis_size);
+        for (auto& rd : ref_dphi)
+            rd = matrix_type::Zero(nqp, basis_size);
+
+        for (size_t q = 0; q < nqp; q++)
+        {
+            const auto pt = ref_qps[q].point();
+            for (size_t i = 0; i < basis_size; i++)
+            {
+                const auto& e = exponents[i];
+                scalar_type val = 1.0;
+                for (size_t d = 0; d < dimension; d++)
+                    val *= iexp_pow(pt[d], e[d]);
+                ref_phi(q, i) = val;
+
+                for (size_t d = 0; d < dimension; d++)
+                {
+                    if (e[d] == 0)
+                        continue;
+
+                    scalar_type dval = e[d];
+                    for (size_t dd = 0; dd < dimension; dd++)
+                        dval *= iexp_pow(pt[dd], (dd == d) ? e[dd]-1 : e[dd]);
+                    ref_dphi[d](q, i) = dval;
+                }
+            }
+        }
+
+        dynamic_vector<scalar_type> w(nqp);
+        for (size_t q = 0; q < nqp; q++)
+            w(q) = ref_qps[q].weight();
+
+        ref_mass = ref_phi.transpose() * w.asDiagonal() * ref_phi;
+        for (size_t d = 0; d < dimension; d++)
+            for (size_t e = 0; e < dimension; e++)
+                ref_stiff[d][e] = ref_dphi[d].transpose() * w.asDiagonal() * ref_dphi[e];
+    }
+
+    size_t degree() const { return basis_degree; }
+    size_t size() const { return basis_size; }
+
+    /* True if the cell is the affine image of the reference element. This
+     * always holds for simplices, cartesian cells must be parallelograms or
+     * parallelepipeds. */
+    bool
+    is_affine(const mesh_type& msh, const cell_type& cl) const
+    {
+        const auto pts = points(msh, cl);
+        const auto [A, b] = affine_map(msh, cl);
+        const auto tol = 1e-12 * A.norm();
+
+        for (size_t i = 0; i < pts.size(); i++)
+        {
+            const point_type pt = point_type(A * refelem::vertex(i).to_vector()) + b;
+            if ((pts[i] - pt).to_vector().norm() > tol)
+                return false;
+        }
+
+        return true;
+    }
+
+    /* Quadrature of degree 2*degree() on the cell, image of the reference one */
+    std::vector<quadrature_point<coordinate_type, dimension>>
+    quadrature(const mesh_type& msh, const cell_type& cl) const
+    {
+        const auto [A, b] = affine_map(msh, cl);
+        const auto detA = std::abs(A.determinant());
+
+        std::vector<quadrature_point<coordinate_type, dimension>> ret;
+        ret.reserve(ref_qps.size());
+        for (auto& qp : ref_qps)
+            ret.push_back({point_type(A * qp.point().to_vector()) + b, qp.weight() * detA});
+
+        return ret;
+    }
+
+    /* Values of the basis at the points returned by quadrature(), one row
+     * per quadrature point */
+    template<typename Basis>
+    matrix_type
+    eval_functions(const mesh_type& msh, const cell_type& cl, const Basis& basis) const
+    {
+        assert(basis.size() == basis_size);
+        const auto [A, b] = affine_map(msh, cl);
+        const auto C = change_of_basis(A, b, basis);
+        return ref_phi * C.transpose();
+    }
+
+    /* Derivatives along direction dir of the basis at the points returned by
+     * quadrature(), one row per quadrature point */
+    template<typename Basis>
+    matrix_type
+    eval_gradients(const mesh_type& msh, const cell_type& cl, const Basis& basis, size_t dir) const
+    {
+        assert(basis.size() == basis_size);
+        assert(dir < dimension);
+        const auto [A, b] = affine_map(msh, cl);
+        const auto C = change_of_basis(A, b, basis);
+        const jacobian_type invAt = A.inverse().transpose();
+
+        matrix_type ret = matrix_type::Zero(ref_qps.size(), basis_size);
+        for (size_t e = 0; e < dimension; e++)
+            ret += invAt(dir, e) * ref_dphi[e];
+
+        return ret * C.transpose();
+    }
+
+    template<typename Basis>
+    matrix_type
+    mass_matrix(const mesh_type& msh, const cell_type& cl, const Basis& basis) const
+    {
+        assert(basis.size() == basis_size);
+        const auto [A, b] = affine_map(msh, cl);
+        const auto C = change_of_basis(A, b, basis);
+        return std::abs(A.determinant()) * C * ref_mass * C.transpose();
+    }
+
+    template<typename Basis>
+    matrix_type
+    stiffness_matrix(const mesh_type& msh, const cell_type& cl, const Basis& basis) const
+    {
+        return stiffness_matrix(msh, cl, basis, jacobian_type::Identity());
+    }
+
+    /* Stiffness matrix with diffusion tensor D, the (i,j) entry is the
+     * integral of (D grad phi_i) . grad phi_j */
+    template<typename Basis>
+    matrix_type
+    stiffness_matrix(const mesh_type& msh, const cell_type& cl, const Basis& basis,
+                     const jacobian_type& D) const
+    {
+        assert(basis.size() == basis_size);
+        const auto [A, b] = affine_map(msh, cl);
+        const auto C = change_of_basis(A, b, basis);
+        const jacobian_type invA = A.inverse();
+        const jacobian_type G = invA * D.transpose() * invA.transpose();
+
+        matrix_type K = matrix_type::Zero(basis_size, basis_size);
+        for (size_t d = 0; d < dimension; d++)
+            for (size_t e = 0; e < dimension; e++)
+                K += G(d, e) * ref_stiff[d][e];
+
+        return std::abs(A.determinant()) * C * K * C.transpose();
+    }
+};
+
+/* Tabulated basis of the given degree for the cells of Mesh, built on first
+ * use and shared by all the meshes of the same type. This is thread-safe. */
+template<typename Mesh>
+const tabulated_scalar_basis<Mesh>&
+get_tabulated_scalar_basis(size_t degree)
+{
+    static std::mutex                                                       mtx;
+    static std::map<size_t, std::unique_ptr<tabulated_scalar_basis<Mesh>>>  tabs;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto& tab = tabs[degree];
+    if (not tab)
+        tab = std::make_unique<tabulated_scalar_basis<Mesh>>(degree);
+
+    return *tab;
+}
+
+/* True if the mass and stiffness matrices of Basis on an Element of Mesh can
+ * be computed with tabulated_scalar_basis: the element is a cell of a mesh
+ * with a reference element and the basis is the real scaled monomial basis.
+ * The cell must still be checked with tabulated_scalar_basis::is_affine(). */
+template<typename Mesh, typename Element, typename Basis>
+constexpr bool
+use_tabulated_basis(void)
+{
+    if constexpr (priv::reference_element<Mesh>::available)
+    {
+        typedef typename Mesh::cell_type        cell_type;
+        typedef typename Mesh::coordinate_type  coordinate_type;
+        return std::is_same_v<Element, cell_type> and
+               std::is_same_v<Basis, scaled_monomial_scalar_basis<Mesh, cell_type, coordinate_type>>;
+    }
+
+    return false;
+}
+
+} // namespace disk
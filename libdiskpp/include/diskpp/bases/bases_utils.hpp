@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include "diskpp/bases/bases_batched.hpp"
+#include "diskpp/bases/bases_tabulated.hpp"
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/quadratures/quadratures.hpp"
 
@@ -194,21 +196,33 @@ outer_product(const eigen_compatible_stdvector<Matrix<T, N, N>>& a, const Matrix
     return ret;
 }
 
+/* The evaluations of scalar and vector bases are Eigen matrices with one
+ * row per basis function, and can be batched (see bases_batched.hpp) */
+template<typename T>
+struct is_eigen_matrix
+    : std::is_base_of<Eigen::MatrixBase<std::decay_t<T>>, std::decay_t<T>>
+{};
+
 } // priv
 
 
-template<typename Mesh, typename Element, typename Basis>
+/* Mass matrix computed on the given quadrature points, which must be exact
+ * for degree 2*basis.degree() */
+template<typename Basis, typename QuadPoints>
 Matrix<typename Basis::scalar_type, Dynamic, Dynamic>
-make_mass_matrix(const Mesh& msh, const Element& elem, const Basis& basis, size_t di = 0)
+make_mass_matrix(const Basis& basis, const QuadPoints& qps)
 {
-    const auto degree     = basis.degree();
-    const auto basis_size = basis.size();
-
     using T = typename Basis::scalar_type;
 
-    Matrix<T, Dynamic, Dynamic> ret = Matrix<T, Dynamic, Dynamic>::Zero(basis_size, basis_size);
+    Matrix<T, Dynamic, Dynamic> ret = Matrix<T, Dynamic, Dynamic>::Zero(basis.size(), basis.size());
 
-    const auto qps = integrate(msh, elem, 2 * (degree+di));
+    using function_type = decltype(basis.eval_functions(std::begin(qps)->point()));
+    if constexpr (priv::is_eigen_matrix<function_type>::value)
+    {
+        if (std::size(qps) > 0)
+            ret = batched_product(qps, [&](const auto& pt) { return basis.eval_functions(pt); });
+        return ret;
+    }
 
     for (auto& qp : qps)
     {
@@ -220,6 +234,24 @@ make_mass_matrix(const Mesh& msh, const Element& elem, const Basis& basis, size_
     return ret;
 }
 
+/* On the affine cells of simplicial and cartesian meshes the mass and
+ * stiffness matrices of the monomial basis are computed from the tables of
+ * the reference element, see bases_tabulated.hpp */
+template<typename Mesh, typename Element, typename Basis>
+Matrix<typename Basis::scalar_type, Dynamic, Dynamic>
+make_mass_matrix(const Mesh& msh, const Element& elem, const Basis& basis, size_t di = 0)
+{
+    if constexpr (use_tabulated_basis<Mesh, Element, Basis>())
+    {
+        const auto& tab = get_tabulated_scalar_basis<Mesh>(basis.degree());
+        if (tab.is_affine(msh, elem))
+            return tab.mass_matrix(msh, elem, basis);
+    }
+
+    const auto qps = integrate(msh, elem, 2 * (basis.degree() + di));
+    return make_mass_matrix(basis, qps);
+}
+
 /* We have a problem here: this definition could be ambiguous with the previous
  * one. */
 //#if 0
@@ -260,10 +292,21 @@ make_stiffness_matrix(const Mesh& msh, const Element& elem, const Basis& basis)
 
     Matrix<T, Dynamic, Dynamic> ret = Matrix<T, Dynamic, Dynamic>::Zero(basis_size, basis_size);
 
+    if constexpr (use_tabulated_basis<Mesh, Element, Basis>())
+    {
+        const auto& tab = get_tabulated_scalar_basis<Mesh>(degree);
+        if (degree > 0 and tab.is_affine(msh, elem))
+            return tab.stiffness_matrix(msh, elem, basis);
+    }
+
     if(degree > 0)
     {
         const auto qps = integrate(msh, elem, 2 * (degree - 1));
 
+        using gradient_type = decltype(basis.eval_gradients(qps.begin()->point()));
+        if constexpr (priv::is_eigen_matrix<gradient_type>::value)
+            return batched_product(qps, [&](const auto& pt) { return basis.eval_gradients(pt); });
+
         for (auto& qp : qps)
         {
             const auto dphi    = basis.eval_gradients(qp.point());
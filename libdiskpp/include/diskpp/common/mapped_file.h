@@ -77,4 +77,5 @@ public:
     bool            end(void) const;
     std::string     get_line(void);
     const char *    mem(void);
+    size_t          size(void) const;
 };
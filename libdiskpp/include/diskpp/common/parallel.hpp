@@ -0,0 +1,214 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace disk {
+
+/* Number of threads used by the parallel loops of the library when the
+ * caller does not specify it. The value can be overridden at runtime with
+ * the DISKPP_NUM_THREADS environment variable. */
+inline size_t
+default_num_threads(void)
+{
+    if (const char *env = std::getenv("DISKPP_NUM_THREADS"))
+    {
+        auto nt = std::strtoul(env, nullptr, 10);
+        if (nt > 0)
+            return nt;
+    }
+
+    auto hc = std::thread::hardware_concurrency();
+    return (hc > 0) ? hc : 1;
+}
+
+/* Execute fun(i, thread_id) for all i in [begin, end). The range is split
+ * in contiguous chunks, one per thread. If num_threads is zero, the value
+ * returned by default_num_threads() is used. The first exception thrown by
+ * a worker is rethrown on the calling thread after all the workers joined. */
+template<typename Function>
+void
+parallel_for(size_t begin, size_t end, const Function& fun, size_t num_threads = 0)
+{
+    if (end <= begin)
+        return;
+
+    const size_t range = end - begin;
+
+    if (num_threads == 0)
+        num_threads = default_num_threads();
+
+    num_threads = std::min(num_threads, range);
+
+    if (num_threads == 1)
+    {
+        for (size_t i = begin; i < end; i++)
+            fun(i, 0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread>        workers;
+    workers.reserve(num_threads);
+
+    const size_t chunk = range / num_threads;
+    const size_t rem   = range % num_threads;
+
+    size_t chunk_begin = begin;
+    for (size_t tid = 0; tid < num_threads; tid++)
+    {
+        size_t chunk_end = chunk_begin + chunk + (tid < rem ? 1 : 0);
+
+        workers.emplace_back([&, tid, chunk_begin, chunk_end] {
+            try
+            {
+                for (size_t i = chunk_begin; i < chunk_end; i++)
+                    fun(i, tid);
+            }
+            catch (...)
+            {
+                errors[tid] = std::current_exception();
+            }
+        });
+
+        chunk_begin = chunk_end;
+    }
+
+    for (auto& w : workers)
+        w.join();
+
+    for (auto& e : errors)
+        if (e)
+            std::rethrow_exception(e);
+}
+
+/* Threads started once and reused by many short parallel loops, such as the
+ * vector kernels of the iterative solvers, which would otherwise spend more
+ * time in starting the threads than in the work itself. run() executes
+ * fun(task) for all task in [0, num_tasks): the calling thread takes task 0
+ * and the workers, started on the first use, the others. The pool runs one
+ * loop at a time: a loop started while another one is running, also from
+ * inside a task, is executed serially by the calling thread. */
+class thread_pool
+{
+    std::vector<std::thread>            m_workers;
+    std::mutex                          m_run_mutex;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_start_cv, m_done_cv;
+    const std::function<void(size_t)>  *m_job;
+    size_t                              m_num_tasks, m_pending, m_generation;
+    std::vector<std::exception_ptr>     m_errors;
+    bool                                m_stop;
+
+    void
+    worker(size_t task, size_t generation)
+    {
+        while (true)
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_start_cv.wait(lk, [&] { return m_stop or m_generation != generation; });
+            if (m_stop)
+                return;
+            generation = m_generation;
+            if (task >= m_num_tasks)
+                continue;
+            lk.unlock();
+
+            try
+            {
+                (*m_job)(task);
+            }
+            catch (...)
+            {
+                m_errors[task] = std::current_exception();
+            }
+
+            lk.lock();
+            if (--m_pending == 0)
+                m_done_cv.notify_one();
+        }
+    }
+
+public:
+    thread_pool()
+        : m_job(nullptr), m_num_tasks(0), m_pending(0), m_generation(0), m_stop(false)
+    {}
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_stop = true;
+        }
+        m_start_cv.notify_all();
+        for (auto& w : m_workers)
+            w.join();
+    }
+
+    template<typename Function>
+    void
+    run(size_t num_tasks, const Function& fun)
+    {
+        std::unique_lock<std::mutex> run_lk(m_run_mutex, std::try_to_lock);
+        if (num_tasks < 2 or not run_lk.owns_lock())
+        {
+            for (size_t task = 0; task < num_tasks; task++)
+                fun(task);
+            return;
+        }
+
+        const std::function<void(size_t)> job = [&](size_t task) { fun(task); };
+
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            while (m_workers.size() < num_tasks-1)
+                m_workers.emplace_back(&thread_pool::worker, this, m_workers.size()+1, m_generation);
+            m_job = &job;
+            m_num_tasks = num_tasks;
+            m_pending = num_tasks-1;
+            m_errors.assign(num_tasks, nullptr);
+            m_generation++;
+        }
+        m_start_cv.notify_all();
+
+        try
+        {
+            fun(0);
+        }
+        catch (...)
+        {
+            m_errors[0] = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_done_cv.wait(lk, [&] { return m_pending == 0; });
+            m_job = nullptr;
+        }
+
+        for (auto& e : m_errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+};
+
+} // namespace disk
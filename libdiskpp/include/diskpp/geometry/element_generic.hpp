@@ -57,6 +57,8 @@ struct generic_element_traits<generic_element<DIM, DIM>>
     static const size_t codimension = DIM;
 };
 
+/* Convert a list of raw indices to identifiers, throws if an index does
+ * not fit in ident_raw_t */
 template<typename To, typename From>
 std::vector<To>
 convert_to(const std::vector<From>& vec)
@@ -64,7 +66,7 @@ convert_to(const std::vector<From>& vec)
     std::vector<To> ret;
     ret.reserve(vec.size());
     for (auto& v : vec)
-        ret.push_back( To(v) );
+        ret.push_back( To(to_ident_raw(v)) );
 
     return ret;
 }
@@ -160,6 +162,9 @@ public:
     const_sid_iterator  subelement_id_end()   const { return m_sids_ptrs.end(); }
 
     size_t              subelement_size() const { return m_sids_ptrs.size(); }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t              lookup_key() const { return m_sids_ptrs.empty() ? 0 : size_t(m_sids_ptrs[0]); }
 };
 
 /* element class, CODIM < DIM case */
@@ -227,6 +232,12 @@ public:
     {
         return this->m_assoc_point == other.m_assoc_point;
     }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t lookup_key(void) const
+    {
+        return m_assoc_point;
+    }
 };
 
 /* EDGE */
@@ -302,6 +313,9 @@ public:
     auto subelement_id_end()   const { return sub_elem_ids.end(); }
 
     size_t subelement_size() const { return sub_elem_ids.size(); }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t lookup_key() const { return sub_elem_ids[0]; }
 };
 
 template<>
@@ -0,0 +1,230 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <vector>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "diskpp/geometry/element_generic.hpp"
+
+namespace disk {
+
+/* Polygons and polyhedra of a generic mesh store the ids of their subelements
+ * and of their points in two std::vectors, therefore each element requires
+ * two heap allocations. generic_element_view has the same interface of
+ * generic_element, but it only refers to the ids, which are stored in
+ * contiguous arrays owned by the mesh storage (see flat_element_pool). A view
+ * is valid as long as the storage that created it is alive. Edges and nodes
+ * do not need views, as their ids are already stored in fixed-size arrays. */
+template<size_t DIM, size_t CODIM>
+class generic_element_view;
+
+template<size_t DIM, size_t CODIM>
+struct generic_element_traits<generic_element_view<DIM, CODIM>>
+{
+    static_assert(CODIM+1 < DIM, "generic_element_view: only for polygons and polyhedra");
+
+    typedef std::conditional_t<(CODIM+2 < DIM),
+                               generic_element_view<DIM, CODIM+1>,
+                               generic_element<DIM, CODIM+1>>        subelement_type;
+    typedef identifier<generic_element_view<DIM,CODIM>, ident_raw_t, 0> id_type;
+    static const size_t dimension = DIM;
+    static const size_t codimension = CODIM;
+};
+
+template<size_t DIM, size_t CODIM>
+class generic_element_view
+{
+public:
+    typedef typename generic_element_traits<generic_element_view>::subelement_type  subelement_type;
+    typedef typename generic_element_traits<generic_element_view>::id_type          id_type;
+
+private:
+    typedef typename subelement_type::id_type       sub_id_type;
+    typedef point_identifier<DIM>                   point_id_type;
+
+    const sub_id_type       *m_sids_ptrs;
+    const point_id_type     *m_pts_ptrs;
+    uint32_t                m_num_sids;
+    uint32_t                m_num_pts;
+
+public:
+    typedef const sub_id_type *     const_sid_iterator;
+
+    generic_element_view()
+        : m_sids_ptrs(nullptr), m_pts_ptrs(nullptr), m_num_sids(0), m_num_pts(0)
+    {}
+
+    generic_element_view(const sub_id_type *sids, size_t num_sids,
+                         const point_id_type *pts, size_t num_pts)
+        : m_sids_ptrs(sids), m_pts_ptrs(pts), m_num_sids(num_sids), m_num_pts(num_pts)
+    {}
+
+    std::span<const point_id_type>
+    point_ids(void) const
+    {
+        assert(m_num_pts > 0);
+        return std::span<const point_id_type>(m_pts_ptrs, m_num_pts);
+    }
+
+    std::span<const sub_id_type>
+    faces_ids(void) const
+    {
+        assert(m_num_sids > 0);
+        return std::span<const sub_id_type>(m_sids_ptrs, m_num_sids);
+    }
+
+    const_sid_iterator  subelement_id_begin() const { return m_sids_ptrs; }
+    const_sid_iterator  subelement_id_end()   const { return m_sids_ptrs + m_num_sids; }
+
+    size_t              subelement_size() const { return m_num_sids; }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t              lookup_key() const { return m_num_sids == 0 ? 0 : size_t(m_sids_ptrs[0]); }
+
+    bool operator<(const generic_element_view& other) const
+    {
+        return std::lexicographical_compare(subelement_id_begin(), subelement_id_end(),
+                                            other.subelement_id_begin(), other.subelement_id_end());
+    }
+
+    bool operator==(const generic_element_view& other) const
+    {
+        return std::equal(subelement_id_begin(), subelement_id_end(),
+                          other.subelement_id_begin(), other.subelement_id_end());
+    }
+};
+
+/* Contiguous storage of the ids of the elements of type Element, in CSR
+ * format: the ids of the element i are in [offsets[i], offsets[i+1]). */
+template<typename Element>
+struct flat_element_pool
+{
+    typedef typename Element::subelement_type::id_type  sub_id_type;
+    typedef point_identifier<generic_element_traits<Element>::dimension> point_id_type;
+
+    std::vector<size_t>         subelement_offsets;
+    std::vector<sub_id_type>    subelement_ids;
+    std::vector<size_t>         point_offsets;
+    std::vector<point_id_type>  point_ids;
+
+    /* Copy the ids of the elements in [begin, end) in the pool and return the
+     * corresponding views. The views are invalidated if the pool is modified. */
+    template<typename Iterator>
+    std::vector<Element>
+    fill(const Iterator& begin, const Iterator& end)
+    {
+        size_t num_elems = std::distance(begin, end);
+        size_t num_sids = 0, num_pts = 0;
+        for (auto itor = begin; itor != end; itor++)
+        {
+            num_sids += itor->subelement_size();
+            num_pts += itor->point_ids().size();
+        }
+
+        subelement_offsets.clear();
+        subelement_offsets.reserve(num_elems+1);
+        subelement_ids.clear();
+        subelement_ids.reserve(num_sids);
+        point_offsets.clear();
+        point_offsets.reserve(num_elems+1);
+        point_ids.clear();
+        point_ids.reserve(num_pts);
+
+        for (auto itor = begin; itor != end; itor++)
+        {
+            subelement_offsets.push_back( subelement_ids.size() );
+            for (auto sitor = itor->subelement_id_begin(); sitor != itor->subelement_id_end(); sitor++)
+                subelement_ids.push_back( sub_id_type(size_t(*sitor)) );
+
+            point_offsets.push_back( point_ids.size() );
+            for (auto& ptid : itor->point_ids())
+                point_ids.push_back( point_id_type(ptid) );
+        }
+        subelement_offsets.push_back( subelement_ids.size() );
+        point_offsets.push_back( point_ids.size() );
+
+        std::vector<Element> ret;
+        ret.reserve(num_elems);
+        for (size_t i = 0; i < num_elems; i++)
+        {
+            auto sofs = subelement_offsets[i];
+            auto pofs = point_offsets[i];
+            ret.push_back( Element(subelement_ids.data() + sofs, subelement_offsets[i+1] - sofs,
+                                   point_ids.data() + pofs, point_offsets[i+1] - pofs) );
+        }
+
+        return ret;
+    }
+
+    /* Same as above, but the ids of the element i are given by the ranges
+     * sub_ids(i) and pt_ids(i), i in [0, num_elems): this allows the loaders
+     * to fill the pool directly from their tables, without building a
+     * generic_element for each polygon/polyhedron first. */
+    template<typename SubIds, typename PointIds>
+    std::vector<Element>
+    fill(size_t num_elems, const SubIds& sub_ids, const PointIds& pt_ids)
+    {
+        subelement_offsets.assign(num_elems+1, 0);
+        point_offsets.assign(num_elems+1, 0);
+        for (size_t i = 0; i < num_elems; i++)
+        {
+            subelement_offsets[i+1] = subelement_offsets[i] + std::ranges::size(sub_ids(i));
+            point_offsets[i+1] = point_offsets[i] + std::ranges::size(pt_ids(i));
+        }
+
+        subelement_ids.resize( subelement_offsets.back() );
+        point_ids.resize( point_offsets.back() );
+
+        std::vector<Element> ret;
+        ret.reserve(num_elems);
+        for (size_t i = 0; i < num_elems; i++)
+        {
+            auto sofs = subelement_offsets[i];
+            for (auto& sid : sub_ids(i))
+                subelement_ids[sofs++] = sub_id_type( to_ident_raw(size_t(sid)) );
+
+            auto pofs = point_offsets[i];
+            for (auto& ptid : pt_ids(i))
+                point_ids[pofs++] = point_id_type( to_ident_raw(size_t(ptid)) );
+
+            sofs = subelement_offsets[i];
+            pofs = point_offsets[i];
+            ret.push_back( Element(subelement_ids.data() + sofs, subelement_offsets[i+1] - sofs,
+                                   point_ids.data() + pofs, point_offsets[i+1] - pofs) );
+        }
+
+        return ret;
+    }
+};
+
+template<size_t DIM, size_t CODIM>
+std::ostream&
+operator<<(std::ostream& os, const generic_element_view<DIM, CODIM>& e)
+{
+    os << "generic_element_view<" << DIM << "," << CODIM << ">: ";
+    for (auto itor = e.subelement_id_begin();
+         itor != e.subelement_id_end();
+         itor++)
+        os << *itor << " ";
+
+    os << "( ";
+    for (auto& pt : e.point_ids())
+        os << pt << " ";
+
+    os << ")";
+
+    return os;
+}
+
+} // namespace disk
@@ -43,7 +43,7 @@ class cartesian_element
     static_assert(DIM == 2 or DIM == 3, "cartesian elements must be 2D or 3D");
 
     //typedef point_identifier<DIM>       point_id_type;
-    typedef size_t point_id_type;
+    typedef ident_raw_t point_id_type;
 
     typedef std::array<point_id_type, cartesian_priv::howmany<DIM, CODIM>::nodes>
         node_array_type;
@@ -60,6 +60,10 @@ public:
         std::copy(l.begin(), l.end(), m_pts_ptrs.begin());
     }
 
+    explicit cartesian_element(const node_array_type& pts)
+        : m_pts_ptrs(pts)
+    {}
+
     node_array_type point_ids(void) const
     {
         return m_pts_ptrs;
@@ -79,6 +83,12 @@ public:
     {
         return cartesian_priv::howmany<DIM, CODIM>::subelements;
     }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t lookup_key(void) const
+    {
+        return m_pts_ptrs[0];
+    }
 };
 
 namespace cartesian_priv {
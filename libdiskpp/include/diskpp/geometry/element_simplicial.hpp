@@ -42,7 +42,7 @@ class simplicial_element
 {
     //typedef point_identifier<DIM>       point_id_type;
 
-    typedef size_t point_id_type;
+    typedef ident_raw_t point_id_type;
 
     typedef std::array<point_id_type, priv::howmany<DIM, CODIM>::nodes> node_array_type;
 
@@ -59,6 +59,12 @@ public:
         std::sort(m_pts_ptrs.begin(), m_pts_ptrs.end());
     }
 
+    explicit simplicial_element(const node_array_type& pts)
+        : m_pts_ptrs(pts)
+    {
+        std::sort(m_pts_ptrs.begin(), m_pts_ptrs.end());
+    }
+
     node_array_type point_ids(void) const
     {
         return m_pts_ptrs;
@@ -83,6 +89,12 @@ public:
     {
         return priv::howmany<DIM, CODIM>::subelements;
     }
+
+    /* First id compared by operator<, used by the mesh to index the element */
+    size_t lookup_key(void) const
+    {
+        return m_pts_ptrs[0];
+    }
 };
 
 namespace priv {
@@ -32,6 +32,7 @@
 #define _GEOMETRY_GENERIC_HPP_
 
 #include "diskpp/geometry/element_generic.hpp"
+#include "diskpp/geometry/element_generic_flat.hpp"
 #include "diskpp/quadratures/bits/raw_simplices.hpp"
 #include "diskpp/common/simplicial_formula.hpp"
 
@@ -73,33 +74,139 @@ using generic_mesh_storage = mesh_storage<T, DIM, generic_storage_class<DIM>>;
 template<typename T, size_t DIM>
 using generic_mesh = mesh<T, DIM, generic_mesh_storage<T, DIM>>;
 
+/* Storage class of the generic meshes with flat connectivity: polygons and
+ * polyhedra are views on the contiguous arrays of the storage. */
+template<size_t DIM>
+struct flat_generic_storage_class {
+    static_assert(DIM == 2 || DIM == 3, "This storage class supports DIM 2 and 3");
+};
+
+template<>
+struct flat_generic_storage_class<2> {
+    typedef generic_element_view<2,0>   surface_type;
+    typedef generic_element<2,1>        edge_type;
+    typedef generic_element<2,2>        node_type;
+};
+
+template<>
+struct flat_generic_storage_class<3> {
+        typedef generic_element_view<3,0>   volume_type;
+        typedef generic_element_view<3,1>   surface_type;
+        typedef generic_element<3,2>        edge_type;
+        typedef generic_element<3,3>        node_type;
+};
+
+template<typename T, size_t DIM>
+struct flat_generic_mesh_storage;
+
+template<typename T>
+struct flat_generic_mesh_storage<T,2> : public mesh_storage<T, 2, flat_generic_storage_class<2>>
+{
+    typedef mesh_storage<T, 2, flat_generic_storage_class<2>>   base_type;
+
+    flat_element_pool<typename base_type::surface_type>         surface_pool;
+
+    flat_generic_mesh_storage() = default;
+    /* The elements refer to the pools: copying would leave them dangling.
+     * Moving keeps the buffers of the pools, so the elements stay valid. */
+    flat_generic_mesh_storage(const flat_generic_mesh_storage&) = delete;
+    flat_generic_mesh_storage& operator=(const flat_generic_mesh_storage&) = delete;
+    flat_generic_mesh_storage(flat_generic_mesh_storage&&) = default;
+    flat_generic_mesh_storage& operator=(flat_generic_mesh_storage&&) = default;
+};
+
+template<typename T>
+struct flat_generic_mesh_storage<T,3> : public mesh_storage<T, 3, flat_generic_storage_class<3>>
+{
+    typedef mesh_storage<T, 3, flat_generic_storage_class<3>>   base_type;
+
+    flat_element_pool<typename base_type::volume_type>          volume_pool;
+    flat_element_pool<typename base_type::surface_type>         surface_pool;
+
+    flat_generic_mesh_storage() = default;
+    /* The elements refer to the pools: copying would leave them dangling.
+     * Moving keeps the buffers of the pools, so the elements stay valid. */
+    flat_generic_mesh_storage(const flat_generic_mesh_storage&) = delete;
+    flat_generic_mesh_storage& operator=(const flat_generic_mesh_storage&) = delete;
+    flat_generic_mesh_storage(flat_generic_mesh_storage&&) = default;
+    flat_generic_mesh_storage& operator=(flat_generic_mesh_storage&&) = default;
+};
+
+/* Generic mesh with the connectivity of all the polygons/polyhedra stored in
+ * contiguous arrays. The FVCA5, FVCA6 and medit loaders fill it directly,
+ * other meshes are obtained from a generic_mesh via make_flat_mesh(). It can
+ * be used in place of a generic_mesh by all the generic_mesh algorithms. */
+template<typename T, size_t DIM>
+using flat_generic_mesh = mesh<T, DIM, flat_generic_mesh_storage<T, DIM>>;
+
+/* Storages whose elements have the interface of generic_element. */
+template<typename Storage>
+struct is_generic_storage : std::false_type {};
+
+template<typename T, size_t DIM>
+struct is_generic_storage<generic_mesh_storage<T, DIM>> : std::true_type {};
+
+template<typename T, size_t DIM>
+struct is_generic_storage<flat_generic_mesh_storage<T, DIM>> : std::true_type {};
+
+template<typename Storage>
+concept generic_storage = is_generic_storage<Storage>::value;
+
+/* Copy a generic mesh in a mesh with flat connectivity. */
+template<typename T, size_t DIM>
+void
+make_flat_mesh(const generic_mesh<T, DIM>& src, flat_generic_mesh<T, DIM>& dst)
+{
+    auto ss = src.backend_storage();
+    auto ds = dst.backend_storage();
+
+    ds->points = ss->points;
+    ds->nodes = ss->nodes;
+    ds->edges = ss->edges;
+
+    if constexpr (DIM == 2)
+    {
+        ds->surfaces = ds->surface_pool.fill(ss->surfaces.begin(), ss->surfaces.end());
+    }
+    else
+    {
+        ds->surfaces = ds->surface_pool.fill(ss->surfaces.begin(), ss->surfaces.end());
+        ds->volumes = ds->volume_pool.fill(ss->volumes.begin(), ss->volumes.end());
+    }
+
+    ds->subdomain_info = ss->subdomain_info;
+    ds->boundary_info = ss->boundary_info;
+
+    dst.reset_lookup_tables();
+}
+
 } // namespace disk
 
 #include "geometry_generic_triangulations.hpp"
 
 namespace disk {
 
-template<typename T, size_t DIM>
+template<typename T, size_t DIM, generic_storage Storage>
 size_t
-howmany_faces(const generic_mesh<T,DIM>& msh,
-              const typename generic_mesh<T,DIM>::cell& cl)
+howmany_faces(const mesh<T,DIM,Storage>& msh,
+              const typename mesh<T,DIM,Storage>::cell& cl)
 {
     return cl.subelement_size();
 }
 
 
-template<typename T, size_t DIM>
-std::vector<typename generic_mesh<T, DIM>::face>
-faces(const generic_mesh<T, DIM>& msh,
-      const typename generic_mesh<T, DIM>::cell& cl)
+template<typename T, size_t DIM, generic_storage Storage>
+std::vector<typename mesh<T, DIM, Storage>::face>
+faces(const mesh<T, DIM, Storage>& msh,
+      const typename mesh<T, DIM, Storage>::cell& cl)
 {
     auto faces_begin = msh.faces_begin();
-    auto id_to_face  = [&](const typename generic_mesh<T, DIM>::face::id_type& id) -> auto
+    auto id_to_face  = [&](const typename mesh<T, DIM, Storage>::face::id_type& id) -> auto
     {
         return *std::next(faces_begin, id);
     };
 
-    std::vector<typename generic_mesh<T, DIM>::face> ret;
+    std::vector<typename mesh<T, DIM, Storage>::face> ret;
     ret.resize(cl.subelement_size());
 
     std::transform(cl.subelement_id_begin(), cl.subelement_id_end(), ret.begin(), id_to_face);
@@ -107,9 +214,9 @@ faces(const generic_mesh<T, DIM>& msh,
     return ret;
 }
 
-template<typename T, size_t DIM>
-std::vector<typename generic_mesh<T, DIM>::face::id_type>
-faces_id(const generic_mesh<T, DIM>& msh, const typename generic_mesh<T, DIM>::cell& cl)
+template<typename T, size_t DIM, generic_storage Storage>
+auto
+faces_id(const mesh<T, DIM, Storage>& msh, const typename mesh<T, DIM, Storage>::cell& cl)
 {
     return cl.faces_ids();
 }
@@ -126,10 +233,10 @@ faces_id(const generic_mesh<T, 1>& msh, const typename generic_mesh<T, 1>::cell&
 /* Determine if a mesh element is convex. The idea is to turn CCW and for each
  * pair of consecutive edges check the cross product. If it is positive, you're
  * turning left. If you have a right turn, then the polygon is not convex. */
-template<typename T>
+template<typename T, generic_storage Storage>
 bool
-is_convex(const disk::generic_mesh<T,2>& msh,
-    const typename disk::generic_mesh<T,2>::cell_type& cl)
+is_convex(const disk::mesh<T,2,Storage>& msh,
+    const typename disk::mesh<T,2,Storage>::cell_type& cl)
 {
     auto pts = points(msh, cl);
     assert(pts.size() > 2);
@@ -161,9 +268,9 @@ is_convex(const disk::generic_mesh<T,2>& msh,
   *
   */
 
-template<typename T>
+template<typename T, generic_storage Storage>
 T
-measure(const generic_mesh<T,3>& msh, const typename generic_mesh<T,3>::cell& cl)
+measure(const mesh<T,3,Storage>& msh, const typename mesh<T,3,Storage>::cell& cl)
 {
     T vol = 0.0;
     auto rss = split_in_raw_tetrahedra(msh, cl);
@@ -182,9 +289,9 @@ measure(const generic_mesh<T,3>& msh, const typename generic_mesh<T,3>::cell& cl
   *
   */
 
-template<typename T>
+template<typename T, generic_storage Storage>
 T
-measure(const generic_mesh<T,3>& msh, const typename generic_mesh<T,3>::face& fc)
+measure(const mesh<T,3,Storage>& msh, const typename mesh<T,3,Storage>::face& fc)
 {
     auto pts = points(msh, fc);
 
@@ -204,10 +311,10 @@ measure(const generic_mesh<T,3>& msh, const typename generic_mesh<T,3>::face& fc
  * \param cl Reference to a cell
  * \return Return the area of the specified 2D cell
  */
-template<typename T>
+template<typename T, generic_storage Storage>
 T
-measure(const generic_mesh<T,2>& msh,
-    const typename generic_mesh<T,2>::cell& cl)
+measure(const mesh<T,2,Storage>& msh,
+    const typename mesh<T,2,Storage>::cell& cl)
 {
     /* Uses the divergence theorem: this way works on
      * nonconvex elements without subtriangulating. */
@@ -222,10 +329,10 @@ measure(const generic_mesh<T,2>& msh,
     return tot_meas;
 }
 
-template<typename T>
+template<typename T, generic_storage Storage>
 point<T,2>
-barycenter(const generic_mesh<T,2>& msh,
-    const typename generic_mesh<T,2>::cell& cl)
+barycenter(const mesh<T,2,Storage>& msh,
+    const typename mesh<T,2,Storage>::cell& cl)
 {
     T Cx = 0.0;
     T Cy = 0.0;
@@ -257,9 +364,9 @@ barycenter(const generic_mesh<T,2>& msh,
  * \return Return the length of the specified 2D face
  */
 
-template<typename T>
+template<typename T, generic_storage Storage>
 T
-measure(const generic_mesh<T,2>& msh, const typename generic_mesh<T,2>::face& fc)
+measure(const mesh<T,2,Storage>& msh, const typename mesh<T,2,Storage>::face& fc)
 {
     auto pts = points(msh, fc);
     assert(pts.size() == 2);
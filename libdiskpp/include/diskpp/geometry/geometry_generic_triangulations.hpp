@@ -28,10 +28,10 @@ measure(const triangle<T,DIM>& t)
 }
 
 /* Call J. R. Shewchuk's Triangle to triangulate a mesh element */
-inline
+template<generic_storage Storage>
 std::vector<triangle<double,2>>
-triangulate_nonconvex_polygon(const generic_mesh<double,2>& msh,
-    const typename generic_mesh<double,2>::cell_type& cl)
+triangulate_nonconvex_polygon(const mesh<double,2,Storage>& msh,
+    const typename mesh<double,2,Storage>::cell_type& cl)
 {
     auto pts = points(msh, cl);
     std::vector<double> tri_pts;
@@ -98,10 +98,10 @@ triangulate_nonconvex_polygon(const generic_mesh<double,2>& msh,
     return ret;
 }
 
-template<typename T>
+template<typename T, generic_storage Storage>
 auto
-triangulate_convex_polygon(const generic_mesh<T,2>& msh,
-    const typename generic_mesh<T,2>::cell_type& cl)
+triangulate_convex_polygon(const mesh<T,2,Storage>& msh,
+    const typename mesh<T,2,Storage>::cell_type& cl)
 {
     std::vector<triangle<T,2>> ret;
 
@@ -122,10 +122,10 @@ triangulate_convex_polygon(const generic_mesh<T,2>& msh,
     return ret;
 }
 
-template<typename T>
+template<typename T, generic_storage Storage>
 auto
-triangulate_polygon(const generic_mesh<T,2>& msh,
-    const typename generic_mesh<T,2>::cell_type& cl)
+triangulate_polygon(const mesh<T,2,Storage>& msh,
+    const typename mesh<T,2,Storage>::cell_type& cl)
 {
     if ( is_convex(msh, cl) )
         return triangulate_convex_polygon(msh, cl);
@@ -201,13 +201,11 @@ faces_id(const cartesian_mesh<T, 2>& msh, const typename cartesian_mesh<T, 2>::c
     typedef typename cartesian_mesh<T, 2>::face face_type;
     std::array<typename face_type::id_type, 4>  ret;
 
-    auto ptids = cl.point_ids();
-    assert(ptids.size() == 4);
+    auto fcs_id = msh.face_ids( msh.lookup(cl) );
+    assert(fcs_id.size() == 4);
 
-    ret[0] = msh.lookup(face_type({ptids[0], ptids[1]}));
-    ret[1] = msh.lookup(face_type({ptids[0], ptids[2]}));
-    ret[2] = msh.lookup(face_type({ptids[1], ptids[3]}));
-    ret[3] = msh.lookup(face_type({ptids[2], ptids[3]}));
+    for (size_t i = 0; i < 4; i++)
+        ret[i] = typename face_type::id_type(fcs_id[i]);
 
     return ret;
 }
@@ -227,15 +225,11 @@ faces_id(const cartesian_mesh<T, 3>& msh, const typename cartesian_mesh<T, 3>::c
     typedef typename cartesian_mesh<T, 3>::face face_type;
     std::array<typename face_type::id_type, 6>   ret;
 
-    auto ptids = cl.point_ids();
-    assert(ptids.size() == 8);
+    auto fcs_id = msh.face_ids( msh.lookup(cl) );
+    assert(fcs_id.size() == 6);
 
-    ret[0] = msh.lookup(face_type({ptids[0], ptids[2], ptids[6], ptids[4]}));
-    ret[1] = msh.lookup(face_type({ptids[1], ptids[3], ptids[7], ptids[5]}));
-    ret[2] = msh.lookup(face_type({ptids[0], ptids[1], ptids[3], ptids[2]}));
-    ret[3] = msh.lookup(face_type({ptids[4], ptids[5], ptids[7], ptids[6]}));
-    ret[4] = msh.lookup(face_type({ptids[0], ptids[4], ptids[5], ptids[1]}));
-    ret[5] = msh.lookup(face_type({ptids[2], ptids[6], ptids[7], ptids[3]}));
+    for (size_t i = 0; i < 6; i++)
+        ret[i] = typename face_type::id_type(fcs_id[i]);
 
     return ret;
 }
@@ -267,7 +261,7 @@ measure(const cartesian_mesh<T,3>& msh,
         const typename cartesian_mesh<T,3>::cell& cl)
 {
     auto pts = points(msh, cl);
-    assert(pts.size() == 4);
+    assert(pts.size() == 8);
     auto v0 = (pts[1] - pts[0]).to_vector().norm();
     auto v1 = (pts[2] - pts[0]).to_vector().norm();
     auto v2 = (pts[4] - pts[0]).to_vector().norm();
@@ -199,13 +199,11 @@ faces_id(const simplicial_mesh<T, 3>& msh, const typename simplicial_mesh<T, 3>:
     typedef typename simplicial_mesh<T, 3>::face face_type;
     std::array<typename face_type::id_type, 4>   ret;
 
-    auto ptids = cl.point_ids();
-    assert(ptids.size() == 4);
+    auto fcs_id = msh.face_ids( msh.lookup(cl) );
+    assert(fcs_id.size() == 4);
 
-    ret[0] = msh.lookup(face_type({ptids[1], ptids[2], ptids[3]}));
-    ret[1] = msh.lookup(face_type({ptids[0], ptids[2], ptids[3]}));
-    ret[2] = msh.lookup(face_type({ptids[0], ptids[1], ptids[3]}));
-    ret[3] = msh.lookup(face_type({ptids[0], ptids[1], ptids[2]}));
+    for (size_t i = 0; i < 4; i++)
+        ret[i] = typename face_type::id_type(fcs_id[i]);
 
     return ret;
 }
@@ -225,14 +223,11 @@ faces_id(const simplicial_mesh<T, 2>& msh, const typename simplicial_mesh<T, 2>:
     typedef typename simplicial_mesh<T, 2>::face face_type;
     std::array<typename face_type::id_type, 3>   ret;
 
-    auto ptids = cl.point_ids();
-    assert(ptids.size() == 3);
-
-    assert(ptids[0] < ptids[1] && ptids[1] < ptids[2]);
+    auto fcs_id = msh.face_ids( msh.lookup(cl) );
+    assert(fcs_id.size() == 3);
 
-    ret[0] = msh.lookup(face_type({ptids[0], ptids[1]}));
-    ret[1] = msh.lookup(face_type({ptids[1], ptids[2]}));
-    ret[2] = msh.lookup(face_type({ptids[0], ptids[2]}));
+    for (size_t i = 0; i < 3; i++)
+        ret[i] = typename face_type::id_type(fcs_id[i]);
 
     return ret;
 }
@@ -72,8 +72,10 @@
 #include <tuple>
 #include <cassert>
 #include <fstream>
+#include <numeric>
 #include <regex>
 #include <set>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -83,6 +85,7 @@
 
 #include "diskpp/common/mapped_file.h"
 #include "strtot.hpp"
+#include "mesh_cache.hpp"
 
 namespace disk {
 
@@ -314,7 +317,7 @@ class netgen_mesh_loader<T,2> : public mesh_loader<simplicial_mesh<T,2>>
 
             points.push_back( point );
 
-            auto point_id = disk::point_identifier<2>( linecount );
+            auto point_id = disk::point_identifier<2>( to_ident_raw(linecount) );
             auto node = node_type( { point_id } );
 
             nodes.push_back(node);
@@ -347,9 +350,9 @@ class netgen_mesh_loader<T,2> : public mesh_loader<simplicial_mesh<T,2>>
 
             auto t = priv::read_triangle_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<2>     p0(std::get<1>(t));
-            disk::point_identifier<2>     p1(std::get<2>(t));
-            disk::point_identifier<2>     p2(std::get<3>(t));
+            disk::point_identifier<2>     p0(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<2>     p1(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<2>     p2(to_ident_raw(std::get<3>(t)));
             //domain_id_type      d(std::get<0>(t));
 
             edges.push_back( edge_type( { p0, p1 } ) );
@@ -384,8 +387,8 @@ class netgen_mesh_loader<T,2> : public mesh_loader<simplicial_mesh<T,2>>
 
             auto t = priv::read_edge_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<2>     p0(std::get<1>(t));
-            disk::point_identifier<2>     p1(std::get<2>(t));
+            disk::point_identifier<2>     p0(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<2>     p1(to_ident_raw(std::get<2>(t)));
 
             edge_type   edge( { p0, p1 } );
 
@@ -503,102 +506,71 @@ class netgen_mesh_loader<T,3> : public mesh_loader<simplicial_mesh<T,3>>
             return false;
         }
 
-        size_t lines, linecount;
+        size_t lines;
 
         mapped_file mf(filename);
 
-        /************************ Read points ************************/
-        linecount = 0;
-
+        /* The sections are parsed in parallel, see parallel_parse_records() */
         const char *data = mf.mem();
+        const char *data_end = data + mf.size();
         char *endptr;
 
+        /************************ Read points ************************/
         lines = strtot<size_t>(data, &endptr);
+        if (this->verbose())
+            std::cout << "Reading points: " << lines << std::endl;
 
-        points.reserve(lines);
-        nodes.reserve(lines);
-
-        while (linecount < lines)
-        {
-            if ( this->verbose() && ((linecount%100000) == 0) )
-            {
-                std::cout << "Reading points: " << linecount;
-                std::cout << "/" << lines << "\r";
-                std::cout.flush();
-            }
-
-            auto point = priv::read_3d_point_line<T>(endptr, &endptr, 1.0);
-
-            points.push_back( point );
-
-            auto point_id = disk::point_identifier<3>( linecount );
-            auto node = node_type( { point_id } );
-
-            nodes.push_back(node);
-            /* Do something with that point */
+        points.resize(lines);
+        nodes.resize(lines);
 
-            linecount++;
-        }
+        auto read_point = [&](size_t i, const char *str, char **ep) {
+            points[i] = priv::read_3d_point_line<T>(str, ep, 1.0);
+            auto point_id = disk::point_identifier<3>( to_ident_raw(i) );
+            nodes[i] = node_type( { point_id } );
+        };
 
-        if (this->verbose())
-        {
-            std::cout << "Reading points: " << linecount;
-            std::cout << "/" << lines << std::endl;
-        }
+        endptr = const_cast<char *>(
+            priv::parallel_parse_records(endptr, data_end, lines, read_point) );
 
         /************************ Read tetrahedra ************************/
-        linecount = 0;
-
         lines = strtot<size_t>(endptr, &endptr);
+        if (this->verbose())
+            std::cout << "Reading tetrahedra: " << lines << std::endl;
 
-        edges.reserve(lines*6);
-        surfaces.reserve(lines*4);
-        tmp_volumes.reserve(lines);
+        edges.resize(lines*6);
+        surfaces.resize(lines*4);
+        tmp_volumes.resize(lines);
 
-        while (linecount < lines)
-        {
-            if ( this->verbose() && ((linecount%100000) == 0) )
-            {
-                std::cout << "Reading tetrahedra: " << linecount;
-                std::cout << "/" << lines << "\r";
-                std::cout.flush();
-            }
-
-            auto t = priv::read_tetrahedron_line<size_t>(endptr, &endptr);
+        auto read_tetrahedron = [&](size_t i, const char *str, char **ep) {
+            auto t = priv::read_tetrahedron_line<size_t>(str, ep);
 
             auto subdomain_num = std::get<0>(t);
-            disk::point_identifier<3>     p0(std::get<1>(t));
-            disk::point_identifier<3>     p1(std::get<2>(t));
-            disk::point_identifier<3>     p2(std::get<3>(t));
-            disk::point_identifier<3>     p3(std::get<4>(t));
-
-            edges.push_back( edge_type( { p0, p1 } ) );
-            edges.push_back( edge_type( { p0, p2 } ) );
-            edges.push_back( edge_type( { p0, p3 } ) );
-            edges.push_back( edge_type( { p1, p2 } ) );
-            edges.push_back( edge_type( { p1, p3 } ) );
-            edges.push_back( edge_type( { p2, p3 } ) );
-
-            surfaces.push_back( surface_type( { p0, p1, p2 } ) );
-            surfaces.push_back( surface_type( { p0, p1, p3 } ) );
-            surfaces.push_back( surface_type( { p0, p2, p3 } ) );
-            surfaces.push_back( surface_type( { p1, p2, p3 } ) );
+            disk::point_identifier<3>     p0(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<3>     p1(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<3>     p2(to_ident_raw(std::get<3>(t)));
+            disk::point_identifier<3>     p3(to_ident_raw(std::get<4>(t)));
+
+            edges[6*i+0] = edge_type( { p0, p1 } );
+            edges[6*i+1] = edge_type( { p0, p2 } );
+            edges[6*i+2] = edge_type( { p0, p3 } );
+            edges[6*i+3] = edge_type( { p1, p2 } );
+            edges[6*i+4] = edge_type( { p1, p3 } );
+            edges[6*i+5] = edge_type( { p2, p3 } );
+
+            surfaces[4*i+0] = surface_type( { p0, p1, p2 } );
+            surfaces[4*i+1] = surface_type( { p0, p1, p3 } );
+            surfaces[4*i+2] = surface_type( { p0, p2, p3 } );
+            surfaces[4*i+3] = surface_type( { p1, p2, p3 } );
 
             subdomain_descriptor si(subdomain_num);
-            auto vs = std::make_pair(volume_type( {p0, p1, p2, p3} ), si);
-            tmp_volumes.push_back( vs );
-
-            linecount++;
-        }
+            tmp_volumes[i] = std::make_pair(volume_type( {p0, p1, p2, p3} ), si);
+        };
 
-        if (this->verbose())
-        {
-            std::cout << "Reading tetrahedra: " << linecount;
-            std::cout << "/" << lines << std::endl;
-        }
+        endptr = const_cast<char *>(
+            priv::parallel_parse_records(endptr, data_end, lines, read_tetrahedron) );
 
-        priv::sort_uniq(edges);
-        priv::sort_uniq(surfaces);
+        priv::parallel_sort_uniq(edges);
+        priv::parallel_sort_uniq(surfaces);
         boundary_info.resize(surfaces.size());
 
         using pvs = std::pair<volume_type, subdomain_descriptor>;
@@ -606,27 +578,20 @@ class netgen_mesh_loader<T,3> : public mesh_loader<simplicial_mesh<T,3>>
             return a.first < b.first;
         };
 
-        std::sort(tmp_volumes.begin(), tmp_volumes.end(), tmpvol_comp);
+        priv::parallel_sort(tmp_volumes.begin(), tmp_volumes.end(), tmpvol_comp);
 
         /************************ Read boundary surfaces ************************/
-        linecount = 0;
-
         lines = strtot<size_t>(endptr, &endptr);
-        while (linecount < lines)
-        {
-            if ( this->verbose() && ((linecount%50000) == 0) )
-            {
-                std::cout << "Reading triangle: " << linecount;
-                std::cout << "/" << lines << "\r";
-                std::cout.flush();
-            }
+        if (this->verbose())
+            std::cout << "Reading triangles: " << lines << std::endl;
 
-            auto t = priv::read_triangle_line<size_t>(endptr, &endptr);
+        auto read_boundary = [&](size_t, const char *str, char **ep) {
+            auto t = priv::read_triangle_line<size_t>(str, ep);
 
             auto bnd_id = std::get<0>(t);
-            disk::point_identifier<3>     p0(std::get<1>(t));
-            disk::point_identifier<3>     p1(std::get<2>(t));
-            disk::point_identifier<3>     p2(std::get<3>(t));
+            disk::point_identifier<3>     p0(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<3>     p1(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<3>     p2(to_ident_raw(std::get<3>(t)));
 
             boundary_descriptor bi(bnd_id, true);
             surface_type surf( { p0, p1, p2 } );
@@ -637,15 +602,9 @@ class netgen_mesh_loader<T,3> : public mesh_loader<simplicial_mesh<T,3>>
 
             auto ofs = std::distance(surfaces.begin(), itor);
             boundary_info.at(ofs) = bi;
+        };
 
-            linecount++;
-        }
-
-        if (this->verbose())
-        {
-            std::cout << "Reading triangle: " << linecount;
-            std::cout << "/" << lines << std::endl;
-        }
+        priv::parallel_parse_records(endptr, data_end, lines, read_boundary);
 
         return true;
     }
@@ -835,7 +794,7 @@ class cartesian_mesh_loader<T,3> : public mesh_loader<cartesian_mesh<T,3>>
 
             points.push_back( point );
 
-            auto point_id = disk::point_identifier<3>( linecount );
+            auto point_id = disk::point_identifier<3>( to_ident_raw(linecount) );
             auto node = node_type( { point_id } );
 
             nodes.push_back(node);
@@ -870,14 +829,14 @@ class cartesian_mesh_loader<T,3> : public mesh_loader<cartesian_mesh<T,3>>
 
             auto t = priv::read_hexahedron_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<3>     p0(std::get<0>(t));
-            disk::point_identifier<3>     p1(std::get<1>(t));
-            disk::point_identifier<3>     p2(std::get<2>(t));
-            disk::point_identifier<3>     p3(std::get<3>(t));
-            disk::point_identifier<3>     p4(std::get<4>(t));
-            disk::point_identifier<3>     p5(std::get<5>(t));
-            disk::point_identifier<3>     p6(std::get<6>(t));
-            disk::point_identifier<3>     p7(std::get<7>(t));
+            disk::point_identifier<3>     p0(to_ident_raw(std::get<0>(t)));
+            disk::point_identifier<3>     p1(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<3>     p2(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<3>     p3(to_ident_raw(std::get<3>(t)));
+            disk::point_identifier<3>     p4(to_ident_raw(std::get<4>(t)));
+            disk::point_identifier<3>     p5(to_ident_raw(std::get<5>(t)));
+            disk::point_identifier<3>     p6(to_ident_raw(std::get<6>(t)));
+            disk::point_identifier<3>     p7(to_ident_raw(std::get<7>(t)));
 
             edges.push_back( edge_type( { p0, p1 } ) );
             edges.push_back( edge_type( { p0, p2 } ) );
@@ -928,10 +887,10 @@ class cartesian_mesh_loader<T,3> : public mesh_loader<cartesian_mesh<T,3>>
 
             auto t = priv::read_hex_face_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<3>     p0(std::get<0>(t));
-            disk::point_identifier<3>     p1(std::get<1>(t));
-            disk::point_identifier<3>     p2(std::get<2>(t));
-            disk::point_identifier<3>     p3(std::get<3>(t));
+            disk::point_identifier<3>     p0(to_ident_raw(std::get<0>(t)));
+            disk::point_identifier<3>     p1(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<3>     p2(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<3>     p3(to_ident_raw(std::get<3>(t)));
 
             surface_type   quad( { p0, p1, p2, p3 } );
 
@@ -1084,7 +1043,7 @@ class cartesian_mesh_loader<T,2> : public mesh_loader<cartesian_mesh<T,2>>
 
             points.push_back( point );
 
-            auto point_id = disk::point_identifier<2>( linecount );
+            auto point_id = disk::point_identifier<2>( to_ident_raw(linecount) );
             auto node = node_type( { point_id } );
 
             nodes.push_back(node);
@@ -1118,10 +1077,10 @@ class cartesian_mesh_loader<T,2> : public mesh_loader<cartesian_mesh<T,2>>
 
             auto t = priv::read_quad_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<2>     p0(std::get<0>(t));
-            disk::point_identifier<2>     p1(std::get<1>(t));
-            disk::point_identifier<2>     p2(std::get<2>(t));
-            disk::point_identifier<2>     p3(std::get<3>(t));
+            disk::point_identifier<2>     p0(to_ident_raw(std::get<0>(t)));
+            disk::point_identifier<2>     p1(to_ident_raw(std::get<1>(t)));
+            disk::point_identifier<2>     p2(to_ident_raw(std::get<2>(t)));
+            disk::point_identifier<2>     p3(to_ident_raw(std::get<3>(t)));
 
             edges.push_back( edge_type( { p0, p1 } ) );
             edges.push_back( edge_type( { p0, p2 } ) );
@@ -1157,8 +1116,8 @@ class cartesian_mesh_loader<T,2> : public mesh_loader<cartesian_mesh<T,2>>
 
             auto t = priv::read_quad_face_line<size_t>(endptr, &endptr);
 
-            disk::point_identifier<2>     p0(std::get<0>(t));
-            disk::point_identifier<2>     p1(std::get<1>(t));
+            disk::point_identifier<2>     p0(to_ident_raw(std::get<0>(t)));
+            disk::point_identifier<2>     p1(to_ident_raw(std::get<1>(t)));
 
             edge_type   bnd( { p0, p1 } );
 
@@ -1285,55 +1244,66 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
    std::vector<std::pair<std::array<ident_raw_t, 2>, size_t>> m_boundary_edges;
 
    bool
-   medit_read_vertices(std::ifstream& ifs)
+   medit_read_vertices(priv::text_scanner& ts)
    {
       size_t elements_to_read;
-      T      x, y, z;
-      T      id;
-
-      ifs >> elements_to_read;
+      if (!ts.read(elements_to_read)) return false;
 
       if (this->verbose())
          std::cout << "Attempting to read " << elements_to_read << " points" << std::endl;
 
-      m_points.reserve(elements_to_read);
-      m_nodes.reserve(elements_to_read);
+      m_points.resize(elements_to_read);
+      m_nodes.resize(elements_to_read);
 
-      for (size_t i = 0; i < elements_to_read; i++) {
-         ifs >> x >> y >> z >> id;
-         m_points.push_back(point_type{x, y});
-         m_nodes.push_back(node_type(disk::point_identifier<2>(i)));
-      }
+      auto read_vertex = [&](size_t i, const char *str, char **endptr) {
+         T     x = 0, y = 0, z = 0, id = 0;
+         char *ptr     = const_cast<char *>(str);
+         bool  success = priv::read_value(&ptr, x) and priv::read_value(&ptr, y) and
+                        priv::read_value(&ptr, z) and priv::read_value(&ptr, id);
+         *endptr = ptr;
+
+         m_points[i] = point_type{x, y};
+         m_nodes[i]  = node_type(disk::point_identifier<2>(to_ident_raw(i)));
+         return success;
+      };
+
+      if (!ts.records(elements_to_read, read_vertex)) return ts.record_error("Vertices");
 
       return true;
    }
 
    bool
-   medit_read_polygons(std::ifstream& ifs, size_t polynum)
+   medit_read_polygons(priv::text_scanner& ts, size_t polynum)
    {
       size_t elements_to_read;
+      if (!ts.read(elements_to_read)) return false;
 
-      ifs >> elements_to_read;
       if (this->verbose())
          std::cout << "Reading " << elements_to_read << " " << polynum << "-angles" << std::endl;
 
-      for (size_t i = 0; i < elements_to_read; i++) {
-         medit2d_poly              p;
+      const size_t polys_ofs = m_polys.size();
+      const size_t edges_ofs = m_edges.size();
+      m_polys.resize(polys_ofs + elements_to_read);
+      m_edges.resize(edges_ofs + elements_to_read * polynum);
+
+      auto read_polygon = [&](size_t i, const char *str, char **endptr) {
+         medit2d_poly             p;
          std::vector<ident_raw_t> nodes(polynum + 1, 0);
+         char                    *ptr = const_cast<char *>(str);
 
          for (size_t j = 0; j < polynum; j++) {
-            ident_raw_t val;
-            ifs >> val;
+            size_t val;
+            if (!priv::read_value(&ptr, val)) {
+               *endptr = ptr;
+               return false;
+            }
             p.nodes.push_back(val - 1);
-            nodes[j] = val - 1;
+            nodes[j] = to_ident_raw(val - 1);
          }
          nodes[polynum] = nodes[0];
 
-         ifs >> p.id;
-
-         m_polys.push_back(p);
-
-         size_t p_id = m_polys.size();
+         bool success = priv::read_value(&ptr, p.id);
+         *endptr      = ptr;
 
          // We have too create edges
          for (size_t j = 0; j < polynum; j++) {
@@ -1341,122 +1311,117 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
             assert(b_edge[0] != b_edge[1]);
             if (b_edge[0] > b_edge[1]) std::swap(b_edge[0], b_edge[1]);
 
-            m_edges.push_back(b_edge);
-            m_polys.at(p_id - 1).attached_edges.insert({b_edge[0], b_edge[1]});
+            m_edges[edges_ofs + i * polynum + j] = b_edge;
+            p.attached_edges.insert({b_edge[0], b_edge[1]});
          }
-      }
+
+         m_polys[polys_ofs + i] = std::move(p);
+         return success;
+      };
+
+      if (!ts.records(elements_to_read, read_polygon))
+         return ts.record_error(std::to_string(polynum) + "-angles");
 
       return true;
    }
 
    bool
-   medit_read_boundary_edges(std::ifstream& ifs)
+   medit_read_boundary_edges(priv::text_scanner& ts)
    {
       size_t elements_to_read;
+      if (!ts.read(elements_to_read)) return false;
 
-      ifs >> elements_to_read;
       if (this->verbose())
          std::cout << "Reading " << elements_to_read << " boundary edges" << std::endl;
 
-      m_boundary_edges.reserve(elements_to_read);
+      m_boundary_edges.resize(elements_to_read);
 
-      for (size_t i = 0; i < elements_to_read; i++) {
-         std::array<ident_raw_t, 2> b_edge;
-         ifs >> b_edge[0];
-         b_edge[0] -= 1;
-         ifs >> b_edge[1];
-         b_edge[1] -= 1;
+      auto read_edge = [&](size_t i, const char *str, char **endptr) {
+         size_t v1, v2, b_id;
+         char  *ptr     = const_cast<char *>(str);
+         bool   success = priv::read_value(&ptr, v1) and priv::read_value(&ptr, v2) and
+                        priv::read_value(&ptr, b_id);
+         *endptr = ptr;
+         if (!success) return false;
+
+         std::array<ident_raw_t, 2> b_edge = {to_ident_raw(v1 - 1), to_ident_raw(v2 - 1)};
 
          assert(b_edge[0] != b_edge[1]);
 
          if (b_edge[0] > b_edge[1]) std::swap(b_edge[0], b_edge[1]);
 
-         std::array<ident_raw_t, 2> bnd = {b_edge[0], b_edge[1]};
-
-         size_t b_id;
-         ifs >> b_id;
+         m_boundary_edges[i] = std::make_pair(b_edge, b_id);
+         return true;
+      };
 
-         m_boundary_edges.push_back(std::make_pair(bnd, b_id));
-      }
+      if (!ts.records(elements_to_read, read_edge)) return ts.record_error("Edges");
 
       return true;
    }
 
-   bool
-   face_unique(const std::array<ident_raw_t, 2>& f1, const std::array<ident_raw_t, 2>& f2)
-   {
-      if (f1[0] == f2[0]) {
-         if (f1[1] == f2[1]) {
-            return false;
-         } else
-            return true;
-      } else
-         return true;
-   }
-
    bool
    medit_read(const std::string& filename)
    {
-      std::ifstream ifs(filename);
-      std::string   keyword;
+      mapped_file mf(filename);
 
-      if (!ifs.is_open()) {
+      if (!mf.is_open()) {
          std::cout << "Error opening " << filename << std::endl;
          return false;
       }
 
-      ifs >> keyword;
-      if (keyword != "MeshVersionFormatted") {
+      priv::text_scanner ts(mf.mem(), mf.mem() + mf.size());
+
+      if (ts.word() != "MeshVersionFormatted") {
          std::cout << "Expected keyword \"MeshVersionFormatted\"" << std::endl;
          return false;
       }
 
-      size_t format;
-      ifs >> format;
+      size_t format = 0;
+      ts.read(format);
 
       if (format != 2) {
          std::cout << "Expected format 2 (here: " << format << ")" << std::endl;
          return false;
       }
 
-      ifs >> keyword;
-      if (keyword != "Dimension") {
+      if (ts.word() != "Dimension") {
          std::cout << "Expected keyword \"Dimension\"" << std::endl;
          return false;
       }
 
-      size_t dim;
-      ifs >> dim;
+      size_t dim = 0;
+      ts.read(dim);
 
       if (dim != 3) {
          std::cout << "Expected dimension >=2 (here: " << dim << ")" << std::endl;
          return false;
       }
 
-      ifs >> keyword;
+      std::string keyword = ts.word();
       while (keyword != "End") {
+         bool success = false;
          if (keyword == "Vertices") {
-            medit_read_vertices(ifs);
+            success = medit_read_vertices(ts);
          } else if (keyword == "Triangles") {
-            medit_read_polygons(ifs, 3);
+            success = medit_read_polygons(ts, 3);
          } else if (keyword == "Quadrilaterals") {
-            medit_read_polygons(ifs, 4);
+            success = medit_read_polygons(ts, 4);
          } else if (keyword == "Pentagons") {
-            medit_read_polygons(ifs, 5);
+            success = medit_read_polygons(ts, 5);
          } else if (keyword == "Hexagons") {
-            medit_read_polygons(ifs, 6);
+            success = medit_read_polygons(ts, 6);
          } else if (keyword == "Edges") {
-            m_boundary_edges.clear();
-            medit_read_boundary_edges(ifs);
-         } else {
+            success = medit_read_boundary_edges(ts);
+         }
+
+         if (!success) {
             std::cout << "Error parsing Medit file" << std::endl;
             return false;
          }
 
-         ifs >> keyword;
+         keyword = ts.word();
       }
 
-      ifs.close();
       return true;
    }
 
@@ -1474,6 +1439,22 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
 
    bool
    populate_mesh(mesh_type& msh)
+   {
+      return populate(msh);
+   }
+
+   /* The polygons are copied directly in the contiguous arrays of the flat
+    * storage, no generic_mesh is built in between */
+   bool
+   populate_mesh(flat_generic_mesh<T, 2>& msh)
+   {
+      return populate(msh);
+   }
+
+ private:
+   template<typename Mesh>
+   bool
+   populate(Mesh& msh)
    {
       if (this->verbose()) std::cout << " *** POPULATING MEDIT MESH ***" << std::endl;
       auto storage = msh.backend_storage();
@@ -1483,35 +1464,21 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
       storage->nodes  = std::move(m_nodes);
 
       /* Edges */
-      /* Make the vector containing the edges */
+      /* Make the vector containing the edges, sort them and remove the
+       * duplicates */
+      priv::parallel_sort_uniq(m_edges);
+
       std::vector<edge_type> edges;
       edges.reserve(m_edges.size());
-      size_t nb_edge(0);
       for (size_t i = 0; i < m_edges.size(); i++) {
-         bool unique = true;
-         for (size_t j = 0; j < i; j++) {
-            if (!face_unique(m_edges[i], m_edges[j])) {
-               unique = false;
-               break;
-            }
-         }
-
-         if (unique) {
-            assert(m_edges[i][0] < m_edges[i][1]);
-            auto node1 = typename node_type::id_type(m_edges[i][0]);
-            auto node2 = typename node_type::id_type(m_edges[i][1]);
+         assert(m_edges[i][0] < m_edges[i][1]);
+         auto node1 = typename node_type::id_type(m_edges[i][0]);
+         auto node2 = typename node_type::id_type(m_edges[i][1]);
 
-            auto e = edge_type(node1, node2);
-
-            /* Next line not necessary anymore, see generic_element<DIM, DIM-1> */
-            //e.set_point_ids(m_edges[i].begin(), m_edges[i].begin() + 2); /* XXX: crap */
-            edges.push_back(e);
-            nb_edge++;
-         }
+         /* Next line not necessary anymore, see generic_element<DIM, DIM-1> */
+         //e.set_point_ids(m_edges[i].begin(), m_edges[i].begin() + 2); /* XXX: crap */
+         edges.push_back(edge_type(node1, node2));
       }
-      /* Sort them */
-      edges.resize(nb_edge);
-      std::sort(edges.begin(), edges.end());
 
       /* Detect which ones are boundary edges */
       storage->boundary_info.resize(edges.size());
@@ -1535,13 +1502,12 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
 
       storage->edges = std::move(edges);
 
-      /* Surfaces */
-      std::vector<surface_type> surfaces;
-      surfaces.reserve(m_polys.size());
-
-      for (auto& p : m_polys) {
-         std::vector<typename edge_type::id_type> surface_edges;
-         for (auto& e : p.attached_edges) {
+      /* Surfaces: the edges of all the polygons in a single array, then the
+       * polygons are stored in lexicographical order of their edges */
+      std::vector<size_t> poly_offsets(m_polys.size() + 1, 0);
+      std::vector<size_t> poly_edges;
+      for (size_t i = 0; i < m_polys.size(); i++) {
+         for (auto& e : m_polys[i].attached_edges) {
             assert(e[0] < e[1]);
             auto n1 = typename node_type::id_type(e[0]);
             auto n2 = typename node_type::id_type(e[1]);
@@ -1553,15 +1519,28 @@ class medit_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
                return false;
             }
 
-            surface_edges.push_back(edge_id.second);
+            poly_edges.push_back(edge_id.second);
          }
-         auto surface = surface_type(surface_edges);
-         surface.set_point_ids(p.nodes.begin(), p.nodes.end()); /* XXX: crap */
-         surfaces.push_back(surface);
+         poly_offsets[i + 1] = poly_edges.size();
       }
 
-      std::sort(surfaces.begin(), surfaces.end());
-      storage->surfaces = std::move(surfaces);
+      auto edges_of = [&](size_t i) {
+         return std::span<const size_t>(poly_edges.data() + poly_offsets[i], poly_offsets[i + 1] - poly_offsets[i]);
+      };
+
+      std::vector<size_t> order(m_polys.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+         auto ea = edges_of(a);
+         auto eb = edges_of(b);
+         return std::lexicographical_compare(ea.begin(), ea.end(), eb.begin(), eb.end());
+      });
+
+      priv::store_surfaces(
+        *storage,
+        order.size(),
+        [&](size_t i) { return edges_of(order[i]); },
+        [&](size_t i) -> const auto& { return m_polys[order[i]].nodes; });
 
       return true;
    }
@@ -1587,177 +1566,142 @@ class medit_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
    std::vector<std::pair<size_t, std::vector<size_t>>> faces_to_edges;
    std::vector<std::vector<size_t>>                    faces_to_vts;
 
-   bool
-   expect(std::ifstream& ifs, const std::string& str)
-   {
-      std::string keyword;
-      ifs >> keyword;
-      if (keyword != str) {
-         std::cout << "Expected keyword \"" << str << "\"" << std::endl;
-         std::cout << "Found \"" << keyword << "\"" << std::endl;
-         return false;
-      }
-
-      return true;
-   }
-
-   std::vector<size_t>
-   read_medit3d_line(std::ifstream& ifs)
-   {
-      std::vector<size_t> ret;
-
-      size_t num_entries;
-      ifs >> num_entries;
-      for (size_t j = 0; j < num_entries; j++) {
-         size_t temp;
-         ifs >> temp;
-         ret.push_back(temp);
-      }
-
-      return ret;
-   }
-
    bool
    medit3d_read(const std::string& filename)
    {
-      std::ifstream ifs(filename);
-      std::string   keyword;
-      size_t        lines_to_read;
+      mapped_file mf(filename);
+      size_t      lines_to_read;
 
-      if (!ifs.is_open()) {
+      if (!mf.is_open()) {
          std::cout << "Error opening " << filename << std::endl;
          return false;
       }
 
-      ifs >> keyword;
-      if (keyword != "MeshVersionFormatted") {
+      priv::text_scanner ts(mf.mem(), mf.mem() + mf.size());
+
+      if (ts.word() != "MeshVersionFormatted") {
          std::cout << "Expected keyword \"MeshVersionFormatted\"" << std::endl;
          return false;
       }
 
-      size_t format;
-      ifs >> format;
+      size_t format = 0;
+      ts.read(format);
 
       if (format != 2) {
          std::cout << "Expected format 2 (here: " << format << ")" << std::endl;
          return false;
       }
 
-      ifs >> keyword;
-      if (keyword != "Dimension") {
+      if (ts.word() != "Dimension") {
          std::cout << "Expected keyword \"Dimension\"" << std::endl;
          return false;
       }
 
-      size_t dim;
-      ifs >> dim;
+      size_t dim = 0;
+      ts.read(dim);
 
       if (dim != 3) {
          std::cout << "Expected dimension == 3 (here: " << dim << ")" << std::endl;
          return false;
       }
 
-      if (!expect(ifs, "Vertices")) return false;
-
-      ifs >> lines_to_read;
+      if (!ts.expect("Vertices") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose()) std::cout << "About to read " << lines_to_read << " points" << std::endl;
 
-      m_points.reserve(lines_to_read);
-      m_nodes.reserve(lines_to_read);
-      for (size_t i = 0; i < lines_to_read; i++) {
-         T x, y, z;
-         ifs >> x >> y >> z;
-         m_points.push_back(point_type({x, y, z}));
-         m_nodes.push_back(node_type(disk::point_identifier<3>(i)));
-      }
+      m_points.resize(lines_to_read);
+      m_nodes.resize(lines_to_read);
 
-      /* Volume to face data */
-      if (!expect(ifs, "Volumes->Faces")) return false;
+      auto read_vertex = [&](size_t i, const char *str, char **endptr) {
+         T     x = 0, y = 0, z = 0;
+         char *ptr     = const_cast<char *>(str);
+         bool  success = priv::read_value(&ptr, x) and priv::read_value(&ptr, y) and
+                        priv::read_value(&ptr, z);
+         *endptr = ptr;
+
+         m_points[i] = point_type({x, y, z});
+         m_nodes[i]  = node_type(disk::point_identifier<3>(to_ident_raw(i)));
+         return success;
+      };
 
-      ifs >> lines_to_read;
+      if (!ts.records(lines_to_read, read_vertex)) return ts.record_error("Vertices");
+
+      /* Volume to face data */
+      if (!ts.expect("Volumes->Faces") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
-         auto vol_faces = read_medit3d_line(ifs);
-         vol_to_faces.push_back(std::make_pair(i, std::move(vol_faces)));
-      }
+      if (!priv::read_index_lists(ts, lines_to_read, vol_to_faces, 0))
+         return ts.record_error("Volumes->Faces");
 
       /* Volume to vertices data */
-      if (!expect(ifs, "Volumes->Vertices")) return false;
-
-      ifs >> lines_to_read;
+      if (!ts.expect("Volumes->Vertices") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
-         auto vol_vts = read_medit3d_line(ifs);
-         vol_to_vts.push_back(std::move(vol_vts));
-      }
+      if (!priv::read_index_lists(ts, lines_to_read, vol_to_vts, 0))
+         return ts.record_error("Volumes->Vertices");
 
       /* Faces to edges data */
-      if (!expect(ifs, "Faces->Edges")) return false;
-
-      ifs >> lines_to_read;
+      if (!ts.expect("Faces->Edges") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
-         auto faces_edges = read_medit3d_line(ifs);
-         faces_to_edges.push_back(std::make_pair(i, std::move(faces_edges)));
-      }
+      if (!priv::read_index_lists(ts, lines_to_read, faces_to_edges, 0))
+         return ts.record_error("Faces->Edges");
 
       /* Faces to vertices data */
-      if (!expect(ifs, "Faces->Vertices")) return false;
-
-      ifs >> lines_to_read;
+      if (!ts.expect("Faces->Vertices") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
-         auto faces_vts = read_medit3d_line(ifs);
-         faces_to_vts.push_back(std::move(faces_vts));
-      }
+      if (!priv::read_index_lists(ts, lines_to_read, faces_to_vts, 0))
+         return ts.record_error("Faces->Vertices");
 
       /* Faces to cv data */
-      if (!expect(ifs, "Faces->Control")) return false;
-
-      if (!expect(ifs, "volumes")) return false;
+      if (!ts.expect("Faces->Control")) return false;
 
-      ifs >> lines_to_read;
+      if (!ts.expect("volumes") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
-         size_t num, id;
-         ifs >> num >> id;
-         m_boundary_edges.push_back({num, id});
-      }
+      m_boundary_edges.resize(lines_to_read);
 
-      /* Edges data */
-      if (!expect(ifs, "Edges")) return false;
+      auto read_control = [&](size_t i, const char *str, char **endptr) {
+         *endptr = const_cast<char *>(str);
+         return priv::read_value(endptr, m_boundary_edges[i][0]) and
+                priv::read_value(endptr, m_boundary_edges[i][1]);
+      };
+
+      if (!ts.records(lines_to_read, read_control)) return ts.record_error("Faces->Control volumes");
 
-      ifs >> lines_to_read;
+      /* Edges data */
+      if (!ts.expect("Edges") or !ts.read(lines_to_read)) return false;
 
       if (this->verbose())
          std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-      for (size_t i = 0; i < lines_to_read; i++) {
+      m_edges.resize(lines_to_read);
+
+      auto read_edge = [&](size_t i, const char *str, char **endptr) {
          size_t v1, v2;
-         ifs >> v1 >> v2;
+         *endptr = const_cast<char *>(str);
+         if (!priv::read_value(endptr, v1) or !priv::read_value(endptr, v2)) return false;
 
          if (v1 > v2) std::swap(v1, v2);
 
-         auto e = edge_type({typename node_type::id_type(v1), typename node_type::id_type(v2)});
+         auto e = edge_type({typename node_type::id_type(to_ident_raw(v1)), typename node_type::id_type(to_ident_raw(v2))});
 
-         m_edges.push_back(std::make_pair(i, e));
-      }
+         m_edges[i] = std::make_pair(i, e);
+         return true;
+      };
+
+      if (!ts.records(lines_to_read, read_edge)) return ts.record_error("Edges");
 
       return true;
    }
@@ -1775,6 +1719,22 @@ class medit_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
 
    bool
    populate_mesh(mesh_type& msh)
+   {
+      return populate(msh);
+   }
+
+   /* The faces and the volumes are copied directly in the contiguous arrays
+    * of the flat storage, no generic_mesh is built in between */
+   bool
+   populate_mesh(flat_generic_mesh<T, 3>& msh)
+   {
+      return populate(msh);
+   }
+
+ private:
+   template<typename Mesh>
+   bool
+   populate(Mesh& msh)
    {
       auto storage = msh.backend_storage();
 
@@ -1785,7 +1745,7 @@ class medit_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
                            const std::pair<size_t, edge_type>& e2) {
          return e1.second < e2.second;
       };
-      std::sort(m_edges.begin(), m_edges.end(), comp_edges);
+      priv::parallel_sort(m_edges.begin(), m_edges.end(), comp_edges);
 
       std::vector<edge_type> edges;
       edges.reserve(m_edges.size());
@@ -1806,19 +1766,17 @@ class medit_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
                           const std::pair<size_t, std::vector<size_t>>& e2) {
          return e1.second < e2.second;
       };
-      std::sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
+      priv::parallel_sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
 
-      std::vector<surface_type> faces;
-      faces.reserve(faces_to_edges.size());
       conv_table.resize(faces_to_edges.size());
-
-      for (size_t i = 0; i < faces_to_edges.size(); i++) {
-         auto         fe = faces_to_edges[i];
-         surface_type s(convert_to<typename edge_type::id_type>(fe.second));
-         s.set_point_ids(convert_to<disk::point_identifier<3>>(faces_to_vts.at(fe.first)));
-         faces.push_back(s);
-         conv_table[fe.first] = i;
-      }
+      for (size_t i = 0; i < faces_to_edges.size(); i++)
+         conv_table[faces_to_edges[i].first] = i;
+
+      priv::store_surfaces(
+        *storage,
+        faces_to_edges.size(),
+        [&](size_t i) -> const auto& { return faces_to_edges[i].second; },
+        [&](size_t i) -> const auto& { return faces_to_vts.at(faces_to_edges[i].first); });
       /* Now the faces are in their place and have correct ptrs */
 
       /* Convert the face pointers in the volume data */
@@ -1828,23 +1786,17 @@ class medit_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
       }
 
       /* Sort volume data */
-      std::sort(vol_to_faces.begin(), vol_to_faces.end(), comp_vecs);
-
-      std::vector<volume_type> volumes;
-      volumes.reserve(vol_to_faces.size());
+      priv::parallel_sort(vol_to_faces.begin(), vol_to_faces.end(), comp_vecs);
 
-      for (size_t i = 0; i < vol_to_faces.size(); i++) {
-         auto        vf = vol_to_faces[i];
-         volume_type v(convert_to<typename surface_type::id_type>(vf.second));
-         v.set_point_ids(convert_to<disk::point_identifier<3>>(vol_to_vts.at(vf.first)));
-         volumes.push_back(v);
-      }
+      priv::store_volumes(
+        *storage,
+        vol_to_faces.size(),
+        [&](size_t i) -> const auto& { return vol_to_faces[i].second; },
+        [&](size_t i) -> const auto& { return vol_to_vts.at(vol_to_faces[i].first); });
 
       storage->points   = std::move(m_points);
       storage->nodes    = std::move(m_nodes);
       storage->edges    = std::move(edges);
-      storage->surfaces = std::move(faces);
-      storage->volumes  = std::move(volumes);
 
       storage->boundary_info.resize(storage->surfaces.size());
       for (size_t i = 0; i < m_boundary_edges.size(); i++) {
@@ -1864,94 +1816,62 @@ class poly_mesh_loader
 
 namespace poly{
 
-
-std::pair<size_t, std::vector<size_t>>
-read_cell_line(std::ifstream& ifs)
+/* The sections of the poly files are read with text_scanner::records(), so
+ * they are parsed in parallel (see parallel_parse_records()). A cell record
+ * is the id of the cell followed by the count and the list of its
+ * subelements, a group record is the name of the group followed by a cell
+ * record. */
+inline bool
+read_cell_record(char **ptr, std::pair<size_t, std::vector<size_t>>& cell)
 {
-    std::vector<size_t> elem;
-    size_t              cell_id, nb_elem;
-
-    ifs >> cell_id;
-    ifs >> nb_elem;
-    // std::cout << cell_id << ", " << nb_elem << std::endl;
-    elem.reserve(nb_elem);
-    for (size_t j = 0; j < nb_elem; j++)
-    {
-        size_t tmp;
-        ifs >> tmp;
-        elem.push_back(tmp);
-    }
-
-    return std::make_pair(cell_id, elem);
+    return priv::read_value(ptr, cell.first) and priv::read_index_list(ptr, cell.second, 0);
 }
 
-bool
-read_cell_block(std::ifstream& ifs, const size_t nb_cells, std::vector<std::pair<size_t, std::vector<size_t>>>& cells)
+inline bool
+read_cell_block(priv::text_scanner& ts, const size_t nb_cells, std::vector<std::pair<size_t, std::vector<size_t>>>& cells)
 {
-    cells.clear();
-    cells.reserve(nb_cells);
+    cells.resize(nb_cells);
 
-    for (size_t i = 0; i < nb_cells; i++)
-        cells.push_back(read_cell_line(ifs));
+    auto read_cell = [&](size_t i, const char *str, char **endptr) {
+        *endptr = const_cast<char *>(str);
+        return read_cell_record(endptr, cells[i]);
+    };
 
-    return true;
+    return ts.records(nb_cells, read_cell);
 }
 
 template<typename T>
 bool
-read_nodes_block(std::ifstream& ifs, const size_t nb_nodes, std::vector<std::pair<size_t, std::array<T, 3>>>& nodes)
+read_nodes_block(priv::text_scanner& ts, const size_t nb_nodes, std::vector<std::pair<size_t, std::array<T, 3>>>& nodes)
 {
-    nodes.clear();
-    nodes.reserve(nb_nodes);
-
-    size_t node_id;
-    std::array<T, 3> coor;
+    nodes.resize(nb_nodes);
 
-    for (size_t i = 0; i < nb_nodes; i++)
-    {
-        ifs >> node_id;
-        for (size_t j = 0; j < 3; j++)
-        {
-            ifs >> coor[j];
-        }
-        nodes.push_back(std::make_pair(node_id, coor));
-    }
+    auto read_node = [&](size_t i, const char *str, char **endptr) {
+        auto& [node_id, coor] = nodes[i];
+        *endptr = const_cast<char *>(str);
+        return priv::read_value(endptr, node_id) and priv::read_value(endptr, coor[0]) and
+               priv::read_value(endptr, coor[1]) and priv::read_value(endptr, coor[2]);
+    };
 
-    return true;
+    return ts.records(nb_nodes, read_node);
 }
 
-std::pair<size_t, std::vector<size_t>>
-read_grp_line(std::ifstream& ifs)
+inline bool
+read_grp_block(priv::text_scanner& ts, const size_t nb_grp, std::vector<std::pair<size_t, std::vector<size_t>>>& grps)
 {
-    std::vector<size_t> elem;
-    std::string         name;
-    size_t              cell_id, nb_elem;
-
-    ifs >> name;
-    ifs >> cell_id;
-    ifs >> nb_elem;
-    // std::cout << cell_id << ", " << nb_elem << std::endl;
-    elem.reserve(nb_elem);
-    for (size_t j = 0; j < nb_elem; j++)
-    {
-        size_t tmp;
-        ifs >> tmp;
-        elem.push_back(tmp);
-    }
-
-    return std::make_pair(cell_id, elem);
-}
+    grps.resize(nb_grp);
 
-bool
-read_grp_block(std::ifstream& ifs, const size_t nb_grp, std::vector<std::pair<size_t, std::vector<size_t>>>& grps)
-{
-    grps.clear();
-    grps.reserve(nb_grp);
+    auto read_grp = [&](size_t i, const char *str, char **endptr) {
+        /* Skip the name of the group */
+        auto ptr = priv::skip_whitespace(str, ts.end());
+        while (ptr < ts.end() and not std::isspace(static_cast<unsigned char>(*ptr)))
+            ptr++;
 
-    for (size_t i = 0; i < nb_grp; i++)
-        grps.push_back(read_grp_line(ifs));
+        *endptr = const_cast<char *>(ptr);
+        return ptr < ts.end() and read_cell_record(endptr, grps[i]);
+    };
 
-    return true;
+    return ts.records(nb_grp, read_grp);
 }
 }
 
@@ -1979,18 +1899,20 @@ class poly_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
     bool
     poly2d_read(const std::string& filename)
     {
-        std::ifstream ifs(filename);
-        std::string   keyword;
-        size_t        dim, version, nb_elems;
+        mapped_file mf(filename);
+        std::string keyword;
+        size_t      dim = 0, version = 0, nb_elems = 0;
 
 
-        if (!ifs.is_open())
+        if (!mf.is_open())
         {
             std::cout << "Error opening " << filename << std::endl;
             return false;
         }
 
-        ifs >> keyword;
+        priv::text_scanner ts(mf.mem(), mf.mem() + mf.size());
+
+        keyword = ts.word();
         if (keyword != "**BeginMesh")
         {
             std::cout << "Expected keyword \"**BeginMesh\"" << std::endl;
@@ -1999,10 +1921,10 @@ class poly_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
 
         while (keyword != "**EndMesh")
         {
-            ifs >> keyword;
+            keyword = ts.word();
             if (keyword == "*Dimension")
             {
-                ifs >> dim;
+                ts.read(dim);
                 if (this->verbose())
                     std::cout << "2D-Mesh" << std::endl;
                 if (dim != 2)
@@ -2013,65 +1935,79 @@ class poly_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
             }
             else if (keyword == "*Version")
             {
-                ifs >> version;
+                ts.read(version);
                 if (this->verbose())
                     std::cout << "Mesh Version: " << version << std::endl;
             }
             else if (keyword == "*Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " nodes" << std::endl;
 
-                poly::read_nodes_block(ifs, nb_elems, vts);
+                if (!poly::read_nodes_block(ts, nb_elems, vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Nodes->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " nodes->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, vts_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, vts_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Edges->Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " edges->nodes" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, edges_to_vts);
+                if (!poly::read_cell_block(ts, nb_elems, edges_to_vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Edges->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " edges->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, edges_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, edges_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->nodes" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, faces_to_vts);
+                if (!poly::read_cell_block(ts, nb_elems, faces_to_vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Edges")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->edges" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, faces_to_edges);
+                if (!poly::read_cell_block(ts, nb_elems, faces_to_edges))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, faces_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, faces_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "**EndMesh")
             {
@@ -2113,7 +2049,7 @@ class poly_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
         for (auto& [id, coor] : vts)
         {
             m_points.push_back(point_type({coor[0], coor[1]}));
-            m_nodes.push_back(node_type(disk::point_identifier<2>(id)));
+            m_nodes.push_back(node_type(disk::point_identifier<2>(to_ident_raw(id))));
         }
 
         // create edges
@@ -2125,7 +2061,7 @@ class poly_mesh_loader<T, 2> : public mesh_loader<generic_mesh<T, 2>>
             if (v1 > v2)
                 std::swap(v1, v2);
 
-            auto e = edge_type({typename node_type::id_type(v1), typename node_type::id_type(v2)});
+            auto e = edge_type({typename node_type::id_type(to_ident_raw(v1)), typename node_type::id_type(to_ident_raw(v2))});
 
             m_edges.push_back(std::make_pair(id, e));
         }
@@ -2226,17 +2162,19 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
     bool
     poly3d_read(const std::string& filename)
     {
-        std::ifstream ifs(filename);
-        std::string   keyword;
-        size_t        dim, version, nb_elems;
+        mapped_file mf(filename);
+        std::string keyword;
+        size_t      dim = 0, version = 0, nb_elems = 0;
 
-        if (!ifs.is_open())
+        if (!mf.is_open())
         {
             std::cout << "Error opening " << filename << std::endl;
             return false;
         }
 
-        ifs >> keyword;
+        priv::text_scanner ts(mf.mem(), mf.mem() + mf.size());
+
+        keyword = ts.word();
         if (keyword != "**BeginMesh")
         {
             std::cout << "Expected keyword \"**BeginMesh\"" << std::endl;
@@ -2245,10 +2183,10 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
 
         while (keyword != "**EndMesh")
         {
-            ifs >> keyword;
+            keyword = ts.word();
             if (keyword == "*Dimension")
             {
-                ifs >> dim;
+                ts.read(dim);
                 if (this->verbose())
                     std::cout << "3D-Mesh" << std::endl;
                 if (dim != 3)
@@ -2259,97 +2197,119 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
             }
             else if (keyword == "*Version")
             {
-                ifs >> version;
+                ts.read(version);
                 if (this->verbose())
                     std::cout << "Mesh Version: " << version << std::endl;
             }
             else if (keyword == "*Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " nodes" << std::endl;
 
-                poly::read_nodes_block(ifs, nb_elems, vts);
+                if (!poly::read_nodes_block(ts, nb_elems, vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Nodes->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " nodes->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, vts_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, vts_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Edges->Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " edges->nodes" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, edges_to_vts);
+                if (!poly::read_cell_block(ts, nb_elems, edges_to_vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Edges->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " edges->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, edges_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, edges_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->nodes" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, faces_to_vts);
+                if (!poly::read_cell_block(ts, nb_elems, faces_to_vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Edges")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->edges" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, faces_to_edges);
+                if (!poly::read_cell_block(ts, nb_elems, faces_to_edges))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Faces->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " faces->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, faces_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, faces_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Volumes->Nodes")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " volumes->nodes" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, vols_to_vts);
+                if (!poly::read_cell_block(ts, nb_elems, vols_to_vts))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Volumes->Edges")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " volumes->edges" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, vols_to_edges);
+                if (!poly::read_cell_block(ts, nb_elems, vols_to_edges))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Volumes->Faces")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " volumes->faces" << std::endl;
 
-                poly::read_cell_block(ifs, nb_elems, vols_to_faces);
+                if (!poly::read_cell_block(ts, nb_elems, vols_to_faces))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "*Volumes->Groups")
             {
-                ifs >> nb_elems;
+                if (!ts.read(nb_elems))
+                    return false;
                 if (this->verbose())
                     std::cout << "Reading " << nb_elems << " volumes->groups" << std::endl;
 
-                poly::read_grp_block(ifs, nb_elems, vols_to_grp);
+                if (!poly::read_grp_block(ts, nb_elems, vols_to_grp))
+                    return ts.record_error(keyword);
             }
             else if (keyword == "**EndMesh")
             {
@@ -2391,7 +2351,7 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
         for (auto& [id, coor] : vts)
         {
             m_points.push_back(point_type({coor[0], coor[1], coor[2]}));
-            m_nodes.push_back(node_type(disk::point_identifier<3>(id)));
+            m_nodes.push_back(node_type(disk::point_identifier<3>(to_ident_raw(id))));
         }
 
         // create edges
@@ -2403,7 +2363,7 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
             if (v1 > v2)
                 std::swap(v1, v2);
 
-            auto e = edge_type({typename node_type::id_type(v1), typename node_type::id_type(v2)});
+            auto e = edge_type({typename node_type::id_type(to_ident_raw(v1)), typename node_type::id_type(to_ident_raw(v2))});
 
             m_edges.push_back(std::make_pair(id, e));
         }
@@ -2415,7 +2375,7 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
         {
             return e1.second < e2.second;
         };
-        std::sort(m_edges.begin(), m_edges.end(), comp_edges);
+        priv::parallel_sort(m_edges.begin(), m_edges.end(), comp_edges);
 
         std::vector<edge_type> edges;
         edges.reserve(m_edges.size());
@@ -2437,20 +2397,18 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
         auto comp_vecs = [](const std::pair<size_t, std::vector<size_t>>& e1,
                             const std::pair<size_t, std::vector<size_t>>& e2)
                             { return e1.second < e2.second; };
-        std::sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
+        priv::parallel_sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
 
-        std::vector<surface_type> faces;
-        faces.reserve(faces_to_edges.size());
+        std::vector<surface_type> faces(faces_to_edges.size());
         conv_table.resize(faces_to_edges.size());
 
-        for (size_t i = 0; i < faces_to_edges.size(); i++)
-        {
-            auto         fe = faces_to_edges.at(i);
+        parallel_for(0, faces_to_edges.size(), [&](size_t i, size_t) {
+            auto&        fe = faces_to_edges.at(i);
             surface_type s(convert_to<typename edge_type::id_type>(fe.second));
             s.set_point_ids(convert_to<disk::point_identifier<3>>(faces_to_vts.at(fe.first).second));
-            faces.push_back(s);
-            conv_table[fe.first] = i;
-        }
+            faces[i] = std::move(s);
+            conv_table.at(fe.first) = i;
+        });
         /* Now the faces are in their place and have correct ptrs */
 
         /* Detect which ones are boundary edges */
@@ -2472,18 +2430,16 @@ class poly_mesh_loader<T, 3> : public mesh_loader<generic_mesh<T, 3>>
         }
 
         /* Sort volume data */
-        std::sort(vols_to_faces.begin(), vols_to_faces.end(), comp_vecs);
+        priv::parallel_sort(vols_to_faces.begin(), vols_to_faces.end(), comp_vecs);
 
-        std::vector<volume_type> volumes;
-        volumes.reserve(vols_to_faces.size());
+        std::vector<volume_type> volumes(vols_to_faces.size());
 
-        for (size_t i = 0; i < vols_to_faces.size(); i++)
-        {
-            auto        vf = vols_to_faces[i];
+        parallel_for(0, vols_to_faces.size(), [&](size_t i, size_t) {
+            auto&       vf = vols_to_faces[i];
             volume_type v(convert_to<typename surface_type::id_type>(vf.second));
             v.set_point_ids(convert_to<disk::point_identifier<3>>(vols_to_vts.at(vf.first).second));
-            volumes.push_back(v);
-        }
+            volumes[i] = std::move(v);
+        });
 
         storage->points   = std::move(m_points);
         storage->nodes    = std::move(m_nodes);
@@ -2665,11 +2621,21 @@ load_mesh(const char *filename, LT& loader, MT& msh)
         std::cout << "the required mesh type" << std::endl;
     }
 
+    /* The cache is written after the first successful read of the file
+     * and used by the following ones, see mesh_cache.hpp */
+    if ( mesh_cache_enabled() and load_mesh_cache(filename, msh) )
+        return true;
+
     bool success = loader.read_mesh(filename);
     if (!success)
         return false;
 
     loader.populate_mesh(msh);
+    msh.reset_lookup_tables();
+
+    if ( mesh_cache_enabled() )
+        save_mesh_cache(filename, msh);
+
     return true;
 }
 
@@ -2723,6 +2689,24 @@ load_mesh_fvca6_3d(const char *filename, disk::generic_mesh<T, 3>& msh)
     return priv::load_mesh(filename, loader, msh);
 }
 
+/* The FVCA5, FVCA6 and medit loaders also fill the meshes with flat
+ * connectivity, without building a generic_mesh first */
+template<typename T>
+bool
+load_mesh_fvca5_2d(const char* filename, disk::flat_generic_mesh<T, 2>& msh)
+{
+    disk::fvca5_mesh_loader<T, 2> loader;
+    return priv::load_mesh(filename, loader, msh);
+}
+
+template<typename T>
+bool
+load_mesh_fvca6_3d(const char *filename, disk::flat_generic_mesh<T, 3>& msh)
+{
+    disk::fvca6_mesh_loader<T, 3> loader;
+    return priv::load_mesh(filename, loader, msh);
+}
+
 template<typename T>
 bool
 load_mesh_poly2d(const char* filename, disk::generic_mesh<T, 2>& msh, bool verbose = false)
@@ -2758,6 +2742,22 @@ load_mesh_medit(const char *filename, disk::generic_mesh<T, 3>& msh)
     return priv::load_mesh(filename, loader, msh);
 }
 
+template<typename T>
+bool
+load_mesh_medit(const char *filename, disk::flat_generic_mesh<T, 2>& msh)
+{
+    disk::medit_mesh_loader<T, 2> loader;
+    return priv::load_mesh(filename, loader, msh);
+}
+
+template<typename T>
+bool
+load_mesh_medit(const char *filename, disk::flat_generic_mesh<T, 3>& msh)
+{
+    disk::medit_mesh_loader<T, 3> loader;
+    return priv::load_mesh(filename, loader, msh);
+}
+
 } // namespace disk
 
 
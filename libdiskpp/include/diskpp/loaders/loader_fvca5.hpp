@@ -66,301 +66,293 @@ class fvca5_mesh_loader<T,2> : public mesh_loader<generic_mesh<T, 2>>
         }
     };
 
-    std::ifstream   ifs;
-    size_t          current_line;
-
     std::vector<point_type>                     m_points;
     std::vector<fvca5_poly>                     m_polys;
     std::vector<std::array<ident_raw_t, 2>>     m_boundary_edges;
     std::vector<std::array<ident_raw_t, 4>>     m_edges;
 
-    bool
-    get_next_line(std::istringstream& iss)
+    /* The file is read line by line: the values after the ones expected
+     * in a line are ignored, apart from the JMLC extensions */
+    static char *
+    end_of_line(char *ptr, const char *end)
     {
-        std::string line;
-        getline(ifs, line);
-        iss = std::istringstream(line);
-        current_line++;
-        return true;
+        auto nl = static_cast<const char *>(std::memchr(ptr, '\n', end - ptr));
+        return const_cast<char *>(nl ? nl : end);
     }
-    
-    bool
-    get_next_line(std::string& line)
+
+    /* JMLC extension: optional number at the end of a line */
+    static bool
+    optional_value(char **ptr, const char *end, size_t& val)
     {
-        getline(ifs, line);
-        current_line++;
-        return true;
+        while (*ptr < end and (**ptr == ' ' or **ptr == '\t' or **ptr == '\r'))
+            (*ptr)++;
+
+        if ( *ptr == end or not std::isdigit(static_cast<unsigned char>(**ptr)) )
+            return false;
+
+        return priv::read_value(ptr, val);
     }
 
-    bool failure(std::istringstream& ifs)
+    /* Read the number of entries of a block, alone on its line */
+    bool fvca5_parse_count(priv::text_scanner& ts, size_t& count, const std::string& what)
     {
-        return ifs.rdstate() & std::ifstream::failbit;
+        if ( not ts.read(count) ) {
+            std::cout << "Line " << ts.line_number() << ": Error while parsing ";
+            std::cout << what << std::endl;
+            return false;
+        }
+        ts.line();
+        return true;
     }
-    
-    bool fvca5_parse_vertices()
+
+    bool fvca5_parse_vertices(priv::text_scanner& ts, const char *end)
     {
-        std::istringstream iss;
-        get_next_line(iss);
-        
         size_t num_vertices;
-        iss >> num_vertices;
-        if ( failure(iss) ) {
-            std::cout << "Line " << current_line << ": Error while parsing ";
-            std::cout << "'vertices' block (number of vertices)" << std::endl;
+        if ( not fvca5_parse_count(ts, num_vertices, "'vertices' block (number of vertices)") )
             return false;
-        }
         
         if (this->verbose())
             std::cout << "Reading " << num_vertices << " vertices" << std::endl;
-        
-        for (size_t i = 0; i < num_vertices; i++) {
-            get_next_line(iss);
-            T x, y;
-            iss >> x >> y;
-            if ( failure(iss) ) {
-                std::cout << "Line " << current_line << ": Error while parsing ";
-                std::cout << "'vertices' block (vertex " << i << ")" << std::endl;
-                return false;
-            }
-            
-            m_points.push_back(point_type{x,y});
+
+        m_points.resize(num_vertices);
+
+        auto read_vertex = [&](size_t i, const char *str, char **endptr) {
+            T x = 0, y = 0;
+            char *ptr = const_cast<char *>(str);
+            bool success = priv::read_value(&ptr, x) and priv::read_value(&ptr, y);
+            *endptr = end_of_line(ptr, end);
+            m_points[i] = point_type{x,y};
+            return success;
+        };
+
+        if ( not ts.records(num_vertices, read_vertex) ) {
+            std::cout << "Line " << ts.record_line_number(ts.failed_record());
+            std::cout << ": Error while parsing 'vertices' block (vertex ";
+            std::cout << ts.failed_record() << ")" << std::endl;
+            return false;
         }
         
         return true;
     }
 
-    bool fvca5_parse_polygons(size_t polynum)
+    bool fvca5_parse_polygons(priv::text_scanner& ts, const char *end, size_t polynum)
     {
-        std::istringstream iss;
-        get_next_line(iss);
-        
         size_t num_polygons;
-
-        iss >> num_polygons;
-        if ( failure(iss) ) {
-            std::cout << "Line " << current_line << ": Error while parsing ";
-            std::cout << "'" << polynum << "-angles' block (number of polygons)";
-            std::cout << std::endl;
+        if ( not fvca5_parse_count(ts, num_polygons, "'" + std::to_string(polynum) +
+                                   "-angles' block (number of polygons)") )
             return false;
-        }
         
         if (this->verbose())
             std::cout << "Reading " << num_polygons << " " << polynum << "-angles" << std::endl;
 
-        for (size_t i = 0; i < num_polygons; i++)
-        {
-            get_next_line(iss);
-            
+        const size_t polys_ofs = m_polys.size();
+        m_polys.resize(polys_ofs + num_polygons);
+
+        auto read_polygon = [&](size_t i, const char *str, char **endptr) {
             fvca5_poly p;
+            char *ptr = const_cast<char *>(str);
 
             for (size_t j = 0; j < polynum; j++)
             {
-                ident_raw_t val;
-                iss >> val;
+                size_t val;
+                if ( not priv::read_value(&ptr, val) ) {
+                    *endptr = end_of_line(ptr, end);
+                    return false;
+                }
                 p.nodes.push_back(val-1);
             }
-            
-            if ( failure(iss) ) {
-                std::cout << "Line " << current_line << ": Error while parsing '";
-                std::cout << polynum << "-angles' block (polygon ";
-                std::cout << i << ")" << std::endl;
-                return false;
-            }
 
             // JMLC extension
-            iss >> std::ws;
-            if ( std::isdigit(iss.peek()) )
-            {
-                std::cout << "d_id" << std::endl;
-                iss >> p.domain_id;
-            }
+            optional_value(&ptr, end, p.domain_id);
 
-            m_polys.push_back(p);
+            *endptr = end_of_line(ptr, end);
+            m_polys[polys_ofs + i] = std::move(p);
+            return true;
+        };
+
+        if ( not ts.records(num_polygons, read_polygon) ) {
+            std::cout << "Line " << ts.record_line_number(ts.failed_record());
+            std::cout << ": Error while parsing '" << polynum << "-angles' block (polygon ";
+            std::cout << ts.failed_record() << ")" << std::endl;
+            return false;
         }
 
         return true;
     }
 
-    bool fvca5_parse_boundary_edges()
+    /* Check the nodes of the i-th edge of the last block read by ts and
+     * make them zero-based */
+    bool fvca5_check_edge(priv::text_scanner& ts, size_t i, ident_raw_t& node_a, ident_raw_t& node_b)
     {
-        std::istringstream iss;
-        get_next_line(iss);
-        
-        size_t num_edges;
+        if (node_a < 1 or node_b < 1) {
+            std::cout << "Line " << ts.record_line_number(i) << ": FVCA5 format ";
+            std::cout << "expects 1-based indices" << std::endl;
+            return false;
+        }
 
-        iss >> num_edges;
-        if ( failure(iss) ) {
-            std::cout << "Line " << current_line << ": Error while parsing ";
-            std::cout << "'edges of the boundary' block (number of edges)";
-            std::cout << std::endl;
+        node_a -= 1;
+        node_b -= 1;
+
+        if (node_a == node_b) {
+            std::cout << "Line " << ts.record_line_number(i) << ": Edge starting and ";
+            std::cout << "finishing on the same node" << std::endl;
             return false;
         }
+
+        if (node_a > node_b)
+            std::swap(node_a, node_b);
+
+        return true;
+    }
+
+    bool fvca5_parse_boundary_edges(priv::text_scanner& ts, const char *end)
+    {
+        size_t num_edges;
+        if ( not fvca5_parse_count(ts, num_edges, "'edges of the boundary' block (number of edges)") )
+            return false;
         
         if (this->verbose())
             std::cout << "Reading " << num_edges << " boundary edges" << std::endl;
 
-        m_boundary_edges.reserve(num_edges);
+        const size_t edges_ofs = m_boundary_edges.size();
+        m_boundary_edges.resize(edges_ofs + num_edges);
+
+        auto read_edge = [&](size_t i, const char *str, char **endptr) {
+            size_t node_a, node_b;
+            char *ptr = const_cast<char *>(str);
+            bool success = priv::read_value(&ptr, node_a) and priv::read_value(&ptr, node_b);
+            *endptr = end_of_line(ptr, end);
+            if (success)
+                m_boundary_edges[edges_ofs + i] = {to_ident_raw(node_a), to_ident_raw(node_b)};
+            return success;
+        };
+
+        if ( not ts.records(num_edges, read_edge) ) {
+            std::cout << "Line " << ts.record_line_number(ts.failed_record());
+            std::cout << ": Error while parsing 'edges of the boundary' block (edge ";
+            std::cout << ts.failed_record() << ")" << std::endl;
+            return false;
+        }
 
         for (size_t i = 0; i < num_edges; i++)
         {
-            get_next_line(iss);
-            ident_raw_t node_a, node_b;
-            iss >> node_a >> node_b;
-            
-            if ( failure(iss) ) {
-                std::cout << "Line " << current_line << ": Error while parsing ";
-                std::cout << "'edges of the boundary' block (edge " << i << ")";
-                std::cout << std::endl;
-                return false;
-            }
-            
-            if (node_a < 1 or node_b < 1) {
-                std::cout << "Line " << current_line << ": FVCA5 format ";
-                std::cout << "expects 1-based indices" << std::endl;
+            auto& e = m_boundary_edges[edges_ofs + i];
+            if ( not fvca5_check_edge(ts, i, e[0], e[1]) )
                 return false;
-            }
-            
-            node_a -= 1;
-            node_b -= 1;
-            
-            if (node_a == node_b) {
-                std::cout << "Line " << current_line << ": Edge starting and ";
-                std::cout << "finishing on the same node" << std::endl;
-                return false;
-            }
-            
-            if (node_a > node_b)
-                std::swap(node_a, node_b);
-            
-            m_boundary_edges.push_back({node_a, node_b});
         }
         
         return true;
     }
 
-    bool fvca5_parse_all_edges()
+    bool fvca5_parse_all_edges(priv::text_scanner& ts, const char *end)
     {
-        std::istringstream iss;
-        get_next_line(iss);
-        
         size_t num_edges;
-
-        iss >> num_edges;
-        if ( failure(iss) ) {
-            std::cout << "Line " << current_line << ": Error while parsing ";
-            std::cout << "'all edges' block (number of edges)";
-            std::cout << std::endl;
+        if ( not fvca5_parse_count(ts, num_edges, "'all edges' block (number of edges)") )
             return false;
-        }
         
         if (this->verbose())
             std::cout << "Reading " << num_edges << " edges" << std::endl;
 
+        const size_t edges_ofs = m_edges.size();
+        m_edges.resize(edges_ofs + num_edges);
+
+        auto read_edge = [&](size_t i, const char *str, char **endptr) {
+            size_t node_a, node_b, neigh_a, neigh_b;
+            char *ptr = const_cast<char *>(str);
+            bool success = priv::read_value(&ptr, node_a) and priv::read_value(&ptr, node_b) and
+                           priv::read_value(&ptr, neigh_a) and priv::read_value(&ptr, neigh_b);
+
+            // JMLC extension: boundary id, not used
+            size_t b_id;
+            optional_value(&ptr, end, b_id);
+
+            *endptr = end_of_line(ptr, end);
+            if (success)
+                m_edges[edges_ofs + i] = {to_ident_raw(node_a), to_ident_raw(node_b),
+                                          to_ident_raw(neigh_a), to_ident_raw(neigh_b)};
+            return success;
+        };
+
+        if ( not ts.records(num_edges, read_edge) ) {
+            std::cout << "Line " << ts.record_line_number(ts.failed_record());
+            std::cout << ": Error while parsing 'all edges' block (edge ";
+            std::cout << ts.failed_record() << ")" << std::endl;
+            return false;
+        }
+
         for (size_t i = 0; i < num_edges; i++)
         {
-            get_next_line(iss);
-            ident_raw_t node_a, node_b, neigh_a, neigh_b;
-
-            iss >> node_a >> node_b >> neigh_a >> neigh_b;
-            if ( failure(iss) ) {
-                std::cout << "Line " << current_line << ": Error while parsing ";
-                std::cout << "'all edges' block (edge " << i << ")";
-                std::cout << std::endl;
-                return false;
-            }
-            
-            if (node_a < 1 or node_b < 1) {
-                std::cout << "Line " << current_line << ": FVCA5 format ";
-                std::cout << "expects 1-based indices" << std::endl;
-                return false;
-            }
-            
-            node_a -= 1;
-            node_b -= 1;
-            
-            if (node_a == node_b) {
-                std::cout << "Line " << current_line << ": Edge starting and ";
-                std::cout << "finishing on the same node" << std::endl;
+            auto& [node_a, node_b, neigh_a, neigh_b] = m_edges[edges_ofs + i];
+            if ( not fvca5_check_edge(ts, i, node_a, node_b) )
                 return false;
-            }
-            
-            if (node_a > node_b)
-                std::swap(node_a, node_b);
-            
+
             if (neigh_a > 0)
                 m_polys.at(neigh_a-1).attached_edges.insert({node_a, node_b});
             
             if (neigh_b > 0)
                 m_polys.at(neigh_b-1).attached_edges.insert({node_a, node_b});
-            
-            // JMLC extension
-            iss >> std::ws;
-            if ( std::isdigit(iss.peek()) )
-            {
-                std::cout << "b_id" << std::endl;
-                //iss >> p.domain_id;
-            }
-            
-            m_edges.push_back({node_a, node_b, neigh_a, neigh_b});
         }
         
         return true;
     }
 
-    bool fvca5_parse_block()
+    bool fvca5_parse_block(priv::text_scanner& ts, const char *end)
     {
-        std::string line;
-        get_next_line(line);
+        const size_t line_number = ts.line_number();
+        std::string line = ts.line();
         
         if ( std::regex_match(line, std::regex("^\\s*$")) )
             return true;
         
         if ( std::regex_match(line, std::regex("^\\s*vertices\\s*$")) )
-            return fvca5_parse_vertices();
+            return fvca5_parse_vertices(ts, end);
         
         if ( std::regex_match(line, std::regex("^\\s*triangles\\s*$")) )
-            return fvca5_parse_polygons(3);
+            return fvca5_parse_polygons(ts, end, 3);
         
         if ( std::regex_match(line, std::regex("^\\s*quadrangles\\s*$")) )
-            return fvca5_parse_polygons(4);
+            return fvca5_parse_polygons(ts, end, 4);
         
         if ( std::regex_match(line, std::regex("^\\s*pentagons\\s*$")) )
-            return fvca5_parse_polygons(5);
+            return fvca5_parse_polygons(ts, end, 5);
         
         if ( std::regex_match(line, std::regex("^\\s*hexagons\\s*$")) )
-            return fvca5_parse_polygons(6);
+            return fvca5_parse_polygons(ts, end, 6);
         
         if ( std::regex_match(line, std::regex("^\\s*ennagons\\s*$")) )
-            return fvca5_parse_polygons(7);
+            return fvca5_parse_polygons(ts, end, 7);
         
         if ( std::regex_match(line, std::regex("^\\s*ettagons\\s*$")) )
-            return fvca5_parse_polygons(8);
+            return fvca5_parse_polygons(ts, end, 8);
         
         if ( std::regex_match(line, std::regex("^\\s*edges\\s+of\\s+the\\s+boundary\\s*$")) )
-            return fvca5_parse_boundary_edges();
+            return fvca5_parse_boundary_edges(ts, end);
         
         /* JMLC format extension */
         if ( std::regex_match(line, std::regex("^\\s*edges\\s+of\\s+transmission\\s*$")) )
-            return fvca5_parse_boundary_edges(); /* Yes, it is fvca5_parse_boundary_edges() */
+            return fvca5_parse_boundary_edges(ts, end); /* Yes, it is fvca5_parse_boundary_edges() */
         
         if ( std::regex_match(line, std::regex("^\\s*all\\s+edges\\s*$")) )
-            return fvca5_parse_all_edges();
+            return fvca5_parse_all_edges(ts, end);
         
-        std::cout << "Line " << current_line << ": Unknown block '";
+        std::cout << "Line " << line_number << ": Unknown block '";
         std::cout << line << "'" << std::endl;
         return false;
     }
 
     bool parse(const std::string& filename)
     {
-        ifs.open(filename);
-        if ( not ifs.is_open() ) {
+        mapped_file mf(filename);
+        if ( not mf.is_open() ) {
             std::cout << "Can't open " << filename << std::endl;
             return false;
         }
+
+        const char *end = mf.mem() + mf.size();
+        priv::text_scanner ts(mf.mem(), end);
         
-        while ( !ifs.eof() ) {
-            bool success = fvca5_parse_block();
+        while ( not ts.at_end() ) {
+            bool success = fvca5_parse_block(ts, end);
 
             if (not success) {
                 m_points.clear();
@@ -377,8 +369,7 @@ class fvca5_mesh_loader<T,2> : public mesh_loader<generic_mesh<T, 2>>
 public:
     static const char constexpr* expected_extension = "typ1";
 
-    fvca5_mesh_loader() : current_line(0)
-    {}
+    fvca5_mesh_loader() = default;
 
     bool
     read_mesh(const std::string& filename)
@@ -389,6 +380,20 @@ public:
     }
 
     bool populate_mesh(mesh_type& msh)
+    {
+        return populate(msh);
+    }
+
+    /* The polygons are copied directly in the contiguous arrays of the
+     * flat storage, no generic_mesh is built in between */
+    bool populate_mesh(flat_generic_mesh<T, 2>& msh)
+    {
+        return populate(msh);
+    }
+
+private:
+    template<typename Mesh>
+    bool populate(Mesh& msh)
     {
         if (this->verbose())
             std::cout << " *** POPULATING FVCA5 MESH ***" << std::endl;
@@ -401,7 +406,7 @@ public:
         /* Nodes */
         std::vector<node_type> nodes(nodes_size);
         for (size_t i = 0; i < nodes_size; i++)
-            nodes[i] = node_type(disk::point_identifier<2>(i));
+            nodes[i] = node_type(disk::point_identifier<2>(to_ident_raw(i)));
 
         storage->nodes = std::move(nodes);
 
@@ -449,15 +454,13 @@ public:
 
         storage->edges = std::move(edges);
 
-        /* Surfaces */
-        using sd_pair = std::pair<surface_type, size_t>;
-        std::vector< sd_pair > surfaces;
-        surfaces.reserve( m_polys.size() );
-
-        for (auto& p : m_polys)
+        /* Surfaces: the edges of all the polygons in a single array, then
+         * the polygons are stored in lexicographical order of their edges */
+        std::vector<size_t> poly_offsets(m_polys.size()+1, 0);
+        std::vector<size_t> poly_edges;
+        for (size_t i = 0; i < m_polys.size(); i++)
         {
-            std::vector<typename edge_type::id_type> surface_edges;
-            for (auto& e : p.attached_edges)
+            for (auto& e : m_polys[i].attached_edges)
             {
                 assert(e[0] < e[1]);
                 auto n1 = typename node_type::id_type(e[0]);
@@ -473,27 +476,31 @@ public:
                     return false;
                 }
 
-                surface_edges.push_back(edge_id.second);
+                poly_edges.push_back(edge_id.second);
             }
-            auto surface = surface_type(surface_edges);
-            surface.set_point_ids(p.nodes.begin(), p.nodes.end()); /* XXX: crap */
-            surfaces.push_back( std::make_pair(surface, p.domain_id) );
-            //storage->subdomain_info.push_back( subdomain_descriptor(p.domain_id) );
+            poly_offsets[i+1] = poly_edges.size();
         }
 
-        auto comp = [](const sd_pair& a, const sd_pair& b) -> bool {
-            return a.first < b.first;
+        auto edges_of = [&](size_t i) {
+            return std::span<const size_t>(poly_edges.data() + poly_offsets[i],
+                                           poly_offsets[i+1] - poly_offsets[i]);
         };
 
-        std::sort(surfaces.begin(), surfaces.end(), comp);
-
-        auto get_surf = [](const sd_pair& sdp) -> auto { return sdp.first; };
-        storage->surfaces.resize( surfaces.size() );
-        std::transform(surfaces.begin(), surfaces.end(), storage->surfaces.begin(), get_surf);
-
-        auto get_id = [](const sd_pair& sdp) -> auto { return subdomain_descriptor(sdp.second); };
-        storage->subdomain_info.resize( surfaces.size() );
-        std::transform(surfaces.begin(), surfaces.end(), storage->subdomain_info.begin(), get_id);
+        std::vector<size_t> order(m_polys.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            auto ea = edges_of(a);
+            auto eb = edges_of(b);
+            return std::lexicographical_compare(ea.begin(), ea.end(), eb.begin(), eb.end());
+        });
+
+        priv::store_surfaces(*storage, order.size(),
+            [&](size_t i) { return edges_of(order[i]); },
+            [&](size_t i) -> const auto& { return m_polys[order[i]].nodes; });
+
+        storage->subdomain_info.resize( order.size() );
+        for (size_t i = 0; i < order.size(); i++)
+            storage->subdomain_info[i] = subdomain_descriptor(m_polys[order[i]].domain_id);
 
         mark_internal_faces(msh);
 
@@ -38,24 +38,6 @@
  * DOI: 10.1016/j.cam.2017.09.017
  */
 
-std::vector<size_t>
-read_fvca6_line(std::ifstream& ifs)
-{
-    std::vector<size_t> ret;
-
-    size_t num_entries;
-    ifs >> num_entries;
-    for(size_t j = 0; j < num_entries; j++)
-    {
-        size_t temp;
-        ifs >> temp;
-        ret.push_back(temp-1); //convert indices to zero-based
-    }
-
-    return ret;
-}
-
-
 template<typename T, size_t N>
 class fvca6_mesh_loader
 {
@@ -81,143 +63,132 @@ class fvca6_mesh_loader<T,3> : public mesh_loader<generic_mesh<T, 3>>
     std::vector<std::pair<size_t, std::vector<size_t>>>     faces_to_edges;
     std::vector<std::vector<size_t>>                        faces_to_vts;
 
+    /* Read a section of lists of one-based indices, converted to
+     * zero-based indices */
+    template<typename Entry>
+    bool fvca6_read_lists(priv::text_scanner& ts, const std::string& keyword,
+                          std::vector<Entry>& lists)
+    {
+        size_t lines_to_read;
+
+        if ( !ts.expect(keyword) or !ts.read(lines_to_read) )
+            return false;
+
+        if (this->verbose())
+            std::cout << "About to read " << lines_to_read << " entries" << std::endl;
+
+        if ( !priv::read_index_lists(ts, lines_to_read, lists, 1) )
+            return ts.record_error(keyword);
+
+        return true;
+    }
+
     bool fvca6_read(const std::string& filename)
     {
-        std::ifstream   ifs(filename);
-        std::string     keyword;
+        mapped_file     mf(filename);
         size_t          lines_to_read;
 
-        if (!ifs.is_open())
+        if (!mf.is_open())
         {
             std::cout << "Error opening " << filename << std::endl;
             return false;
         }
 
+        priv::text_scanner ts(mf.mem(), mf.mem() + mf.size());
+
         /* Apparently the first 16 lines of the file are comments or
          * information repeated elsewhere: throw them away */
 
         for (size_t i = 0; i < 16; i++)
-            std::getline(ifs, keyword);
+            ts.line();
 
-        if ( !expect(ifs, "Vertices") )
+        if ( !ts.expect("Vertices") or !ts.read(lines_to_read) )
             return false;
 
-        ifs >> lines_to_read;
-
         if (this->verbose())
             std::cout << "About to read " << lines_to_read << " points" << std::endl;
 
-        m_points.reserve(lines_to_read);
-        m_nodes.reserve(lines_to_read);
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            T x, y, z;
-            ifs >> x >> y >> z;
-            m_points.push_back( point_type({x, y, z}) );
-            m_nodes.push_back( node_type( disk::point_identifier<3>(i) ) );
-        }
+        m_points.resize(lines_to_read);
+        m_nodes.resize(lines_to_read);
 
-        /* Volume to face data */
-        if ( !expect(ifs, "Volumes->faces") )
-            return false;
+        auto read_vertex = [&](size_t i, const char *str, char **endptr) {
+            T x = 0, y = 0, z = 0;
+            char *ptr = const_cast<char *>(str);
+            bool success = priv::read_value(&ptr, x) and priv::read_value(&ptr, y) and
+                           priv::read_value(&ptr, z);
+            *endptr = ptr;
 
-        ifs >> lines_to_read;
+            m_points[i] = point_type({x, y, z});
+            m_nodes[i] = node_type( disk::point_identifier<3>(to_ident_raw(i)) );
+            return success;
+        };
 
-        if (this->verbose())
-            std::cout << "About to read " << lines_to_read << " entries" << std::endl;
+        if ( !ts.records(lines_to_read, read_vertex) )
+            return ts.record_error("Vertices");
 
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            auto vol_faces = read_fvca6_line(ifs);
-            vol_to_faces.push_back( std::make_pair(i, std::move(vol_faces)) );
-        }
+        /* Volume to face data */
+        if ( !fvca6_read_lists(ts, "Volumes->faces", vol_to_faces) )
+            return false;
 
         /* Volume to vertices data */
-        if ( !expect(ifs, "Volumes->Verticess") )
+        if ( !fvca6_read_lists(ts, "Volumes->Verticess", vol_to_vts) )
             return false;
 
-        ifs >> lines_to_read;
-
-        if (this->verbose())
-            std::cout << "About to read " << lines_to_read << " entries" << std::endl;
-
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            auto vol_vts = read_fvca6_line(ifs);
-            vol_to_vts.push_back( std::move(vol_vts) );
-        }
-
         /* Faces to edges data */
-        if ( !expect(ifs, "Faces->Edgess") )
+        if ( !fvca6_read_lists(ts, "Faces->Edgess", faces_to_edges) )
             return false;
 
-        ifs >> lines_to_read;
-
-        if (this->verbose())
-            std::cout << "About to read " << lines_to_read << " entries" << std::endl;
-
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            auto faces_edges = read_fvca6_line(ifs);
-            faces_to_edges.push_back( std::make_pair(i, std::move(faces_edges)) );
-        }
-
         /* Faces to vertices data */
-        if ( !expect(ifs, "Faces->Vertices") )
+        if ( !fvca6_read_lists(ts, "Faces->Vertices", faces_to_vts) )
             return false;
 
-        ifs >> lines_to_read;
-
-        if (this->verbose())
-            std::cout << "About to read " << lines_to_read << " entries" << std::endl;
-
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            auto faces_vts = read_fvca6_line(ifs);
-            faces_to_vts.push_back( std::move(faces_vts) );
-        }
-
         /* Faces to cv data */
-        if ( !expect(ifs, "Faces->Control") )
+        if ( !ts.expect("Faces->Control") )
             return false;
 
-        if ( !expect(ifs, "volumes") )
+        if ( !ts.expect("volumes") or !ts.read(lines_to_read) )
             return false;
 
-        ifs >> lines_to_read;
-
         if (this->verbose())
             std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
-            int v1;
-            int v2;
-            ifs >> v1 >> v2;
-        }
+        /* Not used: just skip them */
+        auto read_control = [&](size_t, const char *str, char **endptr) {
+            size_t v1, v2;
+            *endptr = const_cast<char *>(str);
+            return priv::read_value(endptr, v1) and priv::read_value(endptr, v2);
+        };
+
+        if ( !ts.records(lines_to_read, read_control) )
+            return ts.record_error("Faces->Control volumes");
 
         /* Edges data */
-        if ( !expect(ifs, "Edges") )
+        if ( !ts.expect("Edges") or !ts.read(lines_to_read) )
             return false;
 
-        ifs >> lines_to_read;
-
         if (this->verbose())
             std::cout << "About to read " << lines_to_read << " entries" << std::endl;
 
-        for (size_t i = 0; i < lines_to_read; i++)
-        {
+        m_edges.resize(lines_to_read);
+
+        auto read_edge = [&](size_t i, const char *str, char **endptr) {
             size_t v1, v2;
-            ifs >> v1 >> v2;
+            *endptr = const_cast<char *>(str);
+            if ( !priv::read_value(endptr, v1) or !priv::read_value(endptr, v2) )
+                return false;
 
             if (v1 > v2)
                 std::swap(v1, v2);
 
-            auto e = edge_type({typename node_type::id_type(v1),
-                                typename node_type::id_type(v2)});
+            auto e = edge_type({typename node_type::id_type(to_ident_raw(v1)),
+                                typename node_type::id_type(to_ident_raw(v2))});
 
-            m_edges.push_back( std::make_pair(i, e) );
-        }
+            m_edges[i] = std::make_pair(i, e);
+            return true;
+        };
+
+        if ( !ts.records(lines_to_read, read_edge) )
+            return ts.record_error("Edges");
 
         return true;
     }
@@ -235,6 +206,20 @@ public:
     }
 
     bool populate_mesh(mesh_type& msh)
+    {
+        return populate(msh);
+    }
+
+    /* The faces and the volumes are copied directly in the contiguous arrays
+     * of the flat storage, no generic_mesh is built in between */
+    bool populate_mesh(flat_generic_mesh<T, 3>& msh)
+    {
+        return populate(msh);
+    }
+
+private:
+    template<typename Mesh>
+    bool populate(Mesh& msh)
     {
         auto storage = msh.backend_storage();
 
@@ -245,7 +230,7 @@ public:
                              const std::pair<size_t, edge_type>& e2) {
             return e1.second < e2.second;
         };
-        std::sort(m_edges.begin(), m_edges.end(), comp_edges);
+        priv::parallel_sort(m_edges.begin(), m_edges.end(), comp_edges);
 
         std::vector<edge_type> edges;
         edges.reserve( m_edges.size() );
@@ -268,20 +253,15 @@ public:
                             const std::pair<size_t, std::vector<size_t>>& e2) {
             return e1.second < e2.second;
         };
-        std::sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
+        priv::parallel_sort(faces_to_edges.begin(), faces_to_edges.end(), comp_vecs);
 
-        std::vector<surface_type> faces;
-        faces.reserve( faces_to_edges.size() );
         conv_table.resize( faces_to_edges.size() );
-
         for (size_t i = 0; i < faces_to_edges.size(); i++)
-        {
-            auto fe = faces_to_edges[i];
-            surface_type s( convert_to<typename edge_type::id_type>(fe.second) );
-            s.set_point_ids( convert_to<disk::point_identifier<3>>(faces_to_vts.at(fe.first)) );
-            faces.push_back(s);
-            conv_table[fe.first] = i;
-        }
+            conv_table[faces_to_edges[i].first] = i;
+
+        priv::store_surfaces(*storage, faces_to_edges.size(),
+            [&](size_t i) -> const auto& { return faces_to_edges[i].second; },
+            [&](size_t i) -> const auto& { return faces_to_vts.at(faces_to_edges[i].first); });
         /* Now the faces are in their place and have correct ptrs */
 
         /* Convert the face pointers in the volume data */
@@ -295,24 +275,15 @@ public:
         //    std::cout << f << std::endl;
 
         /* Sort volume data */
-        std::sort(vol_to_faces.begin(), vol_to_faces.end(), comp_vecs);
-
-        std::vector<volume_type> volumes;
-        volumes.reserve( vol_to_faces.size() );
+        priv::parallel_sort(vol_to_faces.begin(), vol_to_faces.end(), comp_vecs);
 
-        for (size_t i = 0; i < vol_to_faces.size(); i++)
-        {
-            auto vf = vol_to_faces[i];
-            volume_type v( convert_to<typename surface_type::id_type>(vf.second) );
-            v.set_point_ids( convert_to<disk::point_identifier<3>>(vol_to_vts.at(vf.first)) );
-            volumes.push_back(v);
-        }
+        priv::store_volumes(*storage, vol_to_faces.size(),
+            [&](size_t i) -> const auto& { return vol_to_faces[i].second; },
+            [&](size_t i) -> const auto& { return vol_to_vts.at(vol_to_faces[i].first); });
 
         storage->points     = std::move(m_points);
         storage->nodes      = std::move(m_nodes);
         storage->edges      = std::move(edges);
-        storage->surfaces   = std::move(faces);
-        storage->volumes    = std::move(volumes);
 
         std::vector<size_t> bf(storage->surfaces.size());
         for (auto& vol : storage->volumes)
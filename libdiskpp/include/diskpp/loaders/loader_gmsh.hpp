@@ -70,7 +70,7 @@ class gmsh_geometry_loader<simplicial_mesh<T,3>> : public mesh_loader<simplicial
         for (size_t i = 0; i < nodeTags.size(); i++)
         {
             node_tag2ofs.at( nodeTags[i] ) = i;
-            auto point_id = disk::point_identifier<3>( i );
+            auto point_id = disk::point_identifier<3>( to_ident_raw(i) );
             auto node = node_type( { point_id } );
             nodes.push_back(node);
         }
@@ -310,7 +310,7 @@ class gmsh_geometry_loader<simplicial_mesh<T,2>> : public mesh_loader<simplicial
         for (size_t i = 0; i < nodeTags.size(); i++)
         {
             node_tag2ofs.at( nodeTags[i] ) = i;
-            auto point_id = disk::point_identifier<2>( i );
+            auto point_id = disk::point_identifier<2>( to_ident_raw(i) );
             auto node = node_type( { point_id } );
             nodes.push_back(node);
         }
@@ -605,7 +605,7 @@ class gmsh_geometry_loader<generic_mesh<T,3>> : public mesh_loader<generic_mesh<
         for (size_t i = 0; i < nodeTags.size(); i++)
         {
             node_tag2ofs.at( nodeTags[i] ) = i;
-            auto point_id = disk::point_identifier<3>( i );
+            auto point_id = disk::point_identifier<3>( to_ident_raw(i) );
             auto node = node_type( { point_id } );
             nodes.push_back(node);
         }
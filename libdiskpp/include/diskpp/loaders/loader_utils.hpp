@@ -31,9 +31,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <ranges>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "diskpp/common/parallel.hpp"
+#include "strtot.hpp"
+
 namespace disk {
 
 
@@ -154,6 +164,385 @@ sort_uniq(std::vector<T>& v)
     v.erase(uniq_iter, v.end());
 }
 
+/* Below this size sorting and parsing are not split among threads */
+const size_t min_parallel_chunk = 16384;
+
+/* Sort [begin, end) with default_num_threads() threads: the chunks are
+ * sorted in parallel and then merged pairwise. */
+template<typename Iterator, typename Compare>
+void
+parallel_sort(Iterator begin, Iterator end, Compare comp)
+{
+    const size_t n = std::distance(begin, end);
+    const size_t num_chunks = std::min(default_num_threads(), n/min_parallel_chunk);
+    if (num_chunks < 2)
+    {
+        std::sort(begin, end, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(num_chunks+1);
+    for (size_t c = 0; c <= num_chunks; c++)
+        bounds[c] = (n*c)/num_chunks;
+
+    parallel_for(0, num_chunks, [&](size_t c, size_t) {
+        std::sort(begin + bounds[c], begin + bounds[c+1], comp);
+    }, num_chunks);
+
+    for (size_t width = 1; width < num_chunks; width *= 2)
+    {
+        const size_t num_merges = (num_chunks + 2*width - 1)/(2*width);
+        parallel_for(0, num_merges, [&](size_t m, size_t) {
+            const size_t lo = 2*width*m;
+            const size_t mid = std::min(lo + width, num_chunks);
+            const size_t hi = std::min(lo + 2*width, num_chunks);
+            if (mid < hi)
+                std::inplace_merge(begin + bounds[lo], begin + bounds[mid], begin + bounds[hi], comp);
+        }, num_merges);
+    }
+}
+
+template<typename Iterator>
+void
+parallel_sort(Iterator begin, Iterator end)
+{
+    parallel_sort(begin, end, std::less<>());
+}
+
+/* Same as sort_uniq(), but sorting in parallel */
+template<typename T>
+void
+parallel_sort_uniq(std::vector<T>& v)
+{
+    parallel_sort(v.begin(), v.end());
+    auto uniq_iter = std::unique(v.begin(), v.end());
+    v.erase(uniq_iter, v.end());
+}
+
+/* Skip n lines starting from ptr, ignoring the blank ones */
+inline const char *
+skip_lines(const char *ptr, const char *end, size_t n)
+{
+    for (size_t i = 0; i < n and ptr < end; i++)
+    {
+        while (ptr < end and std::isspace(static_cast<unsigned char>(*ptr)))
+            ptr++;
+        ptr = static_cast<const char *>(std::memchr(ptr, '\n', end - ptr));
+        ptr = ptr ? ptr+1 : end;
+    }
+    return ptr;
+}
+
+inline const char *
+skip_whitespace(const char *ptr, const char *end)
+{
+    while (ptr < end and std::isspace(static_cast<unsigned char>(*ptr)))
+        ptr++;
+    return ptr;
+}
+
+/* Parse a section of num_records records of a memory mapped file, starting
+ * at begin. parse(i, str, endptr) is called for the i-th record with str
+ * pointing to it, and it has to set *endptr after the record, like
+ * strtod(). Returns the end of the section.
+ * The section is split at newlines in chunks parsed in parallel, which
+ * assumes one record per line. If a chunk does not end where the next one
+ * starts, the section is parsed again sequentially: parse() must allow
+ * being called more than once for the same record. */
+template<typename Parse>
+const char *
+parallel_parse_records(const char *begin, const char *end, size_t num_records, const Parse& parse)
+{
+    auto sequential = [&]() {
+        char *ptr = const_cast<char *>(begin);
+        for (size_t i = 0; i < num_records; i++)
+            parse(i, ptr, &ptr);
+        return static_cast<const char *>(ptr);
+    };
+
+    const size_t num_chunks = std::min(default_num_threads(), num_records/min_parallel_chunk);
+    if (num_chunks < 2)
+        return sequential();
+
+    /* Find the first record of each chunk */
+    std::vector<size_t> first(num_chunks+1);
+    std::vector<const char *> starts(num_chunks+1);
+    starts[0] = begin;
+    for (size_t c = 1; c <= num_chunks; c++)
+    {
+        first[c] = (num_records*c)/num_chunks;
+        starts[c] = skip_lines(starts[c-1], end, first[c] - first[c-1]);
+    }
+
+    std::vector<const char *> ends(num_chunks);
+    try {
+        parallel_for(0, num_chunks, [&](size_t c, size_t) {
+            char *ptr = const_cast<char *>(starts[c]);
+            for (size_t i = first[c]; i < first[c+1]; i++)
+                parse(i, ptr, &ptr);
+            ends[c] = ptr;
+        }, num_chunks);
+    }
+    catch (...) {
+        /* Maybe a chunk started in the middle of a record */
+        return sequential();
+    }
+
+    for (size_t c = 0; c+1 < num_chunks; c++)
+        if (skip_whitespace(ends[c], end) != skip_whitespace(starts[c+1], end))
+            return sequential();
+
+    return ends[num_chunks-1];
+}
+
+/* Read a value with strtot() and move ptr after it. Returns false if
+ * there is no value at ptr. */
+template<typename U>
+bool
+read_value(char **ptr, U& val)
+{
+    char *endptr;
+    val = strtot<U>(*ptr, &endptr);
+    if (endptr == *ptr)
+        return false;
+
+    *ptr = endptr;
+    return true;
+}
+
+/* Read a record made of a count n followed by n indices, subtracting
+ * base from each index (1 for the formats with one-based indices) */
+inline bool
+read_index_list(char **ptr, std::vector<size_t>& list, size_t base)
+{
+    size_t num_entries;
+    if ( !read_value(ptr, num_entries) )
+        return false;
+
+    list.resize(num_entries);
+    for (auto& idx : list)
+    {
+        if ( !read_value(ptr, idx) )
+            return false;
+        idx -= base;
+    }
+
+    return true;
+}
+
+/* Scanner on the text of a memory mapped mesh file, shared by the loaders
+ * of the keyword based formats (medit, FVCA5, FVCA6, poly). Keywords and
+ * single values are read sequentially, the sections of records are parsed
+ * with parallel_parse_records(). */
+class text_scanner
+{
+    const char *    m_begin;
+    const char *    m_ptr;
+    const char *    m_end;
+    const char *    m_section;
+    size_t          m_failed_record;
+
+public:
+    text_scanner(const char *begin, const char *end)
+        : m_begin(begin), m_ptr(begin), m_end(end), m_section(begin),
+          m_failed_record(0)
+    {}
+
+    /* End of the text, for the parsers of the records */
+    const char *end(void) const
+    {
+        return m_end;
+    }
+
+    /* True if only whitespace is left */
+    bool at_end(void)
+    {
+        m_ptr = skip_whitespace(m_ptr, m_end);
+        return m_ptr == m_end;
+    }
+
+    /* Next word separated by whitespace, empty at the end of the file */
+    std::string word(void)
+    {
+        m_ptr = skip_whitespace(m_ptr, m_end);
+        auto word_begin = m_ptr;
+        while (m_ptr < m_end and not std::isspace(static_cast<unsigned char>(*m_ptr)))
+            m_ptr++;
+        return std::string(word_begin, m_ptr);
+    }
+
+    bool expect(const std::string& str)
+    {
+        auto keyword = word();
+        if ( keyword != str )
+        {
+            std::cout << "Expected keyword \"" << str << "\"" << std::endl;
+            std::cout << "Found \"" << keyword << "\"" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /* Rest of the current line, without the newline */
+    std::string line(void)
+    {
+        auto line_begin = m_ptr;
+        auto nl = static_cast<const char *>(std::memchr(m_ptr, '\n', m_end - m_ptr));
+        m_ptr = nl ? nl+1 : m_end;
+        return std::string(line_begin, nl ? nl : m_end);
+    }
+
+    template<typename U>
+    bool read(U& val)
+    {
+        if ( at_end() )
+            return false;
+
+        char *ptr = const_cast<char *>(m_ptr);
+        bool success = read_value(&ptr, val);
+        m_ptr = ptr;
+        return success;
+    }
+
+    /* Parse num_records records with parallel_parse_records(). parse(i,
+     * str, endptr) returns false if the i-th record is malformed: in that
+     * case records() returns false and failed_record() is the index of the
+     * first malformed record. */
+    template<typename Parse>
+    bool records(size_t num_records, const Parse& parse)
+    {
+        m_section = m_ptr;
+
+        std::atomic<size_t> failed(num_records);
+        auto parse_record = [&](size_t i, const char *str, char **endptr) {
+            if ( parse(i, str, endptr) )
+                return;
+            size_t f = failed.load();
+            while (i < f and not failed.compare_exchange_weak(f, i))
+                ;
+        };
+
+        m_ptr = parallel_parse_records(m_section, m_end, num_records, parse_record);
+        m_failed_record = failed.load();
+        if (m_failed_record == num_records)
+            return true;
+
+        /* Find the first malformed record in the file order. The records
+         * that failed may also come from a split discarded by
+         * parallel_parse_records(), so all of them can be fine. */
+        char *ptr = const_cast<char *>(m_section);
+        for (m_failed_record = 0; m_failed_record < num_records; m_failed_record++)
+            if ( !parse(m_failed_record, ptr, &ptr) )
+                break;
+
+        m_ptr = ptr;
+        return m_failed_record == num_records;
+    }
+
+    size_t failed_record(void) const
+    {
+        return m_failed_record;
+    }
+
+    /* Print the position of the record that failed in records(), for the
+     * error messages of the loaders. Returns false. */
+    bool record_error(const std::string& section) const
+    {
+        std::cout << "Line " << record_line_number(m_failed_record) << ": ";
+        std::cout << "error while parsing '" << section << "' (record ";
+        std::cout << m_failed_record << ")" << std::endl;
+        return false;
+    }
+
+    /* Line of the current position, starting from 1 */
+    size_t line_number(void) const
+    {
+        return 1 + std::count(m_begin, m_ptr, '\n');
+    }
+
+    /* Line of the i-th record of the last section read by records() */
+    size_t record_line_number(size_t i) const
+    {
+        auto ptr = skip_whitespace(skip_lines(m_section, m_end, i), m_end);
+        return 1 + std::count(m_begin, ptr, '\n');
+    }
+};
+
+/* Read num_records records of lists of indices (see read_index_list())
+ * in lists. The entries of lists can also be pairs of the record number
+ * and of the indices. */
+template<typename Entry>
+bool
+read_index_lists(text_scanner& ts, size_t num_records, std::vector<Entry>& lists, size_t base)
+{
+    lists.resize(num_records);
+
+    auto read_list = [&](size_t i, const char *str, char **endptr) {
+        *endptr = const_cast<char *>(str);
+        if constexpr (std::is_same_v<Entry, std::vector<size_t>>)
+            return read_index_list(endptr, lists[i], base);
+        else
+        {
+            lists[i].first = i;
+            return read_index_list(endptr, lists[i].second, base);
+        }
+    };
+
+    return ts.records(num_records, read_list);
+}
+
+/* Build the elements of a generic mesh from the ids of their subelements
+ * sub_ids(i) and of their points pt_ids(i), i in [0, num_elems). */
+template<typename Element, typename SubIds, typename PointIds>
+void
+make_generic_elements(std::vector<Element>& elems, size_t num_elems,
+                      const SubIds& sub_ids, const PointIds& pt_ids)
+{
+    typedef typename Element::subelement_type::id_type                  sub_id_type;
+    typedef point_identifier<generic_element_traits<Element>::dimension> point_id_type;
+
+    elems.resize(num_elems);
+    parallel_for(0, num_elems, [&](size_t i, size_t) {
+        std::vector<sub_id_type> sids;
+        sids.reserve( std::ranges::size(sub_ids(i)) );
+        for (auto& sid : sub_ids(i))
+            sids.push_back( sub_id_type(to_ident_raw(size_t(sid))) );
+
+        std::vector<point_id_type> pids;
+        pids.reserve( std::ranges::size(pt_ids(i)) );
+        for (auto& ptid : pt_ids(i))
+            pids.push_back( point_id_type(to_ident_raw(size_t(ptid))) );
+
+        Element e( std::move(sids) );
+        e.set_point_ids( std::move(pids) );
+        elems[i] = std::move(e);
+    });
+}
+
+/* Store the polygons (surfaces) of a generic mesh storage, see above. A
+ * storage with flat connectivity copies the ids directly in its pool. */
+template<typename Storage, typename SubIds, typename PointIds>
+void
+store_surfaces(Storage& storage, size_t num_elems, const SubIds& sub_ids, const PointIds& pt_ids)
+{
+    if constexpr ( requires { storage.surface_pool; } )
+        storage.surfaces = storage.surface_pool.fill(num_elems, sub_ids, pt_ids);
+    else
+        make_generic_elements(storage.surfaces, num_elems, sub_ids, pt_ids);
+}
+
+/* Store the polyhedra (volumes) of a 3D generic mesh storage */
+template<typename Storage, typename SubIds, typename PointIds>
+void
+store_volumes(Storage& storage, size_t num_elems, const SubIds& sub_ids, const PointIds& pt_ids)
+{
+    if constexpr ( requires { storage.volume_pool; } )
+        storage.volumes = storage.volume_pool.fill(num_elems, sub_ids, pt_ids);
+    else
+        make_generic_elements(storage.volumes, num_elems, sub_ids, pt_ids);
+}
+
 } //namespace priv
 
 } //namespace disk
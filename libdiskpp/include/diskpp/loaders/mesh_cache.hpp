@@ -0,0 +1,501 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Binary cache of the meshes read by the loaders. The cache stores the
+ * populated mesh_storage (points, elements already sorted, boundary and
+ * subdomain information) and it is loaded without parsing nor sorting.
+ *
+ * The cache of "mesh.ext" is "mesh.ext.<hash>.diskpp-cache", where <hash> is
+ * the hash of the name of the mesh type: a file loaded in meshes of different
+ * types has one cache per type. The cache is made of a header followed by the
+ * storage:
+ *  - magic "DISKPPMC" (8 bytes), version (uint32_t), byte order mark
+ *    0x01020304 (uint32_t)
+ *  - size of ident_raw_t (uint32_t) and name of the mesh type (uint64_t
+ *    length + characters): a cache is refused by another mesh type or by a
+ *    build with another index width
+ *  - size and modification time of the source file (uint64_t, int64_t): the
+ *    cache is refused if the source has been modified
+ *  - the element vectors, from the points to the cells, then boundary_info
+ *    and subdomain_info.
+ *
+ * Trivially copyable elements (points, nodes, simplicial and cartesian
+ * elements, edges) are stored as they are in memory and copied in the
+ * storage with a single memcpy(). Generic faces and cells are stored in CSR
+ * format: the offsets and then the ids of the subelements and of the points.
+ *
+ * The cache is a file of the machine that wrote it, not an exchange format.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include <unistd.h>
+
+#include "diskpp/mesh/mesh.hpp"
+#include "diskpp/geometry/element_generic_flat.hpp"
+#include "diskpp/common/mapped_file.h"
+
+namespace disk {
+
+namespace priv {
+
+const char      mesh_cache_magic[8]     = {'D', 'I', 'S', 'K', 'P', 'P', 'M', 'C'};
+const uint32_t  mesh_cache_version      = 1;
+const uint32_t  mesh_cache_byte_order   = 0x01020304;
+
+/* Size and modification time of the source of a cache */
+struct mesh_cache_stamp
+{
+    uint64_t    size;
+    int64_t     mtime;
+
+    bool operator==(const mesh_cache_stamp&) const = default;
+};
+
+inline bool
+mesh_cache_source_stamp(const std::string& source, mesh_cache_stamp& stamp)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(source, ec);
+    if (ec)
+        return false;
+
+    auto mtime = std::filesystem::last_write_time(source, ec);
+    if (ec)
+        return false;
+
+    stamp.size = size;
+    stamp.mtime = mtime.time_since_epoch().count();
+    return true;
+}
+
+class mesh_cache_writer
+{
+    std::ofstream   m_ofs;
+
+public:
+    mesh_cache_writer(const std::string& filename)
+        : m_ofs(filename, std::ios::binary)
+    {}
+
+    bool good(void) const { return m_ofs.good(); }
+
+    template<typename U>
+    void write(const U* values, size_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<U>, "mesh cache: type not trivially copyable");
+        m_ofs.write(reinterpret_cast<const char *>(values), n*sizeof(U));
+    }
+
+    template<typename U>
+    void write(const U& value)
+    {
+        write(&value, 1);
+    }
+
+    void close(void) { m_ofs.close(); }
+};
+
+class mesh_cache_reader
+{
+    const char *    m_pos;
+    const char *    m_end;
+
+public:
+    mesh_cache_reader(const char *data, size_t size)
+        : m_pos(data), m_end(data + size)
+    {}
+
+    /* Read n values, return false if the file is too short */
+    template<typename U>
+    bool read(U* values, size_t n)
+    {
+        static_assert(std::is_trivially_copyable_v<U>, "mesh cache: type not trivially copyable");
+        if ( n > size_t(m_end - m_pos)/sizeof(U) )
+            return false;
+        if (n > 0)
+            std::memcpy(values, m_pos, n*sizeof(U));
+        m_pos += n*sizeof(U);
+        return true;
+    }
+
+    template<typename U>
+    bool read(U& value)
+    {
+        return read(&value, 1);
+    }
+
+    /* Read a value and check that it is the expected one */
+    template<typename U>
+    bool expect(const U& expected)
+    {
+        U value;
+        return read(value) and value == expected;
+    }
+
+    size_t remaining(void) const { return m_end - m_pos; }
+
+    bool end(void) const { return m_pos == m_end; }
+};
+
+template<typename Element>
+void
+mesh_cache_write_elements(mesh_cache_writer& out, const std::vector<Element>& elems)
+{
+    out.write( uint64_t(elems.size()) );
+    if constexpr ( std::is_trivially_copyable_v<Element> )
+    {
+        out.write( uint64_t(sizeof(Element)) );
+        out.write( elems.data(), elems.size() );
+    }
+    else
+    {
+        std::vector<uint64_t> sub_ofs, pts_ofs;
+        sub_ofs.reserve(elems.size()+1);
+        pts_ofs.reserve(elems.size()+1);
+        sub_ofs.push_back(0);
+        pts_ofs.push_back(0);
+        for (auto& e : elems)
+        {
+            sub_ofs.push_back( sub_ofs.back() + e.subelement_size() );
+            pts_ofs.push_back( pts_ofs.back() + e.point_ids().size() );
+        }
+
+        std::vector<ident_raw_t> sub_ids, pts_ids;
+        sub_ids.reserve(sub_ofs.back());
+        pts_ids.reserve(pts_ofs.back());
+        for (auto& e : elems)
+        {
+            for (auto itor = e.subelement_id_begin(); itor != e.subelement_id_end(); itor++)
+                sub_ids.push_back( ident_raw_t(*itor) );
+
+            auto pts = e.point_ids();
+            pts_ids.insert(pts_ids.end(), pts.begin(), pts.end());
+        }
+
+        out.write( sub_ofs.data(), sub_ofs.size() );
+        out.write( pts_ofs.data(), pts_ofs.size() );
+        out.write( sub_ids.data(), sub_ids.size() );
+        out.write( pts_ids.data(), pts_ids.size() );
+    }
+}
+
+/* Ids of the polygons/polyhedra as written by mesh_cache_write_elements():
+ * the ids of the element i are in [ofs[i], ofs[i+1]) */
+struct mesh_cache_csr
+{
+    std::vector<uint64_t>       sub_ofs, pts_ofs;
+    std::vector<ident_raw_t>    sub_ids, pts_ids;
+
+    size_t size(void) const { return sub_ofs.size() - 1; }
+
+    std::span<const ident_raw_t>
+    subelements(size_t i) const
+    {
+        return std::span<const ident_raw_t>(sub_ids.data() + sub_ofs[i], sub_ofs[i+1] - sub_ofs[i]);
+    }
+
+    std::span<const ident_raw_t>
+    points(size_t i) const
+    {
+        return std::span<const ident_raw_t>(pts_ids.data() + pts_ofs[i], pts_ofs[i+1] - pts_ofs[i]);
+    }
+};
+
+inline bool
+mesh_cache_read_csr(mesh_cache_reader& in, mesh_cache_csr& csr)
+{
+    uint64_t num_elems;
+    if ( not in.read(num_elems) )
+        return false;
+
+    if ( num_elems >= in.remaining()/(2*sizeof(uint64_t)) )
+        return false;
+
+    csr.sub_ofs.resize(num_elems+1);
+    csr.pts_ofs.resize(num_elems+1);
+    if ( not in.read(csr.sub_ofs.data(), csr.sub_ofs.size()) or
+         not in.read(csr.pts_ofs.data(), csr.pts_ofs.size()) )
+        return false;
+
+    const size_t max_ids = in.remaining()/sizeof(ident_raw_t);
+    if ( csr.sub_ofs.back() > max_ids or csr.pts_ofs.back() > max_ids - csr.sub_ofs.back() )
+        return false;
+
+    csr.sub_ids.resize(csr.sub_ofs.back());
+    csr.pts_ids.resize(csr.pts_ofs.back());
+    if ( not in.read(csr.sub_ids.data(), csr.sub_ids.size()) or
+         not in.read(csr.pts_ids.data(), csr.pts_ids.size()) )
+        return false;
+
+    for (size_t i = 0; i < num_elems; i++)
+    {
+        if (csr.sub_ofs[i] > csr.sub_ofs[i+1] or csr.sub_ofs[i+1] > csr.sub_ids.size() or
+            csr.pts_ofs[i] > csr.pts_ofs[i+1] or csr.pts_ofs[i+1] > csr.pts_ids.size())
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Element>
+bool
+mesh_cache_read_elements(mesh_cache_reader& in, std::vector<Element>& elems)
+{
+    if constexpr ( std::is_trivially_copyable_v<Element> )
+    {
+        uint64_t num_elems;
+        if ( not in.read(num_elems) )
+            return false;
+
+        if ( not in.expect(uint64_t(sizeof(Element))) or
+             num_elems > in.remaining()/sizeof(Element) )
+            return false;
+
+        elems.resize(num_elems);
+        return in.read(elems.data(), elems.size());
+    }
+    else
+    {
+        mesh_cache_csr csr;
+        if ( not mesh_cache_read_csr(in, csr) )
+            return false;
+
+        elems.clear();
+        elems.reserve(csr.size());
+        for (size_t i = 0; i < csr.size(); i++)
+        {
+            auto sids = csr.subelements(i);
+            auto pids = csr.points(i);
+
+            Element e;
+            e.set_subelement_ids(sids.begin(), sids.end());
+            e.set_point_ids(pids.begin(), pids.end());
+            elems.push_back( std::move(e) );
+        }
+        return true;
+    }
+}
+
+/* The flat storages take the ids of the polygons/polyhedra in their pools */
+template<typename Element>
+bool
+mesh_cache_read_elements(mesh_cache_reader& in, flat_element_pool<Element>& pool,
+                         std::vector<Element>& elems)
+{
+    mesh_cache_csr csr;
+    if ( not mesh_cache_read_csr(in, csr) )
+        return false;
+
+    elems = pool.fill(csr.size(),
+                      [&](size_t i) { return csr.subelements(i); },
+                      [&](size_t i) { return csr.points(i); });
+    return true;
+}
+
+template<typename Storage>
+bool
+mesh_cache_read_surfaces(mesh_cache_reader& in, Storage& storage)
+{
+    if constexpr ( requires { storage.surface_pool; } )
+        return mesh_cache_read_elements(in, storage.surface_pool, storage.surfaces);
+    else
+        return mesh_cache_read_elements(in, storage.surfaces);
+}
+
+template<typename Storage>
+bool
+mesh_cache_read_volumes(mesh_cache_reader& in, Storage& storage)
+{
+    if constexpr ( requires { storage.volume_pool; } )
+        return mesh_cache_read_elements(in, storage.volume_pool, storage.volumes);
+    else
+        return mesh_cache_read_elements(in, storage.volumes);
+}
+
+template<typename Mesh>
+std::string
+mesh_cache_type_name(void)
+{
+    return typeid(Mesh).name();
+}
+
+/* 64-bit FNV-1a hash of the name of the mesh type */
+template<typename Mesh>
+uint64_t
+mesh_cache_type_hash(void)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (auto c : mesh_cache_type_name<Mesh>())
+    {
+        hash ^= uint8_t(c);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+} // namespace priv
+
+/* Name of the cache of a mesh file loaded in a mesh of type Mesh */
+template<typename Mesh>
+std::string
+mesh_cache_filename(const std::string& source)
+{
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  (unsigned long long)priv::mesh_cache_type_hash<Mesh>());
+    return source + "." + hash + ".diskpp-cache";
+}
+
+/* The loaders use the cache unless the DISKPP_MESH_CACHE environment
+ * variable is set to 0 */
+inline bool
+mesh_cache_enabled(void)
+{
+    if (const char *env = std::getenv("DISKPP_MESH_CACHE"))
+        return std::strcmp(env, "0") != 0;
+
+    return true;
+}
+
+/* Write the cache of the mesh read from the file source. The cache is
+ * written in a temporary file and renamed, so that concurrent runs never
+ * see a partial cache. Returns false if the cache could not be written. */
+template<typename Mesh>
+bool
+save_mesh_cache(const std::string& source, const Mesh& msh)
+{
+    priv::mesh_cache_stamp stamp;
+    if ( not priv::mesh_cache_source_stamp(source, stamp) )
+        return false;
+
+    const auto filename = mesh_cache_filename<Mesh>(source);
+    const auto tmp_filename = filename + ".tmp" + std::to_string(::getpid());
+
+    priv::mesh_cache_writer out(tmp_filename);
+    if ( not out.good() )
+        return false;
+
+    const auto type_name = priv::mesh_cache_type_name<Mesh>();
+    out.write(priv::mesh_cache_magic, sizeof(priv::mesh_cache_magic));
+    out.write(priv::mesh_cache_version);
+    out.write(priv::mesh_cache_byte_order);
+    out.write( uint32_t(sizeof(ident_raw_t)) );
+    out.write( uint64_t(type_name.size()) );
+    out.write( type_name.data(), type_name.size() );
+    out.write(stamp);
+
+    auto storage = msh.backend_storage();
+    priv::mesh_cache_write_elements(out, storage->points);
+    priv::mesh_cache_write_elements(out, storage->nodes);
+    priv::mesh_cache_write_elements(out, storage->edges);
+    if constexpr (Mesh::dimension > 1)
+        priv::mesh_cache_write_elements(out, storage->surfaces);
+    if constexpr (Mesh::dimension > 2)
+        priv::mesh_cache_write_elements(out, storage->volumes);
+    priv::mesh_cache_write_elements(out, storage->boundary_info);
+    priv::mesh_cache_write_elements(out, storage->subdomain_info);
+
+    out.close();
+
+    std::error_code ec;
+    if ( not out.good() )
+    {
+        std::filesystem::remove(tmp_filename, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmp_filename, filename, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmp_filename, ec);
+        return false;
+    }
+
+    return true;
+}
+
+/* Load the mesh read from the file source from its cache. Returns false,
+ * leaving msh untouched, if there is no cache or if the cache does not
+ * match the source, the mesh type or this build. */
+template<typename Mesh>
+bool
+load_mesh_cache(const std::string& source, Mesh& msh)
+{
+    const auto filename = mesh_cache_filename<Mesh>(source);
+
+    std::error_code ec;
+    if ( not std::filesystem::is_regular_file(filename, ec) )
+        return false;
+
+    priv::mesh_cache_stamp stamp;
+    if ( not priv::mesh_cache_source_stamp(source, stamp) )
+        return false;
+
+    mapped_file mf(filename);
+    if ( not mf.is_open() )
+        return false;
+
+    priv::mesh_cache_reader in(mf.mem(), mf.size());
+
+    char magic[sizeof(priv::mesh_cache_magic)];
+    if ( not in.read(magic, sizeof(magic)) or
+         std::memcmp(magic, priv::mesh_cache_magic, sizeof(magic)) != 0 )
+        return false;
+
+    const auto type_name = priv::mesh_cache_type_name<Mesh>();
+    if ( not in.expect(priv::mesh_cache_version) or
+         not in.expect(priv::mesh_cache_byte_order) or
+         not in.expect( uint32_t(sizeof(ident_raw_t)) ) or
+         not in.expect( uint64_t(type_name.size()) ) )
+        return false;
+
+    std::string cache_type_name(type_name.size(), '\0');
+    if ( not in.read(cache_type_name.data(), cache_type_name.size()) or
+         cache_type_name != type_name )
+        return false;
+
+    if ( not in.expect(stamp) )
+        return false;
+
+    typename Mesh::storage_type storage;
+    bool ok = priv::mesh_cache_read_elements(in, storage.points) and
+              priv::mesh_cache_read_elements(in, storage.nodes) and
+              priv::mesh_cache_read_elements(in, storage.edges);
+    if constexpr (Mesh::dimension > 1)
+        ok = ok and priv::mesh_cache_read_surfaces(in, storage);
+    if constexpr (Mesh::dimension > 2)
+        ok = ok and priv::mesh_cache_read_volumes(in, storage);
+    ok = ok and priv::mesh_cache_read_elements(in, storage.boundary_info) and
+                priv::mesh_cache_read_elements(in, storage.subdomain_info) and
+                in.end();
+
+    if (not ok)
+        return false;
+
+    *msh.backend_storage() = std::move(storage);
+    msh.reset_lookup_tables();
+    return true;
+}
+
+} // namespace disk
@@ -0,0 +1,378 @@
+/*
+ *       /\        Matteo Cicuttin (C) 2016, 2017, 2018
+ *      /__\       matteo.cicuttin@enpc.fr
+ *     /_\/_\      École Nationale des Ponts et Chaussées - CERMICS
+ *    /\    /\
+ *   /__\  /__\    DISK++, a template library for DIscontinuous SKeletal
+ *  /_\/_\/_\/_\   methods.
+ *
+ * This file is copyright of the following authors:
+ * Nicolas Pignet  (C) 2019                     nicolas.pignet@enpc.fr
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * If you use this code or parts of it for scientific publications, you
+ * are required to cite it as following:
+ *
+ * Hybrid High-Order methods for finite elastoplastic deformations
+ * within a logarithmic strain framework.
+ * M. Abbas, A. Ern, N. Pignet.
+ * International Journal of Numerical Methods in Engineering (2019)
+ * 120(3), 303-327
+ * DOI: 10.1002/nme.6137
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/common/mapped_file.h"
+
+namespace disk
+{
+
+namespace mechanics
+{
+
+/**
+ * @brief Binary checkpoint files
+ *
+ * A checkpoint file is made of a header followed by the payload:
+ *  - magic "DISKPPCK" (8 bytes)
+ *  - version of the format (uint32_t)
+ *  - byte order mark 0x01020304 (uint32_t), to refuse files written on a machine with another byte order
+ *  - size of the payload in bytes (uint64_t)
+ *
+ * The payload is written by the owner of the data, with CheckpointOutput, and read back in the same
+ * order with CheckpointInput. Values are stored in the native representation, without padding.
+ */
+const char     checkpoint_magic[8]    = {'D', 'I', 'S', 'K', 'P', 'P', 'C', 'K'};
+const uint32_t checkpoint_version     = 1;
+const uint32_t checkpoint_byte_order  = 0x01020304;
+const size_t   checkpoint_header_size = sizeof(checkpoint_magic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+/**
+ * @brief Write the payload of a checkpoint in memory. Without memory, only the size is computed, so
+ * that the same function gives the size of the file and then writes it.
+ */
+class CheckpointOutput
+{
+  private:
+    char*  m_data;
+    size_t m_capacity;
+    size_t m_pos;
+
+  public:
+    /**
+     * @brief Construct an output that only counts the bytes
+     */
+    CheckpointOutput() : m_data(nullptr), m_capacity(0), m_pos(0) {}
+
+    /**
+     * @brief Construct an output writing in [data, data + capacity)
+     */
+    CheckpointOutput(char* data, const size_t capacity) : m_data(data), m_capacity(capacity), m_pos(0) {}
+
+    /**
+     * @brief Write n values of a trivially copyable type
+     */
+    template<typename U>
+    void
+    write(const U* values, const size_t n)
+    {
+        static_assert(std::is_trivially_copyable<U>::value, "Checkpoint: type not trivially copyable");
+
+        const size_t bytes = n * sizeof(U);
+        if (m_data)
+        {
+            if (m_pos + bytes > m_capacity)
+                throw std::runtime_error("Checkpoint: payload larger than the file");
+            if (bytes > 0)
+                std::memcpy(m_data + m_pos, values, bytes);
+        }
+        m_pos += bytes;
+    }
+
+    template<typename U>
+    void
+    write(const U& value)
+    {
+        this->write(&value, 1);
+    }
+
+    /**
+     * @brief Write a list of vectors: the number of vectors, then the size and the values of each vector
+     */
+    template<typename T>
+    void
+    write(const std::vector<dynamic_vector<T>>& vectors)
+    {
+        this->write(uint64_t(vectors.size()));
+        for (auto& v : vectors)
+        {
+            this->write(uint64_t(v.size()));
+            this->write(v.data(), v.size());
+        }
+    }
+
+    /**
+     * @brief Number of bytes written
+     */
+    size_t
+    size(void) const
+    {
+        return m_pos;
+    }
+};
+
+/**
+ * @brief Read the payload of a checkpoint from memory, in the order used by CheckpointOutput
+ */
+class CheckpointInput
+{
+  private:
+    const char* m_data;
+    size_t      m_size;
+    size_t      m_pos;
+
+  public:
+    CheckpointInput() : m_data(nullptr), m_size(0), m_pos(0) {}
+
+    CheckpointInput(const char* data, const size_t size) : m_data(data), m_size(size), m_pos(0) {}
+
+    template<typename U>
+    void
+    read(U* values, const size_t n)
+    {
+        static_assert(std::is_trivially_copyable<U>::value, "Checkpoint: type not trivially copyable");
+
+        const size_t bytes = n * sizeof(U);
+        if (m_pos + bytes > m_size)
+            throw std::runtime_error("Checkpoint: unexpected end of the file");
+        if (bytes > 0)
+            std::memcpy(values, m_data + m_pos, bytes);
+        m_pos += bytes;
+    }
+
+    template<typename U>
+    U
+    read(void)
+    {
+        U value;
+        this->read(&value, 1);
+        return value;
+    }
+
+    /**
+     * @brief Read a value and check that it is equal to the expected one
+     *
+     * @param expected expected value
+     * @param what name of the value, for the error message
+     */
+    template<typename U>
+    void
+    expect(const U& expected, const std::string& what)
+    {
+        if (this->read<U>() != expected)
+            throw std::runtime_error("Checkpoint: " + what + " does not match the current computation");
+    }
+
+    /**
+     * @brief Read a list of vectors written by CheckpointOutput. The number and the sizes of the vectors
+     * have to be the ones of the given list, i.e. the discretization of the checkpoint has to be the same.
+     */
+    template<typename T>
+    void
+    read(std::vector<dynamic_vector<T>>& vectors)
+    {
+        this->expect(uint64_t(vectors.size()), "number of vectors");
+        for (auto& v : vectors)
+        {
+            this->expect(uint64_t(v.size()), "size of vectors");
+            this->read(v.data(), v.size());
+        }
+    }
+
+    /**
+     * @brief Return true if the whole payload has been read
+     */
+    bool
+    end(void) const
+    {
+        return m_pos == m_size;
+    }
+};
+
+/**
+ * @brief Write checkpoint files asynchronously
+ *
+ * The file is mapped in memory and the payload is copied in the mapping by the calling thread, which
+ * costs a copy of the data in memory. Writing the mapping to the disk is done by another thread,
+ * so that the computation continues meanwhile. The file is first written with the suffix ".tmp"
+ * and renamed at the end: a failure during the writing leaves the previous checkpoint intact.
+ * At most one file is written at a time, a new checkpoint waits for the end of the previous one.
+ */
+class CheckpointWriter
+{
+  private:
+    std::future<void> m_pending;
+
+  public:
+    CheckpointWriter() {}
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter&
+    operator=(const CheckpointWriter&) = delete;
+
+    ~CheckpointWriter()
+    {
+        try
+        {
+            this->wait();
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * @brief Write a checkpoint
+     *
+     * @param filename name of the checkpoint file
+     * @param payload function writing the payload in a CheckpointOutput, it is called twice: to compute
+     * the size of the file and to write it
+     */
+    template<typename Payload>
+    void
+    write(const std::string& filename, const Payload& payload)
+    {
+        this->wait();
+
+        CheckpointOutput counter;
+        payload(counter);
+        const uint64_t payload_size = counter.size();
+        const size_t   file_size    = checkpoint_header_size + payload_size;
+
+        const std::string tmp_name = filename + ".tmp";
+        const int         fd       = ::open(tmp_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            throw std::runtime_error("Checkpoint: cannot open " + tmp_name);
+
+        if (::ftruncate(fd, file_size) == -1)
+        {
+            ::close(fd);
+            throw std::runtime_error("Checkpoint: cannot resize " + tmp_name);
+        }
+
+        void* addr = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Checkpoint: cannot map " + tmp_name);
+        }
+
+        char* data = static_cast<char*>(addr);
+        std::memcpy(data, checkpoint_magic, sizeof(checkpoint_magic));
+        CheckpointOutput header(data + sizeof(checkpoint_magic), checkpoint_header_size - sizeof(checkpoint_magic));
+        header.write(checkpoint_version);
+        header.write(checkpoint_byte_order);
+        header.write(payload_size);
+
+        CheckpointOutput out(data + checkpoint_header_size, payload_size);
+        try
+        {
+            payload(out);
+        }
+        catch (...)
+        {
+            ::munmap(addr, file_size);
+            ::close(fd);
+            throw;
+        }
+
+        m_pending = std::async(std::launch::async,
+                               [addr, file_size, fd, tmp_name, filename]()
+                               {
+                                   const bool synced = ::msync(addr, file_size, MS_SYNC) == 0;
+                                   ::munmap(addr, file_size);
+                                   ::close(fd);
+
+                                   if (!synced)
+                                       throw std::runtime_error("Checkpoint: cannot write " + tmp_name);
+                                   if (std::rename(tmp_name.c_str(), filename.c_str()) != 0)
+                                       throw std::runtime_error("Checkpoint: cannot rename " + tmp_name);
+                               });
+    }
+
+    /**
+     * @brief Wait for the end of the writing in progress, if any. The errors of the writing are thrown here.
+     */
+    void
+    wait(void)
+    {
+        if (m_pending.valid())
+            m_pending.get();
+    }
+};
+
+/**
+ * @brief Map a checkpoint file in memory and check its header
+ */
+class CheckpointReader
+{
+  private:
+    mapped_file m_file;
+    const char* m_data;
+
+  public:
+    CheckpointReader(const std::string& filename) : m_file(filename), m_data(nullptr)
+    {
+        if (!m_file.is_open())
+            throw std::runtime_error("Checkpoint: cannot open " + filename);
+        m_data = m_file.mem();
+
+        if (m_file.size() < checkpoint_header_size ||
+            std::memcmp(m_data, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+            throw std::runtime_error("Checkpoint: " + filename + " is not a checkpoint");
+
+        CheckpointInput header(m_data + sizeof(checkpoint_magic), checkpoint_header_size - sizeof(checkpoint_magic));
+        if (header.read<uint32_t>() != checkpoint_version)
+            throw std::runtime_error("Checkpoint: unsupported version of " + filename);
+        if (header.read<uint32_t>() != checkpoint_byte_order)
+            throw std::runtime_error("Checkpoint: byte order of " + filename + " is not supported");
+        if (header.read<uint64_t>() != m_file.size() - checkpoint_header_size)
+            throw std::runtime_error("Checkpoint: " + filename + " is truncated");
+    }
+
+    CheckpointReader(const CheckpointReader&) = delete;
+    CheckpointReader&
+    operator=(const CheckpointReader&) = delete;
+
+    /**
+     * @brief Input on the payload of the file
+     */
+    CheckpointInput
+    payload(void) const
+    {
+        return CheckpointInput(m_data + checkpoint_header_size, m_file.size() - checkpoint_header_size);
+    }
+};
+}
+}
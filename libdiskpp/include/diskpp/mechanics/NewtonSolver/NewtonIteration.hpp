@@ -30,12 +30,14 @@
 
 #include <iostream>
 #include <math.h>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "NewtonSolverComput.hpp"
 #include "NewtonSolverInformations.hpp"
 #include "NewtonSolverParameters.hpp"
+#include "OperatorStore.hpp"
 #include "diskpp/bases/bases.hpp"
 
 #include "diskpp/adaptivity/adaptivity.hpp"
@@ -46,6 +48,7 @@
 
 #include "diskpp/methods/hho"
 #include "diskpp/solvers/solver.hpp"
+#include "diskpp/common/parallel.hpp"
 #include "diskpp/common/timecounter.hpp"
 
 namespace disk
@@ -91,16 +94,357 @@ class NewtonIteration
     std::vector<vector_type> m_solution, m_solution_faces, m_solution_mult;
 
     scalar_type m_F_int;
+    scalar_type m_error;
 
     bool m_verbose;
 
+    LinearSolverType     m_linear_solver;
+    CGPreconditionerType m_cg_precond;
+    scalar_type          m_cg_epsilon;
+    int                  m_cg_iter_max;
+    size_t               m_face_block_size; // unknowns of a face, block size of AMG
+
+    /* Kept across the iterations: the pattern of the LHS does not change,
+     * so only the numeric factorization is redone */
+    std::unique_ptr<solvers::factorized_solver<scalar_type>> m_direct_solver;
+
+    static solvers::factorization_type
+    factorization(const LinearSolverType linear_solver)
+    {
+        switch (linear_solver)
+        {
+            case LinearSolverType::PARDISO: return solvers::factorization_type::pardiso_lu;
+            case LinearSolverType::MUMPS: return solvers::factorization_type::mumps;
+            case LinearSolverType::SPARSE_LDLT: return solvers::factorization_type::sparse_ldlt;
+            default: return solvers::factorization_type::sparse_lu;
+        }
+    }
+
+    static bool
+    available(const LinearSolverType linear_solver)
+    {
+        if (linear_solver == LinearSolverType::ITERATIVE_CG)
+            return true;
+
+        return solvers::factorized_solver<scalar_type>::available(factorization(linear_solver));
+    }
+
+    bool
+    solve_direct(const LinearSolverType linear_solver)
+    {
+        const auto type = factorization(linear_solver);
+        if (!m_direct_solver || m_direct_solver->type() != type)
+            m_direct_solver = std::make_unique<solvers::factorized_solver<scalar_type>>(type);
+
+        if (!m_direct_solver->factorize(m_assembler.LHS))
+        {
+            m_direct_solver.reset();
+            return false;
+        }
+
+        m_system_solution = m_direct_solver->solve(m_assembler.RHS);
+        return m_system_solution.allFinite();
+    }
+
+    template<typename Preconditioner>
+    bool
+    solve_cg(Preconditioner& pc)
+    {
+        if (!pc.compute(m_assembler.LHS))
+            return false;
+
+        solvers::conjugated_gradient_params<scalar_type> cgp;
+        cgp.rr_tol   = m_cg_epsilon;
+        cgp.max_iter = m_cg_iter_max;
+        cgp.verbose  = m_verbose;
+
+        auto res = solvers::conjugated_gradient(cgp, m_assembler.LHS, m_assembler.RHS, m_system_solution, pc);
+        if (m_verbose)
+            std::cout << "CG: " << res.status << " after " << res.iterations << " iterations" << std::endl;
+
+        return res.converged();
+    }
+
+    bool
+    solve_cg(void)
+    {
+        switch (m_cg_precond)
+        {
+            case CGPreconditionerType::PRECOND_NONE:
+            {
+                solvers::identity_preconditioner<scalar_type> pc;
+                return solve_cg(pc);
+            }
+            case CGPreconditionerType::PRECOND_JACOBI:
+            {
+                solvers::jacobi_preconditioner<scalar_type> pc;
+                return solve_cg(pc);
+            }
+            case CGPreconditionerType::PRECOND_AMG:
+            {
+                solvers::amg_solver<scalar_type> pc;
+                pc.params().block_size = m_face_block_size;
+                return solve_cg(pc);
+            }
+            default:
+            {
+                solvers::ic0_preconditioner<scalar_type> pc;
+                return solve_cg(pc);
+            }
+        }
+    }
+
+    /* Condensed system of a cell and its contribution to the norm of the internal forces */
+    struct cell_contribution
+    {
+        matrix_type lhs;
+        vector_type rhs;
+        scalar_type F_int2;
+    };
+
+    /* Compute the condensed system of a cell. This function is called concurrently on different cells:
+     * elem and ai belong to the calling thread, the internal variables of the laws, the stabilization
+     * coefficients and the condensation operators are only written for the cell cell_i. */
+    template<typename LoadFunction>
+    cell_contribution
+    compute_cell(const mesh_type&                  msh,
+                 const typename mesh_type::cell&   cl,
+                 const size_t                      cell_i,
+                 const bnd_type&                   bnd,
+                 const param_type&                 rp,
+                 const MeshDegreeInfo<mesh_type>&  degree_infos,
+                 const LoadFunction&               lf,
+                 const OperatorStore<scalar_type>& gradient_precomputed,
+                 const OperatorStore<scalar_type>& stab_precomputed,
+                 behavior_type&                    behavior,
+                 const ContactManager<mesh_type>&  contact_manager,
+                 StabCoeffManager<scalar_type>&    stab_manager,
+                 elem_type&                        elem,
+                 AssemblyInfo&                     ai)
+    {
+        const bool small_def = (behavior.getDeformation() == SMALL_DEF);
+
+        timecounter tc;
+
+        // Gradient Reconstruction
+        // std::cout << "Grad" << std::endl;
+        // the precomputed operator is read without copy, GT_buffer is only used if it is packed
+        matrix_type GT_buffer;
+        tc.tic();
+        if (!rp.m_precomputation)
+        {
+            if (small_def)
+            {
+                const auto gradrec_sym_full = make_matrix_symmetric_gradrec(msh, cl, degree_infos);
+                GT_buffer                   = gradrec_sym_full.first;
+            }
+            else
+            {
+                const auto gradrec_full = make_marix_hho_gradrec(msh, cl, degree_infos);
+                GT_buffer               = gradrec_full.first;
+            }
+        }
+        typedef typename OperatorStore<scalar_type>::const_map_type operator_map_type;
+        const operator_map_type GT = rp.m_precomputation
+                                       ? gradient_precomputed.get(cell_i, GT_buffer)
+                                       : operator_map_type(GT_buffer.data(), GT_buffer.rows(), GT_buffer.cols());
+        tc.toc();
+        ai.m_time_gradrec += tc.elapsed();
+
+        // Begin Assembly
+        // Build rhs and lhs
+
+        // Mechanical Computation
+
+        tc.tic();
+        // std::cout << "Elem" << std::endl;
+        elem.compute(msh, cl, rp, degree_infos, lf, GT, m_solution.at(cell_i),
+                    behavior, stab_manager, small_def);
+
+        matrix_type lhs = elem.K_int;
+        vector_type rhs = elem.RTF;
+        const scalar_type F_int2 = elem.F_int.squaredNorm();
+
+        tc.toc();
+        ai.m_time_elem += tc.elapsed();
+        ai.m_time_law += elem.time_law;
+        ai.m_time_contact += elem.time_contact;
+
+        // Stabilisation Contribution
+        // std::cout << "Stab" << std::endl;
+        tc.tic();
+
+        const auto beta = stab_manager.getValue(msh, cl);
+        // std::cout << beta << std::endl;
+
+        if (rp.m_stab)
+        {
+            if (rp.m_precomputation)
+            {
+                matrix_type stab_buffer;
+                const auto  stab = stab_precomputed.get(cell_i, stab_buffer);
+                assert(elem.K_int.rows() == stab.rows());
+                assert(elem.K_int.cols() == stab.cols());
+                assert(elem.RTF.rows() == stab.rows());
+                assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
+
+                lhs += beta * stab;
+                rhs -= beta * stab * m_solution.at(cell_i);
+            }
+            else
+            {
+                switch (rp.m_stab_type)
+                {
+                    case HHO:
+                    {
+                        matrix_type stab_HHO;
+                        // we do not make any difference for the displacement reconstruction
+                        // if (small_def)
+                        // {
+                        //     const auto recons = make_vector_hho_symmetric_laplacian(msh, cl, degree_infos);
+                        //     stab_HHO          = make_vector_hho_stabilization(msh, cl, recons.first,
+                        //     degree_infos);
+                        // }
+                        // else
+                        // {
+                        const auto recons_scalar = make_scalar_hho_laplacian(msh, cl, degree_infos);
+                        stab_HHO = make_vector_hho_stabilization_optim(msh, cl, recons_scalar.first, degree_infos);
+                        // }
+
+                        assert(elem.K_int.rows() == stab_HHO.rows());
+                        assert(elem.K_int.cols() == stab_HHO.cols());
+                        assert(elem.RTF.rows() == stab_HHO.rows());
+                        assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
+
+                        lhs += beta * stab_HHO;
+                        rhs -= beta * stab_HHO * m_solution.at(cell_i);
+                        break;
+                    }
+                    case HDG:
+                    {
+                        const auto stab_HDG = make_vector_hdg_stabilization(msh, cl, degree_infos);
+                        assert(elem.K_int.rows() == stab_HDG.rows());
+                        assert(elem.K_int.cols() == stab_HDG.cols());
+                        assert(elem.RTF.rows() == stab_HDG.rows());
+                        assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
+
+                        lhs += beta * stab_HDG;
+                        rhs -= beta * stab_HDG * m_solution.at(cell_i);
+                        break;
+                    }
+                    case DG:
+                    {
+                        const auto stab_DG = make_vector_dg_stabilization(msh, cl, degree_infos);
+                        assert(elem.K_int.rows() == stab_DG.rows());
+                        assert(elem.K_int.cols() == stab_DG.cols());
+                        assert(elem.RTF.rows() == stab_DG.rows());
+                        assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
+
+                        lhs += beta * stab_DG;
+                        rhs -= beta * stab_DG * m_solution.at(cell_i);
+                        break;
+                    }
+                    case NO:
+                    {
+                        break;
+                    }
+                    default: throw std::invalid_argument("Unknown stabilization");
+                }
+            }
+        }
+        tc.toc();
+        ai.m_time_stab += tc.elapsed();
+
+        bool check_size = true;
+
+        // contact contribution
+        // std::cout << "Cont" << std::endl;
+        if (bnd.cell_has_contact_faces(cl))
+        {
+            const auto cell_infos  = degree_infos.cellDegreeInfo(msh, cl);
+            const auto faces_infos = cell_infos.facesDegreeInfo();
+
+            const auto cell_degree = cell_infos.cell_degree();
+            const auto grad_degree = cell_infos.grad_degree();
+
+            const auto num_cell_dofs = vector_basis_size(cell_degree, mesh_type::dimension, mesh_type::dimension);
+
+            const auto num_faces_dofs  = vector_faces_dofs(msh, faces_infos);
+            const auto num_primal_dofs = num_cell_dofs + num_faces_dofs;
+            const auto num_mult_dofs   = contact_manager.numberOfMult(msh, cl, bnd, cell_infos);
+            const auto num_total_dofs  = num_primal_dofs + num_mult_dofs;
+
+            assert(vector_basis_size(grad_degree, mesh_type::dimension - 1, mesh_type::dimension) == num_mult_dofs);
+
+            vector_type solution           = vector_type::Zero(num_total_dofs);
+            solution.head(num_primal_dofs) = m_solution.at(cell_i);
+
+            const auto fcs_cont = bnd.faces_with_contact(cl);
+
+            size_t offset = num_primal_dofs;
+
+            matrix_type Acont = matrix_type::Zero(num_total_dofs, num_total_dofs);
+            vector_type rcont = vector_type::Zero(num_total_dofs);
+
+            for (auto fc_cont : fcs_cont)
+            {
+                const auto fc_id   = msh.lookup(fc_cont);
+                const auto mult_id = contact_manager.getMappingFaceToMult(fc_id);
+                const auto face_id = contact_manager.getMappingMultToFace(mult_id);
+
+                const auto num_mult_face = m_solution_mult.at(mult_id).size();
+
+                solution.segment(offset, num_mult_face) = m_solution_mult.at(mult_id);
+                rcont.segment(offset, num_mult_face)    = -m_solution_mult.at(mult_id);
+
+                offset += num_mult_face;
+
+                // std::cout << "id: " << fc_id << "->" << mult_id << "->" << face_id << std::endl;
+                // std::cout << "mult: " << m_solution_mult.at(mult_id).transpose() << std::endl;
+            }
+            assert(offset == num_total_dofs);
+
+            Acont.topLeftCorner(num_primal_dofs, num_primal_dofs) = lhs;
+            rcont.head(num_primal_dofs)                           = rhs;
+
+            Acont.bottomRightCorner(num_mult_dofs, num_mult_dofs) =
+              matrix_type::Identity(num_mult_dofs, num_mult_dofs);
+
+            // std::cout << "sol: " << solution.transpose() << std::endl;
+
+            lhs = Acont;
+            rhs = rcont;
+
+            check_size = false;
+
+            assert(size_t(lhs.rows()) == num_total_dofs && size_t(lhs.cols()) == num_total_dofs);
+            assert(size_t(rhs.rows()) == num_total_dofs);
+        }
+
+        // Static Condensation
+        // std::cout << "StatCond" << std::endl;
+        tc.tic();
+        const auto scnp = make_vector_static_condensation_withMatrix(msh, cl, degree_infos, lhs, rhs, check_size);
+
+        m_AL[cell_i] = std::get<1>(scnp);
+        m_bL[cell_i] = std::get<2>(scnp);
+
+        tc.toc();
+        ai.m_time_statcond += tc.elapsed();
+
+        const auto& lc = std::get<0>(scnp);
+        return cell_contribution{lc.first, lc.second, F_int2};
+    }
+
   public:
     NewtonIteration(const mesh_type&                 msh,
                     const bnd_type&                  bnd,
                     const param_type&                rp,
                     const MeshDegreeInfo<mesh_type>& degree_infos,
                     const ContactManager<mesh_type>& contact_manager) :
-      m_verbose(rp.m_verbose)
+      m_F_int(0), m_error(0), m_verbose(rp.m_verbose), m_linear_solver(rp.m_linear_solver),
+      m_cg_precond(rp.m_cg_precond), m_cg_epsilon(rp.m_cg_epsilon), m_cg_iter_max(rp.m_cg_iter_max),
+      m_face_block_size(vector_basis_size(rp.m_face_degree, mesh_type::dimension - 1, mesh_type::dimension))
     {
         m_AL.clear();
         m_AL.resize(msh.cells_size());
@@ -109,6 +453,7 @@ class NewtonIteration
         m_bL.resize(msh.cells_size());
 
         m_assembler = assembler_type(msh, degree_infos, bnd, contact_manager);
+        m_assembler.initialize_pattern(msh, bnd, contact_manager);
     }
 
     bool
@@ -138,6 +483,19 @@ class NewtonIteration
         m_solution_mult = initial_solution_mult;
     }
 
+    /**
+     * @brief Assemble the linearized system of the current iteration.
+     *
+     * The condensed systems of the cells are computed concurrently by rp.m_num_threads threads (1 by
+     * default, 0 means default_num_threads()), each thread with its own mechanical_computation and
+     * AssemblyInfo, by batches of cells. The systems of a batch are then added to the global system in
+     * the order of the cells, so that the result does not depend on the number of threads. The times of
+     * the steps are summed over the threads.
+     *
+     * WARNING: with more than one thread the load function lf, the functions of the boundary conditions
+     * and the behavior law are called concurrently from several threads. They must be thread-safe: no
+     * writes to shared state without synchronization.
+     */
     template<typename LoadFunction>
     AssemblyInfo
     assemble(const mesh_type&                 msh,
@@ -145,236 +503,51 @@ class NewtonIteration
              const param_type&                rp,
              const MeshDegreeInfo<mesh_type>& degree_infos,
              const LoadFunction&              lf,
-             const std::vector<matrix_type>&  gradient_precomputed,
-             const std::vector<matrix_type>&  stab_precomputed,
+             const OperatorStore<scalar_type>& gradient_precomputed,
+             const OperatorStore<scalar_type>& stab_precomputed,
              behavior_type&                   behavior,
              ContactManager<mesh_type>&       contact_manager,
              StabCoeffManager<scalar_type>&   stab_manager)
     {
-        elem_type    elem;
-        AssemblyInfo ai;
+        const size_t num_threads = rp.m_num_threads > 0 ? rp.m_num_threads : default_num_threads();
+
+        std::vector<elem_type>    elems(num_threads);
+        std::vector<AssemblyInfo> ais(num_threads);
+        AssemblyInfo              ai;
 
         // set RHS to zero
         m_assembler.initialize();
         m_F_int = 0.0;
 
-        const bool small_def = (behavior.getDeformation() == SMALL_DEF);
-
-        timecounter tc, ttot;
-
+        timecounter ttot;
         ttot.tic();
-        size_t cell_i = 0;
-
-        for (auto& cl : msh)
-        {
-            // Gradient Reconstruction
-            // std::cout << "Grad" << std::endl;
-            matrix_type GT;
-            tc.tic();
-            if (rp.m_precomputation)
-            {
-                GT = gradient_precomputed[cell_i];
-            }
-            else
-            {
-                if (small_def)
-                {
-                    const auto gradrec_sym_full = make_matrix_symmetric_gradrec(msh, cl, degree_infos);
-                    GT                          = gradrec_sym_full.first;
-                }
-                else
-                {
-                    const auto gradrec_full = make_marix_hho_gradrec(msh, cl, degree_infos);
-                    GT                      = gradrec_full.first;
-                }
-            }
-            tc.toc();
-            ai.m_time_gradrec += tc.elapsed();
-
-            // Begin Assembly
-            // Build rhs and lhs
 
-            // Mechanical Computation
+        const size_t num_cells = msh.cells_size();
+        const size_t batch     = std::min(num_cells, parallel_assembly_batch_size);
 
-            tc.tic();
-            // std::cout << "Elem" << std::endl;
-            elem.compute(msh, cl, rp, degree_infos, lf, GT, m_solution.at(cell_i),
-                        behavior, stab_manager, small_def);
+        std::vector<cell_contribution> contribs(batch);
 
-            matrix_type lhs = elem.K_int;
-            vector_type rhs = elem.RTF;
-            m_F_int += elem.F_int.squaredNorm();
-
-            tc.toc();
-            ai.m_time_elem += tc.elapsed();
-            ai.m_time_law += elem.time_law;
-
-            // Stabilisation Contribution
-            // std::cout << "Stab" << std::endl;
-            tc.tic();
-
-            const auto beta = stab_manager.getValue(msh, cl);
-            // std::cout << beta << std::endl;
+        for (size_t batch_begin = 0; batch_begin < num_cells; batch_begin += batch)
+        {
+            const size_t batch_end = std::min(batch_begin + batch, num_cells);
 
-            if (rp.m_stab)
-            {
-                if (rp.m_precomputation)
-                {
-                    const matrix_type& stab = stab_precomputed.at(cell_i);
-                    assert(elem.K_int.rows() == stab.rows());
-                    assert(elem.K_int.cols() == stab.cols());
-                    assert(elem.RTF.rows() == stab.rows());
-                    assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
-
-                    lhs += beta * stab;
-                    rhs -= beta * stab * m_solution.at(cell_i);
-                }
-                else
-                {
-                    switch (rp.m_stab_type)
-                    {
-                        case HHO:
-                        {
-                            matrix_type stab_HHO;
-                            // we do not make any difference for the displacement reconstruction
-                            // if (small_def)
-                            // {
-                            //     const auto recons = make_vector_hho_symmetric_laplacian(msh, cl, degree_infos);
-                            //     stab_HHO          = make_vector_hho_stabilization(msh, cl, recons.first,
-                            //     degree_infos);
-                            // }
-                            // else
-                            // {
-                            const auto recons_scalar = make_scalar_hho_laplacian(msh, cl, degree_infos);
-                            stab_HHO = make_vector_hho_stabilization_optim(msh, cl, recons_scalar.first, degree_infos);
-                            // }
-
-                            assert(elem.K_int.rows() == stab_HHO.rows());
-                            assert(elem.K_int.cols() == stab_HHO.cols());
-                            assert(elem.RTF.rows() == stab_HHO.rows());
-                            assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
-
-                            lhs += beta * stab_HHO;
-                            rhs -= beta * stab_HHO * m_solution.at(cell_i);
-                            break;
-                        }
-                        case HDG:
-                        {
-                            const auto stab_HDG = make_vector_hdg_stabilization(msh, cl, degree_infos);
-                            assert(elem.K_int.rows() == stab_HDG.rows());
-                            assert(elem.K_int.cols() == stab_HDG.cols());
-                            assert(elem.RTF.rows() == stab_HDG.rows());
-                            assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
-
-                            lhs += beta * stab_HDG;
-                            rhs -= beta * stab_HDG * m_solution.at(cell_i);
-                            break;
-                        }
-                        case DG:
-                        {
-                            const auto stab_DG = make_vector_dg_stabilization(msh, cl, degree_infos);
-                            assert(elem.K_int.rows() == stab_DG.rows());
-                            assert(elem.K_int.cols() == stab_DG.cols());
-                            assert(elem.RTF.rows() == stab_DG.rows());
-                            assert(elem.RTF.cols() == m_solution.at(cell_i).cols());
-
-                            lhs += beta * stab_DG;
-                            rhs -= beta * stab_DG * m_solution.at(cell_i);
-                            break;
-                        }
-                        case NO:
-                        {
-                            break;
-                        }
-                        default: throw std::invalid_argument("Unknown stabilization");
-                    }
-                }
-            }
-            tc.toc();
-            ai.m_time_stab += tc.elapsed();
+            auto compute = [&](size_t cell_i, size_t tid) {
+                const auto cl = *std::next(msh.cells_begin(), cell_i);
+                contribs[cell_i - batch_begin] = compute_cell(msh, cl, cell_i, bnd, rp, degree_infos, lf,
+                                                              gradient_precomputed, stab_precomputed, behavior,
+                                                              contact_manager, stab_manager, elems[tid], ais[tid]);
+            };
 
-            bool check_size = true;
+            parallel_for(batch_begin, batch_end, compute, num_threads);
 
-            // contact contribution
-            // std::cout << "Cont" << std::endl;
-            if (bnd.cell_has_contact_faces(cl))
+            for (size_t cell_i = batch_begin; cell_i < batch_end; cell_i++)
             {
-                const auto cell_infos  = degree_infos.cellDegreeInfo(msh, cl);
-                const auto faces_infos = cell_infos.facesDegreeInfo();
-
-                const auto cell_degree = cell_infos.cell_degree();
-                const auto grad_degree = cell_infos.grad_degree();
-
-                const auto num_cell_dofs = vector_basis_size(cell_degree, mesh_type::dimension, mesh_type::dimension);
-
-                const auto num_faces_dofs  = vector_faces_dofs(msh, faces_infos);
-                const auto num_primal_dofs = num_cell_dofs + num_faces_dofs;
-                const auto num_mult_dofs   = contact_manager.numberOfMult(msh, cl, bnd, cell_infos);
-                const auto num_total_dofs  = num_primal_dofs + num_mult_dofs;
-
-                assert(vector_basis_size(grad_degree, mesh_type::dimension - 1, mesh_type::dimension) == num_mult_dofs);
-
-                vector_type solution           = vector_type::Zero(num_total_dofs);
-                solution.head(num_primal_dofs) = m_solution.at(cell_i);
-
-                const auto fcs_cont = bnd.faces_with_contact(cl);
-
-                size_t offset = num_primal_dofs;
-
-                matrix_type Acont = matrix_type::Zero(num_total_dofs, num_total_dofs);
-                vector_type rcont = vector_type::Zero(num_total_dofs);
-
-                for (auto fc_cont : fcs_cont)
-                {
-                    const auto fc_id   = msh.lookup(fc_cont);
-                    const auto mult_id = contact_manager.getMappingFaceToMult(fc_id);
-                    const auto face_id = contact_manager.getMappingMultToFace(mult_id);
+                const auto  cl = *std::next(msh.cells_begin(), cell_i);
+                const auto& lc = contribs[cell_i - batch_begin];
 
-                    const auto num_mult_face = m_solution_mult.at(mult_id).size();
-
-                    solution.segment(offset, num_mult_face) = m_solution_mult.at(mult_id);
-                    rcont.segment(offset, num_mult_face)    = -m_solution_mult.at(mult_id);
-
-                    offset += num_mult_face;
-
-                    // std::cout << "id: " << fc_id << "->" << mult_id << "->" << face_id << std::endl;
-                    // std::cout << "mult: " << m_solution_mult.at(mult_id).transpose() << std::endl;
-                }
-                assert(offset == num_total_dofs);
-
-                Acont.topLeftCorner(num_primal_dofs, num_primal_dofs) = lhs;
-                rcont.head(num_primal_dofs)                           = rhs;
-
-                Acont.bottomRightCorner(num_mult_dofs, num_mult_dofs) =
-                  matrix_type::Identity(num_mult_dofs, num_mult_dofs);
-
-                // std::cout << "sol: " << solution.transpose() << std::endl;
-
-                lhs = Acont;
-                rhs = rcont;
-
-                check_size = false;
-
-                assert(lhs.rows() == num_total_dofs && lhs.cols() == num_total_dofs);
-                assert(rhs.rows() == num_total_dofs);
+                m_F_int += lc.F_int2;
+                m_assembler.assemble_nonlinear(msh, cl, bnd, contact_manager, lc.lhs, lc.rhs, m_solution_faces);
             }
-
-            // Static Condensation
-            // std::cout << "StatCond" << std::endl;
-            tc.tic();
-            const auto scnp = make_vector_static_condensation_withMatrix(msh, cl, degree_infos, lhs, rhs, check_size);
-
-            m_AL[cell_i] = std::get<1>(scnp);
-            m_bL[cell_i] = std::get<2>(scnp);
-
-            tc.toc();
-            ai.m_time_statcond += tc.elapsed();
-
-            const auto& lc = std::get<0>(scnp);
-            // std::cout << "Assemb" << std::endl;
-            m_assembler.assemble_nonlinear(msh, cl, bnd, contact_manager, lc.first, lc.second, m_solution_faces);
-
-            cell_i++;
         }
 
         m_F_int = sqrt(m_F_int);
@@ -383,6 +556,9 @@ class NewtonIteration
         m_assembler.impose_neumann_boundary_conditions(msh, bnd);
         m_assembler.finalize();
 
+        for (auto& ai_thread : ais)
+            ai += ai_thread;
+
         ttot.toc();
         ai.m_time_assembly      = ttot.elapsed();
         ai.m_linear_system_size = m_assembler.LHS.rows();
@@ -398,13 +574,27 @@ class NewtonIteration
         tc.tic();
         m_system_solution = vector_type::Zero(m_assembler.LHS.rows());
 
-        solvers::pardiso_params<scalar_type> pparams;
-        mkl_pardiso(pparams, m_assembler.LHS, m_assembler.RHS, m_system_solution);
+        /* The first solver of the chain that works is kept for the next
+         * iterations. When all of them fail the increment is meaningless:
+         * the failure is reported to the caller, which abandons the step. */
+        const auto solved = solve_with_fallback(m_linear_solver,
+                                                [](LinearSolverType ls) { return available(ls); },
+                                                [&](LinearSolverType ls) {
+                                                    return (ls == LinearSolverType::ITERATIVE_CG) ? solve_cg()
+                                                                                                  : solve_direct(ls);
+                                                });
+
+        if (solved && *solved != m_linear_solver)
+        {
+            std::cout << "Linear solver " << m_linear_solver << " not available or failed, ";
+            std::cout << "using " << *solved << std::endl;
+            m_linear_solver = *solved;
+        }
         tc.toc();
 
         // std::cout << "end solve" << std::endl;
 
-        return SolveInfo(m_assembler.LHS.rows(), m_assembler.LHS.nonZeros(), tc.elapsed());
+        return SolveInfo(m_assembler.LHS.rows(), m_assembler.LHS.nonZeros(), tc.elapsed(), solved.has_value());
     }
 
     scalar_type
@@ -561,6 +751,7 @@ class NewtonIteration
         }
 
         const scalar_type error = std::max(relative_displ, relative_error);
+        m_error                 = error;
 
         if (!isfinite(error))
             throw std::runtime_error("Norm of residual is not finite");
@@ -575,6 +766,15 @@ class NewtonIteration
         }
     }
 
+    /**
+     * @brief Error computed by the last call to convergence()
+     */
+    scalar_type
+    error(void) const
+    {
+        return m_error;
+    }
+
     void
     save_solutions(std::vector<vector_type>& solution,
                    std::vector<vector_type>& solution_faces,
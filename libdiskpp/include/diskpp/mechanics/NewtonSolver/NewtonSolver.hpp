@@ -32,9 +32,11 @@
 #include <sstream>
 #include <vector>
 
+#include "Checkpoint.hpp"
 #include "NewtonSolverInformations.hpp"
 #include "NewtonSolverParameters.hpp"
 #include "NewtonStep.hpp"
+#include "OperatorStore.hpp"
 #include "TimeManager.hpp"
 #include "diskpp/mechanics/behaviors/laws/behaviorlaws.hpp"
 #include "diskpp/mechanics/behaviors/tensor_conversion.hpp"
@@ -46,6 +48,7 @@
 #include "diskpp/boundary_conditions/boundary_conditions.hpp"
 #include "diskpp/methods/hho"
 
+#include "diskpp/output/gmshBinary.hpp"
 #include "diskpp/output/gmshConvertMesh.hpp"
 #include "diskpp/output/gmshDisk.hpp"
 #include "diskpp/output/postMesh.hpp"
@@ -94,7 +97,7 @@ class NewtonSolver
     StabCoeffManager<scalar_type> m_stab_manager;
 
     std::vector<vector_type> m_solution, m_solution_faces, m_solution_mult;
-    std::vector<matrix_type> m_gradient_precomputed, m_stab_precomputed;
+    OperatorStore<scalar_type> m_gradient_precomputed, m_stab_precomputed;
 
     PostMesh<mesh_type> m_post_mesh;
 
@@ -227,9 +230,11 @@ class NewtonSolver
     pre_computation(void)
     {
         m_gradient_precomputed.clear();
+        m_gradient_precomputed.setOptions(false, m_rp.m_precomputation_float);
         m_gradient_precomputed.reserve(m_msh.cells_size());
 
         m_stab_precomputed.clear();
+        m_stab_precomputed.setOptions(m_rp.m_precomputation_symmetric, m_rp.m_precomputation_float);
         m_stab_precomputed.reserve(m_msh.cells_size());
 
         for (auto& cl : m_msh)
@@ -288,6 +293,56 @@ class NewtonSolver
         }
     }
 
+    /**
+     * @brief Write the state of the computation after a converged time step in a checkpoint: the time steps,
+     * the solutions, the stabilization coefficients and the internal variables of the behavior
+     *
+     */
+    void
+    write_checkpoint(CheckpointOutput&                  out,
+                     const ListOfTimeStep<scalar_type>& list_time_step,
+                     const NewtonStep<mesh_type>&       newton_step) const
+    {
+        out.write(uint64_t(mesh_type::dimension));
+        out.write(uint64_t(sizeof(scalar_type)));
+        out.write(uint64_t(m_msh.cells_size()));
+        out.write(uint64_t(m_msh.faces_size()));
+
+        list_time_step.save(out);
+        out.write(newton_step.solution());
+        out.write(newton_step.solution_faces());
+        out.write(newton_step.solution_mult());
+        m_stab_manager.save(out);
+        m_behavior.saveState(out);
+    }
+
+    /**
+     * @brief Read a checkpoint written by write_checkpoint(). The mesh, the degrees and the behavior have to be
+     * the ones of the computation that wrote it.
+     *
+     */
+    void
+    read_checkpoint(const std::string& filename, ListOfTimeStep<scalar_type>& list_time_step)
+    {
+        const CheckpointReader reader(filename);
+        CheckpointInput        in = reader.payload();
+
+        in.expect(uint64_t(mesh_type::dimension), "dimension");
+        in.expect(uint64_t(sizeof(scalar_type)), "scalar type");
+        in.expect(uint64_t(m_msh.cells_size()), "number of cells");
+        in.expect(uint64_t(m_msh.faces_size()), "number of faces");
+
+        list_time_step.load(in);
+        in.read(m_solution);
+        in.read(m_solution_faces);
+        in.read(m_solution_mult);
+        m_stab_manager.load(in);
+        m_behavior.loadState(in);
+
+        if (!in.end())
+            throw std::runtime_error("Checkpoint: unexpected data at the end of " + filename);
+    }
+
   public:
     NewtonSolver(const mesh_type& msh, const bnd_type& bnd, const param_type& rp) :
       m_msh(msh), m_verbose(rp.m_verbose), m_convergence(false), m_rp(rp), m_bnd(bnd), m_stab_manager(msh, rp.m_beta)
@@ -457,7 +512,8 @@ class NewtonSolver
 #endif
 
     /**
-     * @brief Add a behavior for materials (by copy)
+     * @brief Add a behavior for materials (by copy). The solver works on its own copy of the internal
+     * variables, the given behavior is not modified by the solver.
      *
      * @param behavior Given behavior
      */
@@ -501,7 +557,11 @@ class NewtonSolver
             this->pre_computation();
             t1.toc();
             if (m_verbose)
+            {
                 std::cout << "Precomputation: " << t1.elapsed() << " sec" << std::endl;
+                m_gradient_precomputed.memoryReport("** Gradient operators");
+                m_stab_precomputed.memoryReport("** Stabilization operators");
+            }
         }
 
         SolverInfo  si;
@@ -515,16 +575,40 @@ class NewtonSolver
         else
             list_time_step = ListOfTimeStep<scalar_type>(m_rp.m_time_step);
 
+        // restart from the last converged time step of a checkpoint
+        if (!m_rp.m_restart_file.empty())
+        {
+            this->read_checkpoint(m_rp.m_restart_file, list_time_step);
+
+            if (!list_time_step.empty())
+            {
+                const auto restart_time = list_time_step.getCurrentTimeStep().start_time();
+                while (!m_rp.m_time_save.empty() && m_rp.m_time_save.front() < restart_time + 1E-5)
+                    m_rp.m_time_save.pop_front();
+
+                if (m_verbose)
+                    std::cout << "** Restart at time: " << restart_time << " (" << m_rp.m_restart_file << ")"
+                              << std::endl;
+            }
+        }
+
         if (m_verbose)
             std::cout << "** Number of time step: " << list_time_step.numberOfTimeStep() << std::endl;
 
+        // length of the time steps if they are adapted
+        const TimeStepController<scalar_type> time_step_controller(m_rp.m_time_step_target_iter);
+
         // time of saving
         bool time_saving = false;
-        if (m_rp.m_n_time_save > 0)
+        if (m_rp.m_n_time_save > 0 && !m_rp.m_time_save.empty())
         {
             time_saving = true;
         }
 
+        // checkpoints and fields at the quadrature points are written to the disk while the computation continues
+        CheckpointWriter checkpoint_writer;
+        GmshAsyncWriter  post_writer;
+
         // Newton step
         NewtonStep<mesh_type> newton_step(m_rp);
         newton_step.initialize(m_solution, m_solution_faces, m_solution_mult);
@@ -570,6 +654,10 @@ class NewtonSolver
 
             if (!m_convergence)
             {
+                // the internal variables come back to the last converged step, the solution of the
+                // Newton's step is only replaced when it converges
+                m_behavior.rollback();
+
                 if (current_step.level() + 1 > m_rp.m_sublevel)
                 {
                     std::cout << "***********************************************************" << std::endl;
@@ -586,7 +674,17 @@ class NewtonSolver
                         std::cout << "***********************************************************" << std::endl;
                     }
 
-                    list_time_step.splitCurrentTimeStep();
+                    if (m_rp.m_adapt_time_step)
+                    {
+                        const std::vector<scalar_type> errors(newton_info.m_errors.begin(),
+                                                              newton_info.m_errors.end());
+                        list_time_step.splitCurrentTimeStep(
+                          time_step_controller.ratioAfterFailure(errors, m_rp.m_iter_max, m_rp.m_epsilon));
+                    }
+                    else
+                    {
+                        list_time_step.splitCurrentTimeStep();
+                    }
                 }
             }
             else
@@ -595,6 +693,13 @@ class NewtonSolver
                 m_behavior.update();
                 m_stab_manager.update();
 
+                if (m_rp.m_adapt_time_step && !list_time_step.empty())
+                {
+                    const auto length = current_step.end_time() - current_step.start_time();
+                    list_time_step.resizeCurrentTimeStep(
+                      time_step_controller.ratioAfterConvergence(newton_info.m_iter) * length);
+                }
+
                 if (time_saving)
                 {
                     if (m_rp.m_time_save.front() < current_time + 1E-5)
@@ -607,24 +712,35 @@ class NewtonSolver
 
                         this->output_discontinuous_displacement(name + "depl_disc.msh");
                         this->output_continuous_displacement(name + "depl_cont.msh");
-                        this->output_CauchyStress_GP(name + "CauchyStress_GP.msh");
-                        this->output_CauchyStress_GP(name + "CauchyStress_GP_def.msh", true);
+                        post_writer.write(name + "CauchyStress_GP.msh", this->make_CauchyStress_GP());
+                        post_writer.write(name + "CauchyStress_GP_def.msh", this->make_CauchyStress_GP(true));
                         this->output_discontinuous_deformed(name + "deformed_disc.msh");
-                        this->output_is_plastic_GP(name + "plastic_GP.msh");
+                        post_writer.write(name + "plastic_GP.msh", this->make_is_plastic_GP());
                         this->output_stabCoeff(name + "stabCoeff.msh");
-                        this->output_equivalentPlasticStrain_GP(name + "equivalentPlasticStrain_GP.msh");
+                        post_writer.write(name + "equivalentPlasticStrain_GP.msh",
+                                          this->make_equivalentPlasticStrain_GP());
 
                         m_rp.m_time_save.pop_front();
                         if (m_rp.m_time_save.empty())
                             time_saving = false;
                     }
                 }
+
+                if (m_rp.m_checkpoint_freq > 0 &&
+                    list_time_step.numberOfTimeStepRealized() % m_rp.m_checkpoint_freq == 0)
+                {
+                    checkpoint_writer.write(m_rp.m_checkpoint_file,
+                                            [&](CheckpointOutput& out)
+                                            { this->write_checkpoint(out, list_time_step, newton_step); });
+                }
             }
         }
 
         // save solutions
         newton_step.save_solutions(m_solution, m_solution_faces, m_solution_mult);
         si.m_time_step = list_time_step.numberOfTimeStep();
+        checkpoint_writer.wait();
+        post_writer.wait();
 
         ttot.toc();
         si.m_time_solver = ttot.elapsed();
@@ -880,177 +996,186 @@ class NewtonSolver
         nodedata.saveNodeData(filename, gmsh);
     }
 
-    void
-    output_CauchyStress_GP(const std::string& filename, bool def = false) const
+    /**
+     * @brief Snapshot of the post-processing mesh with a node at each quadrature point, and a field with
+     * num_comp components at these nodes. For each cell, fun(cl, cell_i, add_qp) calls add_qp(coor) for each
+     * quadrature point, which adds the node and returns where to write its values.
+     *
+     */
+    template<typename Function>
+    GmshBinaryData
+    make_GP_output(const std::string& name, const int num_comp, const Function& fun) const
     {
-        gmsh::Gmesh gmsh = convertMesh(m_post_mesh);
+        const size_t nb_qp = m_behavior.numberOfQP();
 
-        std::vector<gmsh::Data>    data;    // create data (not used)
-        std::vector<gmsh::SubData> subdata; // create subdata to save soution at gauss point
-        size_t                     nb_nodes(gmsh.getNumberofNodes());
+        GmshBinaryData data = make_gmsh_binary_mesh(m_post_mesh, nb_qp);
+        data.reserveElements(GMSH_POINT, nb_qp);
+
+        const int            first_node = data.numberOfNodes() + 1;
+        std::vector<double>& values     = data.addNodeView(name, num_comp, first_node, nb_qp);
+
+        auto add_qp = [&](const std::array<double, 3>& coor) -> double*
+        {
+            const int node = data.addNode(coor);
+            data.addElement(GMSH_POINT, &node);
+            return values.data() + num_comp * (node - first_node);
+        };
 
         int cell_i = 0;
         for (auto& cl : m_msh)
         {
-            const auto di = m_degree_infos.cellDegreeInfo(m_msh, cl);
-
-            const auto  uTF = m_solution.at(cell_i);
-            matrix_type gr;
-            if (m_rp.m_precomputation)
-            {
-                gr = m_gradient_precomputed.at(cell_i);
-            }
-            else
-            {
-                if (m_behavior.getDeformation() == SMALL_DEF)
-                {
-                    gr = make_matrix_symmetric_gradrec(m_msh, cl, m_degree_infos).first;
-                }
-                else
-                {
-                    gr = make_marix_hho_gradrec(m_msh, cl, m_degree_infos).first;
-                }
-            }
-
-            const vector_type GTuTF = gr * uTF;
-
-            const auto gb  = make_matrix_monomial_basis(m_msh, cl, di.grad_degree());
-            const auto gbs = make_sym_matrix_monomial_basis(m_msh, cl, di.grad_degree());
-
-            const auto              cb = make_vector_monomial_basis(m_msh, cl, di.cell_degree());
-            const vector_type uT  = uTF.head(cb.size());
-
-            // Loop on nodes
-            const auto nb_qp = m_behavior.numberOfQP(cell_i);
-
-            for (int i_qp = 0; i_qp < nb_qp; i_qp++)
-            {
-                const auto          qp = m_behavior.quadrature_point(cell_i, i_qp);
-                std::vector<double> tens;
-
-                if (m_behavior.getDeformation() == SMALL_DEF)
-                {
-                    auto stress = m_behavior.compute_stress3D(cell_i, i_qp);
-                    tens        = convertToVectorGmsh(stress);
-                }
-                else
-                {
-                    const auto gphi      = gb.eval_functions(qp.point());
-                    const auto GT_iqn    = eval(GTuTF, gphi);
-                    const auto FT_iqn    = convertGtoF(GT_iqn);
-                    const auto FT_iqn_3D = convertMatrix3DwithOne(FT_iqn);
-
-                    auto P      = m_behavior.compute_stress3D(cell_i, i_qp);
-                    auto stress = convertPK1toCauchy(P, FT_iqn_3D);
-                    tens        = convertToVectorGmsh(stress);
-                }
-
-                std::array<double, 3> coor = init_coor(qp.point());
-
-                if(def)
-                {
-                    const auto cphi = cb.eval_functions(qp.point());
-                    const auto depl = eval(uT, cphi);
-
-                    // Compute new coordinates
-                    for (int j = 0; j < mesh_type::dimension; j++)
-                        coor[j] += depl(j);
-                }
-
-                // Add GP
-                // Create a node at gauss point
-                nb_nodes++;
-                const gmsh::Node    new_node(coor, nb_nodes, 0);
-                const gmsh::SubData sdata(tens, new_node);
-                subdata.push_back(sdata); // add subdata
-            }
+            fun(cl, cell_i, add_qp);
             cell_i++;
         }
 
-        // Save
-        gmsh::NodeData nodedata(9, 0.0, "CauchyStress_GP", data, subdata); // create and init a nodedata view
-
-        nodedata.saveNodeData(filename, gmsh); // save the view
+        return data;
     }
 
-    void
-    output_is_plastic_GP(const std::string& filename) const
+    /**
+     * @brief Snapshot of the Cauchy stress at the quadrature points, on the deformed configuration if def
+     *
+     */
+    GmshBinaryData
+    make_CauchyStress_GP(bool def = false) const
     {
-        gmsh::Gmesh gmsh = convertMesh(m_post_mesh);
-
-        std::vector<gmsh::Data>    data;    // create data (not used)
-        std::vector<gmsh::SubData> subdata; // create subdata to save soution at gauss point
-        size_t                     nb_nodes(gmsh.getNumberofNodes());
-
-        int cell_i = 0;
-        for (auto& cl : m_msh)
-        {
-            // Loop on nodes
-            const auto nb_qp = m_behavior.numberOfQP(cell_i);
-
-            for (int i_qp = 0; i_qp < nb_qp; i_qp++)
-            {
-                const auto qp = m_behavior.quadrature_point(cell_i, i_qp);
-
-                scalar_type p = 0;
-                if (m_behavior.is_plastic(cell_i, i_qp))
-                    p = 1;
+        return this->make_GP_output(
+          "CauchyStress_GP",
+          9,
+          [&](const auto& cl, const int cell_i, const auto& add_qp)
+          {
+              const auto di = m_degree_infos.cellDegreeInfo(m_msh, cl);
+
+              const auto  uTF = m_solution.at(cell_i);
+              matrix_type gr;
+              if (m_rp.m_precomputation)
+              {
+                  gr = m_gradient_precomputed.at(cell_i);
+              }
+              else
+              {
+                  if (m_behavior.getDeformation() == SMALL_DEF)
+                  {
+                      gr = make_matrix_symmetric_gradrec(m_msh, cl, m_degree_infos).first;
+                  }
+                  else
+                  {
+                      gr = make_marix_hho_gradrec(m_msh, cl, m_degree_infos).first;
+                  }
+              }
+
+              const vector_type GTuTF = gr * uTF;
+
+              const auto gb = make_matrix_monomial_basis(m_msh, cl, di.grad_degree());
+
+              const auto        cb = make_vector_monomial_basis(m_msh, cl, di.cell_degree());
+              const vector_type uT = uTF.head(cb.size());
+
+              // Loop on nodes
+              const auto nb_qp = m_behavior.numberOfQP(cell_i);
+
+              for (size_t i_qp = 0; i_qp < nb_qp; i_qp++)
+              {
+                  const auto qp = m_behavior.quadrature_point(cell_i, i_qp);
+
+                  static_matrix<scalar_type, 3, 3> stress;
+                  if (m_behavior.getDeformation() == SMALL_DEF)
+                  {
+                      stress = m_behavior.compute_stress3D(cell_i, i_qp);
+                  }
+                  else
+                  {
+                      const auto gphi      = gb.eval_functions(qp.point());
+                      const auto GT_iqn    = eval(GTuTF, gphi);
+                      const auto FT_iqn    = convertGtoF(GT_iqn);
+                      const auto FT_iqn_3D = convertMatrix3DwithOne(FT_iqn);
+
+                      const auto P = m_behavior.compute_stress3D(cell_i, i_qp);
+                      stress       = convertPK1toCauchy(P, FT_iqn_3D);
+                  }
+
+                  std::array<double, 3> coor = init_coor(qp.point());
+
+                  if (def)
+                  {
+                      const auto cphi = cb.eval_functions(qp.point());
+                      const auto depl = eval(uT, cphi);
+
+                      // Compute new coordinates
+                      for (size_t j = 0; j < mesh_type::dimension; j++)
+                          coor[j] += depl(j);
+                  }
+
+                  // Add GP
+                  double* tens = add_qp(coor);
+                  for (int j = 0; j < 3; j++)
+                      for (int i = 0; i < 3; i++)
+                          tens[i + 3 * j] = stress(i, j);
+              }
+          });
+    }
 
-                const std::vector<double> p_s = convertToVectorGmsh(p);
+    /**
+     * @brief Snapshot of the plastic state (0 or 1) at the quadrature points
+     *
+     */
+    GmshBinaryData
+    make_is_plastic_GP(void) const
+    {
+        return this->make_GP_output("state_GP",
+                                    1,
+                                    [&](const auto&, const int cell_i, const auto& add_qp)
+                                    {
+                                        const auto nb_qp = m_behavior.numberOfQP(cell_i);
+
+                                        for (size_t i_qp = 0; i_qp < nb_qp; i_qp++)
+                                        {
+                                            const auto qp = m_behavior.quadrature_point(cell_i, i_qp);
+
+                                            *add_qp(init_coor(qp.point())) =
+                                              m_behavior.is_plastic(cell_i, i_qp) ? 1.0 : 0.0;
+                                        }
+                                    });
+    }
 
-                // Add GP
-                // Create a node at gauss point
-                nb_nodes++;
-                const gmsh::Node    new_node = convertPoint(qp.point(), nb_nodes);
-                const gmsh::SubData sdata(p_s, new_node);
-                subdata.push_back(sdata); // add subdata
-            }
-            cell_i++;
-        }
+    /**
+     * @brief Snapshot of the equivalent plastic strain at the quadrature points
+     *
+     */
+    GmshBinaryData
+    make_equivalentPlasticStrain_GP(void) const
+    {
+        return this->make_GP_output("equivalentPlasticStrain_GP",
+                                    1,
+                                    [&](const auto&, const int cell_i, const auto& add_qp)
+                                    {
+                                        const auto nb_qp = m_behavior.numberOfQP(cell_i);
+
+                                        for (size_t i_qp = 0; i_qp < nb_qp; i_qp++)
+                                        {
+                                            const auto qp = m_behavior.quadrature_point(cell_i, i_qp);
+
+                                            *add_qp(init_coor(qp.point())) =
+                                              m_behavior.equivalentPlasticStrain(cell_i, i_qp);
+                                        }
+                                    });
+    }
 
-        // Save
-        gmsh::NodeData nodedata(1, 0.0, "state_GP", data, subdata); // create and init a nodedata view
+    void
+    output_CauchyStress_GP(const std::string& filename, bool def = false) const
+    {
+        this->make_CauchyStress_GP(def).write(filename);
+    }
 
-        nodedata.saveNodeData(filename, gmsh); // save the view
+    void
+    output_is_plastic_GP(const std::string& filename) const
+    {
+        this->make_is_plastic_GP().write(filename);
     }
 
     void
     output_equivalentPlasticStrain_GP(const std::string& filename) const
     {
-        gmsh::Gmesh gmsh = convertMesh(m_post_mesh);
-
-        std::vector<gmsh::Data>    data;    // create data (not used)
-        std::vector<gmsh::SubData> subdata; // create subdata to save soution at gauss point
-        size_t                     nb_nodes(gmsh.getNumberofNodes());
-
-        int cell_i = 0;
-        for (auto& cl : m_msh)
-        {
-            // Loop on nodes
-            const auto nb_qp = m_behavior.numberOfQP(cell_i);
-
-            for (int i_qp = 0; i_qp < nb_qp; i_qp++)
-            {
-                const auto qp = m_behavior.quadrature_point(cell_i, i_qp);
-
-                scalar_type p = m_behavior.equivalentPlasticStrain(cell_i, i_qp);
-
-                const std::vector<double> p_s = convertToVectorGmsh(p);
-
-                // Add GP
-                // Create a node at gauss point
-                nb_nodes++;
-                const gmsh::Node    new_node = convertPoint(qp.point(), nb_nodes);
-                const gmsh::SubData sdata(p_s, new_node);
-                subdata.push_back(sdata); // add subdata
-            }
-            cell_i++;
-        }
-
-        // Save
-        gmsh::NodeData nodedata(1, 0.0, "equivalentPlasticStrain_GP", data, subdata); // create and init a nodedata view
-
-        nodedata.saveNodeData(filename, gmsh); // save the view
+        this->make_equivalentPlasticStrain_GP().write(filename);
     }
 
     void
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <cassert>
+#include <vector>
 
 #include "diskpp/bases/bases.hpp"
 #include "diskpp/common/eigen.hpp"
@@ -65,21 +66,33 @@ class mechanical_computation
 
     bool two_dim;
 
+    /* Workspace of compute(), resized on the first cells and then reused:
+     * the gradient basis functions at the quadrature points, stored by
+     * blocks of grad_basis_size functions per point, A : gphi at one point,
+     * and the strain, stress and tangent modulus at each point. */
+    eigen_compatible_stdvector<static_matrix_type> m_gphis;
+    eigen_compatible_stdvector<static_matrix_type> m_A_gphi;
+    eigen_compatible_stdvector<static_matrix_type> m_strains;
+    eigen_compatible_stdvector<static_matrix_type> m_stresses;
+    eigen_compatible_stdvector<static_tensor_type> m_Ceps;
+
     /**
      * @brief Compute A : gphi for finite deformation
      *
      * @param A fourth-order tangent modulus
      * @param gphi set of basis function for gradient reconstruction
-     * @return eigen_compatible_stdvector<static_matrix_type> A : gphi
+     * @param grad_basis_size number of basis functions
+     * @param Aphi A : gphi (output, resized to grad_basis_size)
      */
-    eigen_compatible_stdvector<static_matrix_type>
-    compute_A_gphi(const static_tensor_type& A, const eigen_compatible_stdvector<static_matrix_type>& gphi) const
+    void
+    compute_A_gphi(const static_tensor_type&                       A,
+                   const static_matrix_type*                       gphi,
+                   const size_t                                    grad_basis_size,
+                   eigen_compatible_stdvector<static_matrix_type>& Aphi) const
     {
-        const auto grad_basis_size = gphi.size();
-        const auto DIM2            = dimension * dimension;
+        const auto DIM2 = dimension * dimension;
 
-        disk::eigen_compatible_stdvector<static_matrix_type> Aphi;
-        Aphi.reserve(grad_basis_size);
+        Aphi.resize(grad_basis_size);
 
         // poly classique
         for (size_t i = 0; i < grad_basis_size; i += DIM2)
@@ -89,55 +102,21 @@ class mechanical_computation
             { // depend de l'ordre des bases
                 for (size_t l = 0; l < dimension; l++)
                 { // depend de l'ordre des bases
-                    Aphi.push_back(disk::tm_prod(A, gphi[row], l, k));
+                    Aphi[row] = disk::tm_prod(A, gphi[row], l, k);
                     row++;
                 }
             }
         }
-
-        return Aphi;
-    }
-
-    /**
-     * @brief Compute the stress tensor and the tangent modulus at the given qudature point
-     *  - in small deformation Cauchy and Cep
-     *  - in finite deformation PK1 and A
-     * @tparam QPType Type of law at the quadrature point
-     * @tparam LawData Type for material data
-     * @param qp A behavior quadrature point where we compute the constitutive law
-     * @param RkT_iqn Reconstruction operator evaluated at the quadrature point (symmetric gradient)
-     * in small deformation and gradient in finite deformation)
-     * @param small_def small deformation yes or no
-     * @return std::pair<static_matrix_type, static_tensor_type> stress tensor and the tangent modulus
-     */
-
-    std::pair<static_matrix_type, static_tensor_type>
-    compute_behavior(behavior_type&            behavior,
-                     const size_t&             cell_id,
-                     const size_t&             qp_id,
-                     const static_matrix_type& RkT_iqn,
-                     const bool                small_def,
-                     const bool                use_tangent_modulus) const
-    {
-        if (small_def)
-        {
-            return behavior.compute_whole(cell_id, qp_id, RkT_iqn, use_tangent_modulus);
-        }
-        else
-        {
-            const auto FT_iqn = convertGtoF(RkT_iqn);
-            return behavior.compute_whole(cell_id, qp_id, FT_iqn, use_tangent_modulus);
-        }
     }
 
     void
-    compute_rigidity(const static_tensor_type&                             Cep,
-                     const eigen_compatible_stdvector<static_matrix_type>& gphi,
-                     const bool&                                           small_def,
-                     const scalar_type                                     weight,
-                     const size_t                                          grad_dim_dofs,
-                     const size_t                                          grad_basis_size,
-                     matrix_type&                                          AT) const
+    compute_rigidity(const static_tensor_type& Cep,
+                     const static_matrix_type* gphi,
+                     const bool&               small_def,
+                     const scalar_type         weight,
+                     const size_t              grad_dim_dofs,
+                     const size_t              grad_basis_size,
+                     matrix_type&              AT)
     {
         // std::cout << "module : " << Cep << std::endl;
         if (small_def)
@@ -174,7 +153,8 @@ class mechanical_computation
         else
         {
             // lower part
-            const auto qp_A_gphi = compute_A_gphi(weight * Cep, gphi);
+            compute_A_gphi(weight * Cep, gphi, grad_basis_size, m_A_gphi);
+            const auto& qp_A_gphi = m_A_gphi;
 
             for (size_t j = 0; j < grad_basis_size; j += grad_dim_dofs)
             {
@@ -227,13 +207,13 @@ class mechanical_computation
     }
 
     void
-    compute_internal_forces(const static_matrix_type&                             stress,
-                            const eigen_compatible_stdvector<static_matrix_type>& gphi,
-                            const bool&                                           small_def,
-                            const scalar_type                                     weight,
-                            const size_t                                          grad_dim_dofs,
-                            const size_t                                          grad_basis_size,
-                            vector_type&                                          aT) const
+    compute_internal_forces(const static_matrix_type& stress,
+                            const static_matrix_type* gphi,
+                            const bool&               small_def,
+                            const scalar_type         weight,
+                            const size_t              grad_dim_dofs,
+                            const size_t              grad_basis_size,
+                            vector_type&              aT) const
     {
         //   std::cout << "stress" << std::endl;
         //   std::cout << stress << std::endl;
@@ -324,16 +304,16 @@ class mechanical_computation
 
     template<typename Function>
     void
-    compute(const mesh_type&                 msh,
-            const cell_type&                 cl,
-            const param_type&                rp,
-            const MeshDegreeInfo<mesh_type>& degree_infos,
-            const Function&                  load,
-            const matrix_type&               RkT,
-            const vector_type&               uTF,
-            behavior_type&                   behavior,
-            StabCoeffManager<scalar_type>&   stab_manager,
-            const bool                       small_def)
+    compute(const mesh_type&                     msh,
+            const cell_type&                     cl,
+            const param_type&                    rp,
+            const MeshDegreeInfo<mesh_type>&     degree_infos,
+            const Function&                      load,
+            const Eigen::Ref<const matrix_type>& RkT,
+            const vector_type&                   uTF,
+            behavior_type&                       behavior,
+            StabCoeffManager<scalar_type>&       stab_manager,
+            const bool                           small_def)
     {
         time_law     = 0.0;
         time_contact = 0.0;
@@ -383,48 +363,48 @@ class mechanical_computation
         const auto gb  = make_matrix_monomial_basis(msh, cl, grad_degree);
         const auto gbs = make_sym_matrix_monomial_basis(msh, cl, grad_degree);
 
-        eigen_compatible_stdvector<static_matrix_type> gphi;
-
         const auto cell_id             = msh.lookup(cl);
         const auto nb_qp               = behavior.numberOfQP(cell_id);
         const bool use_tangent_modulus = true;
 
-        scalar_type beta_comp = 0.0, total_weight = 0.0;
+        // Compute the gradient basis functions and the local gradient at all the quadrature points
+        auto& strains = m_strains;
+        m_gphis.resize(nb_qp * grad_basis_size);
+        strains.resize(nb_qp);
         for (int i_qp = 0; i_qp < nb_qp; i_qp++)
         {
-            // Compute gradient basis function
             const auto qp = behavior.quadrature_point(cell_id, i_qp);
-            // std::cout << "qp: " << qp.point() << std::endl;
 
-            if (small_def)
-            {
-                gphi = gbs.eval_functions(qp.point());
-            }
-            else
+            const auto phi = small_def ? gbs.eval_functions(qp.point()) : gb.eval_functions(qp.point());
+            assert(phi.size() == grad_basis_size);
+
+            // RkT_iqn = Grad_sym for small def else RkT_iqn = Grad
+            static_matrix_type* gphi    = m_gphis.data() + i_qp * grad_basis_size;
+            static_matrix_type  RkT_iqn = static_matrix_type::Zero();
+            for (size_t i = 0; i < grad_basis_size; i++)
             {
-                gphi = gb.eval_functions(qp.point());
+                gphi[i] = phi[i];
+                RkT_iqn += RkT_uTF(i) * phi[i];
             }
 
-            assert(gphi.size() == grad_basis_size);
-
-            // Compute local gradient and norm
-            // RkT_iqn = Grad_sym for small def else RkT_iqn = Grad
-            const auto RkT_iqn = eval(RkT_uTF, gphi);
+            // the laws take the linearized strain in small def else F
+            strains[i_qp] = small_def ? RkT_iqn : static_matrix_type(convertGtoF(RkT_iqn));
+        }
 
-            // std::cout << "RkT_iqn" << std::endl;
-            // std::cout << RkT_iqn << std::endl;
+        // Compute behavior at all the quadrature points at once
+        // if small_def stress = Cauchy else stress = PK1
+        tc.tic();
+        behavior.compute_whole_batch(cell_id, strains, m_stresses, m_Ceps, use_tangent_modulus);
+        tc.toc();
+        time_law += tc.elapsed();
 
-            // Compute behavior
-            // if small_def stress = Cauchy else stress = PK1
-            tc.tic();
-            const auto [stress, Cep] =
-              compute_behavior(behavior, cell_id, i_qp, RkT_iqn, small_def, use_tangent_modulus);
-            // std::cout << "stress: " << stress.norm() << std::endl;
-            // std::cout << stress << std::endl;
-            // std::cout << "Cep: " << Cep.norm() << std::endl;
-            // std::cout << Cep << std::endl;
-            tc.toc();
-            time_law += tc.elapsed();
+        scalar_type beta_comp = 0.0, total_weight = 0.0;
+        for (int i_qp = 0; i_qp < nb_qp; i_qp++)
+        {
+            const auto  qp     = behavior.quadrature_point(cell_id, i_qp);
+            const auto* gphi   = m_gphis.data() + i_qp * grad_basis_size;
+            const auto& stress = m_stresses[i_qp];
+            const auto& Cep    = m_Ceps[i_qp];
 
             // Compute rigidity
             this->compute_rigidity(Cep, gphi, small_def, qp.weight(), grad_dim_dofs, grad_basis_size, AT);
@@ -443,22 +423,16 @@ class mechanical_computation
                 if (small_def)
                 {
                     sigma_dev_norm = deviator(stress).norm();
-                    eps_dev_norm   = deviator(RkT_iqn).norm();
+                    eps_dev_norm   = deviator(strains[i_qp]).norm();
                 }
                 else
                 {
-                    const auto F   = convertGtoF(RkT_iqn);
-                    const auto EGL = convertFtoGreenLagrange(F);
-                    eps_dev_norm   = deviator(EGL).norm();
+                    const auto& F   = strains[i_qp];
+                    const auto  EGL = convertFtoGreenLagrange(F);
+                    eps_dev_norm    = deviator(EGL).norm();
 
                     const auto PK2 = convertPK1toPK2(stress, F);
                     sigma_dev_norm = deviator(PK2).norm();
-
-                    // const auto Cauchy = convertPK1toCauchy(stress, F);
-                    // const auto eps    = convertGtoLinearizedStrain(RkT_iqn);
-
-                    // std::cout << sigma_dev_norm / eps_dev_norm << " vs " << deviator(Cauchy).norm() / deviator(eps).norm()
-                    //           << std::endl;
                 }
 
                 total_weight += qp.weight();
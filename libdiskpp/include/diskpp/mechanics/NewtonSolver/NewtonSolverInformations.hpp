@@ -27,6 +27,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 class AssemblyInfo
 {
@@ -63,10 +64,11 @@ class SolveInfo
   public:
     size_t m_linear_system_size, m_nonzeros;
     double m_time_solve;
+    bool   m_solved; // false if all the linear solvers failed
 
-    SolveInfo() : m_linear_system_size(0), m_nonzeros(0), m_time_solve(0.0) {}
-    SolveInfo(const size_t linear_system_size, const size_t nonzeros, const double time_solve) :
-      m_linear_system_size(linear_system_size), m_nonzeros(nonzeros), m_time_solve(time_solve)
+    SolveInfo() : m_linear_system_size(0), m_nonzeros(0), m_time_solve(0.0), m_solved(true) {}
+    SolveInfo(const size_t linear_system_size, const size_t nonzeros, const double time_solve, const bool solved) :
+      m_linear_system_size(linear_system_size), m_nonzeros(nonzeros), m_time_solve(time_solve), m_solved(solved)
     {
     }
 };
@@ -79,6 +81,8 @@ class NewtonSolverInfo
     double       m_time_newton;
     size_t       m_iter;
 
+    std::vector<double> m_errors; // error of the Newton's method at each iteration
+
     NewtonSolverInfo() : m_assembly_info(), m_solve_info(), m_time_newton(0.0), m_iter(0) {}
 
     void
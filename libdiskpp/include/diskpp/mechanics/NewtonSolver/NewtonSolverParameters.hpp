@@ -29,6 +29,7 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,93 @@ enum StabilizationType : int
     DG  = 3
 };
 
+enum class LinearSolverType : int
+{
+    PARDISO      = 0,
+    MUMPS        = 1,
+    SPARSE_LU    = 2,
+    SPARSE_LDLT  = 3,
+    ITERATIVE_CG = 4
+};
+
+enum class CGPreconditionerType : int
+{
+    PRECOND_NONE   = 0,
+    PRECOND_JACOBI = 1,
+    PRECOND_IC0    = 2,
+    PRECOND_AMG    = 3
+};
+
+/* Names are the keywords of the parameter file */
+inline std::ostream&
+operator<<(std::ostream& os, const LinearSolverType ls)
+{
+    switch (ls)
+    {
+        case LinearSolverType::PARDISO: os << "Pardiso"; break;
+        case LinearSolverType::MUMPS: os << "Mumps"; break;
+        case LinearSolverType::SPARSE_LU: os << "SparseLU"; break;
+        case LinearSolverType::SPARSE_LDLT: os << "LDLT"; break;
+        case LinearSolverType::ITERATIVE_CG: os << "CG"; break;
+    }
+    return os;
+}
+
+inline std::ostream&
+operator<<(std::ostream& os, const CGPreconditionerType pc)
+{
+    switch (pc)
+    {
+        case CGPreconditionerType::PRECOND_NONE: os << "None"; break;
+        case CGPreconditionerType::PRECOND_JACOBI: os << "Jacobi"; break;
+        case CGPreconditionerType::PRECOND_IC0: os << "IC0"; break;
+        case CGPreconditionerType::PRECOND_AMG: os << "AMG"; break;
+    }
+    return os;
+}
+
+/* Best direct solver available in this build */
+inline LinearSolverType
+default_linear_solver(void)
+{
+#if defined(HAVE_INTEL_MKL)
+    return LinearSolverType::PARDISO;
+#elif defined(HAVE_MUMPS)
+    return LinearSolverType::MUMPS;
+#else
+    return LinearSolverType::SPARSE_LU;
+#endif
+}
+
+/* Linear solvers tried by NewtonIteration::solve(): the requested one
+ * first, then the direct solvers in order of preference */
+inline std::vector<LinearSolverType>
+linear_solver_chain(const LinearSolverType requested)
+{
+    std::vector<LinearSolverType> chain = {requested};
+    for (auto ls : {LinearSolverType::PARDISO, LinearSolverType::MUMPS, LinearSolverType::SPARSE_LU})
+        if (ls != requested)
+            chain.push_back(ls);
+
+    return chain;
+}
+
+/* Call solve(ls) on the solvers of the chain for which available(ls) is
+ * true, until one of them succeeds. Returns the solver that worked, or
+ * nothing if all of them failed. */
+template<typename Available, typename Solve>
+std::optional<LinearSolverType>
+solve_with_fallback(const LinearSolverType requested, const Available& available, Solve&& solve)
+{
+    for (auto ls : linear_solver_chain(requested))
+    {
+        if (available(ls) && solve(ls))
+            return ls;
+    }
+
+    return std::nullopt;
+}
+
 template<typename T>
 class NewtonSolverParameter
 {
@@ -52,12 +140,16 @@ class NewtonSolverParameter
     bool                           m_has_user_end_time; // final time is given
     T                              m_user_end_time; // final time of the simulation
     int                            m_sublevel;  // number of sublevel if there are problems
+    bool                           m_adapt_time_step; // adapt the time steps to the Newton's iterations
+    int                            m_time_step_target_iter; // iterations for which the time step is kept
     int                            m_iter_max;  // maximun nexton iteration
     T                              m_epsilon;   // stop criteria
 
     bool m_verbose; // some printing
 
     bool m_precomputation; // to compute the gradient before (it's memory consuption)
+    bool m_precomputation_symmetric; // store only half of the precomputed stabilization
+    bool m_precomputation_float;     // store the precomputed operators in single precision
 
     int  m_stab_type; // type of stabilization
     T    m_beta;      // stabilization parameter
@@ -67,10 +159,28 @@ class NewtonSolverParameter
     int          m_n_time_save; // number of saving
     std::list<T> m_time_save;   // list of time where we save result;
 
+    LinearSolverType     m_linear_solver; // solver of the linearized system
+    CGPreconditionerType m_cg_precond;    // preconditioner if the solver is CG
+    T                    m_cg_epsilon;    // relative residual for CG
+    int                  m_cg_iter_max;   // maximum CG iterations (0: twice the system size)
+
+    /* Threads computing the cell systems of the assembly (1: serial, 0: default_num_threads()).
+     * With more than one thread, the load function, the boundary conditions and the behavior law
+     * are evaluated concurrently on different cells: they must be thread-safe. */
+    int m_num_threads;
+
+    int         m_checkpoint_freq; // number of converged time steps between two checkpoints (0: no checkpoint)
+    std::string m_checkpoint_file; // name of the checkpoint file
+    std::string m_restart_file;    // checkpoint to restart from (empty: start at time 0)
+
     NewtonSolverParameter() :
-      m_face_degree(1), m_cell_degree(1), m_grad_degree(1), m_sublevel(5), m_iter_max(20), m_epsilon(T(1E-6)),
-      m_verbose(false), m_precomputation(false), m_stab(true), m_beta(1), m_stab_type(HHO), m_n_time_save(0),
-      m_user_end_time(1.0), m_has_user_end_time(false), m_adapt_stab(false)
+      m_face_degree(1), m_cell_degree(1), m_grad_degree(1), m_has_user_end_time(false), m_user_end_time(1.0),
+      m_sublevel(5), m_adapt_time_step(false), m_time_step_target_iter(5), m_iter_max(20), m_epsilon(T(1E-6)),
+      m_verbose(false), m_precomputation(false), m_precomputation_symmetric(false),
+      m_precomputation_float(false), m_stab_type(HHO), m_beta(1), m_stab(true), m_adapt_stab(false),
+      m_n_time_save(0), m_linear_solver(default_linear_solver()), m_cg_precond(CGPreconditionerType::PRECOND_IC0),
+      m_cg_epsilon(T(1E-10)), m_cg_iter_max(0), m_num_threads(1), m_checkpoint_freq(0),
+      m_checkpoint_file("checkpoint.bin")
     {
         m_time_step.push_back(std::make_pair(m_user_end_time, 1));
     }
@@ -88,9 +198,27 @@ class NewtonSolverParameter
         std::cout << " - Beta: " << m_beta << std::endl;
         std::cout << " - Verbose: " << m_verbose << std::endl;
         std::cout << " - Sublevel: " << m_sublevel << std::endl;
+        std::cout << " - AdaptativeTimeStep ?: " << m_adapt_time_step << std::endl;
+        if (m_adapt_time_step)
+            std::cout << " - TimeStepTargetIter: " << m_time_step_target_iter << std::endl;
         std::cout << " - IterMax: " << m_iter_max << std::endl;
         std::cout << " - Epsilon: " << m_epsilon << std::endl;
         std::cout << " - Precomputation: " << m_precomputation << std::endl;
+        std::cout << " - PrecomputationSymmetric: " << m_precomputation_symmetric << std::endl;
+        std::cout << " - PrecomputationFloat: " << m_precomputation_float << std::endl;
+        std::cout << " - LinearSolver: " << m_linear_solver << std::endl;
+        if (m_linear_solver == LinearSolverType::ITERATIVE_CG)
+        {
+            std::cout << " - CGPreconditioner: " << m_cg_precond << std::endl;
+            std::cout << " - CGEpsilon: " << m_cg_epsilon << std::endl;
+            std::cout << " - CGIterMax: " << m_cg_iter_max << std::endl;
+        }
+        std::cout << " - NumThreads: " << m_num_threads << std::endl;
+        std::cout << " - CheckpointFrequency: " << m_checkpoint_freq << std::endl;
+        if (m_checkpoint_freq > 0)
+            std::cout << " - CheckpointFile: " << m_checkpoint_file << std::endl;
+        if (!m_restart_file.empty())
+            std::cout << " - RestartFile: " << m_restart_file << std::endl;
     }
 
     bool
@@ -198,6 +326,20 @@ class NewtonSolverParameter
                 if (logical == "true" || logical == "True")
                     m_adapt_stab = true;
             }
+            else if (keyword == "AdaptativeTimeStep")
+            {
+                std::string logical;
+                ifs >> logical;
+                line++;
+                m_adapt_time_step = false;
+                if (logical == "true" || logical == "True")
+                    m_adapt_time_step = true;
+            }
+            else if (keyword == "TimeStepTargetIter")
+            {
+                ifs >> m_time_step_target_iter;
+                line++;
+            }
             else if (keyword == "StabType")
             {
                 std::string type;
@@ -247,6 +389,96 @@ class NewtonSolverParameter
                 else
                     m_precomputation = false;
             }
+            else if (keyword == "PrecomputationSymmetric")
+            {
+                std::string logical;
+                ifs >> logical;
+                line++;
+                if (logical == "true" || logical == "True")
+                    m_precomputation_symmetric = true;
+                else
+                    m_precomputation_symmetric = false;
+            }
+            else if (keyword == "PrecomputationFloat")
+            {
+                std::string logical;
+                ifs >> logical;
+                line++;
+                if (logical == "true" || logical == "True")
+                    m_precomputation_float = true;
+                else
+                    m_precomputation_float = false;
+            }
+            else if (keyword == "LinearSolver")
+            {
+                std::string type;
+                ifs >> type;
+                line++;
+                if (type == "Pardiso")
+                    m_linear_solver = LinearSolverType::PARDISO;
+                else if (type == "Mumps")
+                    m_linear_solver = LinearSolverType::MUMPS;
+                else if (type == "SparseLU")
+                    m_linear_solver = LinearSolverType::SPARSE_LU;
+                else if (type == "LDLT")
+                    m_linear_solver = LinearSolverType::SPARSE_LDLT;
+                else if (type == "CG")
+                    m_linear_solver = LinearSolverType::ITERATIVE_CG;
+                else
+                {
+                    std::cout << "Unknown linear solver " << type << " line: " << line << std::endl;
+                    return false;
+                }
+            }
+            else if (keyword == "CGPreconditioner")
+            {
+                std::string type;
+                ifs >> type;
+                line++;
+                if (type == "None")
+                    m_cg_precond = CGPreconditionerType::PRECOND_NONE;
+                else if (type == "Jacobi")
+                    m_cg_precond = CGPreconditionerType::PRECOND_JACOBI;
+                else if (type == "IC0")
+                    m_cg_precond = CGPreconditionerType::PRECOND_IC0;
+                else if (type == "AMG")
+                    m_cg_precond = CGPreconditionerType::PRECOND_AMG;
+                else
+                {
+                    std::cout << "Unknown preconditioner " << type << " line: " << line << std::endl;
+                    return false;
+                }
+            }
+            else if (keyword == "CGEpsilon")
+            {
+                ifs >> m_cg_epsilon;
+                line++;
+            }
+            else if (keyword == "CGIterMax")
+            {
+                ifs >> m_cg_iter_max;
+                line++;
+            }
+            else if (keyword == "NumThreads")
+            {
+                ifs >> m_num_threads;
+                line++;
+            }
+            else if (keyword == "CheckpointFrequency")
+            {
+                ifs >> m_checkpoint_freq;
+                line++;
+            }
+            else if (keyword == "CheckpointFile")
+            {
+                ifs >> m_checkpoint_file;
+                line++;
+            }
+            else if (keyword == "RestartFile")
+            {
+                ifs >> m_restart_file;
+                line++;
+            }
             else
             {
                 std::cout << "Error parsing Parameters file:" << keyword << " line: " << line << std::endl;
@@ -331,4 +563,42 @@ class NewtonSolverParameter
     {
         return m_precomputation;
     }
+
+    void
+    setLinearSolver(const LinearSolverType linear_solver)
+    {
+        m_linear_solver = linear_solver;
+    }
+
+    LinearSolverType
+    getLinearSolver() const
+    {
+        return m_linear_solver;
+    }
+
+    /* More than one thread requires thread-safe load function, boundary conditions and behavior */
+    void
+    setNumThreads(const int num_threads)
+    {
+        m_num_threads = num_threads;
+    }
+
+    int
+    getNumThreads() const
+    {
+        return m_num_threads;
+    }
+
+    void
+    setCheckpoint(const int frequency, const std::string& filename)
+    {
+        m_checkpoint_freq = frequency;
+        m_checkpoint_file = filename;
+    }
+
+    void
+    setRestartFile(const std::string& filename)
+    {
+        m_restart_file = filename;
+    }
 };
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <vector>
 
@@ -145,8 +146,8 @@ class NewtonStep
             const param_type&                rp,
             const MeshDegreeInfo<mesh_type>& degree_infos,
             const LoadIncrement&             lf,
-            const std::vector<matrix_type>&  gradient_precomputed,
-            const std::vector<matrix_type>&  stab_precomputed,
+            const OperatorStore<scalar_type>& gradient_precomputed,
+            const OperatorStore<scalar_type>& stab_precomputed,
             behavior_type&                   behavior,
             ContactManager<mesh_type>&       contact_manager,
             StabCoeffManager<scalar_type>&   stab_manager)
@@ -187,10 +188,12 @@ class NewtonStep
             try
             {
                 m_convergence = newton_iter.convergence(rp, iter);
+                ni.m_errors.push_back(newton_iter.error());
             }
             catch (const std::runtime_error& ia)
             {
                 std::cerr << "Runtime error: " << ia.what() << std::endl;
+                ni.m_errors.push_back(std::numeric_limits<scalar_type>::infinity());
                 m_convergence = false;
                 tc.toc();
                 ni.m_time_newton = tc.elapsed();
@@ -208,6 +211,14 @@ class NewtonStep
             // solve the global system
             SolveInfo solve_info = newton_iter.solve();
             ni.updateSolveInfo(solve_info);
+            if (!solve_info.m_solved)
+            {
+                std::cerr << "All the linear solvers failed" << std::endl;
+                m_convergence = false;
+                tc.toc();
+                ni.m_time_newton = tc.elapsed();
+                return ni;
+            }
             // update unknowns
             ni.m_assembly_info.m_time_postpro += newton_iter.postprocess(msh, bnd, degree_infos, contact_manager);
 
@@ -252,6 +263,28 @@ class NewtonStep
         solution_mult = m_solution_mult;
         assert(m_solution_mult.size() == solution_mult.size());
     }
+
+    /**
+     * @brief Solutions of the last converged step, without copy
+     *
+     */
+    const std::vector<vector_type>&
+    solution(void) const
+    {
+        return m_solution;
+    }
+
+    const std::vector<vector_type>&
+    solution_faces(void) const
+    {
+        return m_solution_faces;
+    }
+
+    const std::vector<vector_type>&
+    solution_mult(void) const
+    {
+        return m_solution_mult;
+    }
 };
 }
 
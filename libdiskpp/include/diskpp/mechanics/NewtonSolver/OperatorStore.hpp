@@ -0,0 +1,366 @@
+/*
+ *       /\        Matteo Cicuttin (C) 2016, 2017, 2018
+ *      /__\       matteo.cicuttin@enpc.fr
+ *     /_\/_\      École Nationale des Ponts et Chaussées - CERMICS
+ *    /\    /\
+ *   /__\  /__\    DISK++, a template library for DIscontinuous SKeletal
+ *  /_\/_\/_\/_\   methods.
+ *
+ * This file is copyright of the following authors:
+ * Nicolas Pignet  (C) 2018                     nicolas.pignet@enpc.fr
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * If you use this code or parts of it for scientific publications, you
+ * are required to cite it as following:
+ *
+ * Hybrid High-Order methods for finite elastoplastic deformations
+ * within a logarithmic strain framework.
+ * M. Abbas, A. Ern, N. Pignet.
+ * International Journal of Numerical Methods in Engineering (2019)
+ * 120(3), 303-327
+ * DOI: 10.1002/nme.6137
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "diskpp/common/eigen.hpp"
+
+namespace disk
+{
+
+namespace mechanics
+{
+
+namespace priv
+{
+
+/* Values of many small matrices in large chunks. A matrix never spans two
+ * chunks, so it is contiguous, and the chunks are never reallocated, so the
+ * pointers stay valid. The chunks grow geometrically up to max_chunk_size
+ * values, so that the unused memory stays small for both small and large
+ * meshes. */
+template<typename S>
+class OperatorPool
+{
+  private:
+    std::vector<std::vector<S>> m_chunks;
+    size_t                      m_used;
+    size_t                      m_capacity;
+
+    static constexpr size_t min_chunk_size = 1 << 12;
+    static constexpr size_t max_chunk_size = 1 << 20;
+
+  public:
+    OperatorPool() : m_used(0), m_capacity(0) {}
+
+    S*
+    allocate(size_t n)
+    {
+        if (m_chunks.empty() || m_used + n > m_chunks.back().size())
+        {
+            const size_t chunk_size = std::clamp(m_capacity, min_chunk_size, max_chunk_size);
+            m_chunks.emplace_back(std::max(n, chunk_size));
+            m_capacity += m_chunks.back().size();
+            m_used = 0;
+        }
+
+        S* ret = m_chunks.back().data() + m_used;
+        m_used += n;
+        return ret;
+    }
+
+    void
+    clear(void)
+    {
+        m_chunks.clear();
+        m_used     = 0;
+        m_capacity = 0;
+    }
+
+    size_t
+    capacity(void) const
+    {
+        return m_capacity;
+    }
+};
+
+} // namespace priv
+
+/**
+ * @brief Storage of one operator per cell (gradient reconstruction, stabilization).
+ *
+ * The values of the operators are stored in a pool of contiguous memory, without one heap
+ * allocation per cell. By default each operator is stored as it is and read through an
+ * Eigen::Map, without any copy. Two options reduce the memory further:
+ *  - symmetric: only the lower triangular part of the (square) operators is stored
+ *  - single precision: the values are stored as float. The operators are expanded to T when they
+ *    are read, so all the computations are still done in T.
+ *
+ * @tparam T scalar type
+ */
+template<typename T>
+class OperatorStore
+{
+  public:
+    typedef dynamic_matrix<T>               matrix_type;
+    typedef Eigen::Map<const matrix_type>   const_map_type;
+
+  private:
+    bool m_symmetric;
+    bool m_single_precision;
+
+    priv::OperatorPool<T>     m_pool;
+    priv::OperatorPool<float> m_pool_float;
+
+    std::vector<const T*>     m_values;
+    std::vector<const float*> m_values_float;
+    std::vector<uint32_t>     m_rows, m_cols;
+    size_t                    m_num_values;
+
+    size_t
+    stored_values(size_t rows, size_t cols) const
+    {
+        return m_symmetric ? rows * (rows + 1) / 2 : rows * cols;
+    }
+
+    /* The operators are packed and must be expanded to be read */
+    bool
+    packed(void) const
+    {
+        return m_symmetric || m_single_precision;
+    }
+
+    /* Expand the i-th packed operator in M */
+    void
+    expand(size_t i, matrix_type& M) const
+    {
+        if (m_single_precision)
+            unpack(m_values_float[i], m_rows[i], m_cols[i], M);
+        else
+            unpack(m_values[i], m_rows[i], m_cols[i], M);
+    }
+
+    /* Copy M to dst, packing the lower triangular part column by column if symmetric */
+    template<typename S>
+    void
+    pack(const matrix_type& M, S* dst) const
+    {
+        if (!m_symmetric)
+        {
+            Eigen::Map<dynamic_matrix<S>>(dst, M.rows(), M.cols()) = M.template cast<S>();
+            return;
+        }
+
+        const auto n = M.rows();
+        for (int j = 0; j < n; j++)
+        {
+            Eigen::Map<dynamic_vector<S>>(dst, n - j) = M.col(j).tail(n - j).template cast<S>();
+            dst += n - j;
+        }
+    }
+
+    template<typename S>
+    void
+    unpack(const S* src, size_t rows, size_t cols, matrix_type& M) const
+    {
+        M.resize(rows, cols);
+
+        if (!m_symmetric)
+        {
+            M = Eigen::Map<const dynamic_matrix<S>>(src, rows, cols).template cast<T>();
+            return;
+        }
+
+        const int n = rows;
+        for (int j = 0; j < n; j++)
+        {
+            const auto col = Eigen::Map<const dynamic_vector<S>>(src, n - j);
+            M.col(j).tail(n - j)             = col.template cast<T>();
+            M.row(j).tail(n - j).transpose() = col.template cast<T>();
+            src += n - j;
+        }
+    }
+
+  public:
+    OperatorStore(bool symmetric = false, bool single_precision = false) :
+      m_symmetric(symmetric), m_single_precision(single_precision), m_num_values(0)
+    {
+    }
+
+    /**
+     * @brief Change the storage options. The store must be empty.
+     */
+    void
+    setOptions(bool symmetric, bool single_precision)
+    {
+        assert(empty());
+        m_symmetric        = symmetric;
+        m_single_precision = single_precision;
+    }
+
+    /**
+     * @brief Remove all the operators and release the memory
+     */
+    void
+    clear(void)
+    {
+        m_pool.clear();
+        m_pool_float.clear();
+        m_values.clear();
+        m_values_float.clear();
+        m_rows.clear();
+        m_cols.clear();
+        m_num_values = 0;
+    }
+
+    void
+    reserve(size_t num_operators)
+    {
+        if (m_single_precision)
+            m_values_float.reserve(num_operators);
+        else
+            m_values.reserve(num_operators);
+        m_rows.reserve(num_operators);
+        m_cols.reserve(num_operators);
+    }
+
+    /**
+     * @brief Append an operator. It must be square if the store is symmetric.
+     */
+    void
+    push_back(const matrix_type& M)
+    {
+        assert(!m_symmetric || M.rows() == M.cols());
+
+        const size_t n = stored_values(M.rows(), M.cols());
+        if (m_single_precision)
+        {
+            float* dst = m_pool_float.allocate(n);
+            pack(M, dst);
+            m_values_float.push_back(dst);
+        }
+        else
+        {
+            T* dst = m_pool.allocate(n);
+            pack(M, dst);
+            m_values.push_back(dst);
+        }
+
+        m_rows.push_back(M.rows());
+        m_cols.push_back(M.cols());
+        m_num_values += n;
+    }
+
+    size_t
+    size(void) const
+    {
+        return m_rows.size();
+    }
+
+    bool
+    empty(void) const
+    {
+        return m_rows.empty();
+    }
+
+    /**
+     * @brief Map the i-th operator in the pool. Only available without the compact options.
+     */
+    const_map_type
+    get(size_t i) const
+    {
+        assert(i < size());
+        if (packed())
+            throw std::logic_error("OperatorStore: packed operators must be read with a buffer");
+
+        return const_map_type(m_values[i], m_rows[i], m_cols[i]);
+    }
+
+    /**
+     * @brief Read the i-th operator. Without the compact options the operator is mapped in the pool,
+     * otherwise it is expanded in buffer, reusing its memory if possible, and buffer is mapped.
+     */
+    const_map_type
+    get(size_t i, matrix_type& buffer) const
+    {
+        assert(i < size());
+        if (!packed())
+            return get(i);
+
+        expand(i, buffer);
+        return const_map_type(buffer.data(), buffer.rows(), buffer.cols());
+    }
+
+    matrix_type
+    at(size_t i) const
+    {
+        if (i >= size())
+            throw std::out_of_range("OperatorStore: index out of range");
+
+        return (*this)[i];
+    }
+
+    matrix_type
+    operator[](size_t i) const
+    {
+        matrix_type M;
+        if (!packed())
+            M = get(i);
+        else
+            expand(i, M);
+        return M;
+    }
+
+    /**
+     * @brief Memory used by the store, in bytes
+     */
+    size_t
+    memory(void) const
+    {
+        return m_pool.capacity() * sizeof(T) + m_pool_float.capacity() * sizeof(float) +
+               m_values.capacity() * sizeof(const T*) + m_values_float.capacity() * sizeof(const float*) +
+               (m_rows.capacity() + m_cols.capacity()) * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief Estimated memory of the same operators stored as one dynamic matrix each, in bytes.
+     * The heap overhead of each allocation is counted as 16 bytes.
+     */
+    size_t
+    memoryDynamicMatrices(void) const
+    {
+        size_t ret = size() * (sizeof(matrix_type) + 16);
+        for (size_t i = 0; i < size(); i++)
+            ret += size_t(m_rows[i]) * m_cols[i] * sizeof(T);
+        return ret;
+    }
+
+    void
+    memoryReport(const std::string& name) const
+    {
+        const double MB = 1024.0 * 1024.0;
+        std::cout << name << ": " << size() << " operators, " << m_num_values << " values";
+        if (m_symmetric)
+            std::cout << ", symmetric";
+        if (m_single_precision)
+            std::cout << ", single precision";
+        std::cout << std::endl;
+        std::cout << "   ** Memory: " << memory() / MB << " MB (" << memoryDynamicMatrices() / MB
+                  << " MB as dynamic matrices)" << std::endl;
+    }
+};
+
+} // end mechanics
+
+} // end disk
@@ -26,8 +26,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <list>
+#include <stdexcept>
 #include <vector>
 
 namespace disk
@@ -129,6 +131,47 @@ class StabCoeffManager
     {
         m_stab_coeff = m_stab_coeff_new;
     }
+
+    /**
+     * @brief Write the coefficients in a checkpoint
+     *
+     * @param out output with a method write(const U* values, size_t n)
+     */
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        const uint64_t n_coeff = m_stab_coeff.size();
+        out.write(&n_coeff, 1);
+        for (auto& coeff : m_stab_coeff)
+        {
+            const T value = coeff.getValue();
+            out.write(&value, 1);
+        }
+    }
+
+    /**
+     * @brief Read the coefficients written by save(), for the current and the next step
+     *
+     * @param in input with a method read(U* values, size_t n)
+     */
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        uint64_t n_coeff;
+        in.read(&n_coeff, 1);
+        if (n_coeff != m_stab_coeff.size())
+            throw std::runtime_error("StabCoeffManager: the saved coefficients do not match the mesh");
+
+        for (auto& coeff : m_stab_coeff)
+        {
+            T value;
+            in.read(&value, 1);
+            coeff.setValue(value);
+        }
+        m_stab_coeff_new = m_stab_coeff;
+    }
 };
 }
 }
\ No newline at end of file
@@ -26,6 +26,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <vector>
@@ -244,13 +247,25 @@ class ListOfTimeStep
      */
     void
     splitCurrentTimeStep(void)
+    {
+        this->splitCurrentTimeStep(T(0.5));
+    }
+
+    /**
+     * @brief Split the current time step in two sub-time steps after a failure, the first one being the
+     * given fraction of the current time step. Both sub-time steps are one level finer.
+     *
+     * @param ratio length of the first sub-time step divided by the length of the current time step
+     */
+    void
+    splitCurrentTimeStep(const T ratio)
     {
         const TimeStep<T> CurrentStep = this->getCurrentTimeStep();
 
         const T start_time = CurrentStep.start_time();
         const T end_time   = CurrentStep.end_time();
 
-        const T new_time = start_time + (end_time - start_time) / T(2);
+        const T new_time = start_time + (end_time - start_time) * ratio;
 
         const TimeStep<T> newStep1(start_time, new_time, CurrentStep.level() + 1);
         const TimeStep<T> newStep2(new_time, end_time, CurrentStep.level() + 1);
@@ -260,6 +275,96 @@ class ListOfTimeStep
         list_steps.push_front(newStep1);
     }
 
+    /**
+     * @brief Change the length of the current time step, keeping its start time. If the time step is
+     * longer than requested, it is split at the requested length, or in sub-time steps of equal length if
+     * the rest would be tiny. If it is shorter, it is merged with the following time steps that end before
+     * the requested end, so that the times given by the user remain ends of time steps.
+     *
+     * @param length requested length of the current time step
+     */
+    void
+    resizeCurrentTimeStep(const T length)
+    {
+        const TimeStep<T> CurrentStep = this->getCurrentTimeStep();
+
+        const T start_time = CurrentStep.start_time();
+        const T end_time   = CurrentStep.end_time();
+        const T tol        = T(1E-8);
+
+        const T n_sub = std::ceil((end_time - start_time) / length - tol);
+        if (n_sub > T(1))
+        {
+            T new_time = start_time + length;
+            if (end_time - new_time < length / T(4))
+                new_time = start_time + (end_time - start_time) / n_sub;
+
+            list_steps.pop_front();
+            list_steps.push_front(TimeStep<T>(new_time, end_time, CurrentStep.level()));
+            list_steps.push_front(TimeStep<T>(start_time, new_time, CurrentStep.level()));
+            return;
+        }
+
+        T      new_end   = end_time;
+        size_t new_level = CurrentStep.level();
+        list_steps.pop_front();
+        while (!list_steps.empty() && list_steps.front().end_time() <= start_time + length * (T(1) + tol))
+        {
+            new_end   = list_steps.front().end_time();
+            new_level = std::min(new_level, list_steps.front().level());
+            list_steps.pop_front();
+        }
+        list_steps.push_front(TimeStep<T>(start_time, new_end, new_level));
+    }
+
+    /**
+     * @brief Write the time steps already realized and the remaining ones in a checkpoint
+     *
+     * @param out output with a method write(const U* values, size_t n)
+     */
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        const uint64_t n_comp = n_time_step_comp, n_steps = list_steps.size();
+        out.write(&n_comp, 1);
+        out.write(&user_end_time, 1);
+        out.write(&n_steps, 1);
+        for (auto& step : list_steps)
+        {
+            const T        times[2] = {step.start_time(), step.end_time()};
+            const uint64_t level    = step.level();
+            out.write(times, 2);
+            out.write(&level, 1);
+        }
+    }
+
+    /**
+     * @brief Replace the time steps by the ones written by save()
+     *
+     * @param in input with a method read(U* values, size_t n)
+     */
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        uint64_t n_comp, n_steps;
+        in.read(&n_comp, 1);
+        in.read(&user_end_time, 1);
+        in.read(&n_steps, 1);
+
+        n_time_step_comp = n_comp;
+        list_steps.clear();
+        for (uint64_t i = 0; i < n_steps; i++)
+        {
+            T        times[2];
+            uint64_t level;
+            in.read(times, 2);
+            in.read(&level, 1);
+            list_steps.push_back(TimeStep<T>(times[0], times[1], level));
+        }
+    }
+
     /**
      * @brief Print informations about current time step
      *
@@ -278,5 +383,85 @@ class ListOfTimeStep
                   << ", sublevel: " << current_step.level() << " ) *************************|" << std::endl;
     }
 };
+
+/**
+ * @brief Choose the length of the time steps from the convergence of the Newton's method.
+ *
+ * After a converged time step, the next time step is longer if the Newton's method needed less
+ * iterations than the target, and shorter if it needed more. After a failure, the time step is cut
+ * according to the decrease of the error during the failed iterations: a step that was close to
+ * convergence is cut less than a step that diverged.
+ *
+ * @tparam T scalar type
+ */
+template<typename T>
+class TimeStepController
+{
+  private:
+    size_t m_target_iter; // number of iterations for which the length is kept
+    T      m_max_growth;  // maximal ratio between two consecutive time steps
+    T      m_min_cut;     // ratio applied when the Newton's method diverges
+    T      m_max_cut;     // maximal ratio applied after a failure
+
+  public:
+    /**
+     * @brief Construct a new TimeStepController object
+     *
+     * @param target_iter number of Newton's iterations for which the length of the time step is kept
+     * @param max_growth maximal ratio between two consecutive time steps
+     * @param min_cut ratio applied to a failed time step when the Newton's method diverges
+     * @param max_cut maximal ratio applied to a failed time step
+     */
+    TimeStepController(const size_t target_iter = 5,
+                       const T      max_growth  = T(2),
+                       const T      min_cut     = T(0.25),
+                       const T      max_cut     = T(0.75)) :
+      m_target_iter(std::max(target_iter, size_t(1))), m_max_growth(max_growth), m_min_cut(min_cut),
+      m_max_cut(max_cut)
+    {
+    }
+
+    /**
+     * @brief Ratio between the length of the next time step and the length of a converged time step
+     *
+     * @param num_iter number of Newton's iterations of the converged time step
+     * @return T ratio in [1/2, max_growth]
+     */
+    T
+    ratioAfterConvergence(const size_t num_iter) const
+    {
+        const T ratio = T(m_target_iter) / T(std::max(num_iter, size_t(1)));
+        return std::min(m_max_growth, std::max(T(0.5), ratio * ratio));
+    }
+
+    /**
+     * @brief Ratio between the length of the first sub-time step and the length of a failed time step
+     *
+     * The mean rate of decrease of the error over the failed iterations gives an estimation of the
+     * number of iterations that were needed to reach the stopping criterion.
+     *
+     * @param errors error of the Newton's method at each iteration of the failed time step
+     * @param iter_max maximal number of iterations
+     * @param epsilon stopping criterion
+     * @return T ratio in [min_cut, max_cut]
+     */
+    T
+    ratioAfterFailure(const std::vector<T>& errors, const size_t iter_max, const T epsilon) const
+    {
+        if (errors.size() < 2)
+            return m_min_cut;
+
+        const T first = errors.front();
+        const T last  = errors.back();
+        if (!std::isfinite(last) || !(last < first) || last <= T(0))
+            return m_min_cut;
+
+        const T rate   = std::pow(last / first, T(1) / T(errors.size() - 1));
+        const T needed = T(errors.size()) + std::log(epsilon / last) / std::log(rate);
+        const T ratio  = T(iter_max) / needed;
+
+        return std::min(m_max_cut, std::max(m_min_cut, ratio));
+    }
+};
 }
 }
\ No newline at end of file
@@ -128,16 +128,18 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
     static_tensor<scalar_type, 3>
     compute_tangent_moduli_A(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const static_matrix_type3D F = this->estrain_curr();
+
+        const scalar_type J = F.determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF  = this->m_estrain_curr.inverse();
+        const static_matrix_type3D invF  = F.inverse();
         const static_matrix_type3D invFt = invF.transpose();
-        const static_matrix_type3D C     = mechanics::convertFtoCauchyGreenRight(this->m_estrain_curr);
+        const static_matrix_type3D C     = mechanics::convertFtoCauchyGreenRight(F);
 
         const scalar_type trace_C = C.trace();
         const scalar_type T1      = compute_T1(data, J);
@@ -146,7 +148,7 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
         const static_tensor<scalar_type, 3> I4          = IdentityTensor4<scalar_type, 3>();
         const static_tensor<scalar_type, 3> invFt_invF  = ProductInf(invFt, invF);
         const static_tensor<scalar_type, 3> invFt_invFt = Kronecker(invFt, invFt);
-        const static_tensor<scalar_type, 3> F_F         = Kronecker(this->m_estrain_curr, this->m_estrain_curr);
+        const static_tensor<scalar_type, 3> F_F         = Kronecker(F, F);
 
         const auto Aiso = data.getMu() * std::pow(3.0, -0.25) *
                           (std::pow(trace_C, -0.25) * I4 - 0.5 * std::pow(trace_C, -5.0 / 4.0) * F_F);
@@ -158,25 +160,29 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
   public:
     Cavitation_qp() : law_qp_bones<T, DIM>() {}
 
-    Cavitation_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) : law_qp_bones<T, DIM>(point, weight)
+    Cavitation_qp(const point<scalar_type, DIM>& point,
+                  const scalar_type&             weight,
+                  QPStateStore<T>*               state,
+                  const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
     }
 
     static_matrix_type3D
     compute_stress3D(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const scalar_type J = this->estrain_curr().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF = this->m_estrain_curr.inverse();
+        const static_matrix_type3D invF = this->estrain_curr().inverse();
         const scalar_type          T1   = compute_T1(data, J);
-        const static_matrix_type3D C    = this->m_estrain_curr.transpose() * this->m_estrain_curr;
+        const static_matrix_type3D C    = this->estrain_curr().transpose() * this->estrain_curr();
 
-        const auto Piso = data.getMu() * std::pow(3.0 * C.trace(), -1.0 / 4.0) * this->m_estrain_curr;
+        const auto Piso = data.getMu() * std::pow(3.0 * C.trace(), -1.0 / 4.0) * this->estrain_curr();
         const auto Pvol = (data.getLambda() * T1 - data.getMu()) * invF.transpose();
 
         return Piso + Pvol;
@@ -191,18 +197,18 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
     static_matrix_type3D
     compute_stressPrev3D(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_prev.determinant();
+        const scalar_type J = this->estrain_prev().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF = this->m_estrain_prev.inverse();
+        const static_matrix_type3D invF = this->estrain_prev().inverse();
         const scalar_type          T1   = compute_T1(data, J);
-        const static_matrix_type3D C    = this->m_estrain_prev.transpose() * this->m_estrain_prev;
+        const static_matrix_type3D C    = this->estrain_prev().transpose() * this->estrain_prev();
 
-        const auto Piso = data.getMu() * std::pow(3.0 * C.trace(), -1.0 / 4.0) * this->m_estrain_prev;
+        const auto Piso = data.getMu() * std::pow(3.0 * C.trace(), -1.0 / 4.0) * this->estrain_prev();
         const auto Pvol = (data.getLambda() * T1 - data.getMu()) * invF.transpose();
 
         return Piso + Pvol;
@@ -211,14 +217,14 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
     scalar_type
     compute_energy(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const scalar_type J = this->estrain_curr().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D C = this->m_estrain_curr.transpose() * this->m_estrain_curr;
+        const static_matrix_type3D C = this->estrain_curr().transpose() * this->estrain_curr();
 
         const scalar_type Wiso = 2.0 * data.getMu() / std::pow(3.0, 5.0 / 4.0) * std::pow(C.trace(), 3.0 / 4.0);
         const scalar_type Wvol =
@@ -231,7 +237,7 @@ class Cavitation_qp : public law_qp_bones<T, DIM>
     compute_whole3D(const static_matrix_type3D& F_curr, const data_type& data, bool tangentmodulus = true)
     {
         // is always elastic
-        this->m_estrain_curr = F_curr;
+        this->estrain_curr() = F_curr;
 
         const auto PK1 = this->compute_stress3D(data);
         const auto A   = this->compute_tangent_moduli_A(data);
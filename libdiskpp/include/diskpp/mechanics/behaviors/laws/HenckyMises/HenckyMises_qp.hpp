@@ -92,8 +92,11 @@ class HenckyMises_qp : public law_qp_bones<T, DIM>
   public:
     HenckyMises_qp() : law_qp_bones<T, DIM>() {}
 
-    HenckyMises_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) :
-      law_qp_bones<T, DIM>(point, weight)
+    HenckyMises_qp(const point<scalar_type, DIM>& point,
+                   const scalar_type&             weight,
+                   QPStateStore<T>*               state,
+                   const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
     }
 
@@ -101,7 +104,7 @@ class HenckyMises_qp : public law_qp_bones<T, DIM>
     compute_stress3D(const data_type& data) const
     {
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
-        const static_matrix_type3D Gs = this->m_estrain_curr;
+        const static_matrix_type3D Gs = this->estrain_curr();
 
         const scalar_type normFrodev = deviator(Gs).norm();
 
@@ -112,7 +115,7 @@ class HenckyMises_qp : public law_qp_bones<T, DIM>
     compute_stress(const data_type& data) const
     {
         const static_matrix_type Id = static_matrix_type::Identity();
-        const static_matrix_type Gs = this->m_estrain_curr.block(0, 0, DIM, DIM);
+        const static_matrix_type Gs = this->estrain_curr().block(0, 0, DIM, DIM);
 
         const scalar_type normFrodev = deviator(Gs).norm();
 
@@ -125,7 +128,7 @@ class HenckyMises_qp : public law_qp_bones<T, DIM>
         static_tensor<scalar_type, DIM> Cep = this->elastic_modulus(data);
 
         // is always elastic
-        this->m_estrain_curr = convertMatrix3D(strain_curr);
+        this->estrain_curr() = convertMatrix3D(strain_curr);
 
         // compute Cauchy stress
         const static_matrix_type stress = this->compute_stress(data);
@@ -27,6 +27,7 @@
 
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/mechanics/behaviors/laws/law_qp_bones.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_vonmises_batch.hpp"
 #include "diskpp/mechanics/behaviors/laws/materialData.hpp"
 #include "diskpp/mechanics/behaviors/maths_tensor.hpp"
 #include "diskpp/mechanics/behaviors/maths_utils.hpp"
@@ -35,6 +36,7 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <limits>
 
 namespace disk
 {
@@ -53,65 +55,46 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
     typedef static_matrix<scalar_type, 3, 3>     static_matrix_type3D;
     typedef MaterialData<scalar_type>            data_type;
 
-  private:
-    // internal variables at previous step
-    static_matrix_type3D m_pstrain_prev; // plastic strain
-    scalar_type          m_p_prev;       // cumulate plastic strain
-
-    // internal variables at current step
-    static_matrix_type3D m_pstrain_curr;    // plastic strain
-    scalar_type          m_p_curr;          // cumulate plastic strain
-    bool                 m_is_plastic_curr; // the gauss point is plastic ?
-
   public:
-    IsotropicHardeningVMis_qp() :
-      law_qp_bones<T, DIM>(), m_pstrain_prev(static_matrix_type3D::Zero()), m_p_prev(scalar_type(0)),
-      m_pstrain_curr(static_matrix_type3D::Zero()), m_p_curr(scalar_type(0)), m_is_plastic_curr(false)
-    {
-    }
+    IsotropicHardeningVMis_qp() : law_qp_bones<T, DIM>() {}
 
-    IsotropicHardeningVMis_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) :
-      law_qp_bones<T, DIM>(point, weight), m_pstrain_prev(static_matrix_type3D::Zero()), m_p_prev(scalar_type(0)),
-      m_pstrain_curr(static_matrix_type3D::Zero()), m_p_curr(scalar_type(0)), m_is_plastic_curr(false)
+    IsotropicHardeningVMis_qp(const point<scalar_type, DIM>& point,
+                              const scalar_type&             weight,
+                              QPStateStore<T>*               state,
+                              const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
+        assert(state->hasPlasticVariables());
     }
 
     bool
     is_plastic() const
     {
-        return m_is_plastic_curr;
+        return this->is_plastic_curr();
     }
 
     static_matrix_type3D
     getPlasticStrain() const
     {
-        return m_pstrain_curr;
+        return this->pstrain_curr();
     }
 
     static_matrix_type
     getTotalStrain() const
     {
-        return convertMatrix<scalar_type, DIM>(this->m_estrain_curr + m_pstrain_curr);
+        return convertMatrix<scalar_type, DIM>(this->estrain_curr() + this->pstrain_curr());
     }
 
     static_matrix_type
     getTotalStrainPrev() const
     {
-        return convertMatrix<scalar_type, DIM>(this->m_estrain_prev + m_pstrain_prev);
+        return convertMatrix<scalar_type, DIM>(this->estrain_prev() + this->pstrain_prev());
     }
 
     scalar_type
     getEquivalentPlasticStrain() const
     {
-        return m_p_curr;
-    }
-
-    void
-    update()
-    {
-        law_qp_bones<T, DIM>::update();
-        m_pstrain_prev = m_pstrain_curr;
-        m_p_prev       = m_p_curr;
+        return this->p_curr();
     }
 
     static_matrix_type3D
@@ -120,7 +103,7 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_curr + data.getLambda() * this->m_estrain_curr.trace() * Id;
+          2 * data.getMu() * this->estrain_curr() + data.getLambda() * this->estrain_curr().trace() * Id;
 
         return stress;
     }
@@ -137,7 +120,7 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return stress;
     }
@@ -148,7 +131,7 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return convertMatrix<scalar_type, DIM>(stress);
     }
@@ -161,18 +144,18 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
         const auto                    nb_point = RpCurve.size();
 
         const static_matrix_type3D incr_strain   = strain_curr - convertMatrix3D(this->getTotalStrainPrev());
-        const static_matrix_type3D estrain_trial = this->m_estrain_prev + incr_strain; // elastic strain trial
+        const static_matrix_type3D estrain_trial = this->estrain_prev() + incr_strain; // elastic strain trial
 
         if (nb_point == 0)
         {
             // We don't have points for the traction curve
             // we suppose that we are in linear elasticity
             // elastic evolution
-            m_is_plastic_curr = false;
+            this->is_plastic_curr() = false;
             // update
-            this->m_estrain_curr = estrain_trial;
-            m_pstrain_curr       = m_pstrain_prev;
-            m_p_curr             = m_p_prev;
+            this->estrain_curr() = estrain_trial;
+            this->pstrain_curr()       = this->pstrain_prev();
+            this->p_curr()             = this->p_prev();
         }
         else
         {
@@ -180,7 +163,7 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
             size_t i0 = nb_point - 2;
             for (size_t i = 0; i < nb_point - 1; i++)
             {
-                if (m_p_prev < RpCurve[i + 1].getP())
+                if (this->p_prev() < RpCurve[i + 1].getP())
                 {
                     i0 = i;
                     break;
@@ -194,12 +177,12 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
             // prediction
             const static_matrix_type3D se         = 2 * data.getMu() * deviator(estrain_trial);
             const scalar_type          se_eq      = this->sigmaeq(se);
-            const scalar_type          Phi_trial0 = se_eq - Rp0 - H0 * (m_p_prev - p0);
+            const scalar_type          Phi_trial0 = se_eq - Rp0 - H0 * (this->p_prev() - p0);
 
             // debug informations
             // std::cout << "point: " << i0 << " on " << nb_point << std::endl;
             // std::cout << "Rp0: " << Rp0 << ", p0: " << p0 << ", H0: " << H0 << std::endl;
-            // std::cout << "se_eq: " << se_eq << ", Rp " << Rp0 + H0 * (m_p_prev - p0) << ", Phi: " << Phi_trial0 <<
+            // std::cout << "se_eq: " << se_eq << ", Rp " << Rp0 + H0 * (this->p_prev() - p0) << ", Phi: " << Phi_trial0 <<
             // std::endl;
 
             if ((std::abs(se.trace()) / se.norm()) > 1E-8)
@@ -214,22 +197,22 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
             if (Phi_trial0 < scalar_type(0))
             {
                 // elastic evolution
-                m_is_plastic_curr = false;
+                this->is_plastic_curr() = false;
             }
             else
             {
                 // plastic evolution
-                m_is_plastic_curr = true;
+                this->is_plastic_curr() = true;
             }
 
             // corection
-            if (m_is_plastic_curr)
+            if (this->is_plastic_curr())
             {
                 const scalar_type troismu = 3 * data.getMu();
                 size_t            i1      = nb_point - 2;
                 for (size_t i = i0 + 1; i < nb_point - 1; i++)
                 {
-                    const scalar_type eq = RpCurve[i].getRp() - troismu * (m_p_prev - RpCurve[i].getP()) - se_eq;
+                    const scalar_type eq = RpCurve[i].getRp() - troismu * (this->p_prev() - RpCurve[i].getP()) - se_eq;
 
                     if (eq > scalar_type(0))
                     {
@@ -242,19 +225,19 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
                 const scalar_type p1  = RpCurve[i1].getP();
                 const scalar_type H1  = (RpCurve[i1 + 1].getRp() - Rp1) / (RpCurve[i1 + 1].getP() - p1);
 
-                const scalar_type Phi_trial1 = se_eq - Rp1 - H1 * (m_p_prev - p1);
+                const scalar_type Phi_trial1 = se_eq - Rp1 - H1 * (this->p_prev() - p1);
 
                 const scalar_type          dem     = troismu + H1;
                 const static_matrix_type3D normal  = scalar_type(3.) * se / (scalar_type(2.) * se_eq);
                 const scalar_type          delta_p = Phi_trial1 / dem;
 
-                // std::cout << "P: " << m_p_prev << ", Rp: " << Rp1 + H1 * (m_p_prev - p1) << ", H: " << H1
+                // std::cout << "P: " << this->p_prev() << ", Rp: " << Rp1 + H1 * (this->p_prev() - p1) << ", H: " << H1
                 //           << ", Si: " << se_eq << ", dp: " << delta_p << std::endl;
 
                 // update
-                m_p_curr             = m_p_prev + delta_p;
-                this->m_estrain_curr = estrain_trial - delta_p * normal;
-                m_pstrain_curr       = m_pstrain_prev + delta_p * normal;
+                this->p_curr()             = this->p_prev() + delta_p;
+                this->estrain_curr() = estrain_trial - delta_p * normal;
+                this->pstrain_curr()       = this->pstrain_prev() + delta_p * normal;
 
                 if (tangentmodulus)
                 {
@@ -270,26 +253,26 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
             else
             {
                 // update
-                this->m_estrain_curr = estrain_trial;
-                m_pstrain_curr       = m_pstrain_prev;
-                m_p_curr             = m_p_prev;
+                this->estrain_curr() = estrain_trial;
+                this->pstrain_curr()       = this->pstrain_prev();
+                this->p_curr()             = this->p_prev();
             }
         }
 
-        if (std::abs(m_pstrain_curr.trace()) > 1E-8)
+        if (std::abs(this->pstrain_curr().trace()) > 1E-8)
         {
-            const std::string mess = "eps_p= " + std::to_string(m_pstrain_curr.trace()) + " <= 0";
+            const std::string mess = "eps_p= " + std::to_string(this->pstrain_curr().trace()) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
         // std::cout << "ep:" << std::endl;
-        // std::cout << m_pstrain_curr << std::endl;
+        // std::cout << this->pstrain_curr() << std::endl;
         // std::cout << "ee:" << std::endl;
-        // std::cout << this->m_estrain_curr << std::endl;
+        // std::cout << this->estrain_curr() << std::endl;
         // std::cout << "e:" << std::endl;
-        // std::cout << this->m_estrain_curr + m_pstrain_curr << std::endl;
+        // std::cout << this->estrain_curr() + this->pstrain_curr() << std::endl;
         // std::cout << "p:" << std::endl;
-        // std::cout << m_p_curr << std::endl;
+        // std::cout << this->p_curr() << std::endl;
 
         // compute Cauchy stress
         const static_matrix_type3D stress = this->compute_stress3D(data);
@@ -297,6 +280,91 @@ class IsotropicHardeningVMis_qp : public law_qp_bones<T, DIM>
         return std::make_pair(stress, Cep);
     }
 
+    /**
+     * @brief Compute the law at num_qp consecutive quadrature points of a cell at once (same results
+     * as compute_whole, including the input checks), see VonMisesBatch
+     */
+    static void
+    compute_whole_batch(IsotropicHardeningVMis_qp*       qps,
+                        const size_t                     num_qp,
+                        const static_matrix_type*        strains,
+                        const data_type&                 data,
+                        static_matrix_type*              stresses,
+                        static_tensor<scalar_type, DIM>* Ceps,
+                        bool                             tangentmodulus = true)
+    {
+        if (num_qp == 0)
+            return;
+
+        const size_t first_id = qps[0].m_state_id;
+        assert(qps[num_qp - 1].m_state_id == first_id + num_qp - 1);
+
+        const auto&       RpCurve  = data.getRpCurve();
+        const size_t      nb_point = RpCurve.size();
+        const scalar_type troismu  = 3 * data.getMu();
+
+        // piecewise linear hardening, the segments are searched as in compute_whole3D
+        auto hardening = [&](const size_t       n,
+                             const scalar_type* p_prev,
+                             const scalar_type* se_eq,
+                             scalar_type*       phi_check,
+                             scalar_type*       phi,
+                             scalar_type*       H_curr)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                if (nb_point < 2)
+                {
+                    // no traction curve, linear elasticity
+                    phi_check[i] = phi[i] = -std::numeric_limits<scalar_type>::infinity();
+                    H_curr[i]             = scalar_type(0);
+                    continue;
+                }
+
+                // we search i0 such that p_prev \in [p_i0, p_{i0+1}]
+                size_t i0 = nb_point - 2;
+                for (size_t k = 0; k < nb_point - 1; k++)
+                {
+                    if (p_prev[i] < RpCurve[k + 1].getP())
+                    {
+                        i0 = k;
+                        break;
+                    }
+                }
+
+                const scalar_type p0 = RpCurve[i0].getP();
+                const scalar_type H0 = (RpCurve[i0 + 1].getRp() - RpCurve[i0].getRp()) / (RpCurve[i0 + 1].getP() - p0);
+                phi_check[i]         = se_eq[i] - RpCurve[i0].getRp() - H0 * (p_prev[i] - p0);
+
+                size_t i1 = nb_point - 2;
+                for (size_t k = i0 + 1; k < nb_point - 1; k++)
+                {
+                    if (RpCurve[k].getRp() - troismu * (p_prev[i] - RpCurve[k].getP()) - se_eq[i] > scalar_type(0))
+                    {
+                        i1 = k - 1;
+                        break;
+                    }
+                }
+
+                const scalar_type p1 = RpCurve[i1].getP();
+                H_curr[i] = (RpCurve[i1 + 1].getRp() - RpCurve[i1].getRp()) / (RpCurve[i1 + 1].getP() - p1);
+                phi[i]    = se_eq[i] - RpCurve[i1].getRp() - H_curr[i] * (p_prev[i] - p1);
+            }
+        };
+
+        VonMisesBatch<T, DIM>::compute(*qps[0].m_state,
+                                       first_id,
+                                       num_qp,
+                                       strains,
+                                       data,
+                                       scalar_type(0),
+                                       hardening,
+                                       stresses,
+                                       Ceps,
+                                       VonMisesBatch<T, DIM>::check_plastic_strain,
+                                       tangentmodulus);
+    }
+
     std::pair<static_matrix_type, static_tensor<scalar_type, DIM>>
     compute_whole(const static_matrix_type& strain_curr, const data_type& data, bool tangentmodulus = true)
     {
@@ -51,8 +51,11 @@ class LinearElasticity_qp : public law_qp_bones<T, DIM>
 
     LinearElasticity_qp() : law_qp_bones<T, DIM>() {}
 
-    LinearElasticity_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) :
-      law_qp_bones<T, DIM>(point, weight)
+    LinearElasticity_qp(const point<scalar_type, DIM>& point,
+                        const scalar_type&             weight,
+                        QPStateStore<T>*               state,
+                        const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
     }
 
@@ -62,7 +65,7 @@ class LinearElasticity_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_curr + data.getLambda() * this->m_estrain_curr.trace() * Id;
+          2 * data.getMu() * this->estrain_curr() + data.getLambda() * this->estrain_curr().trace() * Id;
 
         return stress;
     }
@@ -79,7 +82,7 @@ class LinearElasticity_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return stress;
     }
@@ -90,7 +93,7 @@ class LinearElasticity_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return convertMatrix<scalar_type, DIM>(stress);
     }
@@ -98,7 +101,7 @@ class LinearElasticity_qp : public law_qp_bones<T, DIM>
     std::pair<static_matrix_type3D, static_tensor<scalar_type, 3>>
     compute_whole3D(const static_matrix_type3D& strain_curr, const data_type& data, bool tangentmodulus = true)
     {
-        this->m_estrain_curr                  = strain_curr;
+        this->estrain_curr()                  = strain_curr;
         const static_tensor<scalar_type, 3> C = this->elastic_modulus3D(data);
 
         // compute Cauchy stress
@@ -27,6 +27,7 @@
 
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/mechanics/behaviors/laws/law_qp_bones.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_vonmises_batch.hpp"
 #include "diskpp/mechanics/behaviors/laws/materialData.hpp"
 #include "diskpp/mechanics/behaviors/maths_tensor.hpp"
 #include "diskpp/mechanics/behaviors/maths_utils.hpp"
@@ -51,65 +52,46 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
     typedef static_matrix<scalar_type, 3, 3>     static_matrix_type3D;
     typedef MaterialData<scalar_type>            data_type;
 
-  private:
-    // internal variables at previous step
-    static_matrix_type3D m_pstrain_prev; // plastic strain
-    scalar_type          m_p_prev;       // cumulate plastic strain
-
-    // internal variables at current step
-    static_matrix_type3D m_pstrain_curr;    // plastic strain
-    scalar_type          m_p_curr;          // cumulate plastic strain
-    bool                 m_is_plastic_curr; // the gauss point is plastic ?
-
   public:
-    LinearIsotropicAndKinematicHardening_qp() :
-      law_qp_bones<T, DIM>(), m_pstrain_prev(static_matrix_type3D::Zero()), m_p_prev(scalar_type(0)),
-      m_pstrain_curr(static_matrix_type3D::Zero()), m_p_curr(scalar_type(0)), m_is_plastic_curr(false)
-    {
-    }
+    LinearIsotropicAndKinematicHardening_qp() : law_qp_bones<T, DIM>() {}
 
-    LinearIsotropicAndKinematicHardening_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) :
-      law_qp_bones<T, DIM>(point, weight), m_pstrain_prev(static_matrix_type3D::Zero()), m_p_prev(scalar_type(0)),
-      m_pstrain_curr(static_matrix_type3D::Zero()), m_p_curr(scalar_type(0)), m_is_plastic_curr(false)
+    LinearIsotropicAndKinematicHardening_qp(const point<scalar_type, DIM>& point,
+                                            const scalar_type&             weight,
+                                            QPStateStore<T>*               state,
+                                            const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
+        assert(state->hasPlasticVariables());
     }
 
     bool
     is_plastic() const
     {
-        return m_is_plastic_curr;
+        return this->is_plastic_curr();
     }
 
     static_matrix_type3D
     getPlasticStrain() const
     {
-        return m_pstrain_curr;
+        return this->pstrain_curr();
     }
 
     static_matrix_type
     getTotalStrain() const
     {
-        return convertMatrix<scalar_type, DIM>(this->m_estrain_curr + this->m_pstrain_curr);
+        return convertMatrix<scalar_type, DIM>(this->estrain_curr() + this->pstrain_curr());
     }
 
     static_matrix_type
     getTotalStrainPrev() const
     {
-        return convertMatrix<scalar_type, DIM>(this->m_estrain_prev + this->m_pstrain_prev);
+        return convertMatrix<scalar_type, DIM>(this->estrain_prev() + this->pstrain_prev());
     }
 
     scalar_type
     getEquivalentPlasticStrain() const
     {
-        return m_p_curr;
-    }
-
-    void
-    update()
-    {
-        law_qp_bones<T, DIM>::update();
-        m_pstrain_prev = m_pstrain_curr;
-        m_p_prev       = m_p_curr;
+        return this->p_curr();
     }
 
     static_matrix_type3D
@@ -118,7 +100,7 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_curr + data.getLambda() * this->m_estrain_curr.trace() * Id;
+          2 * data.getMu() * this->estrain_curr() + data.getLambda() * this->estrain_curr().trace() * Id;
 
         return stress;
     }
@@ -135,7 +117,7 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return stress;
     }
@@ -146,7 +128,7 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         const static_matrix_type3D Id = static_matrix_type3D::Identity();
 
         const auto stress =
-          2 * data.getMu() * this->m_estrain_prev + data.getLambda() * this->m_estrain_prev.trace() * Id;
+          2 * data.getMu() * this->estrain_prev() + data.getLambda() * this->estrain_prev().trace() * Id;
 
         return convertMatrix<scalar_type, DIM>(stress);
     }
@@ -158,11 +140,11 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
 
         // prediction
         const static_matrix_type3D incr_strain   = strain_curr - convertMatrix3D(this->getTotalStrainPrev());
-        const static_matrix_type3D estrain_trial = this->m_estrain_prev + incr_strain; // elastic strain trial
-        const static_matrix_type3D X_prev        = data.getK() * m_pstrain_prev;       // back-stress previous
+        const static_matrix_type3D estrain_trial = this->estrain_prev() + incr_strain; // elastic strain trial
+        const static_matrix_type3D X_prev        = data.getK() * this->pstrain_prev();       // back-stress previous
         const static_matrix_type3D se            = 2 * data.getMu() * deviator(estrain_trial) - X_prev;
         const scalar_type          se_eq         = this->sigmaeq(se);
-        const scalar_type          Phi_trial     = se_eq - data.getSigma_y0() - data.getH() * m_p_prev;
+        const scalar_type          Phi_trial     = se_eq - data.getSigma_y0() - data.getH() * this->p_prev();
 
         if ((std::abs(X_prev.trace()) / X_prev.norm()) > 1E-8)
         {
@@ -180,16 +162,16 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         if (Phi_trial < scalar_type(0))
         {
             // elastic evolution
-            m_is_plastic_curr = false;
+            this->is_plastic_curr() = false;
         }
         else
         {
             // plastic evolution
-            m_is_plastic_curr = true;
+            this->is_plastic_curr() = true;
         }
 
         // corection
-        if (m_is_plastic_curr)
+        if (this->is_plastic_curr())
         {
             const scalar_type dem = 3 * data.getMu() + data.getH() + scalar_type(3.) * data.getK() / scalar_type(2.);
             const static_matrix_type3D normal  = scalar_type(3.) * se / (scalar_type(2.) * se_eq);
@@ -199,9 +181,9 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
             //  std::cout << normal << std::endl;
 
             // update
-            m_p_curr             = m_p_prev + delta_p;
-            this->m_estrain_curr = estrain_trial - delta_p * normal;
-            m_pstrain_curr       = m_pstrain_prev + delta_p * normal;
+            this->p_curr()             = this->p_prev() + delta_p;
+            this->estrain_curr() = estrain_trial - delta_p * normal;
+            this->pstrain_curr()       = this->pstrain_prev() + delta_p * normal;
 
             if (tangentmodulus)
             {
@@ -217,23 +199,23 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         else
         {
             // update
-            this->m_estrain_curr = estrain_trial;
-            m_pstrain_curr       = m_pstrain_prev;
-            m_p_curr             = m_p_prev;
+            this->estrain_curr() = estrain_trial;
+            this->pstrain_curr()       = this->pstrain_prev();
+            this->p_curr()             = this->p_prev();
         }
 
-        if ((std::abs(m_pstrain_curr.trace()) / m_pstrain_curr.norm()) > 1E-8)
+        if ((std::abs(this->pstrain_curr().trace()) / this->pstrain_curr().norm()) > 1E-8)
         {
-            const std::string mess = "eps_p= " + std::to_string(m_pstrain_curr.trace()) + " <= 0";
+            const std::string mess = "eps_p= " + std::to_string(this->pstrain_curr().trace()) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
         // std::cout << "ep:" << std::endl;
-        // std::cout << m_pstrain_curr << std::endl;
+        // std::cout << this->pstrain_curr() << std::endl;
         // std::cout << "ee:" << std::endl;
         // std::cout << m_estrain_curr << std::endl;
         // std::cout << "e:" << std::endl;
-        // std::cout << m_estrain_curr + m_pstrain_curr << std::endl;
+        // std::cout << m_estrain_curr + this->pstrain_curr() << std::endl;
 
         // compute Cauchy stress
         const static_matrix_type3D stress = this->compute_stress3D(data);
@@ -246,11 +228,60 @@ class LinearIsotropicAndKinematicHardening_qp : public law_qp_bones<T, DIM>
         //           << std::endl;
 
         // std::cout << "p:" << std::endl;
-        // std::cout << m_p_curr << std::endl;
+        // std::cout << this->p_curr() << std::endl;
 
         return std::make_pair(stress, Cep);
     }
 
+    /**
+     * @brief Compute the law at num_qp consecutive quadrature points of a cell at once (same results
+     * as compute_whole, including the input checks), see VonMisesBatch
+     */
+    static void
+    compute_whole_batch(LinearIsotropicAndKinematicHardening_qp* qps,
+                        const size_t                             num_qp,
+                        const static_matrix_type*                strains,
+                        const data_type&                         data,
+                        static_matrix_type*                      stresses,
+                        static_tensor<scalar_type, DIM>*         Ceps,
+                        bool                                     tangentmodulus = true)
+    {
+        if (num_qp == 0)
+            return;
+
+        const size_t first_id = qps[0].m_state_id;
+        assert(qps[num_qp - 1].m_state_id == first_id + num_qp - 1);
+
+        const scalar_type sigma_y0 = data.getSigma_y0();
+        const scalar_type H        = data.getH();
+
+        auto hardening = [&](const size_t       n,
+                             const scalar_type* p_prev,
+                             const scalar_type* se_eq,
+                             scalar_type*       phi_check,
+                             scalar_type*       phi,
+                             scalar_type*       H_curr)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                phi_check[i] = phi[i] = se_eq[i] - sigma_y0 - H * p_prev[i];
+                H_curr[i]             = H;
+            }
+        };
+
+        VonMisesBatch<T, DIM>::compute(*qps[0].m_state,
+                                       first_id,
+                                       num_qp,
+                                       strains,
+                                       data,
+                                       data.getK(),
+                                       hardening,
+                                       stresses,
+                                       Ceps,
+                                       VonMisesBatch<T, DIM>::check_deviatoric_stress,
+                                       tangentmodulus);
+    }
+
     std::pair<static_matrix_type, static_tensor<scalar_type, DIM>>
     compute_whole(const static_matrix_type& strain_curr, const data_type& data, bool tangentmodulus = true)
     {
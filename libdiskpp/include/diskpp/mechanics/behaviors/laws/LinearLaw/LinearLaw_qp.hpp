@@ -54,14 +54,18 @@ class LinearLaw_qp : public law_qp_bones<T, DIM>
   public:
     LinearLaw_qp() : law_qp_bones<T, DIM>() {}
 
-    LinearLaw_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) : law_qp_bones<T, DIM>(point, weight)
+    LinearLaw_qp(const point<scalar_type, DIM>& point,
+                 const scalar_type&             weight,
+                 QPStateStore<T>*               state,
+                 const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
     }
 
     static_matrix_type3D
     compute_stress3D(const data_type& data) const
     {
-        return data.getLambda() * this->m_estrain_curr;
+        return data.getLambda() * this->estrain_curr();
     }
 
     static_matrix_type
@@ -76,7 +80,7 @@ class LinearLaw_qp : public law_qp_bones<T, DIM>
         static_tensor<scalar_type, 3> Cep = data.getLambda() * IdentityTensor4<scalar_type, 3>();
 
         // is always elastic
-        this->m_estrain_curr = F_curr;
+        this->estrain_curr() = F_curr;
 
         // compute Cauchy stress
         const static_matrix_type3D stress = this->compute_stress3D(data);
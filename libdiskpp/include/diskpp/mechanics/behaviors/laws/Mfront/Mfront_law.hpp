@@ -28,6 +28,7 @@
 
 #ifdef HAVE_MGIS
 
+#include <memory>
 #include <vector>
 
 #include "MGIS/Behaviour/Behaviour.hxx"
@@ -51,15 +52,26 @@ class Mfront_law
   private:
     typedef Mfront_law_cell<mesh_type> law_cell_type;
 
-    size_t                     m_nb_qp;
-    std::vector<law_cell_type> m_list_cell_qp;
-    data_type                  m_data;
-    BehaviourPtr               m_behav;
+    size_t                                     m_nb_qp;
+    std::vector<law_cell_type>                 m_list_cell_qp;
+    data_type                                  m_data;
+    BehaviourPtr                               m_behav;
+    std::unique_ptr<QPStateStore<scalar_type>> m_state; // on the heap, the quadrature points point to it
+
+    /* Deep copy of the store of other, the quadrature points are rebound to the copy */
+    void
+    copyState(const Mfront_law& other)
+    {
+        m_state = std::make_unique<QPStateStore<scalar_type>>(*other.m_state);
+        for (auto& cell_qp : m_list_cell_qp)
+            cell_qp.setState(*m_state);
+    }
 
   public:
-    Mfront_law() : m_nb_qp(0), m_behav(nullptr){};
+    Mfront_law() : m_nb_qp(0), m_behav(nullptr), m_state(std::make_unique<QPStateStore<scalar_type>>()){};
 
-    Mfront_law(const mesh_type& msh, const size_t degree, const BehaviourPtr& b) : m_behav(b)
+    Mfront_law(const mesh_type& msh, const size_t degree, const BehaviourPtr& b) :
+      m_behav(b), m_state(std::make_unique<QPStateStore<scalar_type>>())
     {
         m_nb_qp = 0;
         m_list_cell_qp.clear();
@@ -67,13 +79,41 @@ class Mfront_law
 
         for (auto& cl : msh)
         {
-            law_cell_type cell_qp(msh, cl, degree, m_behav, m_data);
+            law_cell_type cell_qp(msh, cl, degree, m_behav, m_data, *m_state);
 
             m_list_cell_qp.push_back(cell_qp);
             m_nb_qp += cell_qp.getNumberOfQP();
         }
     }
 
+    /**
+     * @brief The copies have their own internal variables, initialized with the ones of other
+     */
+    Mfront_law(const Mfront_law& other) :
+      m_nb_qp(other.m_nb_qp), m_list_cell_qp(other.m_list_cell_qp), m_data(other.m_data), m_behav(other.m_behav)
+    {
+        copyState(other);
+    }
+
+    Mfront_law(Mfront_law&&) = default;
+
+    Mfront_law&
+    operator=(const Mfront_law& other)
+    {
+        if (this != &other)
+        {
+            m_nb_qp        = other.m_nb_qp;
+            m_list_cell_qp = other.m_list_cell_qp;
+            m_data         = other.m_data;
+            m_behav        = other.m_behav;
+            copyState(other);
+        }
+        return *this;
+    }
+
+    Mfront_law&
+    operator=(Mfront_law&&) = default;
+
     void
     addMaterialData(const data_type materialData)
     {
@@ -99,12 +139,51 @@ class Mfront_law
     void
     update()
     {
+        m_state->update();
         for (auto& qp_cell : m_list_cell_qp)
         {
             qp_cell.update(m_data);
         }
     }
 
+    void
+    rollback()
+    {
+        m_state->rollback();
+        for (auto& qp_cell : m_list_cell_qp)
+        {
+            qp_cell.rollback();
+        }
+    }
+
+    /**
+     * @brief Write the state of the last converged step of all the quadrature points in a checkpoint
+     */
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        m_state->save(out);
+        for (auto& qp_cell : m_list_cell_qp)
+        {
+            qp_cell.save(out);
+        }
+    }
+
+    /**
+     * @brief Read the state written by save()
+     */
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        m_state->load(in);
+        for (auto& qp_cell : m_list_cell_qp)
+        {
+            qp_cell.load(in);
+        }
+    }
+
     law_cell_type&
     getCellQPs(const int cell_id)
     {
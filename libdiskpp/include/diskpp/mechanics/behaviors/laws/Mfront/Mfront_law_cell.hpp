@@ -64,22 +64,39 @@ class Mfront_law_cell
   public:
     Mfront_law_cell() : m_behav(nullptr) {}
 
-    Mfront_law_cell(const mesh_type& msh, const cell_type& cl, const size_t degree, const BehaviourPtr& b, const data_type& data):
-    m_behav(b)
+    Mfront_law_cell(const mesh_type&           msh,
+                    const cell_type&           cl,
+                    const size_t               degree,
+                    const BehaviourPtr&        b,
+                    const data_type&           data,
+                    QPStateStore<scalar_type>& state) :
+      m_behav(b)
     {
         const auto qps = integrate(msh, cl, degree);
 
         m_list_qp.clear();
         m_list_qp.reserve(qps.size());
 
+        size_t qp_id = state.add(qps.size());
         for (auto& qp : qps)
         {
-            auto mqp = law_qp_type(qp.point(), qp.weight(), b);
+            auto mqp = law_qp_type(qp.point(), qp.weight(), &state, qp_id++, b);
             mqp.addMaterialParameters(data);
             m_list_qp.push_back(mqp);
         }
     }
 
+    /**
+     * @brief Point the quadrature points to another store with the same layout, used by the copies of
+     * the law
+     */
+    void
+    setState(QPStateStore<scalar_type>& state)
+    {
+        for (auto& qp : m_list_qp)
+            qp.setState(&state);
+    }
+
     int
     getNumberOfQP() const
     {
@@ -96,6 +113,35 @@ class Mfront_law_cell
         }
     }
 
+    void
+    rollback()
+    {
+        for (auto& qp : m_list_qp)
+        {
+            qp.rollback();
+        }
+    }
+
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        for (auto& qp : m_list_qp)
+        {
+            qp.save(out);
+        }
+    }
+
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        for (auto& qp : m_list_qp)
+        {
+            qp.load(in);
+        }
+    }
+
     void
     addInitialMaterialParameters(const data_type& data)
     {
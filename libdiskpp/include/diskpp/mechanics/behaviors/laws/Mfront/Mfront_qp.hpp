@@ -76,8 +76,13 @@ class Mfront_qp : public law_qp_bones<T, DIM>
     {
     }
 
-    Mfront_qp(const point<scalar_type, DIM>& point, const scalar_type& weight, const BehaviourPtr& behav) :
-      law_qp_bones<T, DIM>(point, weight), m_behav(behav), m_behavData(*m_behav),
+    Mfront_qp(const point<scalar_type, DIM>& point,
+              const scalar_type&             weight,
+              QPStateStore<scalar_type>*     state,
+              const size_t                   state_id,
+              const BehaviourPtr&            behav) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id),
+      m_behav(behav), m_behavData(*m_behav),
       m_behavDataView(mgis::behaviour::make_view(m_behavData))
     {
         if ((*m_behav).kinematic == mgis::behaviour::Behaviour::SMALLSTRAINKINEMATIC)
@@ -101,6 +106,40 @@ class Mfront_qp : public law_qp_bones<T, DIM>
         mgis::behaviour::update(m_behavData);
     }
 
+    // the state at the end of the step is reset to the state at the beginning
+    void
+    rollback()
+    {
+        mgis::behaviour::revert(m_behavData);
+    }
+
+    // the state at the beginning of the step is written in a checkpoint, the sizes are given by the behaviour
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        const auto& s0 = m_behavData.s0;
+        out.write(s0.gradients.data(), s0.gradients.size());
+        out.write(s0.thermodynamic_forces.data(), s0.thermodynamic_forces.size());
+        out.write(s0.internal_state_variables.data(), s0.internal_state_variables.size());
+        out.write(&s0.stored_energy, 1);
+        out.write(&s0.dissipated_energy, 1);
+    }
+
+    // the state written by save() becomes the state at the beginning and at the end of the step
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        auto& s0 = m_behavData.s0;
+        in.read(s0.gradients.data(), s0.gradients.size());
+        in.read(s0.thermodynamic_forces.data(), s0.thermodynamic_forces.size());
+        in.read(s0.internal_state_variables.data(), s0.internal_state_variables.size());
+        in.read(&s0.stored_energy, 1);
+        in.read(&s0.dissipated_energy, 1);
+        mgis::behaviour::revert(m_behavData);
+    }
+
     scalar_type
     getEquivalentPlasticStrain() const
     {
@@ -166,7 +205,7 @@ class Mfront_qp : public law_qp_bones<T, DIM>
     std::pair<static_matrix_type3D, static_tensor<scalar_type, 3>>
     compute_whole3D(const static_matrix_type3D& strain_curr, const data_type& data, bool tangentmodulus = true)
     {
-        this->m_estrain_curr = strain_curr;
+        this->estrain_curr() = strain_curr;
 
         if (tangentmodulus)
         {
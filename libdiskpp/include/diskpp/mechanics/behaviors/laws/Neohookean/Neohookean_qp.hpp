@@ -127,14 +127,14 @@ class Neohookean_qp : public law_qp_bones<T, DIM>
     static_tensor<scalar_type, 3>
     compute_tangent_moduli_A(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const scalar_type J = this->estrain_curr().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF  = this->m_estrain_curr.inverse();
+        const static_matrix_type3D invF  = this->estrain_curr().inverse();
         const static_matrix_type3D invFt = invF.transpose();
 
         const scalar_type T1 = compute_T1(data, J);
@@ -150,24 +150,28 @@ class Neohookean_qp : public law_qp_bones<T, DIM>
   public:
     Neohookean_qp() : law_qp_bones<T, DIM>() {}
 
-    Neohookean_qp(const point<scalar_type, DIM>& point, const scalar_type& weight) : law_qp_bones<T, DIM>(point, weight)
+    Neohookean_qp(const point<scalar_type, DIM>& point,
+                  const scalar_type&             weight,
+                  QPStateStore<T>*               state,
+                  const size_t                   state_id) :
+      law_qp_bones<T, DIM>(point, weight, state, state_id)
     {
     }
 
     static_matrix_type3D
     compute_stress3D(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const scalar_type J = this->estrain_curr().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF = this->m_estrain_curr.inverse();
+        const static_matrix_type3D invF = this->estrain_curr().inverse();
         const scalar_type          T1   = compute_T1(data, J);
 
-        return data.getMu() * this->m_estrain_curr + (data.getLambda() * T1 - data.getMu()) * invF.transpose();
+        return data.getMu() * this->estrain_curr() + (data.getLambda() * T1 - data.getMu()) * invF.transpose();
     }
 
     static_matrix_type
@@ -179,30 +183,32 @@ class Neohookean_qp : public law_qp_bones<T, DIM>
     static_matrix_type3D
     compute_stressPrev3D(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_prev.determinant();
+        const scalar_type J = this->estrain_prev().determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D invF = this->m_estrain_prev.inverse();
+        const static_matrix_type3D invF = this->estrain_prev().inverse();
         const scalar_type          T1   = compute_T1(data, J);
 
-        return data.getMu() * this->m_estrain_prev + (data.getLambda() * T1 - data.getMu()) * invF.transpose();
+        return data.getMu() * this->estrain_prev() + (data.getLambda() * T1 - data.getMu()) * invF.transpose();
     }
 
     scalar_type
     compute_energy(const data_type& data) const
     {
-        const scalar_type J = this->m_estrain_curr.determinant();
+        const static_matrix_type3D F = this->estrain_curr();
+
+        const scalar_type J = F.determinant();
         if (J <= 0.0)
         {
             const std::string mess = "J= " + std::to_string(J) + " <= 0";
             throw std::invalid_argument(mess);
         }
 
-        const static_matrix_type3D C = convertFtoCauchyGreenRight(this->m_estrain_curr);
+        const static_matrix_type3D C = convertFtoCauchyGreenRight(F);
 
         const scalar_type Wiso = data.getMu() / 2.0 * (C.trace() - 3);
         const scalar_type Wvol =
@@ -215,7 +221,7 @@ class Neohookean_qp : public law_qp_bones<T, DIM>
     compute_whole3D(const static_matrix_type3D& F_curr, const data_type& data, bool tangentmodulus = true)
     {
         // is always elastic
-        this->m_estrain_curr = F_curr;
+        this->estrain_curr() = F_curr;
 
         const auto PK1 = this->compute_stress3D(data);
         const auto A   = this->compute_tangent_moduli_A(data);
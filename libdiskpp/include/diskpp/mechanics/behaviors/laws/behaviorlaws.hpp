@@ -411,6 +411,50 @@ class Behavior
         }
     }
 
+    /**
+     * @brief Compute the stress and the tangent modulus at all the quadrature points of a cell, with the
+     * batched kernels of the law if it has some (same results as compute_whole at each point)
+     */
+    void
+    compute_whole_batch(const size_t&                                         cell_id,
+                        const eigen_compatible_stdvector<static_matrix_type>& RkT_iqns,
+                        eigen_compatible_stdvector<static_matrix_type>&       stresses,
+                        eigen_compatible_stdvector<static_tensor_type>&       Ceps,
+                        bool                                                  tangent = true)
+    {
+        switch (m_id)
+        {
+            case 100: m_elastic.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent); break;
+            case 101: m_linearHard.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent); break;
+            case 102:
+                m_nonlinearHard.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+            case 103:
+                m_henckymises.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+            case 200: m_neohokean.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent); break;
+            case 201: m_cavitation.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+            case 300:
+                m_log_elastic.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+            case 301:
+                m_log_linearHard.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+            case 302:
+                m_log_nonlinearHard.getCellQPs(cell_id).compute_whole_batch(RkT_iqns, m_data, stresses, Ceps, tangent);
+                break;
+
+            default:
+                stresses.resize(RkT_iqns.size());
+                Ceps.resize(RkT_iqns.size());
+                for (size_t qp_id = 0; qp_id < RkT_iqns.size(); qp_id++)
+                {
+                    std::tie(stresses[qp_id], Ceps[qp_id]) = compute_whole(cell_id, qp_id, RkT_iqns[qp_id], tangent);
+                }
+        }
+    }
+
     static_matrix<scalar_type, 3, 3>
     compute_stress3D(const size_t& cell_id, const size_t& qp_id) const
     {
@@ -508,6 +552,93 @@ class Behavior
         }
     }
 
+    /**
+     * @brief Discard the computations since the last update, after a failed time step
+     */
+    void rollback(void)
+    {
+        switch (m_id)
+        {
+            case 100: return m_elastic.rollback(); break;
+            case 101: return m_linearHard.rollback(); break;
+            case 102: return m_nonlinearHard.rollback(); break;
+            case 103: return m_henckymises.rollback(); break;
+            case 200: return m_neohokean.rollback(); break;
+            case 201: return m_cavitation.rollback(); break;
+            case 300: return m_log_elastic.rollback(); break;
+            case 301: return m_log_linearHard.rollback(); break;
+            case 302: return m_log_nonlinearHard.rollback(); break;
+#ifdef HAVE_MGIS
+            case 500: return m_mfront.rollback(); break;
+#endif
+
+            default: throw std::invalid_argument("Behavior error: Unknown id law");
+        }
+    }
+
+    /**
+     * @brief Write the internal variables of the last converged step in a checkpoint, after the id of the law
+     *
+     * @param out output with a method write(const U* values, size_t n)
+     */
+    template<typename Output>
+    void
+    saveState(Output& out) const
+    {
+        const uint64_t id = m_id;
+        out.write(&id, 1);
+        switch (m_id)
+        {
+            case 100: return m_elastic.getState().save(out); break;
+            case 101: return m_linearHard.getState().save(out); break;
+            case 102: return m_nonlinearHard.getState().save(out); break;
+            case 103: return m_henckymises.getState().save(out); break;
+            case 200: return m_neohokean.getState().save(out); break;
+            case 201: return m_cavitation.getState().save(out); break;
+            case 300: return m_log_elastic.getState().save(out); break;
+            case 301: return m_log_linearHard.getState().save(out); break;
+            case 302: return m_log_nonlinearHard.getState().save(out); break;
+#ifdef HAVE_MGIS
+            case 500: return m_mfront.save(out); break;
+#endif
+
+            default: throw std::invalid_argument("Behavior error: Unknown id law");
+        }
+    }
+
+    /**
+     * @brief Read the internal variables written by saveState(), the law has to be the same
+     *
+     * @param in input with a method read(U* values, size_t n)
+     */
+    template<typename Input>
+    void
+    loadState(Input& in)
+    {
+        uint64_t id;
+        in.read(&id, 1);
+        if (id != m_id)
+            throw std::invalid_argument("Behavior error: the saved law is not the current law");
+
+        switch (m_id)
+        {
+            case 100: return m_elastic.getState().load(in); break;
+            case 101: return m_linearHard.getState().load(in); break;
+            case 102: return m_nonlinearHard.getState().load(in); break;
+            case 103: return m_henckymises.getState().load(in); break;
+            case 200: return m_neohokean.getState().load(in); break;
+            case 201: return m_cavitation.getState().load(in); break;
+            case 300: return m_log_elastic.getState().load(in); break;
+            case 301: return m_log_linearHard.getState().load(in); break;
+            case 302: return m_log_nonlinearHard.getState().load(in); break;
+#ifdef HAVE_MGIS
+            case 500: return m_mfront.load(in); break;
+#endif
+
+            default: throw std::invalid_argument("Behavior error: Unknown id law");
+        }
+    }
+
     vector_type
     projectStressOnCell(const MeshType& msh, const cell_type& cl, const hho_degree_info& hdi) const
     {
@@ -26,10 +26,12 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/mechanics/behaviors/laws/law_cell_bones.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_qp_state.hpp"
 #include "diskpp/mechanics/behaviors/maths_tensor.hpp"
 #include "diskpp/mechanics/behaviors/maths_utils.hpp"
 
@@ -48,25 +50,69 @@ class LawTypeBones
     typedef LawTypeQp                           law_qp_type;
     typedef typename law_qp_type::data_type     data_type;
 
+    const static bool plastic_behavior = PlasticBehavior;
+
   private:
     typedef LawTypeCellBones<mesh_type, law_qp_type, PlasticBehavior> law_cell_type;
+    typedef QPStateStore<scalar_type>                                 state_type;
+
+    size_t                      m_nb_qp;
+    std::vector<law_cell_type>  m_list_cell_qp;
+    data_type                   m_data;
+    std::unique_ptr<state_type> m_state; // on the heap, the quadrature points point to it
 
-    size_t                     m_nb_qp;
-    std::vector<law_cell_type> m_list_cell_qp;
-    data_type                  m_data;
+    /* Deep copy of the store of other, the quadrature points are rebound to the copy */
+    void
+    copyState(const LawTypeBones& other)
+    {
+        m_state.reset(other.m_state ? new state_type(*other.m_state) : nullptr);
+        if (m_state)
+        {
+            for (auto& cell_qp : m_list_cell_qp)
+                cell_qp.setState(*m_state);
+        }
+    }
 
   public:
     LawTypeBones() : m_nb_qp(0){};
 
+    /**
+     * @brief The copies have their own internal variables, initialized with the ones of other
+     */
+    LawTypeBones(const LawTypeBones& other) :
+      m_nb_qp(other.m_nb_qp), m_list_cell_qp(other.m_list_cell_qp), m_data(other.m_data)
+    {
+        copyState(other);
+    }
+
+    LawTypeBones(LawTypeBones&&) = default;
+
+    LawTypeBones&
+    operator=(const LawTypeBones& other)
+    {
+        if (this != &other)
+        {
+            m_nb_qp        = other.m_nb_qp;
+            m_list_cell_qp = other.m_list_cell_qp;
+            m_data         = other.m_data;
+            copyState(other);
+        }
+        return *this;
+    }
+
+    LawTypeBones&
+    operator=(LawTypeBones&&) = default;
+
     LawTypeBones(const mesh_type& msh, const size_t degree)
     {
         m_nb_qp = 0;
+        m_state = std::make_unique<state_type>(PlasticBehavior);
         m_list_cell_qp.clear();
         m_list_cell_qp.reserve(msh.cells_size());
 
         for (auto& cl : msh)
         {
-            law_cell_type cell_qp(msh, cl, degree);
+            law_cell_type cell_qp(msh, cl, degree, *m_state);
 
             m_list_cell_qp.push_back(cell_qp);
             m_nb_qp += cell_qp.getNumberOfQP();
@@ -91,13 +137,36 @@ class LawTypeBones
         return m_nb_qp;
     }
 
+    /**
+     * @brief The current step becomes the previous step, for all the quadrature points
+     */
     void
     update()
     {
-        for (auto& qp_cell : m_list_cell_qp)
-        {
-            qp_cell.update();
-        }
+        if (m_state)
+            m_state->update();
+    }
+
+    /**
+     * @brief Discard the computations since the last update, for all the quadrature points
+     */
+    void
+    rollback()
+    {
+        if (m_state)
+            m_state->rollback();
+    }
+
+    state_type&
+    getState()
+    {
+        return *m_state;
+    }
+
+    const state_type&
+    getState() const
+    {
+        return *m_state;
     }
 
     law_cell_type&
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <tuple>
 #include <vector>
 
 #include "diskpp/bases/bases.hpp"
@@ -62,32 +63,42 @@ class LawTypeCellBones
     std::vector<law_qp_type> m_list_qp;
 
   public:
-    LawTypeCellBones(const mesh_type& msh, const cell_type& cl, const size_t degree)
+    /**
+     * @brief Create the quadrature points of the cell. Their internal variables are added to state.
+     */
+    LawTypeCellBones(const mesh_type&           msh,
+                     const cell_type&           cl,
+                     const size_t               degree,
+                     QPStateStore<scalar_type>& state)
     {
-        const auto qps = integrate(msh, cl, degree);
+        const auto   qps      = integrate(msh, cl, degree);
+        const size_t first_id = state.add(qps.size());
 
         m_list_qp.clear();
         m_list_qp.reserve(qps.size());
 
+        size_t qp_id = first_id;
         for (auto& qp : qps)
         {
-            m_list_qp.push_back(law_qp_type(qp.point(), qp.weight()));
+            m_list_qp.push_back(law_qp_type(qp.point(), qp.weight(), &state, qp_id++));
         }
     }
 
-    int
-    getNumberOfQP() const
+    /**
+     * @brief Point the quadrature points to another store with the same layout, used by the copies of
+     * the laws
+     */
+    void
+    setState(QPStateStore<scalar_type>& state)
     {
-        return m_list_qp.size();
+        for (auto& qp : m_list_qp)
+            qp.setState(&state);
     }
 
-    void
-    update()
+    int
+    getNumberOfQP() const
     {
-        for (auto& qp : m_list_qp)
-        {
-            qp.update();
-        }
+        return m_list_qp.size();
     }
 
     std::vector<law_qp_type>&
@@ -120,6 +131,48 @@ class LawTypeCellBones
         return m_list_qp;
     }
 
+    /**
+     * @brief Compute the stress and the tangent modulus at all the quadrature points of the cell.
+     * The laws which provide a static compute_whole_batch evaluate all the points at once, the
+     * other laws are evaluated point by point.
+     *
+     * @param strains strain (or deformation gradient) at each quadrature point
+     * @param material_data material data
+     * @param stresses stress at each quadrature point (output)
+     * @param Ceps tangent modulus at each quadrature point (output)
+     * @param tangentmodulus compute the tangent modulus
+     */
+    template<typename StaticMatrixType, typename StaticTensorType>
+    void
+    compute_whole_batch(const eigen_compatible_stdvector<StaticMatrixType>& strains,
+                        const data_type&                                    material_data,
+                        eigen_compatible_stdvector<StaticMatrixType>&       stresses,
+                        eigen_compatible_stdvector<StaticTensorType>&       Ceps,
+                        bool                                                tangentmodulus = true)
+    {
+        assert(strains.size() == m_list_qp.size());
+        stresses.resize(m_list_qp.size());
+        Ceps.resize(m_list_qp.size());
+
+        if constexpr (requires { &law_qp_type::compute_whole_batch; })
+        {
+            law_qp_type::compute_whole_batch(m_list_qp.data(),
+                                             m_list_qp.size(),
+                                             strains.data(),
+                                             material_data,
+                                             stresses.data(),
+                                             Ceps.data(),
+                                             tangentmodulus);
+        }
+        else
+        {
+            for (size_t i = 0; i < m_list_qp.size(); i++)
+            {
+                std::tie(stresses[i], Ceps[i]) = m_list_qp[i].compute_whole(strains[i], material_data, tangentmodulus);
+            }
+        }
+    }
+
     vector_type
     projectStressOnCell(const mesh_type&             msh,
                         const cell_type&             cl,
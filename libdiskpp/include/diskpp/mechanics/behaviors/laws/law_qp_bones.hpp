@@ -27,6 +27,7 @@
 #pragma once
 
 #include "diskpp/common/eigen.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_qp_state.hpp"
 #include "diskpp/mechanics/behaviors/laws/materialData.hpp"
 #include "diskpp/mechanics/behaviors/maths_tensor.hpp"
 #include "diskpp/mechanics/behaviors/maths_utils.hpp"
@@ -51,15 +52,86 @@ class law_qp_bones
     typedef MaterialData<scalar_type>            data_type;
 
   protected:
+    typedef QPStateStore<scalar_type>              state_type;
+    typedef Eigen::Map<static_matrix_type3D>       state_matrix_type;
+    typedef Eigen::Map<const static_matrix_type3D> const_state_matrix_type;
+
     // coordinat and weight of considered gauss point.
     point<scalar_type, DIM> m_point;
     scalar_type             m_weight;
 
-    // internal variables at current step
-    static_matrix_type3D m_estrain_prev; // elastic strain
+    // internal variables are stored in a mesh-wide store, see law_qp_state.hpp
+    state_type* m_state;
+    size_t      m_state_id;
+
+    // internal variables at previous step
+    const_state_matrix_type
+    estrain_prev() const // elastic strain
+    {
+        return const_state_matrix_type(m_state->elasticStrainPrev(m_state_id));
+    }
 
     // internal variables at current step
-    static_matrix_type3D m_estrain_curr; // elastic strain
+    const_state_matrix_type
+    estrain_curr() const // elastic strain
+    {
+        return const_state_matrix_type(m_state->elasticStrain(m_state_id));
+    }
+
+    state_matrix_type
+    estrain_curr()
+    {
+        return state_matrix_type(m_state->elasticStrainWrite(m_state_id));
+    }
+
+    // plastic variables, only for plastic laws
+    const_state_matrix_type
+    pstrain_prev() const // plastic strain
+    {
+        return const_state_matrix_type(m_state->plasticStrainPrev(m_state_id));
+    }
+
+    const_state_matrix_type
+    pstrain_curr() const
+    {
+        return const_state_matrix_type(m_state->plasticStrain(m_state_id));
+    }
+
+    state_matrix_type
+    pstrain_curr()
+    {
+        return state_matrix_type(m_state->plasticStrainWrite(m_state_id));
+    }
+
+    scalar_type
+    p_prev() const // cumulate plastic strain
+    {
+        return m_state->equivalentPlasticStrainPrev(m_state_id);
+    }
+
+    scalar_type
+    p_curr() const
+    {
+        return m_state->equivalentPlasticStrain(m_state_id);
+    }
+
+    scalar_type&
+    p_curr()
+    {
+        return m_state->equivalentPlasticStrainWrite(m_state_id);
+    }
+
+    bool
+    is_plastic_curr() const // the gauss point is plastic ?
+    {
+        return m_state->isPlastic(m_state_id);
+    }
+
+    uint8_t&
+    is_plastic_curr()
+    {
+        return m_state->isPlasticWrite(m_state_id);
+    }
 
     static_tensor<scalar_type, DIM>
     elastic_modulus(const data_type& data) const
@@ -82,15 +154,24 @@ class law_qp_bones
     }
 
   public:
-    law_qp_bones() :
-      m_weight(0), m_estrain_prev(static_matrix_type3D::Zero()), m_estrain_curr(static_matrix_type3D::Zero())
+    law_qp_bones() : m_weight(0), m_state(nullptr), m_state_id(0) {}
+
+    law_qp_bones(const point<scalar_type, DIM>& point,
+                 const scalar_type&             weight,
+                 state_type*                    state,
+                 const size_t                   state_id) :
+      m_point(point), m_weight(weight), m_state(state), m_state_id(state_id)
     {
     }
 
-    law_qp_bones(const point<scalar_type, DIM>& point, const scalar_type& weight) :
-      m_point(point), m_weight(weight), m_estrain_prev(static_matrix_type3D::Zero()),
-      m_estrain_curr(static_matrix_type3D::Zero())
+    /**
+     * @brief Point to another store of internal variables with the same layout, used by the copies of
+     * the laws
+     */
+    void
+    setState(state_type* state)
     {
+        m_state = state;
     }
 
     quadrature_point<scalar_type, DIM>
@@ -120,7 +201,7 @@ class law_qp_bones
     static_matrix_type3D
     getElasticStrain() const
     {
-        return m_estrain_curr;
+        return estrain_curr();
     }
 
     static_matrix_type3D
@@ -132,13 +213,13 @@ class law_qp_bones
     static_matrix_type
     getTotalStrain() const
     {
-        return m_estrain_curr.block(0, 0, DIM, DIM);
+        return estrain_curr().block(0, 0, DIM, DIM);
     }
 
     static_matrix_type
     getTotalStrainPrev() const
     {
-        return m_estrain_prev.block(0, 0, DIM, DIM);
+        return estrain_prev().block(0, 0, DIM, DIM);
     }
 
     scalar_type
@@ -147,10 +228,10 @@ class law_qp_bones
         return scalar_type(0);
     }
 
+    // the previous step is updated by the store
     void
     update()
     {
-        m_estrain_prev = m_estrain_curr;
     }
 };
 }
@@ -0,0 +1,320 @@
+/*
+ *       /\        Matteo Cicuttin (C) 2016, 2017, 2018
+ *      /__\       matteo.cicuttin@enpc.fr
+ *     /_\/_\      École Nationale des Ponts et Chaussées - CERMICS
+ *    /\    /\
+ *   /__\  /__\    DISK++, a template library for DIscontinuous SKeletal
+ *  /_\/_\/_\/_\   methods.
+ *
+ * This file is copyright of the following authors:
+ * Nicolas Pignet  (C) 2018                     nicolas.pignet@enpc.fr
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * If you use this code or parts of it for scientific publications, you
+ * are required to cite it as following:
+ *
+ * Hybrid High-Order methods for finite elastoplastic deformations
+ * within a logarithmic strain framework.
+ * M. Abbas, A. Ern, N. Pignet.
+ * International Journal of Numerical Methods in Engineering (2019)
+ * 120(3), 303-327
+ * DOI: 10.1002/nme.6137
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace disk
+{
+
+/**
+ * @brief Internal variables of all the quadrature points of the mesh, stored as structure of arrays:
+ * each variable of all the quadrature points is contiguous in memory.
+ *
+ * The variables are
+ *  - the elastic strain (3x3, column major)
+ *  - the plastic strain (3x3, column major), only for plastic laws
+ *  - the equivalent plastic strain, only for plastic laws
+ *  - the plastic state, only for plastic laws
+ *
+ * There are two buffers, one for the previous step and one for the current step. update() swaps
+ * the buffers instead of copying the current step in the previous one. A quadrature point is copied
+ * from the previous step to the current step only when it is modified the first time after
+ * update(), until then reading the current step returns the values of the previous step. Since all
+ * the points are computed at each Newton iteration, update() does not copy anything in practice.
+ *
+ * @tparam T scalar type
+ */
+template<typename T>
+class QPStateStore
+{
+  public:
+    static const size_t strain_size = 9;
+
+  private:
+    struct buffer
+    {
+        std::vector<T>       elastic_strain;
+        std::vector<T>       plastic_strain;
+        std::vector<T>       equivalent_plastic_strain;
+        std::vector<uint8_t> plastic;
+    };
+
+    bool                 m_plastic;
+    size_t               m_size;
+    size_t               m_curr;
+    buffer               m_buffers[2];
+    std::vector<uint8_t> m_written;
+
+    const buffer&
+    prev_buffer(void) const
+    {
+        return m_buffers[1 - m_curr];
+    }
+
+    /* buffer containing the current values of the point */
+    const buffer&
+    read_buffer(size_t qp) const
+    {
+        assert(qp < m_size);
+        return m_written[qp] ? m_buffers[m_curr] : m_buffers[1 - m_curr];
+    }
+
+    /* copy the point from the previous step, if not done since the last update */
+    buffer&
+    write_buffer(size_t qp)
+    {
+        assert(qp < m_size);
+        buffer& curr = m_buffers[m_curr];
+        if (!m_written[qp])
+        {
+            const buffer& prev = prev_buffer();
+            std::copy_n(prev.elastic_strain.begin() + qp * strain_size, strain_size,
+                        curr.elastic_strain.begin() + qp * strain_size);
+            if (m_plastic)
+            {
+                std::copy_n(prev.plastic_strain.begin() + qp * strain_size, strain_size,
+                            curr.plastic_strain.begin() + qp * strain_size);
+                curr.equivalent_plastic_strain[qp] = prev.equivalent_plastic_strain[qp];
+                curr.plastic[qp]                   = prev.plastic[qp];
+            }
+            m_written[qp] = 1;
+        }
+        return curr;
+    }
+
+  public:
+    /**
+     * @brief Construct an empty store
+     *
+     * @param plastic allocate the plastic variables
+     */
+    QPStateStore(bool plastic = false) : m_plastic(plastic), m_size(0), m_curr(0) {}
+
+    /**
+     * @brief Add num_qp quadrature points, with all the variables set to zero
+     *
+     * @return size_t index of the first new point
+     */
+    size_t
+    add(size_t num_qp)
+    {
+        const size_t first = m_size;
+        m_size += num_qp;
+
+        for (auto& buf : m_buffers)
+        {
+            buf.elastic_strain.resize(m_size * strain_size, T(0));
+            if (m_plastic)
+            {
+                buf.plastic_strain.resize(m_size * strain_size, T(0));
+                buf.equivalent_plastic_strain.resize(m_size, T(0));
+                buf.plastic.resize(m_size, 0);
+            }
+        }
+        m_written.resize(m_size, 1);
+
+        return first;
+    }
+
+    size_t
+    size(void) const
+    {
+        return m_size;
+    }
+
+    bool
+    hasPlasticVariables(void) const
+    {
+        return m_plastic;
+    }
+
+    /**
+     * @brief The current step becomes the previous step. The points that were not written during the
+     * step are copied first, so that both buffers are up to date for them.
+     */
+    void
+    update(void)
+    {
+        for (size_t qp = 0; qp < m_size; qp++)
+            write_buffer(qp);
+
+        m_curr = 1 - m_curr;
+        std::fill(m_written.begin(), m_written.end(), 0);
+    }
+
+    /**
+     * @brief Discard the writes since the last update: the current step is again equal to the previous
+     * step for all the points. Nothing is copied.
+     */
+    void
+    rollback(void)
+    {
+        std::fill(m_written.begin(), m_written.end(), 0);
+    }
+
+    /**
+     * @brief Write the variables of the previous step, i.e. of the last converged step, in a checkpoint
+     *
+     * @param out output with a method write(const U* values, size_t n)
+     */
+    template<typename Output>
+    void
+    save(Output& out) const
+    {
+        const buffer& prev = prev_buffer();
+
+        out.write(uint8_t(m_plastic));
+        out.write(uint64_t(m_size));
+        out.write(prev.elastic_strain.data(), prev.elastic_strain.size());
+        if (m_plastic)
+        {
+            out.write(prev.plastic_strain.data(), prev.plastic_strain.size());
+            out.write(prev.equivalent_plastic_strain.data(), prev.equivalent_plastic_strain.size());
+            out.write(prev.plastic.data(), prev.plastic.size());
+        }
+    }
+
+    /**
+     * @brief Read the variables written by save() in the previous step, the current step is then equal to
+     * the previous step. The store must have the same points than the store that was saved.
+     *
+     * @param in input with a method read(U* values, size_t n)
+     */
+    template<typename Input>
+    void
+    load(Input& in)
+    {
+        uint8_t  plastic;
+        uint64_t size;
+        in.read(&plastic, 1);
+        in.read(&size, 1);
+        if (bool(plastic) != m_plastic || size != m_size)
+            throw std::runtime_error("QPStateStore: the saved quadrature points do not match");
+
+        buffer& prev = m_buffers[1 - m_curr];
+        in.read(prev.elastic_strain.data(), prev.elastic_strain.size());
+        if (m_plastic)
+        {
+            in.read(prev.plastic_strain.data(), prev.plastic_strain.size());
+            in.read(prev.equivalent_plastic_strain.data(), prev.equivalent_plastic_strain.size());
+            in.read(prev.plastic.data(), prev.plastic.size());
+        }
+        std::fill(m_written.begin(), m_written.end(), 0);
+    }
+
+    /**
+     * @brief Make the current step of the points [first, first + num_qp) writable, for the kernels
+     * that work directly on the arrays
+     */
+    void
+    prepareWrite(size_t first, size_t num_qp)
+    {
+        for (size_t qp = first; qp < first + num_qp; qp++)
+            write_buffer(qp);
+    }
+
+    const T*
+    elasticStrainPrev(size_t qp) const
+    {
+        return prev_buffer().elastic_strain.data() + qp * strain_size;
+    }
+
+    const T*
+    elasticStrain(size_t qp) const
+    {
+        return read_buffer(qp).elastic_strain.data() + qp * strain_size;
+    }
+
+    T*
+    elasticStrainWrite(size_t qp)
+    {
+        return write_buffer(qp).elastic_strain.data() + qp * strain_size;
+    }
+
+    const T*
+    plasticStrainPrev(size_t qp) const
+    {
+        assert(m_plastic);
+        return prev_buffer().plastic_strain.data() + qp * strain_size;
+    }
+
+    const T*
+    plasticStrain(size_t qp) const
+    {
+        assert(m_plastic);
+        return read_buffer(qp).plastic_strain.data() + qp * strain_size;
+    }
+
+    T*
+    plasticStrainWrite(size_t qp)
+    {
+        assert(m_plastic);
+        return write_buffer(qp).plastic_strain.data() + qp * strain_size;
+    }
+
+    T
+    equivalentPlasticStrainPrev(size_t qp) const
+    {
+        assert(m_plastic);
+        return prev_buffer().equivalent_plastic_strain[qp];
+    }
+
+    T
+    equivalentPlasticStrain(size_t qp) const
+    {
+        assert(m_plastic);
+        return read_buffer(qp).equivalent_plastic_strain[qp];
+    }
+
+    T&
+    equivalentPlasticStrainWrite(size_t qp)
+    {
+        assert(m_plastic);
+        return write_buffer(qp).equivalent_plastic_strain[qp];
+    }
+
+    bool
+    isPlastic(size_t qp) const
+    {
+        assert(m_plastic);
+        return read_buffer(qp).plastic[qp];
+    }
+
+    uint8_t&
+    isPlasticWrite(size_t qp)
+    {
+        assert(m_plastic);
+        return write_buffer(qp).plastic[qp];
+    }
+};
+
+}
@@ -0,0 +1,294 @@
+/*
+ *       /\        Matteo Cicuttin (C) 2016, 2017, 2018
+ *      /__\       matteo.cicuttin@enpc.fr
+ *     /_\/_\      École Nationale des Ponts et Chaussées - CERMICS
+ *    /\    /\
+ *   /__\  /__\    DISK++, a template library for DIscontinuous SKeletal
+ *  /_\/_\/_\/_\   methods.
+ *
+ * This file is copyright of the following authors:
+ * Nicolas Pignet  (C) 2018                     nicolas.pignet@enpc.fr
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * If you use this code or parts of it for scientific publications, you
+ * are required to cite it as following:
+ *
+ * Hybrid High-Order methods for finite elastoplastic deformations
+ * within a logarithmic strain framework.
+ * M. Abbas, A. Ern, N. Pignet.
+ * International Journal of Numerical Methods in Engineering (2019)
+ * 120(3), 303-327
+ * DOI: 10.1002/nme.6137
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_qp_state.hpp"
+#include "diskpp/mechanics/behaviors/laws/materialData.hpp"
+
+namespace disk
+{
+
+/**
+ * @brief Radial return and consistent tangent modulus of the von Mises plasticity laws in small
+ * deformations, for blocks of quadrature points.
+ *
+ * The quadrature points are processed by blocks of block_size points. The internal variables of a
+ * block are first gathered from the QPStateStore in arrays with one entry per point, then all the
+ * computations are done by loops over the points of the block without branches, which the compiler
+ * can vectorize, and finally the results are scattered back to the store. The only per point
+ * computation is the evaluation of the hardening, which can search in a traction curve.
+ *
+ * The tensors are symmetric and stored by their 6 components xx, yy, zz, xy, xz, yz.
+ *
+ * The input checks of the per point laws (deviatoric back stress and trial stress, deviatoric
+ * plastic strain) are done for each block after the correction, outside the vectorized loops, and
+ * throw std::invalid_argument with the same messages. The internal variables of a block which
+ * fails a check are not written.
+ *
+ * @tparam T scalar type
+ * @tparam DIM dimension of the mesh
+ */
+template<typename T, int DIM>
+class VonMisesBatch
+{
+  public:
+    static const size_t block_size = 8;
+
+    typedef static_matrix<T, DIM, DIM> static_matrix_type;
+    typedef static_tensor<T, DIM>      static_tensor_type;
+    typedef MaterialData<T>            data_type;
+
+    /* Input checks done on each block, see compute() */
+    enum checks : unsigned
+    {
+        /* tr(X_prev) and tr(se) small with respect to their norm, as the kinematic hardening law */
+        check_deviatoric_stress = 1,
+        /* |tr(eps_p)| <= 1E-8 after the correction, as the isotropic hardening law */
+        check_plastic_strain = 2,
+    };
+
+  private:
+    static const int num_comp = 6;
+
+    /* row, column and weight in the norms of each component */
+    static int
+    row(int c)
+    {
+        static const int r[num_comp] = {0, 1, 2, 0, 0, 1};
+        return r[c];
+    }
+
+    static int
+    col(int c)
+    {
+        static const int s[num_comp] = {0, 1, 2, 1, 2, 2};
+        return s[c];
+    }
+
+    static T
+    weight(int c)
+    {
+        return c < 3 ? T(1) : T(2);
+    }
+
+  public:
+    /**
+     * @brief Compute the new internal variables, the Cauchy stress and the tangent modulus of the
+     * points [first_id, first_id + num_qp) of the store
+     *
+     * @param state store of the internal variables, with plastic variables
+     * @param first_id index of the first point in the store
+     * @param num_qp number of points
+     * @param strains linearized strain at each point
+     * @param data material data (mu and lambda are used)
+     * @param K linear kinematic hardening modulus, zero for a purely isotropic hardening
+     * @param hardening functor hardening(n, p_prev, se_eq, phi_check, phi, H) which computes for the
+     * n points of a block (including the unused points of the last block), given the previous
+     * equivalent plastic strain and the von Mises stress of the trial state, the yield function
+     * phi_check of the trial state used to check the plasticity, and the yield function phi and the
+     * hardening slope H used for the radial return
+     * @param stresses Cauchy stress at each point (output)
+     * @param Ceps tangent modulus at each point (output)
+     * @param check_mask input checks to do, see checks
+     * @param tangentmodulus compute the consistent tangent modulus, else the elastic modulus
+     */
+    template<typename Hardening>
+    static void
+    compute(QPStateStore<T>&          state,
+            const size_t              first_id,
+            const size_t              num_qp,
+            const static_matrix_type* strains,
+            const data_type&          data,
+            const T                   K,
+            const Hardening&          hardening,
+            static_matrix_type*       stresses,
+            static_tensor_type*       Ceps,
+            const unsigned            check_mask,
+            bool                      tangentmodulus = true)
+    {
+        assert(state.hasPlasticVariables());
+
+        const T mu     = data.getMu();
+        const T lambda = data.getLambda();
+        const T mu2    = mu * mu;
+
+        /* variables of a block, one entry per point */
+        T estrain[num_comp][block_size], pstrain[num_comp][block_size], se[num_comp][block_size];
+        T p[block_size], se_eq[block_size], phi_check[block_size], phi[block_size], H[block_size];
+        T coeff_nxn[block_size], coeff_dev[block_size];
+        T tr_X[block_size], norm_X[block_size], tr_se[block_size], norm_se[block_size];
+        bool plastic[block_size];
+
+        for (size_t first = 0; first < num_qp; first += block_size)
+        {
+            const size_t n = std::min(block_size, num_qp - first);
+
+            // gather the previous step and compute the elastic strain trial
+            for (size_t i = 0; i < block_size; i++)
+            {
+                if (i >= n)
+                {
+                    for (int c = 0; c < num_comp; c++)
+                        estrain[c][i] = pstrain[c][i] = T(0);
+                    p[i] = T(0);
+                    continue;
+                }
+
+                const size_t id      = first_id + first + i;
+                const T*     ee_prev = state.elasticStrainPrev(id);
+                const T*     ep_prev = state.plasticStrainPrev(id);
+                for (int c = 0; c < num_comp; c++)
+                {
+                    const int k  = row(c) + 3 * col(c);
+                    T         ee = ee_prev[k];
+                    if (row(c) < DIM && col(c) < DIM)
+                        ee += strains[first + i](row(c), col(c)) - (ee_prev[k] + ep_prev[k]);
+
+                    estrain[c][i] = ee;
+                    pstrain[c][i] = ep_prev[k];
+                }
+                p[i] = state.equivalentPlasticStrainPrev(id);
+            }
+
+            // prediction
+            for (size_t i = 0; i < block_size; i++)
+            {
+                const T tr = (estrain[0][i] + estrain[1][i] + estrain[2][i]) / T(3);
+                T       sq = T(0), sq_p = T(0);
+                for (int c = 0; c < num_comp; c++)
+                {
+                    const T dev = c < 3 ? estrain[c][i] - tr : estrain[c][i];
+                    se[c][i]    = 2 * mu * dev - K * pstrain[c][i];
+                    sq += weight(c) * se[c][i] * se[c][i];
+                    sq_p += weight(c) * pstrain[c][i] * pstrain[c][i];
+                }
+                se_eq[i] = std::sqrt(T(1.5) * sq);
+
+                tr_X[i]    = K * (pstrain[0][i] + pstrain[1][i] + pstrain[2][i]);
+                norm_X[i]  = std::abs(K) * std::sqrt(sq_p);
+                tr_se[i]   = se[0][i] + se[1][i] + se[2][i];
+                norm_se[i] = std::sqrt(sq);
+            }
+
+            hardening(block_size, p, se_eq, phi_check, phi, H);
+
+            // correction
+            for (size_t i = 0; i < block_size; i++)
+            {
+                plastic[i] = phi_check[i] >= T(0);
+
+                const T dem     = 3 * mu + H[i] + T(1.5) * K;
+                const T inv_eq  = se_eq[i] > T(0) ? T(1) / se_eq[i] : T(0);
+                const T delta_p = plastic[i] ? phi[i] / dem : T(0);
+
+                for (int c = 0; c < num_comp; c++)
+                {
+                    const T normal = T(1.5) * se[c][i] * inv_eq;
+                    estrain[c][i] -= delta_p * normal;
+                    pstrain[c][i] += delta_p * normal;
+                    se[c][i] = normal;
+                }
+                p[i] += delta_p;
+
+                coeff_nxn[i] = plastic[i] ? 4 * mu2 * (delta_p * inv_eq - T(1) / dem) : T(0);
+                coeff_dev[i] = plastic[i] ? 6 * mu2 * delta_p * inv_eq : T(0);
+            }
+
+            // input checks, a zero norm gives NaN and passes as in the per point laws
+            for (size_t i = 0; i < n; i++)
+            {
+                if (check_mask & check_deviatoric_stress)
+                {
+                    if (std::abs(tr_X[i]) / norm_X[i] > T(1E-8))
+                        throw std::invalid_argument("X_trace= " + std::to_string(tr_X[i]) + " <= 0");
+
+                    if (std::abs(tr_se[i]) / norm_se[i] > T(1E-8))
+                        throw std::invalid_argument("Se_trace= " + std::to_string(tr_se[i]) + " <= 0");
+                }
+
+                const T tr_p = pstrain[0][i] + pstrain[1][i] + pstrain[2][i];
+                if ((check_mask & check_plastic_strain) && std::abs(tr_p) > T(1E-8))
+                    throw std::invalid_argument("eps_p= " + std::to_string(tr_p) + " <= 0");
+            }
+
+            // scatter the current step, the stress and the tangent modulus
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t id = first_id + first + i;
+                T*           ee = state.elasticStrainWrite(id);
+                T*           ep = state.plasticStrainWrite(id);
+                for (int c = 0; c < num_comp; c++)
+                {
+                    ee[row(c) + 3 * col(c)] = ee[col(c) + 3 * row(c)] = estrain[c][i];
+                    ep[row(c) + 3 * col(c)] = ep[col(c) + 3 * row(c)] = pstrain[c][i];
+                }
+                state.equivalentPlasticStrainWrite(id) = p[i];
+                state.isPlasticWrite(id)               = plastic[i];
+
+                const T tr = estrain[0][i] + estrain[1][i] + estrain[2][i];
+                for (int c = 0; c < num_comp; c++)
+                {
+                    if (row(c) < DIM && col(c) < DIM)
+                    {
+                        const T s = 2 * mu * estrain[c][i] + (c < 3 ? lambda * tr : T(0));
+                        stresses[first + i](row(c), col(c)) = stresses[first + i](col(c), row(c)) = s;
+                    }
+                }
+
+                // C_ijkl = 2 mu Is + lambda IxI + a n x n - b (Is - IxI / 3), stored at (i * DIM + k, j * DIM + l)
+                static_matrix<T, 3, 3> normal;
+                for (int c = 0; c < num_comp; c++)
+                    normal(row(c), col(c)) = normal(col(c), row(c)) = se[c][i];
+
+                const T a = tangentmodulus ? coeff_nxn[i] : T(0);
+                const T b = tangentmodulus ? coeff_dev[i] : T(0);
+
+                static_tensor_type& Cep = Ceps[first + i];
+                for (int ii = 0; ii < DIM; ii++)
+                    for (int jj = 0; jj < DIM; jj++)
+                        for (int kk = 0; kk < DIM; kk++)
+                            for (int ll = 0; ll < DIM; ll++)
+                            {
+                                const T Is  = T(0.5) * (T(ii == kk && jj == ll) + T(ii == ll && jj == kk));
+                                const T IxI = T(ii == jj && kk == ll);
+
+                                Cep(ii * DIM + kk, jj * DIM + ll) = (2 * mu - b) * Is + (lambda + b / T(3)) * IxI +
+                                                                    a * normal(ii, jj) * normal(kk, ll);
+                            }
+            }
+        }
+    }
+};
+
+}
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "diskpp/common/eigen.hpp"
@@ -64,22 +65,65 @@ class LogarithmicStrain
     typedef LawTypeCellBones<mesh_type, law_qp_type, true> law_cell_type;
 
   private:
-    size_t                     m_nb_qp;
-    std::vector<law_cell_type> m_list_cell_qp;
-    data_type                  m_data;
+    typedef QPStateStore<scalar_type> state_type;
+
+    size_t                      m_nb_qp;
+    std::vector<law_cell_type>  m_list_cell_qp;
+    data_type                   m_data;
+    std::unique_ptr<state_type> m_state; // on the heap, the quadrature points point to it
+
+    /* Deep copy of the store of other, the quadrature points are rebound to the copy */
+    void
+    copyState(const LogarithmicStrain& other)
+    {
+        m_state.reset(other.m_state ? new state_type(*other.m_state) : nullptr);
+        if (m_state)
+        {
+            for (auto& cell_qp : m_list_cell_qp)
+                cell_qp.setState(*m_state);
+        }
+    }
 
   public:
     LogarithmicStrain() : m_nb_qp(0){};
 
+    /**
+     * @brief The copies have their own internal variables, initialized with the ones of other
+     */
+    LogarithmicStrain(const LogarithmicStrain& other) :
+      m_nb_qp(other.m_nb_qp), m_list_cell_qp(other.m_list_cell_qp), m_data(other.m_data)
+    {
+        copyState(other);
+    }
+
+    LogarithmicStrain(LogarithmicStrain&&) = default;
+
+    LogarithmicStrain&
+    operator=(const LogarithmicStrain& other)
+    {
+        if (this != &other)
+        {
+            m_nb_qp        = other.m_nb_qp;
+            m_list_cell_qp = other.m_list_cell_qp;
+            m_data         = other.m_data;
+            copyState(other);
+        }
+        return *this;
+    }
+
+    LogarithmicStrain&
+    operator=(LogarithmicStrain&&) = default;
+
     LogarithmicStrain(const mesh_type& msh, const size_t degree)
     {
         m_nb_qp = 0;
+        m_state = std::make_unique<state_type>(law_hpp_type::plastic_behavior);
         m_list_cell_qp.clear();
         m_list_cell_qp.reserve(msh.cells_size());
 
         for (auto& cl : msh)
         {
-            law_cell_type cell_qp(msh, cl, degree);
+            law_cell_type cell_qp(msh, cl, degree, *m_state);
 
             m_list_cell_qp.push_back(cell_qp);
             m_nb_qp += cell_qp.getNumberOfQP();
@@ -107,10 +151,27 @@ class LogarithmicStrain
     void
     update()
     {
-        for (auto& qp_cell : m_list_cell_qp)
-        {
-            qp_cell.update();
-        }
+        if (m_state)
+            m_state->update();
+    }
+
+    void
+    rollback()
+    {
+        if (m_state)
+            m_state->rollback();
+    }
+
+    state_type&
+    getState()
+    {
+        return *m_state;
+    }
+
+    const state_type&
+    getState() const
+    {
+        return *m_state;
     }
 
 
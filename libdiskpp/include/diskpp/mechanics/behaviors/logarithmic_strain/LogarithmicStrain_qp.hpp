@@ -148,12 +148,21 @@ class LogarithmicStrain_qp
     }
 
   public:
-    LogarithmicStrain_qp(const point<scalar_type, DIM>& point, const scalar_type& weight)
+    LogarithmicStrain_qp(const point<scalar_type, DIM>& point,
+                         const scalar_type&             weight,
+                         QPStateStore<scalar_type>*     state,
+                         const size_t                   state_id)
     {
-        m_law_hpp_qp = law_hpp_qp_type(point, weight);
+        m_law_hpp_qp = law_hpp_qp_type(point, weight, state, state_id);
         Pn           = static_tensor<scalar_type, 3>::Zero();
     }
 
+    void
+    setState(QPStateStore<scalar_type>* state)
+    {
+        m_law_hpp_qp.setState(state);
+    }
+
     quadrature_point<scalar_type, DIM>
     quadrature_point() const
     {
@@ -51,7 +51,7 @@ compute_eigenvalues(const static_matrix<T, N, N>& Mat)
 {
     typedef static_matrix<T, N, N> matrix_type;
 
-    SelfAdjointEigenSolver<matrix_type> es(Mat);
+    Eigen::SelfAdjointEigenSolver<matrix_type> es(Mat);
 
     // std::cout << "eigenvalues:" << std::endl;
     // std::cout << es.eigenvalues() << std::endl;
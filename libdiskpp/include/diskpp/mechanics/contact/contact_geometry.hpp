@@ -26,8 +26,10 @@
 
 #pragma once
 
-#include "bases/bases.hpp"
-#include "common/eigen.hpp"
+#include <algorithm>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/mesh/point.hpp"
 
 namespace disk
 {
@@ -36,10 +38,119 @@ namespace mechanics
 
 template<typename T, size_t DIM>
 static_vector<T, DIM>
-gap(const point_type<T, DIM>& p_mast, const point_type<T, DIM>& p_slav)
+gap(const point<T, DIM>& p_mast, const point<T, DIM>& p_slav)
 {
     return (p_mast - p_slav).to_vector();
 }
 
+/**
+ * @brief Closest point of the segment [a, b] to p
+ *
+ * @param p point
+ * @param a first vertex of the segment
+ * @param b second vertex of the segment
+ * @param bar barycentric coordinates of the closest point with respect to a and b (output)
+ * @return static_vector<T, DIM> closest point
+ */
+template<typename T, int DIM>
+static_vector<T, DIM>
+closest_point_segment(const static_vector<T, DIM>& p,
+                      const static_vector<T, DIM>& a,
+                      const static_vector<T, DIM>& b,
+                      static_vector<T, 2>&         bar)
+{
+    const static_vector<T, DIM> ab = b - a;
+    const T                     l2 = ab.squaredNorm();
+
+    T t = l2 > T(0) ? (p - a).dot(ab) / l2 : T(0);
+    t   = std::min(std::max(t, T(0)), T(1));
+
+    bar(0) = T(1) - t;
+    bar(1) = t;
+    return a + t * ab;
+}
+
+/**
+ * @brief Closest point of the triangle (a, b, c) to p, by the Voronoi regions of the vertices, edges
+ * and interior of the triangle (Ericson, Real-Time Collision Detection, 5.1.5)
+ *
+ * @param p point
+ * @param a first vertex of the triangle
+ * @param b second vertex of the triangle
+ * @param c third vertex of the triangle
+ * @param bar barycentric coordinates of the closest point with respect to a, b and c (output)
+ * @return static_vector<T, 3> closest point
+ */
+template<typename T>
+static_vector<T, 3>
+closest_point_triangle(const static_vector<T, 3>& p,
+                       const static_vector<T, 3>& a,
+                       const static_vector<T, 3>& b,
+                       const static_vector<T, 3>& c,
+                       static_vector<T, 3>&       bar)
+{
+    const static_vector<T, 3> ab = b - a;
+    const static_vector<T, 3> ac = c - a;
+    const static_vector<T, 3> ap = p - a;
+
+    const T d1 = ab.dot(ap);
+    const T d2 = ac.dot(ap);
+    if (d1 <= T(0) && d2 <= T(0))
+    {
+        bar = static_vector<T, 3>(1, 0, 0);
+        return a;
+    }
+
+    const static_vector<T, 3> bp = p - b;
+
+    const T d3 = ab.dot(bp);
+    const T d4 = ac.dot(bp);
+    if (d3 >= T(0) && d4 <= d3)
+    {
+        bar = static_vector<T, 3>(0, 1, 0);
+        return b;
+    }
+
+    const T vc = d1 * d4 - d3 * d2;
+    if (vc <= T(0) && d1 >= T(0) && d3 <= T(0))
+    {
+        const T v = d1 / (d1 - d3);
+        bar       = static_vector<T, 3>(T(1) - v, v, 0);
+        return a + v * ab;
+    }
+
+    const static_vector<T, 3> cp = p - c;
+
+    const T d5 = ab.dot(cp);
+    const T d6 = ac.dot(cp);
+    if (d6 >= T(0) && d5 <= d6)
+    {
+        bar = static_vector<T, 3>(0, 0, 1);
+        return c;
+    }
+
+    const T vb = d5 * d2 - d1 * d6;
+    if (vb <= T(0) && d2 >= T(0) && d6 <= T(0))
+    {
+        const T w = d2 / (d2 - d6);
+        bar       = static_vector<T, 3>(T(1) - w, 0, w);
+        return a + w * ac;
+    }
+
+    const T va = d3 * d6 - d5 * d4;
+    if (va <= T(0) && (d4 - d3) >= T(0) && (d5 - d6) >= T(0))
+    {
+        const T w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        bar       = static_vector<T, 3>(0, T(1) - w, w);
+        return b + w * (c - b);
+    }
+
+    const T denom = T(1) / (va + vb + vc);
+    const T v     = vb * denom;
+    const T w     = vc * denom;
+    bar           = static_vector<T, 3>(T(1) - v - w, v, w);
+    return a + v * ab + w * ac;
+}
+
 } // end mechanics
-} // diskpp
\ No newline at end of file
+} // diskpp
@@ -26,15 +26,688 @@
 
 #pragma once
 
-#include "bases/bases.hpp"
-#include "common/eigen.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/geometry/geometry.hpp"
+#include "diskpp/mechanics/contact/contact_geometry.hpp"
+#include "diskpp/quadratures/quadratures.hpp"
 
 namespace disk
 {
 namespace mechanics
 {
 
+/**
+ * @brief Axis-aligned bounding box
+ *
+ * @tparam T scalar type
+ * @tparam DIM dimension
+ */
+template<typename T, size_t DIM>
+class BoundingBox
+{
+    typedef static_vector<T, DIM> vector_type;
+
+    vector_type m_min, m_max;
+
+  public:
+    /**
+     * @brief Construct an empty box
+     */
+    BoundingBox()
+    {
+        m_min.setConstant(std::numeric_limits<T>::max());
+        m_max.setConstant(std::numeric_limits<T>::lowest());
+    }
+
+    const vector_type&
+    min() const
+    {
+        return m_min;
+    }
+
+    const vector_type&
+    max() const
+    {
+        return m_max;
+    }
+
+    void
+    extend(const vector_type& p)
+    {
+        m_min = m_min.cwiseMin(p);
+        m_max = m_max.cwiseMax(p);
+    }
+
+    void
+    extend(const BoundingBox& box)
+    {
+        m_min = m_min.cwiseMin(box.m_min);
+        m_max = m_max.cwiseMax(box.m_max);
+    }
+
+    vector_type
+    center() const
+    {
+        return (m_min + m_max) / T(2);
+    }
+
+    /**
+     * @brief Index of the direction where the box is the largest
+     */
+    int
+    largestAxis() const
+    {
+        int axis;
+        (m_max - m_min).maxCoeff(&axis);
+        return axis;
+    }
+
+    /**
+     * @brief Squared distance between the box and p, zero if p is in the box
+     */
+    T
+    squaredDistance(const vector_type& p) const
+    {
+        const vector_type d = (m_min - p).cwiseMax(p - m_max).cwiseMax(vector_type::Zero());
+        return d.squaredNorm();
+    }
+
+    /**
+     * @brief Perimeter in 2D and area of the boundary in 3D, which measures the quality of a tree of boxes
+     */
+    T
+    surface() const
+    {
+        const vector_type e = (m_max - m_min).cwiseMax(vector_type::Zero());
+        if constexpr (DIM == 2)
+            return 2 * (e(0) + e(1));
+        else
+            return 2 * (e(0) * e(1) + e(0) * e(2) + e(1) * e(2));
+    }
+};
+
+/**
+ * @brief Projection of a point on the closest master face
+ */
+template<typename T, size_t DIM>
+struct ContactProjection
+{
+    bool                  found;        // false if no master face is closer than the search distance
+    size_t                master_face;  // index of the master face in the mesh
+    point<T, DIM>         master_point; // projection of the point on the master face
+    static_vector<T, DIM> normal;       // outward unit normal of the master face at master_point
+    T                     distance;     // distance between the point and master_point
+};
+
+/**
+ * @brief Quadrature point of a slave face paired with a master face
+ */
+template<typename T, size_t DIM>
+struct ContactPair
+{
+    size_t                   slave_face;  // index of the slave face in the mesh
+    point<T, DIM>            slave_point; // quadrature point in the current configuration
+    point<T, DIM>            slave_ref;   // quadrature point in the reference configuration
+    T                        weight;      // quadrature weight in the reference configuration
+    ContactProjection<T, DIM> master;     // projection on the master boundary
+    T                        gap;         // normal gap, negative if the slave point penetrates the master
+};
+
+/**
+ * @brief Pairing of the quadrature points of the slave boundary with the faces of the master boundary,
+ * in the current (deformed) configuration.
+ *
+ * The master faces are stored in a bounding volume hierarchy (a binary tree of axis-aligned boxes),
+ * such that the closest master face of a point is found in logarithmic time. When the displacement
+ * changes, between two Newton iterations or two time steps, the boxes are refitted from the leaves to
+ * the root without changing the structure of the tree. The tree is rebuilt only when the refitted boxes
+ * have grown too much with respect to the last build (the total surface of the boxes measures how much
+ * they overlap), i.e. when the deformation has changed the neighbours of the faces.
+ *
+ * The geometry of the faces is defined by the vertices of the mesh. The polygonal faces are split in
+ * triangles joining the barycenter of the face to its edges, which assumes that the vertices of a face
+ * are ordered along its boundary.
+ *
+ * Scope: the pairing is not used yet by NewtonSolver, whose contact (ContactManager) is the Signorini
+ * condition against a rigid obstacle and needs no search. A two-body contact formulation has to own the
+ * pairing and call updateDisplacement(), which refits the tree, with the displacement of the points of the
+ * mesh at each Newton iteration, before pairSlaveFaces(). Calling refit() or build() alone only makes sense
+ * when the geometry has not changed since the last update.
+ *
+ * @tparam MeshType type of the mesh (2D or 3D)
+ */
+template<typename MeshType>
+class ContactPairing
+{
+  public:
+    typedef MeshType                            mesh_type;
+    typedef typename mesh_type::coordinate_type scalar_type;
+
+    const static size_t dimension = mesh_type::dimension;
+
+    typedef point<scalar_type, dimension>              point_type;
+    typedef static_vector<scalar_type, dimension>      vector_type;
+    typedef BoundingBox<scalar_type, dimension>        box_type;
+    typedef ContactProjection<scalar_type, dimension>  projection_type;
+    typedef ContactPair<scalar_type, dimension>        pair_type;
+
+    static_assert(dimension == 2 || dimension == 3, "ContactPairing: only 2D and 3D meshes");
+
+  private:
+    /* faces of a boundary, their vertices are contiguous in vertices */
+    struct face_list
+    {
+        std::vector<size_t> faces;
+        std::vector<size_t> offsets;
+        std::vector<size_t> vertices;
+
+        size_t
+        size() const
+        {
+            return faces.size();
+        }
+
+        size_t
+        numVertices(size_t i) const
+        {
+            return offsets[i + 1] - offsets[i];
+        }
+
+        const size_t*
+        vertex(size_t i) const
+        {
+            return vertices.data() + offsets[i];
+        }
+    };
+
+    /* a leaf if count > 0, with the faces m_order[first, first + count), else the children are left and
+     * right, which are stored after their parent */
+    struct bvh_node
+    {
+        box_type box;
+        size_t   first, count;
+        size_t   left, right;
+    };
+
+    struct slave_qp
+    {
+        size_t      face;
+        point_type  ref_point;
+        scalar_type weight;
+        size_t      first_coeff;
+    };
+
+    static const size_t leaf_size = 4;
+
+    eigen_compatible_stdvector<vector_type> m_ref_nodes, m_nodes;
+
+    face_list                m_master, m_slave;
+    std::vector<scalar_type> m_master_orientation;
+
+    std::vector<slave_qp>    m_slave_qps;
+    std::vector<scalar_type> m_slave_coeffs;
+
+    std::vector<box_type> m_face_boxes;
+    std::vector<size_t>   m_order;
+    std::vector<bvh_node> m_tree;
+
+    scalar_type m_build_surface;
+    scalar_type m_rebuild_ratio;
+    size_t      m_num_builds, m_num_refits;
+
+    /* closest point of a face to p, with its barycentric coordinates with respect to the vertices of
+     * the face (if coeffs is not null) and the unit normal given by the ordering of the vertices */
+    static scalar_type
+    closest_point_face(const vector_type&                             p,
+                       const size_t*                                  vtx,
+                       const size_t                                   nv,
+                       const eigen_compatible_stdvector<vector_type>& nodes,
+                       vector_type&                                   proj,
+                       vector_type&                                   normal,
+                       scalar_type*                                   coeffs)
+    {
+        if constexpr (dimension == 2)
+        {
+            assert(nv == 2);
+            const vector_type& a = nodes[vtx[0]];
+            const vector_type& b = nodes[vtx[1]];
+
+            static_vector<scalar_type, 2> bar;
+            proj = closest_point_segment(p, a, b, bar);
+
+            const vector_type t = b - a;
+            normal              = vector_type(t(1), -t(0)).normalized();
+            if (coeffs)
+            {
+                coeffs[0] = bar(0);
+                coeffs[1] = bar(1);
+            }
+            return (p - proj).squaredNorm();
+        }
+        else
+        {
+            assert(nv >= 3);
+            static_vector<scalar_type, 3> bar;
+            if (nv == 3)
+            {
+                const vector_type& a = nodes[vtx[0]];
+                const vector_type& b = nodes[vtx[1]];
+                const vector_type& c = nodes[vtx[2]];
+
+                proj   = closest_point_triangle(p, a, b, c, bar);
+                normal = (b - a).cross(c - a).normalized();
+                if (coeffs)
+                    std::copy_n(bar.data(), 3, coeffs);
+                return (p - proj).squaredNorm();
+            }
+
+            vector_type center = vector_type::Zero();
+            for (size_t k = 0; k < nv; k++)
+                center += nodes[vtx[k]];
+            center /= scalar_type(nv);
+
+            scalar_type best = std::numeric_limits<scalar_type>::max();
+            size_t      best_k = 0;
+            static_vector<scalar_type, 3> best_bar = static_vector<scalar_type, 3>::Zero();
+            for (size_t k = 0; k < nv; k++)
+            {
+                const vector_type& b = nodes[vtx[k]];
+                const vector_type& c = nodes[vtx[(k + 1) % nv]];
+
+                const vector_type q  = closest_point_triangle(p, center, b, c, bar);
+                const scalar_type d2 = (p - q).squaredNorm();
+                if (d2 < best)
+                {
+                    best     = d2;
+                    best_k   = k;
+                    best_bar = bar;
+                    proj     = q;
+                    normal   = (b - center).cross(c - center);
+                }
+            }
+            normal.normalize();
+
+            if (coeffs)
+            {
+                std::fill_n(coeffs, nv, best_bar(0) / scalar_type(nv));
+                coeffs[best_k] += best_bar(1);
+                coeffs[(best_k + 1) % nv] += best_bar(2);
+            }
+            return best;
+        }
+    }
+
+    /* normal of a face given by the ordering of its vertices, weighted by the measure */
+    vector_type
+    face_normal(const size_t* vtx, const size_t nv) const
+    {
+        if constexpr (dimension == 2)
+        {
+            const vector_type t = m_nodes[vtx[1]] - m_nodes[vtx[0]];
+            return vector_type(t(1), -t(0));
+        }
+        else
+        {
+            vector_type n = vector_type::Zero();
+            for (size_t k = 0; k < nv; k++)
+                n += m_nodes[vtx[k]].cross(m_nodes[vtx[(k + 1) % nv]]);
+            return n;
+        }
+    }
+
+    void
+    compute_face_boxes()
+    {
+        m_face_boxes.resize(m_master.size());
+        for (size_t i = 0; i < m_master.size(); i++)
+        {
+            box_type      box;
+            const size_t* vtx = m_master.vertex(i);
+            for (size_t k = 0; k < m_master.numVertices(i); k++)
+                box.extend(m_nodes[vtx[k]]);
+            m_face_boxes[i] = box;
+        }
+    }
+
+    scalar_type
+    tree_surface() const
+    {
+        scalar_type s = 0;
+        for (auto& node : m_tree)
+            s += node.box.surface();
+        return s;
+    }
+
+    /* top-down build: the faces are split at the median of their centers along the largest direction */
+    size_t
+    build_node(size_t first, size_t count)
+    {
+        const size_t node_id = m_tree.size();
+        m_tree.push_back(bvh_node());
+
+        box_type box, centers;
+        for (size_t i = first; i < first + count; i++)
+        {
+            box.extend(m_face_boxes[m_order[i]]);
+            centers.extend(m_face_boxes[m_order[i]].center());
+        }
+
+        if (count <= leaf_size)
+        {
+            m_tree[node_id] = bvh_node{box, first, count, 0, 0};
+            return node_id;
+        }
+
+        const int    axis = centers.largestAxis();
+        const size_t half = count / 2;
+        std::nth_element(m_order.begin() + first,
+                         m_order.begin() + first + half,
+                         m_order.begin() + first + count,
+                         [&](size_t a, size_t b)
+                         { return m_face_boxes[a].center()(axis) < m_face_boxes[b].center()(axis); });
+
+        const size_t left  = build_node(first, half);
+        const size_t right = build_node(first + half, count - half);
+        m_tree[node_id]    = bvh_node{box, 0, 0, left, right};
+        return node_id;
+    }
+
+    /* interpolate the current position of a quadrature point of a slave face */
+    vector_type
+    slave_position(const slave_qp& qp) const
+    {
+        const size_t* vtx = m_slave.vertex(qp.face);
+        vector_type   x   = vector_type::Zero();
+        for (size_t k = 0; k < m_slave.numVertices(qp.face); k++)
+            x += m_slave_coeffs[qp.first_coeff + k] * m_nodes[vtx[k]];
+        return x;
+    }
+
+  public:
+    /**
+     * @brief Collect the faces of the master and slave boundaries, build the tree of the master faces and
+     * compute the quadrature of the slave faces
+     *
+     * @param msh mesh
+     * @param master_id boundary id of the master faces
+     * @param slave_id boundary id of the slave faces
+     * @param degree degree of the quadrature on the slave faces
+     */
+    ContactPairing(const mesh_type& msh, const size_t master_id, const size_t slave_id, const size_t degree) :
+      m_build_surface(0), m_rebuild_ratio(2), m_num_builds(0), m_num_refits(0)
+    {
+        m_ref_nodes.reserve(msh.points_size());
+        for (auto itor = msh.points_begin(); itor != msh.points_end(); itor++)
+            m_ref_nodes.push_back((*itor).to_vector());
+        m_nodes = m_ref_nodes;
+
+        m_master.offsets.push_back(0);
+        m_slave.offsets.push_back(0);
+
+        eigen_compatible_stdvector<point_type> slave_ref_points;
+        std::vector<scalar_type>               slave_weights;
+        for (auto& cl : msh)
+        {
+            for (auto& fc : faces(msh, cl))
+            {
+                if (!msh.is_boundary(fc))
+                    continue;
+
+                const size_t bnd_id = msh.boundary_info(fc).id();
+                if (bnd_id != master_id && bnd_id != slave_id)
+                    continue;
+
+                face_list& list = bnd_id == master_id ? m_master : m_slave;
+                list.faces.push_back(msh.lookup(fc));
+                for (auto& pid : fc.point_ids())
+                    list.vertices.push_back(pid);
+                list.offsets.push_back(list.vertices.size());
+
+                const size_t  i   = list.size() - 1;
+                const size_t* vtx = list.vertex(i);
+                const size_t  nv  = list.numVertices(i);
+
+                if (bnd_id == master_id)
+                {
+                    /* orient the normal given by the vertices outward of the cell */
+                    const auto n_out = normal(msh, cl, fc);
+                    m_master_orientation.push_back(face_normal(vtx, nv).dot(n_out) < 0 ? -1 : 1);
+                }
+                else
+                {
+                    for (auto& qp : integrate(msh, fc, degree))
+                    {
+                        const size_t first_coeff = m_slave_coeffs.size();
+                        m_slave_coeffs.resize(first_coeff + nv);
+
+                        vector_type proj, n;
+                        closest_point_face(qp.point().to_vector(), vtx, nv, m_ref_nodes, proj, n,
+                                           m_slave_coeffs.data() + first_coeff);
+                        m_slave_qps.push_back(slave_qp{i, qp.point(), qp.weight(), first_coeff});
+                    }
+                }
+            }
+        }
+
+        if (m_master.size() == 0)
+            throw std::invalid_argument("ContactPairing: no face on the master boundary");
+
+        build();
+    }
+
+    /**
+     * @brief Build the tree from scratch in the current configuration
+     */
+    void
+    build()
+    {
+        compute_face_boxes();
+
+        m_order.resize(m_master.size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+
+        m_tree.clear();
+        m_tree.reserve(2 * m_master.size() / leaf_size + 1);
+        build_node(0, m_master.size());
+
+        m_build_surface = tree_surface();
+        m_num_builds++;
+    }
+
+    /**
+     * @brief Update the boxes of the tree to the current configuration without changing its structure.
+     * The tree is rebuilt if the boxes have grown more than the rebuild ratio.
+     */
+    void
+    refit()
+    {
+        compute_face_boxes();
+
+        /* the children are after their parent */
+        for (size_t n = m_tree.size(); n-- > 0;)
+        {
+            bvh_node& node = m_tree[n];
+            box_type  box;
+            if (node.count > 0)
+            {
+                for (size_t i = node.first; i < node.first + node.count; i++)
+                    box.extend(m_face_boxes[m_order[i]]);
+            }
+            else
+            {
+                box.extend(m_tree[node.left].box);
+                box.extend(m_tree[node.right].box);
+            }
+            node.box = box;
+        }
+        m_num_refits++;
+
+        if (tree_surface() > m_rebuild_ratio * m_build_surface)
+            build();
+    }
+
+    /**
+     * @brief Move the mesh to the current configuration and refit the tree
+     *
+     * @param displacement displacement of each point of the mesh
+     */
+    void
+    updateDisplacement(const eigen_compatible_stdvector<vector_type>& displacement)
+    {
+        if (displacement.size() != m_ref_nodes.size())
+            throw std::invalid_argument("ContactPairing: one displacement per point of the mesh is required");
+
+        for (size_t i = 0; i < m_nodes.size(); i++)
+            m_nodes[i] = m_ref_nodes[i] + displacement[i];
+
+        refit();
+    }
+
+    /**
+     * @brief Set the ratio between the surface of the refitted boxes and the surface of the boxes of the last
+     * build above which the tree is rebuilt
+     */
+    void
+    setRebuildRatio(const scalar_type ratio)
+    {
+        m_rebuild_ratio = ratio;
+    }
+
+    /**
+     * @brief Number of times the tree has been built, including the first build
+     */
+    size_t
+    numberOfBuilds() const
+    {
+        return m_num_builds;
+    }
+
+    /**
+     * @brief Number of times the tree has been refitted
+     */
+    size_t
+    numberOfRefits() const
+    {
+        return m_num_refits;
+    }
+
+    size_t
+    numberOfMasterFaces() const
+    {
+        return m_master.size();
+    }
+
+    size_t
+    numberOfSlaveFaces() const
+    {
+        return m_slave.size();
+    }
+
+    /**
+     * @brief Project a point on the closest master face, in the current configuration
+     *
+     * @param pt point
+     * @param max_distance only the master faces closer than this distance are searched
+     * @return projection_type projection, found is false if no master face is close enough
+     */
+    projection_type
+    project(const point_type& pt, const scalar_type max_distance = std::numeric_limits<scalar_type>::max()) const
+    {
+        const vector_type p = pt.to_vector();
+
+        projection_type res;
+        res.found = false;
+
+        scalar_type best =
+          max_distance < std::sqrt(std::numeric_limits<scalar_type>::max()) ? max_distance * max_distance
+                                                                             : std::numeric_limits<scalar_type>::max();
+        vector_type proj, n;
+
+        std::vector<size_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const bvh_node& node = m_tree[stack.back()];
+            stack.pop_back();
+
+            if (node.box.squaredDistance(p) > best)
+                continue;
+
+            if (node.count > 0)
+            {
+                for (size_t i = node.first; i < node.first + node.count; i++)
+                {
+                    const size_t      f  = m_order[i];
+                    const scalar_type d2 = closest_point_face(p, m_master.vertex(f), m_master.numVertices(f),
+                                                              m_nodes, proj, n, nullptr);
+                    if (d2 <= best)
+                    {
+                        best             = d2;
+                        res.found        = true;
+                        res.master_face  = m_master.faces[f];
+                        res.master_point = point_type(proj);
+                        res.normal       = m_master_orientation[f] * n;
+                    }
+                }
+                continue;
+            }
+
+            /* visit the closest child first */
+            const scalar_type dl = m_tree[node.left].box.squaredDistance(p);
+            const scalar_type dr = m_tree[node.right].box.squaredDistance(p);
+            if (dl < dr)
+            {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            }
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+
+        if (res.found)
+            res.distance = std::sqrt(best);
+
+        return res;
+    }
+
+    /**
+     * @brief Pair the quadrature points of the slave faces with the closest master faces, in the current
+     * configuration
+     *
+     * @param max_distance only the slave points closer than this distance to the master boundary are paired
+     * @return std::vector<pair_type> pairs, ordered by slave face
+     */
+    std::vector<pair_type>
+    pairSlaveFaces(const scalar_type max_distance = std::numeric_limits<scalar_type>::max()) const
+    {
+        std::vector<pair_type> pairs;
+        pairs.reserve(m_slave_qps.size());
+
+        for (auto& qp : m_slave_qps)
+        {
+            const point_type x    = point_type(slave_position(qp));
+            const auto       proj = project(x, max_distance);
+            if (!proj.found)
+                continue;
+
+            const scalar_type gap_n = -gap(proj.master_point, x).dot(proj.normal);
+            pairs.push_back(pair_type{m_slave.faces[qp.face], x, qp.ref_point, qp.weight, proj, gap_n});
+        }
 
+        return pairs;
+    }
+};
 
 } // end mechanics
-} // diskpp
\ No newline at end of file
+} // diskpp
@@ -23,10 +23,49 @@
 #pragma once
 
 #include <iostream>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
 
 namespace disk{
 
+/* Raw type of the identifiers and of the connectivity of the meshes. With
+ * DISKPP_32BIT_INDICES it is 32 bits wide: the identifiers use the uint32_t
+ * specialization below and the connectivity takes half the memory, but a
+ * mesh can not have more than 2^31 - 1 entities of each kind. */
+#ifdef DISKPP_32BIT_INDICES
+typedef uint32_t    ident_raw_t;
+constexpr size_t    ident_raw_max = 0x7FFFFFFF;
+#else
+typedef size_t      ident_raw_t;
+constexpr size_t    ident_raw_max = std::numeric_limits<size_t>::max();
+#endif
+
+/* Convert an index to ident_raw_t, throw if it does not fit. To be used
+ * where indices come from outside, for example in the loaders. */
+template<typename I>
+ident_raw_t
+to_ident_raw(I val)
+{
+    static_assert(std::is_integral_v<I>, "Index must be of integral type");
+
+    if constexpr (std::is_signed_v<I>)
+    {
+        if (val < 0)
+            throw std::overflow_error("Negative index " + std::to_string(val));
+    }
+
+    if ( static_cast<std::make_unsigned_t<I>>(val) > ident_raw_max )
+        throw std::overflow_error("Index " + std::to_string(val) +
+            " does not fit in ident_raw_t, rebuild without DISKPP_32BIT_INDICES");
+
+    return static_cast<ident_raw_t>(val);
+}
+
 template<typename T, typename impl, impl default_value>
 struct identifier
 {
@@ -71,9 +110,8 @@ private:
                      * size_t using the MSB of id_val as flag could be useful.
                      */
 
-    /* This *actually* wastes tons of memory. The specialization below must
-     * be used, but before there are some places where hardcoded size_t's had
-     * to be replaced with ident_raw_t */
+    /* This *actually* wastes tons of memory. The specialization below is
+     * used when building with DISKPP_32BIT_INDICES. */
 };
 
 template<typename T, uint32_t default_value>
@@ -81,6 +119,17 @@ class identifier<T, uint32_t, default_value>
 {
     uint32_t    id_val;
 
+    template<typename I>
+    static uint32_t
+    narrow(I val)
+    {
+        auto raw = to_ident_raw(val);
+        if (raw > 0x7FFFFFFF)
+            throw std::overflow_error("Index " + std::to_string(raw) +
+                " does not fit in a 32 bit identifier");
+        return static_cast<uint32_t>(raw);
+    }
+
 public:
     typedef uint32_t    value_type;
 
@@ -92,6 +141,15 @@ public:
     identifier(const identifier&) = default;
 
     explicit identifier(uint32_t val) : id_val( (val & 0x7FFFFFFF) | 0x80000000 )
+    {
+        assert( val <= 0x7FFFFFFF );
+    }
+
+    /* Indices of other types are checked instead of silently narrowed */
+    template<typename I>
+        requires (std::is_integral_v<I> and !std::is_same_v<I, bool>
+                  and !std::is_same_v<I, uint32_t>)
+    explicit identifier(I val) : identifier( narrow(val) )
     {}
 
     operator uint32_t() const
@@ -126,6 +184,4 @@ operator<<(std::ostream& os, const identifier<T, impl, default_value>& id)
     return os;
 }
 
-typedef size_t      ident_raw_t;
-
 } // end disk
@@ -79,6 +79,9 @@
 #include <iterator>
 #include <set>
 #include <optional>
+#include <mutex>
+#include <atomic>
+#include <span>
 
 #include "ident.hpp"
 
@@ -196,6 +199,132 @@ find_element_id(const Iterator& begin, const Iterator& end, const T& element)
     return std::make_pair(false, typename T::id_type());
 }
 
+namespace priv {
+
+/* Index of a range of mesh elements. In a sorted range all the elements
+ * with the same lookup_key() are contiguous: the index stores where each
+ * group begins, so a lookup is reduced to a search among the few elements
+ * of a group. If the range is not sorted (for example after the mesh has
+ * been renumbered, see mesh_renumbering.hpp) the index also stores the
+ * positions of the elements in sorted order and the groups refer to it. */
+class element_index
+{
+    std::vector<size_t>     m_group_begin;
+    std::vector<size_t>     m_order;
+
+public:
+    element_index() {}
+
+    template<typename Iterator>
+    void build(const Iterator& begin, const Iterator& end)
+    {
+        m_group_begin.clear();
+        m_order.clear();
+
+        if (begin == end)
+            return;
+
+        size_t max_key = 0;
+        for (auto itor = begin; itor != end; itor++)
+            max_key = std::max(max_key, itor->lookup_key());
+
+        if ( not std::is_sorted(begin, end) )
+        {
+            m_order.resize( std::distance(begin, end) );
+            std::iota(m_order.begin(), m_order.end(), 0);
+            auto comp = [&](size_t a, size_t b) {
+                return *std::next(begin, a) < *std::next(begin, b);
+            };
+            std::sort(m_order.begin(), m_order.end(), comp);
+        }
+
+        m_group_begin.assign(max_key+2, 0);
+        for (auto itor = begin; itor != end; itor++)
+            m_group_begin[itor->lookup_key()+1]++;
+
+        std::partial_sum(m_group_begin.begin(), m_group_begin.end(), m_group_begin.begin());
+    }
+
+    template<typename Iterator, typename T>
+    std::pair<bool, typename T::id_type>
+    find(const Iterator& begin, const T& element) const
+    {
+        const size_t key = element.lookup_key();
+        if (key+1 >= m_group_begin.size())
+            return std::make_pair(false, typename T::id_type());
+
+        const auto group_begin = m_group_begin[key];
+        const auto group_end = m_group_begin[key+1];
+
+        if ( m_order.empty() )
+        {
+            auto fi = find_element_id(std::next(begin, group_begin), std::next(begin, group_end), element);
+            if (!fi.first)
+                return fi;
+
+            typename T::id_type id(group_begin + size_t(fi.second));
+            return std::make_pair(true, id);
+        }
+
+        auto comp = [&](size_t pos, const T& elem) {
+            return *std::next(begin, pos) < elem;
+        };
+        auto obegin = std::next(m_order.begin(), group_begin);
+        auto oend = std::next(m_order.begin(), group_end);
+        auto itor = std::lower_bound(obegin, oend, element, comp);
+        if (itor == oend or element < *std::next(begin, *itor))
+            return std::make_pair(false, typename T::id_type());
+
+        typename T::id_type id(*itor);
+        return std::make_pair(true, id);
+    }
+};
+
+/* Globally unique stamp for the geometry of a mesh, see mesh::geometry_version() */
+inline size_t
+next_mesh_version(void)
+{
+    static std::atomic<size_t> counter(0);
+    return ++counter;
+}
+
+/* Lookup tables of a mesh: the indices of cells and faces and the table of
+ * the ids of the faces of each cell, stored in CSR format. The tables are
+ * built on first use and rebuilt if the number of cells or faces changes or
+ * if they are invalidated. They are shared by all the copies of a mesh, as
+ * the storage is, so invalidating them is seen by all the copies. */
+struct mesh_lookup_tables
+{
+    std::mutex                  mtx;
+    std::atomic<bool>           index_ready;
+    std::atomic<bool>           incidence_ready;
+    std::atomic<size_t>         version;
+    std::atomic<size_t>         num_cells;
+    std::atomic<size_t>         num_faces;
+
+    element_index               cells;
+    element_index               faces;
+    std::vector<size_t>         cell_faces_offsets;
+    std::vector<ident_raw_t>    cell_faces;
+
+    mesh_lookup_tables()
+        : index_ready(false), incidence_ready(false), version(next_mesh_version()),
+          num_cells(0), num_faces(0)
+    {}
+
+    /* The storage has been modified: give it a new version and drop the
+     * tables, they are rebuilt on the next lookup. */
+    void invalidate(void)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        index_ready.store(false, std::memory_order_release);
+        incidence_ready.store(false, std::memory_order_release);
+        version.store(next_mesh_version(), std::memory_order_release);
+    }
+};
+
+} // namespace priv
+
 /****************************************************************************/
 namespace priv {
 
@@ -380,6 +509,66 @@ class mesh : public priv::mesh_base<T,DIM,Storage>
 {
     typedef priv::mesh_base<T,DIM,Storage> base_type;
 
+    std::shared_ptr<priv::mesh_lookup_tables>   m_lookup_tables =
+        std::make_shared<priv::mesh_lookup_tables>();
+
+    bool lookup_tables_valid(const priv::mesh_lookup_tables& lt) const
+    {
+        return lt.num_cells.load(std::memory_order_relaxed) == this->cells_size() and
+               lt.num_faces.load(std::memory_order_relaxed) == this->faces_size();
+    }
+
+    /* Get the lookup tables, building them if needed. This is thread-safe:
+     * the ready flags are cleared before the tables are rebuilt and set
+     * (release) once they are complete, so the lock-free path never sees a
+     * partially built table. */
+    const priv::mesh_lookup_tables&
+    lookup_tables(bool need_incidence) const
+    {
+        auto& lt = *m_lookup_tables;
+
+        if ( lt.index_ready.load(std::memory_order_acquire) and lookup_tables_valid(lt) and
+             (not need_incidence or lt.incidence_ready.load(std::memory_order_acquire)) )
+            return lt;
+
+        std::lock_guard<std::mutex> lock(lt.mtx);
+
+        if ( not lt.index_ready.load(std::memory_order_relaxed) or not lookup_tables_valid(lt) )
+        {
+            if (this->cells_size() > ident_raw_max or this->faces_size() > ident_raw_max)
+                throw std::overflow_error("Too many elements for ident_raw_t, rebuild without DISKPP_32BIT_INDICES");
+
+            lt.index_ready.store(false, std::memory_order_release);
+            lt.incidence_ready.store(false, std::memory_order_release);
+            lt.cells.build(this->cells_begin(), this->cells_end());
+            lt.faces.build(this->faces_begin(), this->faces_end());
+            lt.num_cells.store(this->cells_size(), std::memory_order_relaxed);
+            lt.num_faces.store(this->faces_size(), std::memory_order_relaxed);
+            lt.index_ready.store(true, std::memory_order_release);
+        }
+
+        if ( need_incidence and not lt.incidence_ready.load(std::memory_order_relaxed) )
+        {
+            lt.cell_faces_offsets.resize(this->cells_size()+1);
+            lt.cell_faces.clear();
+
+            size_t cell_i = 0;
+            for (auto itor = this->cells_begin(); itor != this->cells_end(); itor++)
+            {
+                lt.cell_faces_offsets[cell_i++] = lt.cell_faces.size();
+                auto fcs = faces(*this, *itor);
+                for (auto& fc : fcs)
+                    lt.cell_faces.push_back( lookup(fc) );
+            }
+            lt.cell_faces_offsets[cell_i] = lt.cell_faces.size();
+            lt.cell_faces.shrink_to_fit();
+
+            lt.incidence_ready.store(true, std::memory_order_release);
+        }
+
+        return lt;
+    }
+
 public:
     static const size_t dimension = DIM;
 
@@ -602,12 +791,23 @@ public:
     void transform(const Transform& tr)
     {
         std::transform(points_begin(), points_end(), points_begin(), tr);
+        m_lookup_tables->version.store(priv::next_mesh_version(), std::memory_order_release);
+    }
+
+    /* Stamp that changes every time the geometry of the mesh is modified
+     * via transform() or reset_lookup_tables(). Data computed from the
+     * geometry (for example quadrature_cache) use it to detect that they
+     * are stale. Refinements are detected by the number of elements. */
+    size_t geometry_version(void) const
+    {
+        return m_lookup_tables->version.load(std::memory_order_acquire);
     }
 
     /* Returns the numerial ID of a cell. */
     typename cell::id_type lookup(const cell& cl) const
     {
-        auto ci = find_element_id(this->cells_begin(), this->cells_end(), cl);
+        const auto& lt = lookup_tables(false);
+        auto ci = lt.cells.find(this->cells_begin(), cl);
         if (!ci.first)
             throw std::invalid_argument("Cell not present in mesh");
 
@@ -617,7 +817,8 @@ public:
     /* Returns the numerial ID of a face. */
     typename face::id_type lookup(const face& fc) const
     {
-        auto fi = find_element_id(this->faces_begin(), this->faces_end(), fc);
+        const auto& lt = lookup_tables(false);
+        auto fi = lt.faces.find(this->faces_begin(), fc);
         if (!fi.first)
         {
             std::stringstream ss;
@@ -627,6 +828,27 @@ public:
         return fi.second;
     }
 
+    /* Returns the numerical IDs of the faces of the cell with ID cell_id,
+     * in the same order as faces(msh, cl). */
+    std::span<const ident_raw_t> face_ids(size_t cell_id) const
+    {
+        const auto& lt = lookup_tables(true);
+        assert(cell_id < this->cells_size());
+        auto begin = lt.cell_faces.data() + lt.cell_faces_offsets[cell_id];
+        auto end = lt.cell_faces.data() + lt.cell_faces_offsets[cell_id+1];
+        return std::span<const ident_raw_t>(begin, end);
+    }
+
+    /* Mark the storage as modified: the lookup tables are dropped and the
+     * geometry version changes, in this mesh and in all its copies. The
+     * tables are rebuilt automatically if the number of cells or faces
+     * changes, call this after any other modification of the storage (for
+     * example if the elements are renumbered or the storage is replaced). */
+    void reset_lookup_tables(void)
+    {
+        m_lookup_tables->invalidate();
+    }
+
     auto operator[](size_t cell_num) const {
         assert(cell_num < this->cells_size());
         return *std::next(this->cells_begin(), cell_num);
@@ -705,22 +927,10 @@ class neighbour_connectivity
     {
         face_owners.resize( msh.faces_size() );
 
-        size_t cell_i = 0;
-        for (auto& cl : msh)
+        for (size_t cell_i = 0; cell_i < msh.cells_size(); cell_i++)
         {
-            auto fcs = faces(msh, cl);
-
-            for (auto& fc : fcs)
+            for (auto& fc_id : msh.face_ids(cell_i))
             {
-                auto fi = find_element_id(msh.faces_begin(), msh.faces_end(), fc);
-                if (!fi.first)
-                {
-                    std::stringstream ss;
-                    ss << fc << ": Face not present in mesh";
-                    throw std::invalid_argument(ss.str());
-                }
-                auto fc_id = offset(msh, fc);
-
                 auto& fo = face_owners.at(fc_id);
                 if (not fo[0])
                     fo[0] = cit(cell_i);
@@ -729,8 +939,6 @@ class neighbour_connectivity
                 else
                     throw std::logic_error("BUG: a face has max 2 owners");
             }
-
-            ++cell_i;
         }
     }
 
@@ -919,22 +1127,14 @@ template<typename Mesh>
 size_t
 offset(const Mesh& msh, const typename Mesh::cell_type& cl)
 {
-    auto itor = std::lower_bound(msh.cells_begin(), msh.cells_end(), cl);
-    if ( itor == msh.cells_end() )
-        throw std::logic_error("Cell not found: this is likely a bug.");
-
-    return std::distance(msh.cells_begin(), itor);
+    return msh.lookup(cl);
 }
 
 template<typename Mesh>
 size_t
 offset(const Mesh& msh, const typename Mesh::face_type& fc)
 {
-    auto itor = std::lower_bound(msh.faces_begin(), msh.faces_end(), fc);
-    if ( itor == msh.faces_end() )
-        throw std::logic_error("Face not found: this is likely a bug.");
-
-    return std::distance(msh.faces_begin(), itor);
+    return msh.lookup(fc);
 }
 
 template<template<typename, size_t, typename> class Mesh,
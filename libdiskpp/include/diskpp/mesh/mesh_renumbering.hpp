@@ -0,0 +1,565 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Renumbering of the cells, faces and points of a mesh to improve locality.
+ *
+ * The loaders and the meshers leave the elements sorted by the ids of their
+ * subelements, so the faces of a cell and the cells around a point end up
+ * far apart in memory and the matrices assembled on the mesh have a large
+ * bandwidth. renumber_mesh() sorts the cells along a Hilbert curve (or with
+ * the Reverse Cuthill-McKee algorithm), then numbers faces and points in the
+ * order in which the cells visit them.
+ *
+ * A renumbering is described by a mesh_permutation: each vector maps the new
+ * id of an element to its old id, an empty vector means that the elements
+ * are not moved. The permutation is returned to the caller, who can use it
+ * to permute data attached to the mesh. The boundary and subdomain
+ * information follow their faces and cells. After the renumbering cells and
+ * faces are not sorted anymore, so they must be searched via mesh::lookup()
+ * and not with a binary search on the storage (the meshers do so). The edges
+ * of the 3D meshes are not faces and they are kept sorted. The renumbering
+ * is seen by all the copies of the mesh, which share the storage.
+ *
+ * Simplicial, cartesian and generic meshes in 2D and 3D are supported. Flat
+ * generic meshes are not: renumber the generic mesh before make_flat_mesh(). */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "diskpp/mesh/mesh.hpp"
+#include "diskpp/geometry/geometry.hpp"
+
+namespace disk {
+
+/* Permutation of the cells, faces and points of a mesh: new id -> old id */
+struct mesh_permutation
+{
+    std::vector<size_t>     cells;
+    std::vector<size_t>     faces;
+    std::vector<size_t>     points;
+};
+
+enum class renumbering_method
+{
+    hilbert,    /* cells along a Hilbert curve through their centers */
+    rcm,        /* Reverse Cuthill-McKee on the cell-face-cell adjacency */
+};
+
+namespace priv {
+
+const size_t renumbering_none = std::numeric_limits<size_t>::max();
+
+/* Position of the point of integer coordinates X (each less than 2^bits) on
+ * the Hilbert curve filling the DIM-dimensional cube. Algorithm of
+ * J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004. */
+template<size_t DIM>
+uint64_t
+hilbert_key(std::array<uint32_t, DIM> X, size_t bits)
+{
+    static_assert(DIM > 0 and DIM <= 3, "hilbert_key: DIM must be 1, 2 or 3");
+    assert(bits > 0 and bits*DIM <= 64);
+
+    const uint32_t M = uint32_t(1) << (bits-1);
+
+    /* Inverse undo */
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+        const uint32_t P = Q - 1;
+        for (size_t i = 0; i < DIM; i++)
+        {
+            if (X[i] & Q)
+            {
+                X[0] ^= P;
+            }
+            else
+            {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    /* Gray encode */
+    for (size_t i = 1; i < DIM; i++)
+        X[i] ^= X[i-1];
+
+    uint32_t t = 0;
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+        if (X[DIM-1] & Q)
+            t ^= Q - 1;
+
+    for (size_t i = 0; i < DIM; i++)
+        X[i] ^= t;
+
+    /* The key is made of the bits of the transposed coordinates, from the
+     * most significant */
+    uint64_t key = 0;
+    for (size_t b = bits; b-- > 0;)
+        for (size_t i = 0; i < DIM; i++)
+            key = (key << 1) | ((X[i] >> b) & 1);
+
+    return key;
+}
+
+/* Check that perm is empty or a permutation of [0, size), return its
+ * inverse (old id -> new id). */
+inline std::vector<size_t>
+inverse_permutation(const std::vector<size_t>& perm, size_t size, const char *what)
+{
+    std::vector<size_t> inv(size, renumbering_none);
+
+    if (perm.empty())
+    {
+        std::iota(inv.begin(), inv.end(), 0);
+        return inv;
+    }
+
+    if (perm.size() != size)
+        throw std::invalid_argument(std::string("permute_mesh: wrong size of the ") + what + " permutation");
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (perm[i] >= size or inv[perm[i]] != renumbering_none)
+            throw std::invalid_argument(std::string("permute_mesh: invalid ") + what + " permutation");
+        inv[perm[i]] = i;
+    }
+
+    return inv;
+}
+
+/* Elements in the order given by perm (new id -> old id) */
+template<typename Element>
+std::vector<Element>
+permute_elements(std::vector<Element>& elems, const std::vector<size_t>& perm)
+{
+    if (perm.empty())
+        return std::move(elems);
+
+    std::vector<Element> ret;
+    ret.reserve(elems.size());
+    for (auto& p : perm)
+        ret.push_back( std::move(elems[p]) );
+
+    return ret;
+}
+
+/* Renumber the points of an element via point_map and its subelements via
+ * sub_map. Simplicial and cartesian elements only refer to points. */
+template<size_t DIM, size_t CODIM>
+simplicial_element<DIM, CODIM>
+renumber_element(const simplicial_element<DIM, CODIM>& e,
+                 const std::vector<size_t>& point_map, const std::vector<size_t>&)
+{
+    auto pts = e.point_ids();
+    for (auto& pt : pts)
+        pt = to_ident_raw(point_map[pt]);
+
+    return simplicial_element<DIM, CODIM>(pts);
+}
+
+template<size_t DIM, size_t CODIM>
+cartesian_element<DIM, CODIM>
+renumber_element(const cartesian_element<DIM, CODIM>& e,
+                 const std::vector<size_t>& point_map, const std::vector<size_t>&)
+{
+    auto pts = e.point_ids();
+    for (auto& pt : pts)
+        pt = to_ident_raw(point_map[pt]);
+
+    return cartesian_element<DIM, CODIM>(pts);
+}
+
+template<size_t DIM, size_t CODIM>
+generic_element<DIM, CODIM>
+renumber_element(const generic_element<DIM, CODIM>& e,
+                 const std::vector<size_t>& point_map, const std::vector<size_t>& sub_map)
+{
+    typedef generic_element<DIM, CODIM>     element_type;
+
+    if constexpr (CODIM == DIM)
+    {
+        auto pt = e.point_ids()[0];
+        return element_type( point_identifier<DIM>(to_ident_raw(point_map[pt])) );
+    }
+    else if constexpr (CODIM+1 == DIM)
+    {
+        /* Edges: node ids are point ids */
+        typedef typename element_type::sub_id_type  node_id_type;
+        auto pts = e.point_ids();
+        return element_type( node_id_type(to_ident_raw(point_map[pts[0]])),
+                             node_id_type(to_ident_raw(point_map[pts[1]])) );
+    }
+    else
+    {
+        typedef typename element_type::subelement_type::id_type     sub_id_type;
+        std::vector<sub_id_type> sids;
+        sids.reserve(e.subelement_size());
+        for (auto itor = e.subelement_id_begin(); itor != e.subelement_id_end(); itor++)
+            sids.push_back( sub_id_type(to_ident_raw(sub_map[*itor])) );
+
+        auto pts = e.point_ids();
+        std::vector<point_identifier<DIM>> new_pts;
+        new_pts.reserve(pts.size());
+        for (auto& pt : pts)
+            new_pts.push_back( point_identifier<DIM>(to_ident_raw(point_map[pt])) );
+
+        element_type ret(std::move(sids));
+        ret.set_point_ids(std::move(new_pts));
+        return ret;
+    }
+}
+
+template<typename Element>
+std::vector<Element>
+renumber_elements(const std::vector<Element>& elems,
+                  const std::vector<size_t>& point_map, const std::vector<size_t>& sub_map)
+{
+    std::vector<Element> ret;
+    ret.reserve(elems.size());
+    for (auto& e : elems)
+        ret.push_back( renumber_element(e, point_map, sub_map) );
+
+    return ret;
+}
+
+} // namespace priv
+
+/* Apply a permutation to the cells, faces and points of the mesh. The
+ * boundary and subdomain information are permuted with their faces and
+ * cells. Throws std::invalid_argument if a vector of perm is neither empty
+ * nor a permutation. */
+template<typename Mesh>
+void
+permute_mesh(Mesh& msh, const mesh_permutation& perm)
+{
+    static_assert(Mesh::dimension == 2 or Mesh::dimension == 3,
+                  "permute_mesh: only 2D and 3D meshes are supported");
+
+    auto storage = msh.backend_storage();
+
+    const auto point_map = priv::inverse_permutation(perm.points, storage->points.size(), "point");
+    const auto face_map = priv::inverse_permutation(perm.faces, msh.faces_size(), "face");
+    priv::inverse_permutation(perm.cells, msh.cells_size(), "cell");
+
+    storage->points = priv::permute_elements(storage->points, perm.points);
+
+    /* Nodes stay in the order of their points */
+    storage->nodes = priv::renumber_elements(storage->nodes, point_map, {});
+    std::sort(storage->nodes.begin(), storage->nodes.end());
+
+    if constexpr (Mesh::dimension == 2)
+    {
+        auto edges = priv::renumber_elements(storage->edges, point_map, {});
+        storage->edges = priv::permute_elements(edges, perm.faces);
+
+        auto surfaces = priv::renumber_elements(storage->surfaces, point_map, face_map);
+        storage->surfaces = priv::permute_elements(surfaces, perm.cells);
+    }
+    else
+    {
+        /* Edges are not faces: keep them sorted */
+        auto edges = priv::renumber_elements(storage->edges, point_map, {});
+        std::vector<size_t> edge_order(edges.size());
+        std::iota(edge_order.begin(), edge_order.end(), 0);
+        std::sort(edge_order.begin(), edge_order.end(),
+                  [&](size_t a, size_t b) { return edges[a] < edges[b]; });
+        const auto edge_map = priv::inverse_permutation(edge_order, edges.size(), "edge");
+        storage->edges = priv::permute_elements(edges, edge_order);
+
+        auto surfaces = priv::renumber_elements(storage->surfaces, point_map, edge_map);
+        storage->surfaces = priv::permute_elements(surfaces, perm.faces);
+
+        auto volumes = priv::renumber_elements(storage->volumes, point_map, face_map);
+        storage->volumes = priv::permute_elements(volumes, perm.cells);
+    }
+
+    if (storage->boundary_info.size() == msh.faces_size())
+        storage->boundary_info = priv::permute_elements(storage->boundary_info, perm.faces);
+
+    if (storage->subdomain_info.size() == msh.cells_size())
+        storage->subdomain_info = priv::permute_elements(storage->subdomain_info, perm.cells);
+
+    msh.reset_lookup_tables();
+}
+
+/* Order of the cells along the Hilbert curve through their centers (the
+ * average of their points), as new id -> old id. */
+template<typename Mesh>
+std::vector<size_t>
+hilbert_cell_order(const Mesh& msh)
+{
+    static const size_t DIM = Mesh::dimension;
+    const size_t bits = 63/DIM;
+    const size_t num_cells = msh.cells_size();
+
+    std::vector<std::array<double, DIM>> centers(num_cells);
+    std::array<double, DIM> min, max;
+    min.fill( std::numeric_limits<double>::max() );
+    max.fill( std::numeric_limits<double>::lowest() );
+
+    size_t cell_i = 0;
+    for (auto itor = msh.cells_begin(); itor != msh.cells_end(); itor++)
+    {
+        auto& c = centers[cell_i++];
+        c.fill(0.0);
+        auto ptids = itor->point_ids();
+        for (auto& ptid : ptids)
+        {
+            auto pt = *std::next(msh.points_begin(), size_t(ptid));
+            for (size_t d = 0; d < DIM; d++)
+                c[d] += double(pt[d]);
+        }
+
+        for (size_t d = 0; d < DIM; d++)
+        {
+            c[d] /= double(ptids.size());
+            min[d] = std::min(min[d], c[d]);
+            max[d] = std::max(max[d], c[d]);
+        }
+    }
+
+    /* Same scale on all the axes, to not distort the curve */
+    double extent = 0.0;
+    for (size_t d = 0; d < DIM; d++)
+        extent = std::max(extent, max[d] - min[d]);
+
+    const double scale = extent > 0.0 ? double((uint64_t(1) << bits) - 1)/extent : 0.0;
+
+    std::vector<std::pair<uint64_t, size_t>> keys(num_cells);
+    for (size_t i = 0; i < num_cells; i++)
+    {
+        std::array<uint32_t, DIM> X;
+        for (size_t d = 0; d < DIM; d++)
+            X[d] = uint32_t( (centers[i][d] - min[d])*scale );
+
+        keys[i] = std::make_pair(priv::hilbert_key<DIM>(X, bits), i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<size_t> order(num_cells);
+    for (size_t i = 0; i < num_cells; i++)
+        order[i] = keys[i].second;
+
+    return order;
+}
+
+/* Order of the cells given by the Reverse Cuthill-McKee algorithm on the
+ * graph of the cells sharing a face, as new id -> old id. Each connected
+ * component starts from a pseudo-peripheral cell. */
+template<typename Mesh>
+std::vector<size_t>
+rcm_cell_order(const Mesh& msh)
+{
+    const size_t num_cells = msh.cells_size();
+    const size_t none = priv::renumbering_none;
+
+    /* Cells on the two sides of each face */
+    std::vector<std::array<size_t, 2>> face_cells(msh.faces_size(), {none, none});
+    for (size_t c = 0; c < num_cells; c++)
+    {
+        for (auto& fid : msh.face_ids(c))
+        {
+            auto& fc = face_cells[fid];
+            if (fc[0] == none)
+                fc[0] = c;
+            else
+                fc[1] = c;
+        }
+    }
+
+    /* Adjacency of the cells, in CSR format */
+    std::vector<size_t> adj_offsets(num_cells+1);
+    std::vector<size_t> adj;
+    for (size_t c = 0; c < num_cells; c++)
+    {
+        adj_offsets[c] = adj.size();
+        for (auto& fid : msh.face_ids(c))
+        {
+            auto& fc = face_cells[fid];
+            auto other = (fc[0] == c) ? fc[1] : fc[0];
+            if (other != none and other != c)
+                adj.push_back(other);
+        }
+    }
+    adj_offsets[num_cells] = adj.size();
+
+    auto degree = [&](size_t c) { return adj_offsets[c+1] - adj_offsets[c]; };
+
+    /* Breadth-first visit of the cells not yet numbered, returns the number
+     * of levels. The levels of the visited cells are left in level. */
+    std::vector<size_t> level(num_cells, none);
+    std::vector<bool> numbered(num_cells, false);
+    std::vector<size_t> component;
+    auto bfs = [&](size_t root) {
+        for (auto& c : component)
+            level[c] = none;
+        component.clear();
+
+        level[root] = 0;
+        component.push_back(root);
+        size_t num_levels = 1;
+        for (size_t i = 0; i < component.size(); i++)
+        {
+            auto c = component[i];
+            for (size_t j = adj_offsets[c]; j < adj_offsets[c+1]; j++)
+            {
+                auto n = adj[j];
+                if (level[n] != none or numbered[n])
+                    continue;
+                level[n] = level[c] + 1;
+                num_levels = std::max(num_levels, level[n] + 1);
+                component.push_back(n);
+            }
+        }
+        return num_levels;
+    };
+
+    std::vector<size_t> order;
+    order.reserve(num_cells);
+    std::vector<size_t> neighbours;
+    for (size_t start = 0; start < num_cells; start++)
+    {
+        if (numbered[start])
+            continue;
+
+        /* Pseudo-peripheral cell: start from the cell of minimum degree
+         * and move to the farthest level while the eccentricity grows */
+        bfs(start);
+        size_t root = start;
+        for (auto& c : component)
+            if (degree(c) < degree(root))
+                root = c;
+
+        size_t num_levels = bfs(root);
+        for (size_t iter = 0; iter < 8; iter++)
+        {
+            size_t candidate = none;
+            for (auto& c : component)
+                if (level[c]+1 == num_levels and (candidate == none or degree(c) < degree(candidate)))
+                    candidate = c;
+
+            auto candidate_levels = bfs(candidate);
+            if (candidate_levels <= num_levels)
+                break;
+
+            root = candidate;
+            num_levels = candidate_levels;
+        }
+
+        /* Cuthill-McKee from root: neighbours by increasing degree */
+        size_t head = order.size();
+        order.push_back(root);
+        numbered[root] = true;
+        while (head < order.size())
+        {
+            auto c = order[head++];
+            neighbours.clear();
+            for (size_t j = adj_offsets[c]; j < adj_offsets[c+1]; j++)
+                if (not numbered[adj[j]])
+                    neighbours.push_back(adj[j]);
+
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+            std::stable_sort(neighbours.begin(), neighbours.end(),
+                             [&](size_t a, size_t b) { return degree(a) < degree(b); });
+
+            for (auto& n : neighbours)
+            {
+                numbered[n] = true;
+                order.push_back(n);
+            }
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/* Permutation that puts the cells in cell_order (new id -> old id) and
+ * numbers faces and points in the order in which the cells visit them. */
+template<typename Mesh>
+mesh_permutation
+make_mesh_permutation(const Mesh& msh, const std::vector<size_t>& cell_order)
+{
+    const size_t none = priv::renumbering_none;
+
+    mesh_permutation perm;
+    perm.cells = cell_order;
+    perm.faces.reserve(msh.faces_size());
+    perm.points.reserve(msh.points_size());
+
+    std::vector<size_t> face_map(msh.faces_size(), none);
+    std::vector<size_t> point_map(msh.points_size(), none);
+    for (auto& c : cell_order)
+    {
+        for (auto& fid : msh.face_ids(c))
+        {
+            if (face_map[fid] != none)
+                continue;
+            face_map[fid] = perm.faces.size();
+            perm.faces.push_back(fid);
+        }
+
+        auto cl = msh[c];
+        for (auto& ptid : cl.point_ids())
+        {
+            size_t pid = size_t(ptid);
+            if (point_map[pid] != none)
+                continue;
+            point_map[pid] = perm.points.size();
+            perm.points.push_back(pid);
+        }
+    }
+
+    /* Faces and points not attached to any cell go at the end */
+    for (size_t i = 0; i < face_map.size(); i++)
+        if (face_map[i] == none)
+            perm.faces.push_back(i);
+
+    for (size_t i = 0; i < point_map.size(); i++)
+        if (point_map[i] == none)
+            perm.points.push_back(i);
+
+    return perm;
+}
+
+/* Renumber the cells, faces and points of the mesh for locality. Returns
+ * the permutation that has been applied. */
+template<typename Mesh>
+mesh_permutation
+renumber_mesh(Mesh& msh, renumbering_method method = renumbering_method::hilbert)
+{
+    std::vector<size_t> cell_order;
+    switch (method)
+    {
+        case renumbering_method::hilbert:
+            cell_order = hilbert_cell_order(msh);
+            break;
+
+        case renumbering_method::rcm:
+            cell_order = rcm_cell_order(msh);
+            break;
+    }
+
+    auto perm = make_mesh_permutation(msh, cell_order);
+    permute_mesh(msh, perm);
+    return perm;
+}
+
+} // namespace disk
@@ -66,6 +66,7 @@ class simple_mesher<triangular_mesh<T>>
     typedef typename triangular_mesh<T>::surface_type   surface_type;
 
     std::shared_ptr<storage_type>   storage;
+    mesh_type*                      m_msh;
 
     void init_pattern_1(void)
     {
@@ -153,7 +154,7 @@ class simple_mesher<triangular_mesh<T>>
 
 public:
     simple_mesher(mesh_type& msh)
-        : storage( msh.backend_storage() )
+        : storage( msh.backend_storage() ), m_msh(&msh)
     {
         init_pattern_1();
     }
@@ -208,14 +209,10 @@ public:
             assert(ptids[1] < storage->points.size());
             assert(ptids[2] < storage->points.size());
 
+            /* The edges are the faces: the mesh could have been renumbered,
+             * so they are searched via the lookup tables */
             auto eofs = [&](const edge_type& e) -> auto {
-                //std::cout << "Searching for edge " << e << std::endl;
-                auto be = begin(storage->edges);
-                auto ee = end(storage->edges);
-                auto ei = std::lower_bound(be, ee, e);
-                if (ei == ee or e != *ei)
-                    throw std::logic_error("Edge not found. This is a bug.");
-                return point_identifier<2>(std::distance(be, ei) + node_offset);
+                return point_identifier<2>(size_t(m_msh->lookup(e)) + node_offset);
             };
 
             auto p_e0 = eofs( edge_type({ptids[0], ptids[1]}) );
@@ -250,6 +247,7 @@ public:
         std::sort(new_surfaces.begin(), new_surfaces.end());
         std::swap(storage->surfaces, new_surfaces);
         storage->subdomain_info.resize( storage->surfaces.size() );
+        m_msh->reset_lookup_tables();
     }
 };
 
@@ -268,6 +266,7 @@ class simple_mesher<tetrahedral_mesh<T>>
     typedef std::pair<surface_type, boundary_descriptor>    ns_pair;
 
     std::shared_ptr<storage_type>   storage;
+    mesh_type*                      m_msh;
     std::vector<ns_pair>            new_surfaces;
     std::vector<volume_type>        new_volumes;
 
@@ -296,7 +295,7 @@ class simple_mesher<tetrahedral_mesh<T>>
     public:
 
     simple_mesher(mesh_type& msh)
-        : storage(msh.backend_storage())
+        : storage(msh.backend_storage()), m_msh(&msh)
     {
         /* Init the first level of the mesh */
         storage->points.push_back(point_type(0.0, 0.0, 0.0));
@@ -437,13 +436,10 @@ class simple_mesher<tetrahedral_mesh<T>>
                 return point_identifier<3>(std::distance(be, ei) + node_offset);
                 };
 
-            auto ssearch = [&](const surface_type& s) -> auto {
-                auto bs = begin(storage->surfaces);
-                auto es = end(storage->surfaces);
-                auto si = std::lower_bound(bs, es, s);
-                if (si == es or s != *si)
-                    throw std::logic_error("Surface not found. This is a bug.");
-                return std::distance(bs, si);
+            /* The surfaces could have been renumbered, the edges are kept
+             * sorted (see permute_mesh()) */
+            auto ssearch = [&](const surface_type& s) -> size_t {
+                return m_msh->lookup(s);
             };
 
             auto s0 = surface_type({ ptids[0], ptids[1], ptids[2]});
@@ -521,6 +517,7 @@ class simple_mesher<tetrahedral_mesh<T>>
         assert(storage->volumes.size() == volume_offset * 8);
         assert(storage->surfaces.size() == expected_surfaces);
         storage->subdomain_info.resize( storage->volumes.size() );
+        m_msh->reset_lookup_tables();
     }
 };
 
@@ -537,10 +534,11 @@ class simple_mesher<cartesian_mesh<T,2>>
     typedef typename mesh_type::surface_type    surface_type;
 
     std::shared_ptr<storage_type>   storage;
+    mesh_type*                      m_msh;
 
 public:
     simple_mesher(mesh_type& msh)
-        : storage( msh.backend_storage() )
+        : storage( msh.backend_storage() ), m_msh(&msh)
     {
         auto rot = 0.0;
         /* Init the first level of the mesh */
@@ -677,18 +675,10 @@ public:
             assert(ptids[2] < pmi);
             assert(ptids[3] < pmi);
 
+            /* The edges are the faces: the mesh could have been renumbered,
+             * so they are searched via the lookup tables */
             auto eofs = [&](const edge_type& e) -> auto {
-                auto be = begin(storage->edges);
-                auto ee = end(storage->edges);
-                auto ei = std::lower_bound(be, ee, e);
-                if (ei == ee or e != *ei) {
-                    std::cout << s << std::endl;
-                    std::cout << e << std::endl;
-                    for (auto& ee : storage->edges)
-                        std::cout << "  " << ee << std::endl;
-                    throw std::logic_error("Edge not found. This is a bug.");
-                }
-                return point_identifier<2>(std::distance(be, ei) + node_offset);
+                return point_identifier<2>(size_t(m_msh->lookup(e)) + node_offset);
             };
 
             auto p_e0 = eofs( edge_type({ptids[0], ptids[1]}) );
@@ -726,6 +716,7 @@ public:
         std::sort(new_surfaces.begin(), new_surfaces.end());
         std::swap(storage->surfaces, new_surfaces);
         storage->subdomain_info.resize( storage->surfaces.size() );
+        m_msh->reset_lookup_tables();
     }
 };
 
@@ -53,7 +53,7 @@ public:
             m_coords[i] = T(0);
     }
 
-    point(const point& other) : m_coords(other.m_coords) {}
+    point(const point& other) = default;
 
     point(std::initializer_list<T> l)
     {
@@ -98,11 +98,7 @@ public:
     T   operator[](size_t pos) const { return m_coords[pos]; }
     T&  operator[](size_t pos)       { return m_coords[pos]; }
 
-    point operator=(const point& other)
-    {
-        m_coords = other.m_coords;
-        return *this;
-    }
+    point& operator=(const point& other) = default;
 
     void set_all(const T& val)
     {
@@ -16,6 +16,7 @@
 #include "diskpp/bases/bases_new.hpp"
 #include "diskpp/bases/bases_operations.hpp"
 #include "diskpp/bases/bases_traits.hpp"
+#include "diskpp/methods/implementation_hho/assembly_pattern.hpp"
 
 namespace disk::hho {
 
@@ -34,6 +35,7 @@ class basic_condensed_assembler {
     std::vector<bool>               dirichlet_faces;
 
     std::vector<trip_type>          triplets;
+    assembly_pattern<ScalT>         pattern;
 
     size_t                          face_poly_degree;
     size_t                          num_all_faces;
@@ -145,6 +147,16 @@ public:
             return std::tuple(fi*fbs, fj*fbs, gi*fbs, gj*fbs);
         };
 
+        if (pattern.valid()) {
+            auto global = [&](size_t li) -> std::optional<size_t> {
+                auto fc_id = fcs_id[li/fbs];
+                if (dirichlet_faces[fc_id])
+                    return {};
+                return compress_table[fc_id]*fbs + li%fbs;
+            };
+            pattern.add(msh.lookup(cl), lhs, global, LHS);
+        }
+
         for (size_t lnum_i = 0; lnum_i < fcs.size(); lnum_i++) {
             if (dirichlet_faces[ fcs_id[lnum_i] ])
                 continue;
@@ -156,7 +168,7 @@ public:
                     //RHS.segment(gnum_i*fbs, fbs) -=
                     //    lhs.block(lnum_i*fbs, lnum_j*fbs, fbs, fbs) * dirichlet_data.segment(lnum_i*fbs, fbs);
                 }
-                else {
+                else if (not pattern.valid()) {
                     auto gnum_j = compress_table[ fcs_id[lnum_j] ];
                     for (size_t i = 0; i < fbs; i++) {
                         auto li = lnum_i*fbs + i;
@@ -204,9 +216,46 @@ public:
         return system_size;
     }
 
+    /* Compute the sparsity pattern of LHS from the mesh connectivity. After
+     * this call, assemble() accumulates the local matrices directly in the
+     * values of LHS and finalize() does not need to build the matrix. */
+    void
+    initialize_pattern(const mesh_type& msh)
+    {
+        const auto fbs = FaceBasis::size_of_degree(face_poly_degree);
+
+        auto cell_layout = [&](size_t cell_i, const cell_type&, std::vector<std::pair<size_t, size_t>>& blocks) {
+            const auto fcs_id = msh.face_ids(cell_i);
+            for (auto& fc_id : fcs_id)
+                if (not dirichlet_faces[fc_id])
+                    blocks.push_back({compress_table[fc_id]*fbs, fbs});
+            return fcs_id.size()*fbs;
+        };
+
+        pattern.compute(msh, system_size, cell_layout, LHS);
+        triplets.clear();
+        triplets.shrink_to_fit();
+    }
+
+    /* Reset the system before a new assembly. If the pattern is
+     * available, the structure of LHS is kept. */
+    void
+    initialize(void)
+    {
+        if (pattern.valid())
+            pattern.zero(LHS);
+        else
+            LHS = Eigen::SparseMatrix<ScalT>(system_size, system_size);
+
+        RHS = vector_type::Zero(system_size);
+    }
+
     void
     finalize(void)
     {
+        if (pattern.valid())
+            return;
+
         LHS.setFromTriplets(triplets.begin(), triplets.end());
         triplets.clear();
     }
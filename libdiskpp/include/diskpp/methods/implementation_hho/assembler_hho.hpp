@@ -33,6 +33,8 @@
 #include "diskpp/bases/bases.hpp"
 #include "diskpp/boundary_conditions/boundary_conditions.hpp"
 #include "diskpp/common/eigen.hpp"
+#include "diskpp/common/parallel.hpp"
+#include "assembly_pattern.hpp"
 #include "diskpp/quadratures/quadratures.hpp"
 #include "utils_hho.hpp"
 #include "diskpp/mesh/mesh.hpp"
@@ -44,6 +46,10 @@ using namespace Eigen;
 namespace disk
 {
 
+/* Number of cells whose local contributions are kept in memory at the same time
+ * during a multithreaded assembly */
+static const size_t parallel_assembly_batch_size = 8192;
+
 // assembler for scalar primal problem with HHO like diffusion problem
 template<typename Mesh>
 class diffusion_condensed_assembler
@@ -56,6 +62,7 @@ class diffusion_condensed_assembler
     hho_degree_info         di;
     std::vector<Triplet<T>> triplets;
     bool                    use_bnd;
+    assembly_pattern<T>     pattern;
 
     size_t num_all_faces, num_dirichlet_faces, num_other_faces, system_size;
 
@@ -139,6 +146,8 @@ class diffusion_condensed_assembler
     void
     initialize(const Mesh& msh, hho_degree_info hdi, const std::vector<bool>& is_dirichlet)
     {
+        pattern.clear();
+
         num_all_faces       = msh.faces_size();
         num_dirichlet_faces = std::count(is_dirichlet.begin(), is_dirichlet.end(), true);
         num_other_faces     = num_all_faces - num_dirichlet_faces;
@@ -204,6 +213,9 @@ class diffusion_condensed_assembler
             }
         }
 
+        if (pattern.valid())
+            pattern.add(msh.lookup(cl), lhs, asm_map, LHS);
+
         for (size_t i = 0; i < lhs.rows(); i++)
         {
             if (!asm_map[i].assemble())
@@ -211,10 +223,10 @@ class diffusion_condensed_assembler
 
             for (size_t j = 0; j < lhs.cols(); j++)
             {
-                if (asm_map[j].assemble())
-                    triplets.push_back(Triplet<T>(asm_map[i], asm_map[j], lhs(i, j)));
-                else
+                if (!asm_map[j].assemble())
                     RHS[ asm_map[i] ] -= lhs(i, j) * dirichlet_data(j);
+                else if (!pattern.valid())
+                    triplets.push_back(Triplet<T>(asm_map[i], asm_map[j], lhs(i, j)));
             }
 
             RHS[ asm_map[i] ]  += rhs(i);
@@ -260,6 +272,9 @@ class diffusion_condensed_assembler
             }
         }
 
+        if (pattern.valid())
+            pattern.add(msh.lookup(cl), lhs, asm_map, LHS);
+
         for (size_t i = 0; i < lhs.rows(); i++)
         {
             if (!asm_map[i].assemble())
@@ -267,10 +282,10 @@ class diffusion_condensed_assembler
 
             for (size_t j = 0; j < lhs.cols(); j++)
             {
-                if (asm_map[j].assemble())
-                    triplets.push_back(Triplet<T>(asm_map[i], asm_map[j], lhs(i, j)));
-                else
+                if (!asm_map[j].assemble())
                     RHS[ asm_map[i] ] -= lhs(i, j) * dirichlet_data(j);
+                else if (!pattern.valid())
+                    triplets.push_back(Triplet<T>(asm_map[i], asm_map[j], lhs(i, j)));
             }
 
             RHS[ asm_map[i] ] += rhs(i);
@@ -341,10 +356,7 @@ class diffusion_condensed_assembler
             for (auto itor = msh.boundary_faces_begin(); itor != msh.boundary_faces_end(); itor++)
             {
                 const auto bfc = *itor;
-                const auto eid = find_element_id(msh.faces_begin(), msh.faces_end(), bfc);
-                if (!eid.first)
-                    throw std::invalid_argument("This is a bug: face not found");
-                const auto face_id = eid.second;
+                const auto face_id = msh.lookup(bfc);
 
                 if (bnd.is_robin_face(face_id))
                 {
@@ -395,7 +407,12 @@ class diffusion_condensed_assembler
 
                             for (size_t j = 0; j < num_face_dofs; j++)
                             {
-                                if (asm_map[j].assemble())
+                                if (!asm_map[j].assemble())
+                                    continue;
+
+                                if (pattern.valid())
+                                    pattern.coeff_ref(LHS, asm_map[i], asm_map[j]) += mass(i, j);
+                                else
                                     triplets.push_back(Triplet<T>(asm_map[i], asm_map[j], mass(i, j)));
                             }
                         }
@@ -471,10 +488,7 @@ class diffusion_condensed_assembler
         {
             const auto fc = fcs[face_i];
 
-            auto eid = find_element_id(msh.faces_begin(), msh.faces_end(), fc);
-            if (!eid.first)
-                throw std::invalid_argument("This is a bug: face not found");
-            const auto face_id = eid.second;
+            const auto face_id = msh.lookup(fc);
 
             const bool dirichlet = bnd.is_dirichlet_face(face_id);
 
@@ -496,9 +510,63 @@ class diffusion_condensed_assembler
         return ret;
     }
 
+    /**
+     * @brief Compute the sparsity pattern of the global matrix from the mesh connectivity.
+     *
+     * After this call, the local matrices are accumulated directly in the values of LHS: finalize()
+     * does not need to build the matrix anymore and initialize() resets the values while keeping
+     * the structure. Use this when the system is assembled many times, as in time or Newton loops.
+     */
+    void
+    initialize_pattern(const Mesh& msh)
+    {
+        const auto fbs = scalar_basis_size(di.face_degree(), Mesh::dimension - 1);
+
+        auto cell_layout = [&](size_t cell_i, const typename Mesh::cell_type&, std::vector<std::pair<size_t, size_t>>& blocks) {
+            const auto fcs_id = msh.face_ids(cell_i);
+            for (auto& face_id : fcs_id)
+            {
+                const auto cofs = compress_table.at(face_id);
+                if (cofs < num_other_faces and expand_table.at(cofs) == face_id)
+                    blocks.push_back({cofs * fbs, fbs});
+            }
+            return fcs_id.size() * fbs;
+        };
+
+        pattern.compute(msh, system_size, cell_layout, LHS);
+        triplets.clear();
+        triplets.shrink_to_fit();
+    }
+
+    /* Reset the global system before a new assembly */
+    void
+    initialize(void)
+    {
+        initialize_lhs();
+        initialize_rhs();
+    }
+
+    void
+    initialize_lhs(void)
+    {
+        if (pattern.valid())
+            pattern.zero(LHS);
+        else
+            LHS = SparseMatrix<T>(system_size, system_size);
+    }
+
+    void
+    initialize_rhs(void)
+    {
+        RHS = vector_type::Zero(system_size);
+    }
+
     void
     finalize(void)
     {
+        if (pattern.valid())
+            return;
+
         LHS.setFromTriplets(triplets.begin(), triplets.end());
         triplets.clear();
 
@@ -1016,11 +1084,7 @@ class stokes_assembler_alg
 
             if (dirichlet)
             {
-                auto eid = find_element_id(msh.faces_begin(), msh.faces_end(), fc);
-                if (!eid.first)
-                    throw std::invalid_argument("This is a bug: face not found");
-
-                const auto face_id = eid.second;
+                const auto face_id = msh.lookup(fc);
 
                 auto dirichlet_fun = m_bnd.dirichlet_boundary_func(face_id);
 
@@ -1279,11 +1343,6 @@ class assembler_mechanics
                 bool ind_ok = false;
                 for (size_t face_j = 0; face_j < fcs.size(); face_j++)
                 {
-                    const auto fcj  = fcs[face_j];
-                    auto       eidj = find_element_id(msh.faces_begin(), msh.faces_end(), fcj);
-                    if (!eidj.first)
-                        throw std::invalid_argument("This is a bug: face not found");
-
                     matrix_type mat_Fj = lc.first.block(face_j * num_face_dofs, pos, num_face_dofs, num_face_dofs);
 
                     switch (bnd.dirichlet_boundary_type(face_id))
@@ -1809,11 +1868,6 @@ class assembler_mechanics
                 bool        ind_ok = false;
                 for (size_t face_j = 0; face_j < fcs.size(); face_j++)
                 {
-                    const auto fcj  = fcs[face_j];
-                    auto       eidj = find_element_id(msh.faces_begin(), msh.faces_end(), fcj);
-                    if (!eidj.first)
-                        throw std::invalid_argument("This is a bug: face not found");
-
                     matrix_type mat_Fj = lc.first.block(face_j * num_face_dofs, pos, num_face_dofs, num_face_dofs);
 
                     switch (bnd.dirichlet_boundary_type(face_id))
@@ -2326,6 +2380,64 @@ class scalar_primal_hho_assembler
     size_t fbs;
     size_t system_size;
 
+    /* Scatter the local contribution of a cell, whose faces have the ids
+     * fcs_id, in the given buffers. It does not modify the assembler, so it
+     * can be called concurrently. */
+    template<typename FaceIds>
+    void
+    scatter(const Mesh&                                  msh,
+            const FaceIds&                               fcs_id,
+            const boundary_type&                         bnd,
+            const dynamic_matrix<scalar_type>&           lhs,
+            const dynamic_vector<scalar_type>&           rhs,
+            std::vector<Triplet<scalar_type>>&           trips,
+            std::vector<std::pair<size_t, scalar_type>>& ds) const
+    {
+        std::vector<assembly_index> asm_map;
+        asm_map.reserve(fcs_id.size() * fbs);
+
+        dynamic_vector<scalar_type> dirichlet_data = dynamic_vector<scalar_type>::Zero(fcs_id.size() * fbs);
+
+        for (size_t face_i = 0; face_i < fcs_id.size(); face_i++)
+        {
+            const auto face_id         = fcs_id[face_i];
+            const auto face_LHS_offset = compress_table.at(face_id) * fbs;
+
+            const bool dirichlet = bnd.is_dirichlet_face(face_id);
+
+            for (size_t i = 0; i < fbs; i++)
+            {
+                asm_map.push_back(assembly_index(face_LHS_offset + i, !dirichlet));
+            }
+
+            if (dirichlet)
+            {
+                auto dirichlet_fun = bnd.dirichlet_boundary_func(face_id);
+
+                const auto fc = *std::next(msh.faces_begin(), face_id);
+
+                dirichlet_data.segment(face_i * fbs, fbs) =
+                  project_function(msh, fc, di.face_degree(), dirichlet_fun, 2);
+            }
+        }
+
+        for (size_t i = 0; i < size_t(lhs.rows()); i++)
+        {
+            if (!asm_map[i].assemble())
+                continue;
+
+            for (size_t j = 0; j < size_t(lhs.cols()); j++)
+            {
+                if (asm_map[j].assemble())
+                    trips.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
+                else
+                    ds.push_back(std::make_pair(asm_map[i], -lhs(i, j) * dirichlet_data(j)));
+            }
+
+            ds.push_back(std::make_pair(asm_map[i], rhs(i)));
+        }
+    }
+
   public:
     typedef dynamic_matrix<scalar_type> matrix_type;
     typedef dynamic_vector<scalar_type> vector_type;
@@ -2391,50 +2503,54 @@ class scalar_primal_hho_assembler
              const matrix_type&   lhs,
              const vector_type&   rhs)
     {
-        const auto                  fcs_id = faces_id(msh, cl);
-        std::vector<assembly_index> asm_map;
-        asm_map.reserve(fcs_id.size() * fbs);
+        scatter(msh, faces_id(msh, cl), bnd, lhs, rhs, triplets, duos);
+    }
 
-        vector_type dirichlet_data = vector_type::Zero(fcs_id.size() * fbs);
+    /**
+     * @brief Assemble the contributions of all the cells of the mesh using multiple threads.
+     *
+     * The local contributions are computed concurrently by calling `local_contrib(cl)`, which must
+     * be thread-safe and return a pair (lhs, rhs) like the arguments of `assemble()`. Each cell scatters
+     * in its own buffers, which are then appended to the global ones following the cell ordering:
+     * the resulting matrix does not depend on the number of threads and it is bitwise identical to
+     * the one obtained by calling `assemble()` on each cell in a serial loop.
+     *
+     * @param msh mesh
+     * @param bnd boundary conditions
+     * @param local_contrib callable computing the condensed local system of a cell
+     * @param num_threads number of threads (0 means `default_num_threads()`)
+     */
+    template<typename LocalContribution>
+    void
+    assemble(const Mesh& msh, const boundary_type& bnd, const LocalContribution& local_contrib, size_t num_threads = 0)
+    {
+        const size_t num_cells = msh.cells_size();
+        const size_t batch     = std::min(num_cells, parallel_assembly_batch_size);
 
-        for (size_t face_i = 0; face_i < fcs_id.size(); face_i++)
+        std::vector<std::vector<Triplet<scalar_type>>>           cell_triplets(batch);
+        std::vector<std::vector<std::pair<size_t, scalar_type>>> cell_duos(batch);
+
+        for (size_t batch_begin = 0; batch_begin < num_cells; batch_begin += batch)
         {
-            const auto face_id         = fcs_id[face_i];
-            const auto face_LHS_offset = compress_table.at(face_id) * fbs;
+            const size_t batch_end = std::min(batch_begin + batch, num_cells);
 
-            const bool dirichlet = bnd.is_dirichlet_face(face_id);
+            auto contrib = [&](size_t cell_i, size_t) {
+                const auto cl = *std::next(msh.cells_begin(), cell_i);
+                const auto lc = local_contrib(cl);
+                const auto bi = cell_i - batch_begin;
+                cell_triplets[bi].clear();
+                cell_duos[bi].clear();
+                scatter(msh, msh.face_ids(cell_i), bnd, lc.first, lc.second, cell_triplets[bi], cell_duos[bi]);
+            };
 
-            for (size_t i = 0; i < fbs; i++)
-            {
-                asm_map.push_back(assembly_index(face_LHS_offset + i, !dirichlet));
-            }
+            parallel_for(batch_begin, batch_end, contrib, num_threads);
 
-            if (dirichlet)
+            for (size_t bi = 0; bi < batch_end - batch_begin; bi++)
             {
-                auto dirichlet_fun = bnd.dirichlet_boundary_func(face_id);
-
-                const auto fc = *std::next(msh.faces_begin(), face_id);
-
-                dirichlet_data.segment(face_i * fbs, fbs) =
-                  project_function(msh, fc, di.face_degree(), dirichlet_fun, 2);
+                triplets.insert(triplets.end(), cell_triplets[bi].begin(), cell_triplets[bi].end());
+                duos.insert(duos.end(), cell_duos[bi].begin(), cell_duos[bi].end());
             }
         }
-
-        for (size_t i = 0; i < lhs.rows(); i++)
-        {
-            if (!asm_map[i].assemble())
-                continue;
-
-            for (size_t j = 0; j < lhs.cols(); j++)
-            {
-                if (asm_map[j].assemble())
-                    triplets.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
-                else
-                    duos.push_back(std::make_pair(asm_map[i], -lhs(i, j) * dirichlet_data(j)));
-            }
-
-            duos.push_back(std::make_pair(asm_map[i], rhs(i)));
-        }
     }
 
     void
@@ -2706,8 +2822,14 @@ class vector_primal_hho_assembler
     size_t
     num_faces_dofs(const Mesh& msh, const cell_type& cl) const
     {
-        const auto fcs_id   = faces_id(msh, cl);
-        size_t     num_dofs = 0;
+        return num_faces_dofs(faces_id(msh, cl));
+    }
+
+    template<typename FaceIds>
+    size_t
+    num_faces_dofs(const FaceIds& fcs_id) const
+    {
+        size_t num_dofs = 0;
 
         for (auto face_id : fcs_id)
         {
@@ -2720,8 +2842,14 @@ class vector_primal_hho_assembler
     std::vector<size_t>
     faces_offset(const Mesh& msh, const cell_type& cl) const
     {
-        const auto fcs_id   = faces_id(msh, cl);
-        size_t     num_dofs = 0;
+        return faces_offset(faces_id(msh, cl));
+    }
+
+    template<typename FaceIds>
+    std::vector<size_t>
+    faces_offset(const FaceIds& fcs_id) const
+    {
+        size_t num_dofs = 0;
 
         std::vector<size_t> ret;
         ret.reserve(fcs_id.size());
@@ -2857,24 +2985,31 @@ class vector_primal_hho_assembler
         return;
     }
 
+  private:
+    /* Scatter the local contribution of the cell cl, whose faces have the
+     * ids fcs_id, in the given buffers. It does not modify the assembler, so
+     * it can be called concurrently. */
+    template<typename FaceIds>
     void
-    assemble(const mesh_type&     msh,
-             const cell_type&     cl,
-             const boundary_type& bnd,
-             const matrix_type&   lhs,
-             const vector_type&   rhs,
-             int                  di = 0)
+    scatter(const mesh_type&                             msh,
+            const cell_type&                             cl,
+            const FaceIds&                               fcs_id,
+            const boundary_type&                         bnd,
+            const dynamic_matrix<scalar_type>&           lhs,
+            const dynamic_vector<scalar_type>&           rhs,
+            int                                          di,
+            std::vector<Triplet<scalar_type>>&           trips,
+            std::vector<std::pair<size_t, scalar_type>>& ds) const
     {
-        const auto fcs_id       = faces_id(msh, cl);
         const auto fcs          = faces(msh, cl);
-        const auto n_faces_dofs = num_faces_dofs(msh, cl);
+        const auto n_faces_dofs = num_faces_dofs(fcs_id);
 
         std::vector<assembly_index> asm_map;
         asm_map.reserve(n_faces_dofs);
 
         vector_type rhs_bc = vector_type::Zero(n_faces_dofs);
 
-        const auto offset_faces = faces_offset(msh, cl);
+        const auto offset_faces = faces_offset(fcs_id);
         for (size_t face_i = 0; face_i < fcs_id.size(); face_i++)
         {
             const auto face_id     = fcs_id[face_i];
@@ -3082,10 +3217,10 @@ class vector_primal_hho_assembler
             for (size_t i = 0; i < lhs.cols(); i++)
             {
                 if (asm_map[i].assemble())
-                    triplets.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
+                    trips.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
             }
 
-            duos.push_back(std::make_pair(asm_map[j], rhs(j) - rhs_bc(j)));
+            ds.push_back(std::make_pair(asm_map[j], rhs(j) - rhs_bc(j)));
         }
 #else
         for (size_t i = 0; i < lhs.rows(); i++)
@@ -3096,14 +3231,76 @@ class vector_primal_hho_assembler
             for (size_t j = 0; j < lhs.cols(); j++)
             {
                 if (asm_map[j].assemble())
-                    triplets.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
+                    trips.push_back(Triplet<scalar_type>(asm_map[i], asm_map[j], lhs(i, j)));
             }
 
-            duos.push_back(std::make_pair(asm_map[i], rhs(i) - rhs_bc(i)));
+            ds.push_back(std::make_pair(asm_map[i], rhs(i) - rhs_bc(i)));
         }
 #endif
     }
 
+  public:
+    void
+    assemble(const mesh_type&     msh,
+             const cell_type&     cl,
+             const boundary_type& bnd,
+             const matrix_type&   lhs,
+             const vector_type&   rhs,
+             int                  di = 0)
+    {
+        scatter(msh, cl, faces_id(msh, cl), bnd, lhs, rhs, di, triplets, duos);
+    }
+
+    /**
+     * @brief Assemble the contributions of all the cells of the mesh using multiple threads.
+     *
+     * See scalar_primal_hho_assembler::assemble(). The local contributions are computed concurrently
+     * by `local_contrib(cl)`, which must be thread-safe and return a pair (lhs, rhs). The resulting
+     * system is bitwise identical to the one obtained with a serial loop, whatever the number of threads.
+     *
+     * @param msh mesh
+     * @param bnd boundary conditions
+     * @param local_contrib callable computing the condensed local system of a cell
+     * @param di increment of the degree of the quadrature used to project the Dirichlet data
+     * @param num_threads number of threads (0 means `default_num_threads()`)
+     */
+    template<typename LocalContribution>
+    void
+    assemble(const mesh_type&         msh,
+             const boundary_type&     bnd,
+             const LocalContribution& local_contrib,
+             int                      di          = 0,
+             size_t                   num_threads = 0)
+    {
+        const size_t num_cells = msh.cells_size();
+        const size_t batch     = std::min(num_cells, parallel_assembly_batch_size);
+
+        std::vector<std::vector<Triplet<scalar_type>>>           cell_triplets(batch);
+        std::vector<std::vector<std::pair<size_t, scalar_type>>> cell_duos(batch);
+
+        for (size_t batch_begin = 0; batch_begin < num_cells; batch_begin += batch)
+        {
+            const size_t batch_end = std::min(batch_begin + batch, num_cells);
+
+            auto contrib = [&](size_t cell_i, size_t) {
+                const auto cl = *std::next(msh.cells_begin(), cell_i);
+                const auto lc = local_contrib(cl);
+                const auto bi = cell_i - batch_begin;
+                cell_triplets[bi].clear();
+                cell_duos[bi].clear();
+                scatter(msh, cl, msh.face_ids(cell_i), bnd, lc.first, lc.second, di, cell_triplets[bi], cell_duos[bi]);
+            };
+
+            parallel_for(batch_begin, batch_end, contrib, num_threads);
+
+            for (size_t bi = 0; bi < batch_end - batch_begin; bi++)
+            {
+                triplets.insert(triplets.end(), cell_triplets[bi].begin(), cell_triplets[bi].end());
+                duos.insert(duos.end(), cell_duos[bi].begin(), cell_duos[bi].end());
+            }
+        }
+    }
+
     vector_type
     take_local_solution(const Mesh&                     msh,
                         const typename Mesh::face_type& fc,
@@ -3925,6 +4122,7 @@ class vector_mechanics_hho_assembler
 
     std::vector<Triplet<scalar_type>>           triplets;
     std::vector<std::pair<size_t, scalar_type>> duos;
+    assembly_pattern<scalar_type>               pattern;
 
     size_t num_all_faces, num_dirichlet_faces, num_other_faces;
     size_t system_size, m_total_dofs;
@@ -3966,8 +4164,14 @@ class vector_mechanics_hho_assembler
     size_t
     num_faces_dofs(const Mesh& msh, const cell_type& cl) const
     {
-        const auto fcs_id   = faces_id(msh, cl);
-        size_t     num_dofs = 0;
+        return num_faces_dofs(faces_id(msh, cl));
+    }
+
+    template<typename FaceIds>
+    size_t
+    num_faces_dofs(const FaceIds& fcs_id) const
+    {
+        size_t num_dofs = 0;
 
         for (auto face_id : fcs_id)
         {
@@ -3980,8 +4184,14 @@ class vector_mechanics_hho_assembler
     std::vector<size_t>
     faces_offset(const Mesh& msh, const cell_type& cl) const
     {
-        const auto fcs_id   = faces_id(msh, cl);
-        size_t     num_dofs = 0;
+        return faces_offset(faces_id(msh, cl));
+    }
+
+    template<typename FaceIds>
+    std::vector<size_t>
+    faces_offset(const FaceIds& fcs_id) const
+    {
+        size_t num_dofs = 0;
 
         std::vector<size_t> ret;
         ret.reserve(fcs_id.size());
@@ -3995,6 +4205,41 @@ class vector_mechanics_hho_assembler
         return ret;
     }
 
+    /* Number of unknowns of a face which are assembled in the global system */
+    size_t
+    num_assembled_face_dofs(const size_t face_id, const boundary_type& bnd) const
+    {
+        if (!faces_degree[face_id].hasUnknowns())
+            return 0;
+
+        const auto n_face_dofs = num_face_dofs(face_id);
+
+        if (!bnd.is_contact_face(face_id))
+            return n_face_dofs - bnd.dirichlet_imposed_dofs(face_id, faces_degree[face_id].degree());
+
+        if (bnd.contact_boundary_type(face_id) == SIGNORINI_FACE)
+            return n_face_dofs;
+
+        return 0;
+    }
+
+    template<typename MultiplierLayout>
+    void
+    compute_pattern(const mesh_type& msh, const boundary_type& bnd, const MultiplierLayout& mult_layout)
+    {
+        auto cell_layout = [&](size_t cell_i, const cell_type& cl, std::vector<std::pair<size_t, size_t>>& blocks) {
+            const auto fcs_id = msh.face_ids(cell_i);
+            for (auto& face_id : fcs_id)
+                blocks.push_back({compress_table.at(face_id), num_assembled_face_dofs(face_id, bnd)});
+
+            return num_faces_dofs(fcs_id) + mult_layout(cl, blocks);
+        };
+
+        pattern.compute(msh, system_size, cell_layout, LHS);
+        triplets.clear();
+        triplets.shrink_to_fit();
+    }
+
     std::tuple<vector_type, std::vector<assembly_index>>
     create_local_connectivity(const mesh_type&                msh,
                               const cell_type&                cl,
@@ -4406,10 +4651,58 @@ class vector_mechanics_hho_assembler
     void
     initialize_lhs(void)
     {
-        LHS = SparseMatrix<scalar_type>(system_size, system_size);
+        if (pattern.valid())
+            pattern.zero(LHS);
+        else
+            LHS = SparseMatrix<scalar_type>(system_size, system_size);
         return;
     }
 
+    /**
+     * @brief Compute the sparsity pattern of the global matrix from the mesh connectivity.
+     *
+     * After this call, the local matrices are accumulated directly in the values of LHS, finalize()
+     * does not build the matrix anymore and initialize() resets the values while keeping the structure.
+     * The pattern depends only on the mesh and on the boundary conditions, so it has to be computed
+     * only once for all the Newton iterations and load steps.
+     */
+    void
+    initialize_pattern(const mesh_type& msh, const boundary_type& bnd)
+    {
+        compute_pattern(msh, bnd, [](const cell_type&, std::vector<std::pair<size_t, size_t>>&) { return 0; });
+    }
+
+    /* Same as above, with the Lagrange multipliers of the contact faces */
+    void
+    initialize_pattern(const mesh_type&                            msh,
+                       const boundary_type&                        bnd,
+                       const mechanics::ContactManager<mesh_type>& contact_manager)
+    {
+        const auto num_all_faces = msh.faces_size();
+
+        auto mult_layout = [&](const cell_type& cl, std::vector<std::pair<size_t, size_t>>& blocks) {
+            if (!bnd.cell_has_contact_faces(cl))
+                return size_t(0);
+
+            size_t     num_mult_dofs = 0;
+            const auto fcs_id        = faces_id(msh, cl);
+            for (auto& face_id : fcs_id)
+            {
+                if (bnd.is_contact_face(face_id))
+                {
+                    const auto mult_id       = contact_manager.getMappingFaceToMult(face_id);
+                    const auto num_mult_face = contact_manager.numberOfMultFace(mult_id);
+
+                    blocks.push_back({compress_table.at(num_all_faces + mult_id), num_mult_face});
+                    num_mult_dofs += num_mult_face;
+                }
+            }
+            return num_mult_dofs;
+        };
+
+        compute_pattern(msh, bnd, mult_layout);
+    }
+
     void
     initialize_rhs(void)
     {
@@ -4432,6 +4725,19 @@ class vector_mechanics_hho_assembler
         assert(lhs.rows() == rhs.size());
         assert(rhs.size() == rhs_bc.size());
 
+        if (pattern.valid())
+        {
+            pattern.add(msh.lookup(cl), lhs, asm_map, LHS);
+
+            for (Eigen::Index i = 0; i < lhs.rows(); i++)
+            {
+                if (asm_map[i].assemble())
+                    duos.push_back(std::make_pair(asm_map[i], rhs(i) - rhs_bc(i)));
+            }
+
+            return;
+        }
+
 #ifdef FILL_COLMAJOR
         for (size_t j = 0; j < lhs.rows(); j++)
         {
@@ -4516,6 +4822,19 @@ class vector_mechanics_hho_assembler
         assert(rhs.size() == rhs_bc.size());
         assert(rhs.size() == asm_map.size());
 
+        if (pattern.valid())
+        {
+            pattern.add(msh.lookup(cl), lhs, asm_map, LHS);
+
+            for (Eigen::Index i = 0; i < lhs.rows(); i++)
+            {
+                if (asm_map[i].assemble())
+                    duos.push_back(std::make_pair(asm_map[i], rhs(i) - rhs_bc(i)));
+            }
+
+            return;
+        }
+
 #ifdef FILL_COLMAJOR
         for (size_t j = 0; j < lhs.rows(); j++)
         {
@@ -4913,8 +5232,11 @@ class vector_mechanics_hho_assembler
     void
     finalize(void)
     {
-        LHS.setFromTriplets(triplets.begin(), triplets.end());
-        triplets.clear();
+        if (!pattern.valid())
+        {
+            LHS.setFromTriplets(triplets.begin(), triplets.end());
+            triplets.clear();
+        }
 
         for (auto& [id, val] : duos)
             RHS(id) += val;
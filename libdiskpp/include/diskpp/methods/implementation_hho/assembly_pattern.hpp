@@ -0,0 +1,274 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "diskpp/common/eigen.hpp"
+
+namespace disk
+{
+
+/**
+ * @brief Precomputed sparsity pattern of a condensed HHO system.
+ *
+ * The pattern is computed once from the mesh connectivity: each cell couples all the blocks of global
+ * unknowns it sees (typically one block per face). The structure of the global matrix is allocated in
+ * compressed form and, for each cell, the position in `valuePtr()` of every entry of the local matrix
+ * is cached the first time the cell is assembled. Subsequent assemblies accumulate the local matrices
+ * directly in the values of the global matrix, without triplets, sorting or memory allocation.
+ *
+ * Since contributions are summed in the same order as `setFromTriplets()` does, the values obtained
+ * with the pattern are identical to the ones obtained via triplets.
+ *
+ * @tparam T scalar type
+ */
+template<typename T>
+class assembly_pattern
+{
+    typedef Eigen::SparseMatrix<T>                   sparse_matrix_type;
+    typedef typename sparse_matrix_type::StorageIndex storage_index;
+    typedef std::pair<size_t, size_t>                block_type;
+
+    std::vector<size_t>        m_cell_offsets;
+    std::vector<storage_index> m_slots;
+    std::vector<bool>          m_cell_ready;
+    bool                       m_valid;
+
+    storage_index
+    find_slot(const sparse_matrix_type& LHS, size_t row, size_t col) const
+    {
+        const size_t outer = sparse_matrix_type::IsRowMajor ? row : col;
+        const size_t inner = sparse_matrix_type::IsRowMajor ? col : row;
+
+        const auto begin = LHS.innerIndexPtr() + LHS.outerIndexPtr()[outer];
+        const auto end   = LHS.innerIndexPtr() + LHS.outerIndexPtr()[outer + 1];
+        const auto itor  = std::lower_bound(begin, end, storage_index(inner));
+
+        if (itor == end or *itor != storage_index(inner))
+            throw std::logic_error("assembly_pattern: entry not present in the pattern");
+
+        return storage_index(std::distance(LHS.innerIndexPtr(), itor));
+    }
+
+  public:
+    assembly_pattern() : m_valid(false) {}
+
+    /* True if the pattern has been computed and can be used for the assembly */
+    bool
+    valid(void) const
+    {
+        return m_valid;
+    }
+
+    /* Drop the pattern, for example if the numbering of the unknowns changed */
+    void
+    clear(void)
+    {
+        m_cell_offsets.clear();
+        m_slots.clear();
+        m_cell_ready.clear();
+        m_valid = false;
+    }
+
+    /**
+     * @brief Symbolic phase: compute the structure of the global matrix.
+     *
+     * @param msh mesh
+     * @param system_size size of the global system
+     * @param cell_layout callable
+     * `size_t(size_t cell_i, const cell_type& cl, std::vector<std::pair<size_t, size_t>>& blocks)`,
+     * called with the index and the cell. It fills `blocks` with the (first global unknown, number of
+     * unknowns) of each block of unknowns assembled by the cell and returns the size of the local matrix
+     * of the cell. A block is identified by its first unknown: blocks shared among cells must have the
+     * same size.
+     * @param LHS global matrix, whose structure is overwritten and values set to zero
+     */
+    template<typename Mesh, typename CellLayout>
+    void
+    compute(const Mesh& msh, size_t system_size, const CellLayout& cell_layout, sparse_matrix_type& LHS)
+    {
+        const size_t num_cells = msh.cells_size();
+        m_cell_offsets.resize(num_cells + 1);
+
+        /* Blocks coupled to each block, stored at the position of the first unknown of the block */
+        std::vector<std::vector<size_t>> coupled(system_size);
+        std::vector<size_t>              block_size(system_size, 0);
+        std::vector<block_type>          blocks;
+
+        size_t cell_i    = 0;
+        size_t num_slots = 0;
+        for (auto& cl : msh)
+        {
+            blocks.clear();
+            const size_t local_size = cell_layout(cell_i, cl, blocks);
+
+            m_cell_offsets[cell_i++] = num_slots;
+            num_slots += local_size * local_size;
+
+            for (auto& [bi, si] : blocks)
+            {
+                if (si == 0)
+                    continue;
+
+                assert(bi + si <= system_size);
+                assert(block_size[bi] == 0 or block_size[bi] == si);
+                block_size[bi] = si;
+
+                for (auto& [bj, sj] : blocks)
+                    if (sj > 0)
+                        coupled[bi].push_back(bj);
+            }
+        }
+        m_cell_offsets[num_cells] = num_slots;
+
+        /* Count the nonzeros of each outer vector. The pattern is symmetric, so it
+         * does not matter if the matrix is row or column major. */
+        std::vector<storage_index> outer(system_size + 1, 0);
+        for (size_t ofs = 0; ofs < system_size;)
+        {
+            const size_t bs = block_size[ofs];
+            if (bs == 0)
+            {
+                outer[ofs + 1] = outer[ofs];
+                ofs++;
+                continue;
+            }
+
+            auto& cpl = coupled[ofs];
+            std::sort(cpl.begin(), cpl.end());
+            cpl.erase(std::unique(cpl.begin(), cpl.end()), cpl.end());
+
+            size_t block_nnz = 0;
+            for (auto& b : cpl)
+                block_nnz += block_size[b];
+
+            for (size_t k = 0; k < bs; k++)
+                outer[ofs + k + 1] = outer[ofs + k] + storage_index(block_nnz);
+
+            ofs += bs;
+        }
+
+        const size_t nnz = outer[system_size];
+
+        LHS.resize(system_size, system_size);
+        LHS.resizeNonZeros(nnz);
+        std::copy(outer.begin(), outer.end(), LHS.outerIndexPtr());
+
+        for (size_t ofs = 0; ofs < system_size; ofs++)
+        {
+            const size_t bs = block_size[ofs];
+            if (bs == 0)
+                continue;
+
+            for (size_t k = 0; k < bs; k++)
+            {
+                auto inner = LHS.innerIndexPtr() + outer[ofs + k];
+                for (auto& b : coupled[ofs])
+                    for (size_t r = 0; r < block_size[b]; r++)
+                        *inner++ = storage_index(b + r);
+            }
+
+            ofs += bs - 1;
+        }
+
+        std::fill(LHS.valuePtr(), LHS.valuePtr() + nnz, T(0));
+
+        m_slots.assign(num_slots, storage_index(-1));
+        m_cell_ready.assign(num_cells, false);
+        m_valid = true;
+    }
+
+    /* Set to zero the values of the global matrix, keeping its structure */
+    void
+    zero(sparse_matrix_type& LHS) const
+    {
+        assert(m_valid);
+        std::fill(LHS.valuePtr(), LHS.valuePtr() + LHS.nonZeros(), T(0));
+    }
+
+    /* Reference to the entry (row, col) of the global matrix. The entry must be in the pattern. */
+    T&
+    coeff_ref(sparse_matrix_type& LHS, size_t row, size_t col) const
+    {
+        assert(m_valid);
+        return LHS.valuePtr()[find_slot(LHS, row, col)];
+    }
+
+    /**
+     * @brief Numeric phase: accumulate the local matrix of a cell in the global matrix.
+     *
+     * @param cell_id number of the cell
+     * @param lhs local matrix
+     * @param global callable `std::optional<size_t>(size_t i)` giving the global unknown of the local
+     * unknown `i`, or nothing if the unknown is not assembled. It is used only the first time the cell
+     * is assembled.
+     * @param LHS global matrix
+     */
+    template<typename GlobalIndex>
+    void
+    add(size_t cell_id, const dynamic_matrix<T>& lhs, const GlobalIndex& global, sparse_matrix_type& LHS)
+    {
+        assert(m_valid);
+        assert(cell_id < m_cell_ready.size());
+        assert(lhs.rows() == lhs.cols());
+
+        const size_t n     = lhs.rows();
+        auto         slots = m_slots.data() + m_cell_offsets[cell_id];
+
+        if (m_cell_offsets[cell_id + 1] - m_cell_offsets[cell_id] != n * n)
+            throw std::invalid_argument("assembly_pattern: local matrix size does not match the pattern");
+
+        if (not m_cell_ready[cell_id])
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                const auto gj = global(j);
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto gi = global(i);
+                    if (gi and gj)
+                        slots[j * n + i] = find_slot(LHS, gi.value(), gj.value());
+                }
+            }
+            m_cell_ready[cell_id] = true;
+        }
+
+        T*       values = LHS.valuePtr();
+        const T* data   = lhs.data();
+        for (size_t k = 0; k < n * n; k++)
+            if (slots[k] >= 0)
+                values[slots[k]] += data[k];
+    }
+
+    /* Same as above, with the assembly map given as a vector of `assembly_index` */
+    template<typename AssemblyIndex>
+    void
+    add(size_t                            cell_id,
+        const dynamic_matrix<T>&          lhs,
+        const std::vector<AssemblyIndex>& asm_map,
+        sparse_matrix_type&               LHS)
+    {
+        auto global = [&](size_t i) -> std::optional<size_t> {
+            if (asm_map[i].assemble())
+                return size_t(asm_map[i]);
+            return {};
+        };
+
+        add(cell_id, lhs, global, LHS);
+    }
+};
+
+} // end disk
@@ -39,9 +39,12 @@
 
 #include "diskpp/adaptivity/adaptivity.hpp"
 #include "diskpp/bases/bases.hpp"
+#include "diskpp/bases/bases_batched.hpp"
+#include "diskpp/bases/bases_tabulated.hpp"
 #include "diskpp/boundary_conditions/boundary_conditions.hpp"
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/quadratures/quadratures.hpp"
+#include "diskpp/quadratures/quadrature_cache.hpp"
 #include "utils_hho.hpp"
 
 namespace disk
@@ -135,10 +138,12 @@ using diffusion_tensor = static_matrix<typename Mesh::coordinate_type, Mesh::dim
 
 namespace priv {
 
-template<bool use_diffusion_tensor, bool use_face_projection, typename Mesh, typename ScalarReconstructionBasis>
+template<bool use_diffusion_tensor, bool use_face_projection, typename Mesh, typename ScalarReconstructionBasis,
+    typename Quadrature = uncached_quadrature>
 auto
 make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, const hho_degree_info& hdi,
-    const ScalarReconstructionBasis& rb, const diffusion_tensor<Mesh>& diff_tens)
+    const ScalarReconstructionBasis& rb, const diffusion_tensor<Mesh>& diff_tens,
+    const Quadrature& qr = Quadrature())
 {
     using T = typename Mesh::coordinate_type;
     const size_t DIM = Mesh::dimension;
@@ -165,22 +170,55 @@ make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, c
     /* Degree k+1 stiffness matrix*/
     matrix_type gr_lhs = matrix_type::Zero(rbs-1, rbs-1);
     matrix_type gr_rhs = matrix_type::Zero(rbs - 1, num_total_dofs);
-    
 
-    auto qps = disk::integrate(msh, cl, 2*(rd-1));
-    for (auto& qp : qps)
+    /* Gradients of the reconstruction basis without the constant, and the
+     * same multiplied by the diffusion tensor if needed */
+    auto r_dphi = [&](const auto& pt) {
+        return rb.eval_gradients(pt).block(1, 0, rbs-1, DIM).eval();
+    };
+
+    auto r_kdphi = [&](const auto& pt) {
+        gradient_type ret = r_dphi(pt);
+        if constexpr (use_diffusion_tensor)
+            ret = ret * diff_tens.transpose();
+        return ret;
+    };
+
+    /* On affine simplicial and cartesian cells the stiffness matrix of the
+     * reconstruction basis is computed from the tables of the reference
+     * element. The cell basis is the head of the reconstruction basis if they
+     * have the same scaling. */
+    bool tabulated = false;
+    if constexpr (use_tabulated_basis<Mesh, typename Mesh::cell_type, ScalarReconstructionBasis>())
     {
-        auto r_dphi_tmp = rb.eval_gradients(qp.point());
-        auto r_dphi = r_dphi_tmp.block(1, 0, rbs-1, DIM);
-        auto c_dphi = cb.eval_gradients(qp.point());
-        if (use_diffusion_tensor) {
-            gr_lhs += qp.weight() * (r_dphi * diff_tens.transpose()) * r_dphi.transpose();
-            gr_rhs.block(0, 0, rbs - 1, cbs) += qp.weight() * (r_dphi * diff_tens.transpose()) * c_dphi.transpose();
+        const auto& tab = get_tabulated_scalar_basis<Mesh>(rb.degree());
+        if (tab.is_affine(msh, cl) and cb.scaling_matrix() == rb.scaling_matrix() and
+            cb.scaling_origin().to_vector() == rb.scaling_origin().to_vector())
+        {
+            const matrix_type K = use_diffusion_tensor ? tab.stiffness_matrix(msh, cl, rb, diff_tens)
+                                                       : tab.stiffness_matrix(msh, cl, rb);
+            gr_lhs = K.block(1, 1, rbs - 1, rbs - 1);
+            gr_rhs.block(0, 0, rbs - 1, cbs) = K.block(1, 0, rbs - 1, cbs);
+            tabulated = true;
         }
-        else {
-            gr_lhs += qp.weight() * r_dphi * r_dphi.transpose();
-            gr_rhs.block(0, 0, rbs - 1, cbs) += qp.weight() * r_dphi * c_dphi.transpose();
+    }
+
+    if (not tabulated)
+    {
+        auto qps = qr(msh, cl, 2*(rd-1));
+        const matrix_type r_dphis = batched_evaluations(qps, r_dphi);
+        matrix_type r_kdphis = r_dphis;
+        if constexpr (use_diffusion_tensor)
+        {
+            /* One block of DIM columns per quadrature point */
+            for (size_t pos = 0; pos < size_t(r_dphis.cols()); pos += DIM)
+                r_kdphis.middleCols(pos, DIM) = r_dphis.middleCols(pos, DIM) * diff_tens.transpose();
         }
+        r_kdphis = batched_weighted(qps, r_kdphis);
+
+        const matrix_type c_dphis = batched_evaluations(qps, [&](const auto& pt) { return cb.eval_gradients(pt); });
+        gr_lhs += r_kdphis * r_dphis.transpose();
+        gr_rhs.block(0, 0, rbs - 1, cbs) += r_kdphis * c_dphis.transpose();
     }
 
     /* Now the faces */
@@ -192,49 +230,27 @@ make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, c
         const auto  fb  = make_scalar_monomial_basis(msh, fc, fd);
         const auto  fbs = fb.size();
 
-        auto qps_f = integrate(msh, fc, rd + std::max(cd, fd) );
-        for (auto& qp : qps_f)
-        {
-            gradient_type r_dphi_tmp = rb.eval_gradients(qp.point());
-            gradient_type r_dphi;
-            if (use_diffusion_tensor)
-                r_dphi = r_dphi_tmp.block(1, 0, rbs-1, DIM) * diff_tens.transpose();
-            else
-                r_dphi = r_dphi_tmp.block(1, 0, rbs-1, DIM);
+        auto qps_f = qr(msh, fc, rd + std::max(cd, fd) );
 
-            vector_type f_phi = fb.eval_functions(qp.point());
-            gr_rhs.block(0, offset, rbs - 1, fbs) += qp.weight() * (r_dphi * n) * f_phi.transpose();
+        auto r_dphi_n = [&](const auto& pt) { return vector_type(r_kdphi(pt) * n); };
+        const matrix_type r_dphi_ns = batched_weighted(qps_f, batched_evaluations(qps_f, r_dphi_n));
+        const matrix_type f_phis = batched_evaluations(qps_f, [&](const auto& pt) { return fb.eval_functions(pt); });
+        const matrix_type c_phis = batched_evaluations(qps_f, [&](const auto& pt) { return cb.eval_functions(pt); });
+        const matrix_type FR = r_dphi_ns * f_phis.transpose();
 
-            if constexpr (not use_face_projection) {
-                vector_type c_phi = cb.eval_functions(qp.point());
-                gr_rhs.block(0, 0, rbs - 1, cbs) -= qp.weight() * (r_dphi * n) * c_phi.transpose();
-            }
-        }
+        gr_rhs.block(0, offset, rbs - 1, fbs) += FR;
 
         if constexpr (use_face_projection)
         {
-            matrix_type MF = matrix_type::Zero(fbs, fbs);
-            matrix_type TF = matrix_type::Zero(fbs, cbs);
-            matrix_type FR = matrix_type::Zero(rbs-1, fbs);
-            for (auto& qp : qps_f)
-            {
-                gradient_type r_dphi_tmp = rb.eval_gradients(qp.point());
-                gradient_type r_dphi;
-                if constexpr (use_diffusion_tensor)
-                    r_dphi = r_dphi_tmp.block(1, 0, rbs - 1, DIM) * diff_tens.transpose();
-                else
-                    r_dphi = r_dphi_tmp.block(1, 0, rbs - 1, DIM);
-                
-                vector_type c_phi = cb.eval_functions(qp.point());
-                vector_type f_phi = fb.eval_functions(qp.point());
-            
-                MF += qp.weight() * f_phi * f_phi.transpose();
-                TF += qp.weight() * f_phi * c_phi.transpose();
-                FR += qp.weight() * (r_dphi * n) * f_phi.transpose();
-            }
-
+            const matrix_type f_phis_w = batched_weighted(qps_f, f_phis);
+            const matrix_type MF = f_phis_w * f_phis.transpose();
+            const matrix_type TF = f_phis_w * c_phis.transpose();
             gr_rhs.block(0, 0, rbs - 1, cbs) -= FR * MF.ldlt().solve(TF);
         }
+        else
+        {
+            gr_rhs.block(0, 0, rbs - 1, cbs) -= r_dphi_ns * c_phis.transpose();
+        }
 
         offset += fbs;
     }
@@ -278,6 +294,26 @@ make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, c
     return priv::make_scalar_hho_laplacian<true, false>(msh, cl, hdi, rb, diff_tens);
 }
 
+/* Same as above, but the quadratures are taken from the cache */
+template<typename Mesh>
+auto
+make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, const hho_degree_info& hdi,
+    const quadrature_cache<Mesh>& qc)
+{
+    auto rb = make_scalar_monomial_basis(msh, cl, hdi.reconstruction_degree());
+    diffusion_tensor<Mesh> diff_tens = diffusion_tensor<Mesh>::Zero();
+    return priv::make_scalar_hho_laplacian<false, false>(msh, cl, hdi, rb, diff_tens, qc);
+}
+
+template<typename Mesh>
+auto
+make_scalar_hho_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, const hho_degree_info& hdi,
+    const diffusion_tensor<Mesh>& diff_tens, const quadrature_cache<Mesh>& qc)
+{
+    auto rb = make_scalar_monomial_basis(msh, cl, hdi.reconstruction_degree());
+    return priv::make_scalar_hho_laplacian<true, false>(msh, cl, hdi, rb, diff_tens, qc);
+}
+
 template<typename Mesh>
 auto
 make_shl_face_proj(const Mesh& msh, const typename Mesh::cell_type& cl, const hho_degree_info& hdi)
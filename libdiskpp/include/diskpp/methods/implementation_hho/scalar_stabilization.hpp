@@ -31,9 +31,11 @@
 
 #include "diskpp/adaptivity/adaptivity.hpp"
 #include "diskpp/bases/bases.hpp"
+#include "diskpp/bases/bases_batched.hpp"
 #include "diskpp/boundary_conditions/boundary_conditions.hpp"
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/quadratures/quadratures.hpp"
+#include "diskpp/quadratures/quadrature_cache.hpp"
 #include "utils_hho.hpp"
 
 namespace disk
@@ -142,12 +144,13 @@ make_scalar_hho_difference(const Mesh& msh, const typename Mesh::cell_type& cl,
  * @param hF use diameter of face for scaling if true (or cell diameter if false)
  * @return dynamic_matrix<typename Mesh::coordinate_type> return the stabilization term
  */
-template<typename Mesh>
+template<typename Mesh, typename Quadrature = priv::uncached_quadrature>
 dynamic_matrix<typename Mesh::coordinate_type>
 make_scalar_hdg_stabilization(const Mesh&                     msh,
                               const typename Mesh::cell_type& cl,
                               const CellDegreeInfo<Mesh>&     cell_infos,
-                              bool hF = true)
+                              bool                            hF = true,
+                              const Quadrature&               qr = Quadrature())
 {
     using T = typename Mesh::coordinate_type;
     typedef Matrix<T, Dynamic, Dynamic> matrix_type;
@@ -189,23 +192,14 @@ make_scalar_hdg_stabilization(const Mesh&                     msh,
             const matrix_type If    = matrix_type::Identity(fbs, fbs);
             matrix_type       oper  = matrix_type::Zero(fbs, total_dofs);
             matrix_type       tr    = matrix_type::Zero(fbs, total_dofs);
-            matrix_type       mass  = make_mass_matrix(msh, fc, fb);
+            matrix_type       mass  = make_mass_matrix(fb, qr(msh, fc, 2*facdeg));
             matrix_type       trace = matrix_type::Zero(fbs, cbs);
 
             oper.block(0, offset, fbs, fbs) = -If;
 
-            const auto qps = integrate(msh, fc, facdeg + celdeg);
-            for (auto& qp : qps)
-            {
-                const auto c_phi = cb.eval_functions(qp.point());
-                const auto f_phi = fb.eval_functions(qp.point());
-
-                assert(c_phi.rows() == cbs);
-                assert(f_phi.rows() == fbs);
-                assert(c_phi.cols() == f_phi.cols());
-
-                trace += priv::outer_product(priv::inner_product(qp.weight(), f_phi), c_phi);
-            }
+            const auto qps = qr(msh, fc, facdeg + celdeg);
+            trace = batched_product(qps, [&](const auto& pt) { return fb.eval_functions(pt); },
+                                         [&](const auto& pt) { return cb.eval_functions(pt); });
 
             tr.block(0, offset, fbs, fbs) = -mass;
             tr.block(0, 0, fbs, cbs)      = trace;
@@ -503,6 +497,24 @@ make_scalar_hdg_stabilization(const Mesh&                     msh,
     return make_scalar_hdg_stabilization(msh, cl, cell_infos, hF);
 }
 
+/**
+ * @brief same as above, but the quadratures are taken from the cache
+ *
+ * @param qc quadrature cache of the mesh
+ */
+template<typename Mesh>
+dynamic_matrix<typename Mesh::coordinate_type>
+make_scalar_hdg_stabilization(const Mesh&                     msh,
+                              const typename Mesh::cell_type& cl,
+                              const hho_degree_info&          di,
+                              const quadrature_cache<Mesh>&   qc,
+                              bool                            hF = true)
+{
+    const CellDegreeInfo<Mesh> cell_infos(msh, cl, di.cell_degree(), di.face_degree(), di.grad_degree());
+
+    return make_scalar_hdg_stabilization(msh, cl, cell_infos, hF, qc);
+}
+
 /**
  * @brief compute the stabilization term \f$ \sum_{F \in F_T} 1/h_F(u_F-\Pi^k_F(u_T), v_F-\Pi^k_F(v_T))_F \f$
  * for scalar HHO unknowns
@@ -805,13 +817,14 @@ make_scalar_hho_stabilization(const Mesh&                     msh,
  * @param hF use diameter of face for scaling if true (or cell diameter if false)
  * @return dynamic_matrix<typename Mesh::coordinate_type> return the stabilization term
  */
-template<typename Mesh, typename ScalarReconstructionBasis>
+template<typename Mesh, typename ScalarReconstructionBasis, typename Quadrature = priv::uncached_quadrature>
 dynamic_matrix<typename Mesh::coordinate_type>
 make_scalar_hho_stabilization(const Mesh&                 msh,
     const typename Mesh::cell_type&                       cl,
     const ScalarReconstructionBasis&                      rb,
     const dynamic_matrix<typename Mesh::coordinate_type>& reconstruction,
-    const hho_degree_info&                                hdi)
+    const hho_degree_info&                                hdi,
+    const Quadrature&                                     qr = Quadrature())
 {
     using T = typename Mesh::coordinate_type;
     typedef Matrix<T, Dynamic, Dynamic> matrix_type;
@@ -829,17 +842,14 @@ make_scalar_hho_stabilization(const Mesh&                 msh,
     // Build \pi_F^k (v_F - P_T^K v) equations (21) and (22)
 
     // Step 1: compute \pi_T^k p_T^k v (third term).
-    const matrix_type M1    = make_mass_matrix(msh, cl, cb);
+    const matrix_type M1    = make_mass_matrix(cb, qr(msh, cl, 2*celdeg));
 
-    matrix_type M2    = matrix_type::Zero(cbs, rbs - 1);
-    auto qps = integrate(msh, cl, recdeg+celdeg);
-    for(auto& qp : qps)
-    {
-        auto trial_tmp = rb.eval_functions( qp.point() );
-        auto trial = trial_tmp.tail(rbs-1);
-        auto test = cb.eval_functions( qp.point() );
-        M2 += qp.weight() * test * trial.transpose();
-    }
+    /* Reconstruction basis without the constant */
+    auto r_phi = [&](const auto& pt) { return rb.eval_functions(pt).tail(rbs-1).eval(); };
+    auto c_phi = [&](const auto& pt) { return cb.eval_functions(pt); };
+
+    auto qps = qr(msh, cl, recdeg+celdeg);
+    matrix_type M2 = batched_product(qps, c_phi, r_phi);
 
     matrix_type       proj1 = -M1.ldlt().solve(M2 * reconstruction);
 
@@ -863,20 +873,13 @@ make_scalar_hho_stabilization(const Mesh&                 msh,
         const auto fb     = make_scalar_monomial_basis(msh, fc, facdeg);
         const auto fbs    = scalar_basis_size(facdeg, Mesh::dimension - 1);
 
-        matrix_type face_mass_matrix  = make_mass_matrix(msh, fc, fb);
-        matrix_type face_trace_matrix = matrix_type::Zero(fbs, rbs-1);
-        matrix_type face_trace_matrix2 = matrix_type::Zero(fbs, cbs);
+        matrix_type face_mass_matrix  = make_mass_matrix(fb, qr(msh, fc, 2*facdeg));
 
-        const auto face_quadpoints = integrate(msh, fc, recdeg + facdeg);
-        for (auto& qp : face_quadpoints)
-        {
-            const auto f_phi = fb.eval_functions(qp.point());
-            const auto c_phi = cb.eval_functions(qp.point());
-            const auto r_phi_tmp = rb.eval_functions(qp.point());
-            const auto r_phi = r_phi_tmp.tail(rbs-1);
-            face_trace_matrix += qp.weight() * f_phi * r_phi.transpose();
-            face_trace_matrix2 += qp.weight() * f_phi * c_phi.transpose();
-        }
+        const auto face_quadpoints = qr(msh, fc, recdeg + facdeg);
+        auto f_phi = [&](const auto& pt) { return fb.eval_functions(pt); };
+        const matrix_type f_phis = batched_weighted(face_quadpoints, batched_evaluations(face_quadpoints, f_phi));
+        const matrix_type face_trace_matrix = f_phis * batched_evaluations(face_quadpoints, r_phi).transpose();
+        const matrix_type face_trace_matrix2 = f_phis * batched_evaluations(face_quadpoints, c_phi).transpose();
 
         LLT<matrix_type> piKF;
         piKF.compute(face_mass_matrix);
@@ -912,6 +915,19 @@ make_scalar_hho_stabilization(const Mesh&                     msh,
     return make_scalar_hho_stabilization(msh, cl, rb, reconstruction, hdi);
 }
 
+/* Same as above, but the quadratures are taken from the cache */
+template<typename Mesh>
+dynamic_matrix<typename Mesh::coordinate_type>
+make_scalar_hho_stabilization(const Mesh&                     msh,
+        const typename Mesh::cell_type&                       cl,
+        const dynamic_matrix<typename Mesh::coordinate_type>& reconstruction,
+        const hho_degree_info&                                hdi,
+        const quadrature_cache<Mesh>&                         qc)
+{
+    auto rb = make_scalar_monomial_basis(msh, cl, hdi.reconstruction_degree());
+    return make_scalar_hho_stabilization(msh, cl, rb, reconstruction, hdi, qc);
+}
+
 /**
  * @brief compute the stabilization term \f$\sum_{F \in F_T} 1/h_F(u_F - u_T + \Pi^k_T R^{k+1}_T(\hat{u}_T) -
  * R^{k+1}_T(\hat{u}_T), v_F - v_T + \Pi^k_T R^{k+1}_T(\hat{v}_T) - R^{k+1}_T(\hat{v}_T))_F \f$ for scalar HHO
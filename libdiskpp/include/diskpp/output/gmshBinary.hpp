@@ -0,0 +1,401 @@
+/*
+ *       /\        Matteo Cicuttin (C) 2016, 2017
+ *      /__\       matteo.cicuttin@enpc.fr
+ *     /_\/_\      École Nationale des Ponts et Chaussées - CERMICS
+ *    /\    /\
+ *   /__\  /__\    DISK++, a template library for DIscontinuous SKeletal
+ *  /_\/_\/_\/_\   methods.
+ *
+ * This file is copyright of the following authors:
+ * Nicolas Pignet  (C) 2018                     nicolas.pignet@enpc.fr
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * If you use this code or parts of it for scientific publications, you
+ * are required to cite it as following:
+ *
+ * Implementation of Discontinuous Skeletal methods on arbitrary-dimensional,
+ * polytopal meshes using generic programming.
+ * M. Cicuttin, D. A. Di Pietro, A. Ern.
+ * Journal of Computational and Applied Mathematics.
+ * DOI: 10.1016/j.cam.2017.09.017
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "diskpp/mesh/point.hpp"
+
+namespace disk {
+
+/* Gmsh element types */
+enum GmshElementType : int
+{
+   GMSH_LINE        = 1,
+   GMSH_TRIANGLE    = 2,
+   GMSH_QUADRANGLE  = 3,
+   GMSH_TETRAHEDRON = 4,
+   GMSH_HEXAHEDRON  = 5,
+   GMSH_POINT       = 15
+};
+
+/**
+ * @brief Snapshot of a mesh and of fields at its nodes, in flat buffers, written as a binary Gmsh
+ * file (format 2.2). The buffers are sized once by the reserve functions and the fields are filled
+ * in place, so that building the snapshot does not allocate per node. A snapshot does not refer
+ * to the data it was built from: it can be written by another thread while the data changes.
+ */
+class GmshBinaryData
+{
+   struct element_block
+   {
+      int              type;
+      int              nodes_per_element;
+      std::vector<int> nodes;
+   };
+
+   struct node_view
+   {
+      std::string         name;
+      int                 num_comp;
+      int                 first_node;
+      std::vector<double> values;
+   };
+
+   std::vector<double>        m_coords;
+   std::vector<element_block> m_blocks;
+   std::vector<node_view>     m_views;
+
+   static int
+   nodes_per_element(int type)
+   {
+      switch (type) {
+         case GMSH_LINE: return 2;
+         case GMSH_TRIANGLE: return 3;
+         case GMSH_QUADRANGLE: return 4;
+         case GMSH_TETRAHEDRON: return 4;
+         case GMSH_HEXAHEDRON: return 8;
+         case GMSH_POINT: return 1;
+         default: throw std::invalid_argument("GmshBinaryData: unknown element type");
+      }
+   }
+
+   element_block&
+   block(int type)
+   {
+      if (m_blocks.empty() || m_blocks.back().type != type)
+         m_blocks.push_back(element_block{type, nodes_per_element(type), {}});
+      return m_blocks.back();
+   }
+
+ public:
+   GmshBinaryData() {}
+
+   void
+   reserveNodes(size_t num_nodes)
+   {
+      m_coords.reserve(m_coords.size() + 3 * num_nodes);
+   }
+
+   void
+   reserveElements(int type, size_t num_elements)
+   {
+      auto& b = block(type);
+      b.nodes.reserve(b.nodes.size() + b.nodes_per_element * num_elements);
+   }
+
+   size_t
+   numberOfNodes(void) const
+   {
+      return m_coords.size() / 3;
+   }
+
+   size_t
+   numberOfElements(void) const
+   {
+      size_t n = 0;
+      for (auto& b : m_blocks)
+         n += b.nodes.size() / b.nodes_per_element;
+      return n;
+   }
+
+   /**
+    * @brief Add a node
+    *
+    * @return int number of the node in the file (starting from 1)
+    */
+   template<typename T, size_t DIM>
+   int
+   addNode(const point<T, DIM>& pt)
+   {
+      for (size_t i = 0; i < 3; i++)
+         m_coords.push_back(i < DIM ? double(pt.at(i)) : 0.0);
+      return int(numberOfNodes());
+   }
+
+   int
+   addNode(const std::array<double, 3>& coor)
+   {
+      m_coords.insert(m_coords.end(), coor.begin(), coor.end());
+      return int(numberOfNodes());
+   }
+
+   /**
+    * @brief Add an element, the nodes are numbered from 1 as returned by addNode()
+    */
+   void
+   addElement(int type, const int* nodes)
+   {
+      auto& b = block(type);
+      b.nodes.insert(b.nodes.end(), nodes, nodes + b.nodes_per_element);
+   }
+
+   /**
+    * @brief Add a field at the nodes [first_node, first_node + num_nodes), numbered from 1
+    *
+    * @return std::vector<double>& values of the field, num_comp per node, to be filled by the caller
+    */
+   std::vector<double>&
+   addNodeView(const std::string& name, int num_comp, int first_node, size_t num_nodes)
+   {
+      m_views.push_back(node_view{name, num_comp, first_node, std::vector<double>(num_comp * num_nodes, 0.0)});
+      return m_views.back().values;
+   }
+
+   /**
+    * @brief Write the mesh and the fields in a binary Gmsh file
+    */
+   void
+   write(const std::string& filename) const
+   {
+      std::ofstream ofs(filename, std::ios::binary);
+      if (!ofs.is_open())
+         throw std::runtime_error("GmshBinaryData: cannot open " + filename);
+
+      auto write_int = [&](int v) { ofs.write(reinterpret_cast<const char*>(&v), sizeof(int)); };
+
+      ofs << "$MeshFormat\n2.2 1 " << sizeof(double) << "\n";
+      write_int(1);
+      ofs << "\n$EndMeshFormat\n";
+
+      // node-number x y z
+      ofs << "$Nodes\n" << numberOfNodes() << "\n";
+      std::vector<char> buffer;
+      const size_t      node_bytes = sizeof(int) + 3 * sizeof(double);
+      buffer.resize(numberOfNodes() * node_bytes);
+      for (size_t i = 0; i < numberOfNodes(); i++) {
+         const int num = int(i + 1);
+         std::memcpy(buffer.data() + i * node_bytes, &num, sizeof(int));
+         std::memcpy(buffer.data() + i * node_bytes + sizeof(int), m_coords.data() + 3 * i, 3 * sizeof(double));
+      }
+      ofs.write(buffer.data(), buffer.size());
+      ofs << "\n$EndNodes\n";
+
+      // per block: type, number of elements, number of tags, then elm-number physical elementary nodes...
+      ofs << "$Elements\n" << numberOfElements() << "\n";
+      int elem_num = 0;
+      for (auto& b : m_blocks) {
+         const int num_elems = int(b.nodes.size() / b.nodes_per_element);
+         if (num_elems == 0)
+            continue;
+
+         const int header[3] = {b.type, num_elems, 2};
+         ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+         std::vector<int> data;
+         data.reserve(num_elems * (3 + b.nodes_per_element));
+         for (int e = 0; e < num_elems; e++) {
+            data.push_back(++elem_num);
+            data.push_back(0);
+            data.push_back(0);
+            data.insert(data.end(),
+                        b.nodes.begin() + e * b.nodes_per_element,
+                        b.nodes.begin() + (e + 1) * b.nodes_per_element);
+         }
+         ofs.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(int));
+      }
+      ofs << "\n$EndElements\n";
+
+      // node-number values...
+      for (auto& v : m_views) {
+         const size_t num_nodes = v.values.size() / v.num_comp;
+         ofs << "$NodeData\n1\n\"" << v.name << "\"\n1\n0.0\n3\n0\n" << v.num_comp << "\n" << num_nodes << "\n";
+
+         const size_t value_bytes = sizeof(int) + v.num_comp * sizeof(double);
+         buffer.resize(num_nodes * value_bytes);
+         for (size_t i = 0; i < num_nodes; i++) {
+            const int num = int(v.first_node + i);
+            std::memcpy(buffer.data() + i * value_bytes, &num, sizeof(int));
+            std::memcpy(buffer.data() + i * value_bytes + sizeof(int),
+                        v.values.data() + i * v.num_comp,
+                        v.num_comp * sizeof(double));
+         }
+         ofs.write(buffer.data(), buffer.size());
+         ofs << "\n$EndNodeData\n";
+      }
+
+      if (!ofs.good())
+         throw std::runtime_error("GmshBinaryData: cannot write " + filename);
+   }
+};
+
+/**
+ * @brief Snapshot of the simplicial mesh of a PostMesh: its nodes and its triangles (2D) or
+ * tetrahedra (3D), positively oriented. The nodes keep their numbers in the post-processing mesh.
+ *
+ * @param num_extra_nodes number of nodes that will be added, for the reservation
+ */
+template<typename PostMeshType>
+GmshBinaryData
+make_gmsh_binary_mesh(const PostMeshType& post_mesh, size_t num_extra_nodes = 0)
+{
+   const auto& mesh    = post_mesh.mesh();
+   auto        storage = mesh.backend_storage();
+
+   const size_t DIM = std::remove_reference<decltype(mesh)>::type::dimension;
+   static_assert(DIM == 2 || DIM == 3, "make_gmsh_binary_mesh: only 2D and 3D meshes");
+
+   GmshBinaryData data;
+   data.reserveNodes(storage->points.size() + num_extra_nodes);
+   for (auto& pt : storage->points)
+      data.addNode(pt);
+
+   if constexpr (DIM == 2) {
+      data.reserveElements(GMSH_TRIANGLE, storage->surfaces.size());
+      for (auto& s : storage->surfaces) {
+         const auto ptids = s.point_ids();
+         int        nodes[3];
+         for (size_t i = 0; i < 3; i++)
+            nodes[i] = int(ptids[i]) + 1;
+
+         const auto v0 = storage->points[ptids[1]] - storage->points[ptids[0]];
+         const auto v1 = storage->points[ptids[2]] - storage->points[ptids[0]];
+         if (v0.x() * v1.y() - v0.y() * v1.x() < 0)
+            std::swap(nodes[1], nodes[2]);
+
+         data.addElement(GMSH_TRIANGLE, nodes);
+      }
+   } else {
+      data.reserveElements(GMSH_TETRAHEDRON, storage->volumes.size());
+      for (auto& v : storage->volumes) {
+         const auto ptids = v.point_ids();
+         int        nodes[4];
+         for (size_t i = 0; i < 4; i++)
+            nodes[i] = int(ptids[i]) + 1;
+
+         const auto v0 = (storage->points[ptids[1]] - storage->points[ptids[0]]).to_vector();
+         const auto v1 = (storage->points[ptids[2]] - storage->points[ptids[0]]).to_vector();
+         const auto v2 = (storage->points[ptids[3]] - storage->points[ptids[0]]).to_vector();
+         if (v0.cross(v1).dot(v2) < 0)
+            std::swap(nodes[1], nodes[2]);
+
+         data.addElement(GMSH_TETRAHEDRON, nodes);
+      }
+   }
+
+   return data;
+}
+
+/**
+ * @brief Write Gmsh snapshots on a background thread, in the order they are given. The caller
+ * continues as soon as the snapshot is queued.
+ */
+class GmshAsyncWriter
+{
+   std::deque<std::pair<std::string, GmshBinaryData>> m_queue;
+   std::mutex                                         m_mutex;
+   std::condition_variable                            m_cv;
+   bool                                               m_busy, m_stop;
+   std::exception_ptr                                 m_error;
+   std::thread                                        m_thread;
+
+   void
+   run(void)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (true) {
+         m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+         if (m_queue.empty())
+            return;
+
+         auto job = std::move(m_queue.front());
+         m_queue.pop_front();
+         m_busy = true;
+         lock.unlock();
+
+         try {
+            job.second.write(job.first);
+         } catch (...) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if (!m_error)
+               m_error = std::current_exception();
+         }
+
+         lock.lock();
+         m_busy = false;
+         m_cv.notify_all();
+      }
+   }
+
+ public:
+   GmshAsyncWriter() : m_busy(false), m_stop(false), m_thread(&GmshAsyncWriter::run, this) {}
+
+   GmshAsyncWriter(const GmshAsyncWriter&) = delete;
+   GmshAsyncWriter&
+   operator=(const GmshAsyncWriter&) = delete;
+
+   ~GmshAsyncWriter()
+   {
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_stop = true;
+      }
+      m_cv.notify_all();
+      m_thread.join();
+   }
+
+   /**
+    * @brief Queue a snapshot to write in filename
+    */
+   void
+   write(const std::string& filename, GmshBinaryData&& data)
+   {
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_queue.emplace_back(filename, std::move(data));
+      }
+      m_cv.notify_all();
+   }
+
+   /**
+    * @brief Wait until all the queued snapshots are written. The first error of the writing is thrown here.
+    */
+   void
+   wait(void)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+      if (m_error) {
+         auto error = m_error;
+         m_error    = nullptr;
+         std::rethrow_exception(error);
+      }
+   }
+};
+
+} // disk
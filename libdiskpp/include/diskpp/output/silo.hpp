@@ -444,10 +444,10 @@ public:
         return true;
     }
 
-    template<typename T>
-    bool add_mesh(generic_mesh<T,3>& msh, const std::string& name)
+    template<typename T, generic_storage Storage>
+    bool add_mesh(mesh<T,3,Storage>& msh, const std::string& name)
     {
-        using mesh_type = generic_mesh<T,3>;
+        using mesh_type = mesh<T,3,Storage>;
 
         static_assert(std::is_same<T,double>::value, "Only double for now");
 
@@ -525,8 +525,8 @@ public:
         return true;
     }
 
-    template<typename T>
-    bool add_mesh(const generic_mesh<T,2>& msh, const std::string& name)
+    template<typename T, generic_storage Storage>
+    bool add_mesh(const mesh<T,2,Storage>& msh, const std::string& name)
     {
         static_assert(std::is_same<T,double>::value, "Only double for now");
 
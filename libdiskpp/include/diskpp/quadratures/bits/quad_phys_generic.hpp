@@ -36,10 +36,10 @@ namespace priv {
 
 /* Integrate a convex element: determine a rough center and build triangles
  * between it and all the edges. Then use a triangle quadrature. */
-template<typename T>
+template<typename T, generic_storage Storage>
 auto
-integrate_convex(const disk::generic_mesh<T,2>& msh,
-    const typename disk::generic_mesh<T,2>::cell_type& cl, size_t degree)
+integrate_convex(const disk::mesh<T,2,Storage>& msh,
+    const typename disk::mesh<T,2,Storage>::cell_type& cl, size_t degree)
 {
     auto pts = points(msh, cl);
     assert(pts.size() > 2);
@@ -61,10 +61,10 @@ integrate_convex(const disk::generic_mesh<T,2>& msh,
 
 /* Integrate a non-convex element: triangulate by calling a mesh generator.
  * Then use a triangle quadrature. */
-template<typename T>
+template<typename T, generic_storage Storage>
 auto
-integrate_nonconvex(const disk::generic_mesh<T,2>& msh,
-    const typename disk::generic_mesh<T,2>::cell_type& cl, size_t degree)
+integrate_nonconvex(const disk::mesh<T,2,Storage>& msh,
+    const typename disk::mesh<T,2,Storage>::cell_type& cl, size_t degree)
 {
     auto tris = triangulate_nonconvex_polygon(msh, cl);
 
@@ -83,9 +83,9 @@ integrate_nonconvex(const disk::generic_mesh<T,2>& msh,
 } // namespace quadrature
 
 
-template<typename T>
+template<typename T, generic_storage Storage>
 std::vector<disk::quadrature_point<T, 2>>
-integrate(const disk::generic_mesh<T, 2>& msh, const typename disk::generic_mesh<T, 2>::cell& cl, size_t degree)
+integrate(const disk::mesh<T, 2, Storage>& msh, const typename disk::mesh<T, 2, Storage>::cell& cl, size_t degree)
 {
     const auto pts = points(msh, cl);
 
@@ -108,10 +108,10 @@ integrate(const disk::generic_mesh<T, 2>& msh, const typename disk::generic_mesh
     return quadrature::priv::integrate_nonconvex(msh, cl, degree);
 }
 
-template<typename T>
+template<typename T, generic_storage Storage>
 auto
-integrate(const disk::generic_mesh<T, 2>& msh,
-    const typename disk::generic_mesh<T, 2>::face& fc, size_t degree)
+integrate(const disk::mesh<T, 2, Storage>& msh,
+    const typename disk::mesh<T, 2, Storage>::face& fc, size_t degree)
 {
     auto pts = points(msh, fc);
     assert(pts.size() == 2);
@@ -121,10 +121,10 @@ integrate(const disk::generic_mesh<T, 2>& msh,
 
 namespace priv {
 
-template<typename T>
+template<typename T, generic_storage Storage>
 std::vector<disk::quadrature_point<T, 3>>
-integrate_polyhedron(const disk::generic_mesh<T, 3>&                msh,
-                     const typename disk::generic_mesh<T, 3>::cell& cl,
+integrate_polyhedron(const disk::mesh<T, 3, Storage>&                msh,
+                     const typename disk::mesh<T, 3, Storage>::cell& cl,
                      const size_t                                   degree)
 {
     using quadpoint_type = disk::quadrature_point<T, 3>;
@@ -155,10 +155,10 @@ integrate_polyhedron(const disk::generic_mesh<T, 3>&                msh,
     return ret;
 } 
 
-template<typename T>
+template<typename T, generic_storage Storage>
 std::vector<disk::quadrature_point<T, 3>>
-integrate_polyhedron_face(const disk::generic_mesh<T, 3>&                msh,
-                          const typename disk::generic_mesh<T, 3>::face& fc,
+integrate_polyhedron_face(const disk::mesh<T, 3, Storage>&                msh,
+                          const typename disk::mesh<T, 3, Storage>::face& fc,
                           const size_t                                         degree)
 {
     using quadpoint_type = disk::quadrature_point<T, 3>;
@@ -191,9 +191,9 @@ integrate_polyhedron_face(const disk::generic_mesh<T, 3>&                msh,
 
 } // end priv
 
-template<typename T>
+template<typename T, generic_storage Storage>
 std::vector<disk::quadrature_point<T, 3>>
-integrate(const disk::generic_mesh<T, 3>& msh, const typename disk::generic_mesh<T, 3>::cell& cl, const size_t degree)
+integrate(const disk::mesh<T, 3, Storage>& msh, const typename disk::mesh<T, 3, Storage>::cell& cl, const size_t degree)
 {
     if (degree == 0)
     {
@@ -214,9 +214,9 @@ integrate(const disk::generic_mesh<T, 3>& msh, const typename disk::generic_mesh
     }
 }
 
-template<typename T>
+template<typename T, generic_storage Storage>
 std::vector<disk::quadrature_point<T, 3>>
-integrate(const disk::generic_mesh<T, 3>& msh, const typename disk::generic_mesh<T, 3>::face& fc, const size_t degree)
+integrate(const disk::mesh<T, 3, Storage>& msh, const typename disk::mesh<T, 3, Storage>::face& fc, const size_t degree)
 {
     if (degree == 0)
     {
@@ -0,0 +1,239 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "diskpp/common/parallel.hpp"
+#include "diskpp/quadratures/quadratures.hpp"
+
+namespace disk {
+
+namespace priv {
+
+/* Quadrature provider that calls integrate() every time. The operator
+ * builders accepting a quadrature_cache use this when none is given. */
+struct uncached_quadrature
+{
+    template<typename Mesh, typename Element>
+    auto
+    operator()(const Mesh& msh, const Element& elem, size_t degree) const
+    {
+        return integrate(msh, elem, degree);
+    }
+};
+
+} // namespace priv
+
+/* Mesh-wide store of quadrature rules. integrate() builds a new std::vector
+ * at each call and, on generic meshes, triangulates the element again. The
+ * cache computes the rules of a given degree for all the cells (or all the
+ * faces) of the mesh the first time that degree is requested, and keeps
+ * them in a single contiguous array indexed by element id. The cache is
+ * thread-safe and is invalidated automatically when the mesh is transformed,
+ * refined or renumbered. The spans returned are valid until the next
+ * invalidation or clear(). */
+template<typename Mesh>
+class quadrature_cache
+{
+public:
+    typedef Mesh                                                    mesh_type;
+    typedef typename mesh_type::coordinate_type                     coordinate_type;
+    typedef typename mesh_type::cell_type                           cell_type;
+    typedef typename mesh_type::face_type                           face_type;
+    typedef quadrature_point<coordinate_type, mesh_type::dimension> quadpoint_type;
+
+    static const size_t max_degree = 40;
+
+private:
+    struct table
+    {
+        std::mutex                  mtx;
+        std::atomic<bool>           ready;
+        std::vector<size_t>         offsets;
+        std::vector<quadpoint_type> qps;
+
+        table() : ready(false) {}
+    };
+
+    /* The tables are filled on demand by the const methods */
+    const mesh_type*                        m_msh;
+    mutable std::array<table, max_degree+1> m_cell_tables;
+    mutable std::array<table, max_degree+1> m_face_tables;
+
+    mutable std::mutex                      m_mtx;
+    mutable std::atomic<size_t>             m_version;
+    mutable size_t                          m_num_cells;
+    mutable size_t                          m_num_faces;
+
+    bool
+    mesh_unchanged(void) const
+    {
+        return m_version.load(std::memory_order_acquire) == m_msh->geometry_version() and
+               m_num_cells == m_msh->cells_size() and m_num_faces == m_msh->faces_size();
+    }
+
+    void
+    check_mesh(void) const
+    {
+        if ( mesh_unchanged() )
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if ( mesh_unchanged() )
+            return;
+
+        clear_tables();
+        m_num_cells = m_msh->cells_size();
+        m_num_faces = m_msh->faces_size();
+        m_version.store(m_msh->geometry_version(), std::memory_order_release);
+    }
+
+    void
+    clear_tables(void) const
+    {
+        for (auto& tab : m_cell_tables)
+        {
+            tab.ready.store(false, std::memory_order_relaxed);
+            tab.offsets.clear();
+            tab.qps.clear();
+        }
+
+        for (auto& tab : m_face_tables)
+        {
+            tab.ready.store(false, std::memory_order_relaxed);
+            tab.offsets.clear();
+            tab.qps.clear();
+        }
+    }
+
+    template<typename Iterator>
+    void
+    fill(table& tab, const Iterator& begin, const Iterator& end, size_t degree) const
+    {
+        const size_t num_elems = std::distance(begin, end);
+
+        std::vector<std::vector<quadpoint_type>> elem_qps(num_elems);
+        auto compute = [&](size_t i, size_t) {
+            elem_qps[i] = disk::integrate(*m_msh, *std::next(begin, i), degree);
+        };
+        parallel_for(0, num_elems, compute);
+
+        tab.offsets.resize(num_elems+1);
+        size_t num_qps = 0;
+        for (size_t i = 0; i < num_elems; i++)
+        {
+            tab.offsets[i] = num_qps;
+            num_qps += elem_qps[i].size();
+        }
+        tab.offsets[num_elems] = num_qps;
+
+        tab.qps.clear();
+        tab.qps.reserve(num_qps);
+        for (auto& qps : elem_qps)
+            tab.qps.insert(tab.qps.end(), qps.begin(), qps.end());
+    }
+
+    template<typename Iterator>
+    std::span<const quadpoint_type>
+    get(table& tab, const Iterator& begin, const Iterator& end, size_t elem_id, size_t degree) const
+    {
+        if ( not tab.ready.load(std::memory_order_acquire) )
+        {
+            std::lock_guard<std::mutex> lock(tab.mtx);
+            if ( not tab.ready.load(std::memory_order_relaxed) )
+            {
+                fill(tab, begin, end, degree);
+                tab.ready.store(true, std::memory_order_release);
+            }
+        }
+
+        assert(elem_id+1 < tab.offsets.size());
+        auto qbegin = tab.qps.data() + tab.offsets[elem_id];
+        auto qend = tab.qps.data() + tab.offsets[elem_id+1];
+        return std::span<const quadpoint_type>(qbegin, qend);
+    }
+
+public:
+    quadrature_cache(const mesh_type& msh)
+        : m_msh(&msh), m_version(msh.geometry_version()),
+          m_num_cells(msh.cells_size()), m_num_faces(msh.faces_size())
+    {}
+
+    quadrature_cache(const quadrature_cache&) = delete;
+    quadrature_cache& operator=(const quadrature_cache&) = delete;
+
+    const mesh_type&
+    mesh(void) const
+    {
+        return *m_msh;
+    }
+
+    /* Quadrature of the specified degree on the cell */
+    std::span<const quadpoint_type>
+    integrate(const cell_type& cl, size_t degree) const
+    {
+        if (degree > max_degree)
+            throw std::invalid_argument("quadrature_cache: degree too high");
+
+        check_mesh();
+        return get(m_cell_tables[degree], m_msh->cells_begin(), m_msh->cells_end(),
+                   m_msh->lookup(cl), degree);
+    }
+
+    /* Quadrature of the specified degree on the face */
+    std::span<const quadpoint_type>
+    integrate(const face_type& fc, size_t degree) const
+    {
+        if (degree > max_degree)
+            throw std::invalid_argument("quadrature_cache: degree too high");
+
+        check_mesh();
+        return get(m_face_tables[degree], m_msh->faces_begin(), m_msh->faces_end(),
+                   m_msh->lookup(fc), degree);
+    }
+
+    /* Same interface of priv::uncached_quadrature, for the operator builders */
+    template<typename Element>
+    std::span<const quadpoint_type>
+    operator()(const mesh_type& msh, const Element& elem, size_t degree) const
+    {
+        assert(&msh == m_msh or msh.backend_storage() == m_msh->backend_storage());
+        return integrate(elem, degree);
+    }
+
+    /* Drop all the cached rules. Not safe while other threads use the cache. */
+    void
+    clear(void)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        clear_tables();
+    }
+
+    /* Number of quadrature points currently stored */
+    size_t
+    size(void) const
+    {
+        size_t ret = 0;
+        for (auto& tab : m_cell_tables)
+            ret += tab.qps.size();
+        for (auto& tab : m_face_tables)
+            ret += tab.qps.size();
+        return ret;
+    }
+};
+
+} // namespace disk
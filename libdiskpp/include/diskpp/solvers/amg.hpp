@@ -0,0 +1,497 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <Eigen/SparseCholesky>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/solvers/sparse_kernels.hpp"
+
+namespace disk { namespace solvers {
+
+template<typename T>
+struct amg_params
+{
+    size_t  block_size;         /* unknowns per node, for example per face */
+    T       strength_threshold; /* strong coupling: |A_IJ| >= thr * sqrt(|A_II| |A_JJ|) */
+    size_t  max_levels;
+    size_t  coarse_size;        /* solve directly below this number of unknowns */
+    size_t  smoother_degree;    /* degree of the Chebyshev smoother */
+    T       smoother_ratio;     /* the smoother targets [rho/ratio, rho] */
+    size_t  num_threads;        /* 0: default_num_threads() */
+    T       rr_tol;             /* only for the standalone solver */
+    size_t  max_iter;           /* only for the standalone solver */
+    bool    verbose;
+
+    amg_params() : block_size(1),
+                   strength_threshold(0.08),
+                   max_levels(20),
+                   coarse_size(1000),
+                   smoother_degree(3),
+                   smoother_ratio(30),
+                   num_threads(0),
+                   rr_tol(1e-8),
+                   max_iter(100),
+                   verbose(false) {}
+};
+
+namespace priv {
+
+/* Strength of connection between the nodes (groups of block_size unknowns)
+ * of A: the Frobenius norm of each block. Returns the strong neighbours of
+ * each node. */
+template<typename T>
+std::vector<std::vector<size_t>>
+amg_strong_connections(const Eigen::SparseMatrix<T>& A, size_t bs, T threshold)
+{
+    const size_t num_nodes = A.rows() / bs;
+
+    std::vector<Eigen::Triplet<T>> triplets;
+    triplets.reserve(A.nonZeros());
+    for (int k = 0; k < A.outerSize(); k++)
+        for (typename Eigen::SparseMatrix<T>::InnerIterator it(A, k); it; ++it)
+            triplets.push_back( Eigen::Triplet<T>(it.row()/bs, it.col()/bs, it.value()*it.value()) );
+
+    Eigen::SparseMatrix<T> S(num_nodes, num_nodes);
+    S.setFromTriplets(triplets.begin(), triplets.end());
+
+    dynamic_vector<T> diag = S.diagonal().cwiseSqrt();
+
+    std::vector<std::vector<size_t>> strong(num_nodes);
+    for (int J = 0; J < S.outerSize(); J++)
+    {
+        for (typename Eigen::SparseMatrix<T>::InnerIterator it(S, J); it; ++it)
+        {
+            const size_t I = it.row();
+            if (I == size_t(J))
+                continue;
+
+            if (std::sqrt(it.value()) >= threshold * std::sqrt(diag(I)*diag(J)))
+                strong[I].push_back(J);
+        }
+    }
+
+    return strong;
+}
+
+/* Greedy aggregation of the nodes (Vanek, Mandel, Brezina 1996). Returns
+ * the aggregate of each node and the number of aggregates. */
+inline size_t
+amg_aggregate(const std::vector<std::vector<size_t>>& strong, std::vector<size_t>& aggregates)
+{
+    const size_t num_nodes = strong.size();
+    const size_t none = size_t(-1);
+
+    aggregates.assign(num_nodes, none);
+    size_t num_aggregates = 0;
+
+    /* Pass 1: nodes whose neighbourhood is completely free */
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        if (aggregates[i] != none)
+            continue;
+
+        bool free = true;
+        for (auto j : strong[i])
+            free = free and (aggregates[j] == none);
+
+        if (not free)
+            continue;
+
+        aggregates[i] = num_aggregates;
+        for (auto j : strong[i])
+            aggregates[j] = num_aggregates;
+        num_aggregates++;
+    }
+
+    /* Pass 2: join a neighbouring aggregate of pass 1 */
+    std::vector<size_t> pass1 = aggregates;
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        if (aggregates[i] != none)
+            continue;
+
+        for (auto j : strong[i])
+        {
+            if (pass1[j] != none)
+            {
+                aggregates[i] = pass1[j];
+                break;
+            }
+        }
+    }
+
+    /* Pass 3: new aggregates with the remaining nodes */
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        if (aggregates[i] != none)
+            continue;
+
+        aggregates[i] = num_aggregates;
+        for (auto j : strong[i])
+            if (aggregates[j] == none)
+                aggregates[j] = num_aggregates;
+        num_aggregates++;
+    }
+
+    return num_aggregates;
+}
+
+/* Inverse of the block diagonal of A, as a sparse matrix */
+template<typename T>
+Eigen::SparseMatrix<T>
+amg_block_diagonal_inverse(const Eigen::SparseMatrix<T>& A, size_t bs)
+{
+    std::vector<Eigen::Triplet<T>> triplets;
+    triplets.reserve(A.rows() * bs);
+
+    for (size_t ofs = 0; ofs < size_t(A.rows()); ofs += bs)
+    {
+        dynamic_matrix<T> D = dynamic_matrix<T>::Zero(bs, bs);
+        for (size_t j = 0; j < bs; j++)
+            for (typename Eigen::SparseMatrix<T>::InnerIterator it(A, ofs+j); it; ++it)
+                if (size_t(it.row()) >= ofs and size_t(it.row()) < ofs+bs)
+                    D(it.row()-ofs, j) = it.value();
+
+        dynamic_matrix<T> Dinv = D.fullPivLu().inverse();
+        for (size_t i = 0; i < bs; i++)
+            for (size_t j = 0; j < bs; j++)
+                if (Dinv(i,j) != T(0))
+                    triplets.push_back( Eigen::Triplet<T>(ofs+i, ofs+j, Dinv(i,j)) );
+    }
+
+    Eigen::SparseMatrix<T> ret(A.rows(), A.cols());
+    ret.setFromTriplets(triplets.begin(), triplets.end());
+    return ret;
+}
+
+/* Estimate of the spectral radius of Dinv*A with a few power iterations */
+template<typename T>
+T
+amg_spectral_radius(const Eigen::SparseMatrix<T>& Dinv, const Eigen::SparseMatrix<T>& A)
+{
+    /* Deterministic start vector, not smooth: the smooth vectors are
+     * (almost) in the kernel and would converge slowly */
+    dynamic_vector<T> v(A.rows());
+    for (size_t i = 0; i < size_t(v.size()); i++)
+        v(i) = T((i*7919) % 101)/101 - 0.5;
+
+    T rho = 1.0;
+    for (size_t i = 0; i < 20; i++)
+    {
+        dynamic_vector<T> w = Dinv * (A * v);
+        T nw = w.norm();
+        if (nw == T(0))
+            break;
+        rho = nw / v.norm();
+        v = w / nw;
+    }
+
+    return rho;
+}
+
+} // namespace priv
+
+/* Smoothed aggregation algebraic multigrid for symmetric positive definite
+ * matrices, see "Algebraic multigrid by smoothed aggregation for second
+ * and fourth order elliptic problems" by Vanek, Mandel & Brezina.
+ *
+ * On the finest level the unknowns are grouped in nodes of block_size
+ * unknowns each: for a statically condensed HHO system the natural choice
+ * is block_size = scalar_basis_size(face_degree, DIM-1), so that the
+ * aggregates are made of whole faces and the smoother inverts the face
+ * blocks. The first unknown of each block must represent the constants
+ * (this is the case with the scaled monomial bases): the tentative
+ * prolongator interpolates only that component, the higher order modes on
+ * each face are left to the smoother. The coarse levels are therefore
+ * scalar. The tentative prolongator is smoothed with a damped block Jacobi
+ * step, the smoother is a Chebyshev polynomial in D^{-1}A, with D the block
+ * diagonal of A. The coarsest level is solved with a sparse Cholesky.
+ *
+ * apply() performs one V-cycle and has the preconditioner interface of
+ * preconditioners.hpp, so this class can be passed to
+ * conjugated_gradient(). solve() uses the V-cycle as a standalone
+ * iterative solver. */
+template<typename T>
+class amg_solver
+{
+    typedef Eigen::SparseMatrix<T>      sparse_matrix_type;
+    typedef dynamic_vector<T>           vector_type;
+
+    struct level
+    {
+        std::optional<parallel_sparse_matrix<T>>    A, Dinv, P, R;
+        T                                           rho;
+        size_t                                      size;
+    };
+
+    amg_params<T>                                       m_params;
+    std::vector<level>                                  m_levels;
+    std::unique_ptr<Eigen::SimplicialLDLT<sparse_matrix_type>>  m_coarse_solver;
+
+    /* Shape of the matrix the hierarchy was built from */
+    Eigen::Index                                        m_rows = 0;
+    Eigen::Index                                        m_cols = 0;
+    Eigen::Index                                        m_nonzeros = 0;
+
+    /* Chebyshev iteration on D^{-1}A x = D^{-1}b, see Saad, "Iterative
+     * methods for sparse linear systems", algorithm 12.1. The polynomial
+     * is the same for pre and post smoothing, so the V-cycle is symmetric
+     * and can precondition the conjugate gradient. */
+    void
+    smooth(const level& lvl, const vector_type& b, vector_type& x, size_t nt) const
+    {
+        const T upper = 1.1 * lvl.rho;
+        const T lower = upper / m_params.smoother_ratio;
+        const T theta = (upper + lower)/2;
+        const T delta = (upper - lower)/2;
+        const T sigma = theta/delta;
+        T rho = 1/sigma;
+
+        vector_type r(lvl.size), z(lvl.size), d(lvl.size);
+        lvl.A->multiply(x, r);
+        parallel_xpby(b, T(-1), r, nt);
+        lvl.Dinv->multiply(r, d);
+        d /= theta;
+
+        for (size_t k = 1; k <= m_params.smoother_degree; k++)
+        {
+            parallel_axpy(T(1), d, x, nt);
+            if (k == m_params.smoother_degree)
+                break;
+
+            lvl.A->multiply(d, z);
+            parallel_axpy(T(-1), z, r, nt);
+            lvl.Dinv->multiply(r, z);
+
+            T rho_next = 1/(2*sigma - rho);
+            d *= rho_next*rho;
+            parallel_axpy(2*rho_next/delta, z, d, nt);
+            rho = rho_next;
+        }
+    }
+
+    void
+    vcycle(size_t l, const vector_type& b, vector_type& x) const
+    {
+        if (l == m_levels.size())
+        {
+            x = m_coarse_solver->solve(b);
+            return;
+        }
+
+        const size_t nt = priv::kernel_threads(m_params.num_threads);
+        const auto& lvl = m_levels[l];
+
+        x = vector_type::Zero(lvl.size);
+        smooth(lvl, b, x, nt);
+
+        vector_type r(lvl.size);
+        lvl.A->multiply(x, r);
+        parallel_xpby(b, T(-1), r, nt);
+
+        vector_type bc, xc, e;
+        lvl.R->multiply(r, bc);
+        vcycle(l+1, bc, xc);
+        lvl.P->multiply(xc, e);
+        parallel_axpy(T(1), e, x, nt);
+
+        smooth(lvl, b, x, nt);
+    }
+
+public:
+    amg_solver()
+    {}
+
+    amg_solver(const amg_params<T>& params)
+        : m_params(params)
+    {}
+
+    amg_params<T>&
+    params(void)
+    {
+        return m_params;
+    }
+
+    size_t
+    num_levels(void) const
+    {
+        return m_levels.size() + 1;
+    }
+
+    /* Build the multigrid hierarchy */
+    bool
+    compute(const sparse_matrix_type& A_fine)
+    {
+        m_levels.clear();
+        m_coarse_solver.reset();
+        m_rows = A_fine.rows();
+        m_cols = A_fine.cols();
+        m_nonzeros = A_fine.nonZeros();
+
+        size_t bs = m_params.block_size;
+        if (bs == 0 or A_fine.rows() % bs != 0)
+        {
+            if (m_params.verbose)
+                std::cout << "[AMG] Matrix size is not a multiple of the block size, using 1" << std::endl;
+            bs = 1;
+        }
+
+        const size_t nt = priv::kernel_threads(m_params.num_threads);
+
+        sparse_matrix_type A = A_fine;
+        while (size_t(A.rows()) > m_params.coarse_size and m_levels.size()+1 < m_params.max_levels)
+        {
+            auto strong = priv::amg_strong_connections(A, bs, m_params.strength_threshold);
+            std::vector<size_t> aggregates;
+            size_t num_aggregates = priv::amg_aggregate(strong, aggregates);
+
+            /* Coarsening stagnated: the aggregates group the nodes, that
+             * is the blocks of bs unknowns */
+            const size_t num_nodes = A.rows() / bs;
+            if (num_aggregates > 0.9*num_nodes)
+                break;
+
+            std::vector<size_t> agg_size(num_aggregates, 0);
+            for (auto& a : aggregates)
+                agg_size[a]++;
+
+            std::vector<Eigen::Triplet<T>> triplets;
+            triplets.reserve(aggregates.size());
+            for (size_t node = 0; node < aggregates.size(); node++)
+            {
+                auto a = aggregates[node];
+                T val = 1.0/std::sqrt(T(agg_size[a]));
+                triplets.push_back( Eigen::Triplet<T>(node*bs, a, val) );
+            }
+
+            sparse_matrix_type P_tent(A.rows(), num_aggregates);
+            P_tent.setFromTriplets(triplets.begin(), triplets.end());
+
+            sparse_matrix_type Dinv = priv::amg_block_diagonal_inverse(A, bs);
+            T rho = priv::amg_spectral_radius(Dinv, A);
+            T omega = 4.0/(3.0*rho);
+
+            sparse_matrix_type AP = A * P_tent;
+            sparse_matrix_type P = P_tent - omega * (Dinv * AP);
+            P.prune(T(0));
+            sparse_matrix_type R = P.transpose();
+            sparse_matrix_type Ac = R * (A * P);
+            Ac.prune(T(0));
+
+            level lvl;
+            lvl.A.emplace(A, nt);
+            lvl.Dinv.emplace(Dinv, nt);
+            lvl.P.emplace(P, nt);
+            lvl.R.emplace(R, nt);
+            lvl.rho = rho;
+            lvl.size = A.rows();
+            m_levels.push_back( std::move(lvl) );
+
+            if (m_params.verbose)
+            {
+                std::cout << "[AMG] Level " << m_levels.size()-1 << ": " << A.rows();
+                std::cout << " unknowns, " << A.nonZeros() << " nonzeros" << std::endl;
+            }
+
+            A = std::move(Ac);
+            bs = 1;
+        }
+
+        if (m_params.verbose)
+        {
+            std::cout << "[AMG] Level " << m_levels.size() << ": " << A.rows();
+            std::cout << " unknowns, " << A.nonZeros() << " nonzeros (direct)" << std::endl;
+        }
+
+        m_coarse_solver = std::make_unique<Eigen::SimplicialLDLT<sparse_matrix_type>>(A);
+        if (m_coarse_solver->info() != Eigen::Success)
+        {
+            std::cout << "[AMG] Coarse level factorization failed" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /* z = one V-cycle applied to r, starting from zero */
+    void
+    apply(const vector_type& r, vector_type& z) const
+    {
+        assert(m_coarse_solver);
+        vcycle(0, r, z);
+    }
+
+    /* Standalone solver: V-cycles until the residual, relative to the
+     * right hand side, is below rr_tol. Returns true if converged. A must
+     * be the matrix passed to compute(): the residuals are computed with
+     * the copy kept in the hierarchy, A is read only when the hierarchy
+     * has no levels. */
+    bool
+    solve(const sparse_matrix_type& A, const vector_type& b, vector_type& x) const
+    {
+        assert(m_coarse_solver);
+        assert(A.rows() == m_rows and A.cols() == m_cols and A.nonZeros() == m_nonzeros);
+        if (A.rows() != m_rows or A.cols() != m_cols or A.nonZeros() != m_nonzeros)
+        {
+            std::cout << "[AMG] Matrix does not match the hierarchy" << std::endl;
+            return false;
+        }
+
+        const size_t nt = priv::kernel_threads(m_params.num_threads);
+
+        if (x.size() != b.size())
+            x = vector_type::Zero(b.size());
+
+        T nb = b.norm();
+        if (nb == T(0))
+        {
+            x.setZero();
+            return true;
+        }
+
+        /* Without levels the hierarchy keeps only the factorization */
+        std::optional<parallel_sparse_matrix<T>> A_copy;
+        if (m_levels.empty())
+            A_copy.emplace(A, nt);
+        const auto& pA = A_copy ? *A_copy : *m_levels[0].A;
+
+        vector_type r(b.size()), e;
+        for (size_t iter = 0; iter < m_params.max_iter; iter++)
+        {
+            pA.multiply(x, r);
+            parallel_xpby(b, T(-1), r, nt);
+
+            T rr = r.norm()/nb;
+            if (m_params.verbose)
+                std::cout << "[AMG] Iteration " << iter << ", rr = " << rr << std::endl;
+
+            if (rr < m_params.rr_tol)
+                return true;
+
+            apply(r, e);
+            parallel_axpy(T(1), e, x, nt);
+        }
+
+        pA.multiply(x, r);
+        return (b - r).norm()/nb < m_params.rr_tol;
+    }
+};
+
+} // namespace solvers
+} // namespace disk
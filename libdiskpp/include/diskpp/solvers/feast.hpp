@@ -65,10 +65,16 @@
 #include <array>
 #include <type_traits>
 #include <fstream>
+#include <cassert>
 
 #include "diskpp/common/eigen.hpp"
 #include "diskpp/common/colormanip.h"
 #include "diskpp/common/timecounter.hpp"
+#include "diskpp/common/parallel.hpp"
+
+#ifdef HAVE_MUMPS
+#include <zmumps_c.h>
+#endif
 
 
 /****************************************************************************/
@@ -191,6 +197,7 @@ struct feast_eigensolver_params
     int     feast_info;
     size_t  max_iter;
     feast_inner_solver fis;
+    bool    parallel_contour = false; /* solve the contour points concurrently */
 };
 
 static double quadrature_xs[] = {
@@ -207,6 +214,224 @@ static double quadrature_ws[] = {
     0.101228536290376, 0.101228536290376
 };
 
+/* Factorizations of the 8 shifted matrices Z_e*B - A used by feast(). The
+ * shifts do not change between the subspace iterations, so the matrices
+ * are factorized once and the factors are reused by all the iterations.
+ * All the shifted matrices have the same sparsity pattern, therefore the
+ * fill-reducing ordering is computed only once, in analyze(), and shared
+ * by the factorizations. Keeping the factors costs the memory of 8 LU
+ * decompositions. */
+namespace priv {
+
+using feast_csm = Eigen::SparseMatrix<std::complex<double>>;
+using feast_cdm = Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic>;
+
+class feast_sparselu_shifts
+{
+    using perm_type = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int>;
+    using lu_type = Eigen::SparseLU<feast_csm, Eigen::NaturalOrdering<int>>;
+
+    perm_type                   m_perm;
+    std::array<lu_type, 8>      m_lus;
+
+public:
+    /* The factorizations are independent, they can run concurrently */
+    static const bool concurrent = true;
+
+    bool
+    analyze(const feast_csm& lhs)
+    {
+        Eigen::COLAMDOrdering<int> ord;
+        ord(lhs, m_perm);
+        return true;
+    }
+
+    bool
+    factorize(size_t e, const feast_csm& lhs)
+    {
+        /* Same column permutation that SparseLU would apply internally */
+        feast_csm lhs_p = lhs * m_perm.inverse();
+        m_lus[e].compute(lhs_p);
+        if (m_lus[e].info() != Eigen::Success) {
+            std::cout << "FEAST: SparseLU failed" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    feast_cdm
+    solve(size_t e, const feast_cdm& rhs)
+    {
+        feast_cdm y = m_lus[e].solve(rhs);
+        return m_perm.inverse() * y;
+    }
+};
+
+#ifdef HAVE_MUMPS
+class feast_mumps_shifts
+{
+    int                                                 m_n;
+    std::vector<MUMPS_INT>                              m_irn, m_jcn, m_perm;
+    std::array<std::vector<std::complex<double>>, 8>    m_vals;
+    std::array<ZMUMPS_STRUC_C, 8>                       m_ids;
+    std::array<bool, 8>                                 m_initialized;
+
+    static ZMUMPS_COMPLEX *
+    mumps_ptr(std::complex<double> *p)
+    {
+        return reinterpret_cast<ZMUMPS_COMPLEX *>(p);
+    }
+
+    void
+    init(size_t e)
+    {
+        auto& id = m_ids[e];
+        id.job = -1;
+        id.par = 1;
+        id.sym = 0;
+        id.comm_fortran = -987654; /* MPI_COMM_WORLD, see mumps.hpp */
+        zmumps_c(&id);
+
+        id.icntl[0] = -1;
+        id.icntl[1] = -1;
+        id.icntl[2] = -1;
+        id.icntl[3] = 0;
+
+        id.n = m_n;
+        id.nz = m_irn.size();
+        id.irn = m_irn.data();
+        id.jcn = m_jcn.data();
+        m_initialized[e] = true;
+    }
+
+public:
+    /* MUMPS is multithreaded by itself, run the factorizations in sequence */
+    static const bool concurrent = false;
+
+    feast_mumps_shifts()
+        : m_n(0)
+    {
+        m_initialized.fill(false);
+    }
+
+    feast_mumps_shifts(const feast_mumps_shifts&) = delete;
+    feast_mumps_shifts& operator=(const feast_mumps_shifts&) = delete;
+
+    ~feast_mumps_shifts()
+    {
+        for (size_t e = 0; e < 8; e++) {
+            if (not m_initialized[e])
+                continue;
+            m_ids[e].job = -2;
+            zmumps_c(&m_ids[e]);
+        }
+    }
+
+    bool
+    analyze(const feast_csm& lhs)
+    {
+        assert(lhs.isCompressed());
+        m_n = lhs.rows();
+        m_irn.resize(lhs.nonZeros());
+        m_jcn.resize(lhs.nonZeros());
+        for (int j = 0; j < lhs.outerSize(); j++) {
+            for (int k = lhs.outerIndexPtr()[j]; k < lhs.outerIndexPtr()[j+1]; k++) {
+                m_irn[k] = lhs.innerIndexPtr()[k] + 1;
+                m_jcn[k] = j + 1;
+            }
+        }
+
+        /* Compute the ordering once, on the first shift */
+        init(0);
+        auto& id = m_ids[0];
+        id.job = 1;
+        zmumps_c(&id);
+        if (id.info[0] < 0) {
+            std::cout << "FEAST: MUMPS analysis failed, INFO(1) = ";
+            std::cout << id.info[0] << std::endl;
+            return false;
+        }
+
+        m_perm.assign(id.sym_perm, id.sym_perm + m_n);
+        return true;
+    }
+
+    bool
+    factorize(size_t e, const feast_csm& lhs)
+    {
+        assert(lhs.isCompressed() and lhs.nonZeros() == m_irn.size());
+        m_vals[e].assign(lhs.valuePtr(), lhs.valuePtr() + lhs.nonZeros());
+
+        auto& id = m_ids[e];
+        if (e != 0) {
+            /* Other shifts: analysis with the ordering of the first one */
+            init(e);
+            id.icntl[6] = 1;
+            id.perm_in = m_perm.data();
+            id.job = 1;
+            zmumps_c(&id);
+        }
+
+        id.a = mumps_ptr(m_vals[e].data());
+        id.job = 2;
+        zmumps_c(&id);
+        if (id.info[0] < 0) {
+            std::cout << "FEAST: MUMPS factorization failed, INFO(1) = ";
+            std::cout << id.info[0] << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    feast_cdm
+    solve(size_t e, const feast_cdm& rhs)
+    {
+        feast_cdm ret = rhs;
+        auto& id = m_ids[e];
+        id.rhs = mumps_ptr(ret.data());
+        id.nrhs = ret.cols();
+        id.lrhs = ret.rows();
+        id.job = 3;
+        zmumps_c(&id);
+        return ret;
+    }
+};
+#else
+/* Without HAVE_MUMPS we can only call mumps_lu(), which factorizes the
+ * matrix at each call. The shifted matrices are kept, at least they are
+ * not rebuilt at each iteration. */
+class feast_mumps_shifts
+{
+    std::array<feast_csm, 8>    m_lhs;
+
+public:
+    static const bool concurrent = false;
+
+    bool
+    analyze(const feast_csm&)
+    {
+        return true;
+    }
+
+    bool
+    factorize(size_t e, const feast_csm& lhs)
+    {
+        m_lhs[e] = lhs;
+        return true;
+    }
+
+    template<typename Matrix>
+    feast_cdm
+    solve(size_t e, const Matrix& rhs)
+    {
+        return mumps_lu(m_lhs[e], rhs);
+    }
+};
+#endif /* HAVE_MUMPS */
+
+} // namespace priv
+
 /* This function implements the algorithm presented in
  *   "A Density Matrix-based Algorithm for Solving Eigenvalue Problems"
  *   by E. Polizzi. arXiv:0901.2665v1.
@@ -231,9 +456,17 @@ static double quadrature_ws[] = {
  *   "FEAST as a subspace iteration eigensolver accelerated by approximate
  *   spectral projection" by Tang & Polizzi, arXiv:1302:0432v4.
  *
+ * The 8 shifted matrices are factorized only once, before the subspace
+ * iterations, see feast_sparselu_shifts and feast_mumps_shifts. If
+ * params.parallel_contour is set, the contour points are factorized and
+ * solved concurrently (only with SparseLU).
+ *
  * This is momentarily implemented only for double. I promise I'll make it generic.
  */
 
+namespace priv {
+
+template<typename Shifts>
 feast_status
 feast(const feast_eigensolver_params<double>& params,
     const Eigen::SparseMatrix<double>& A,
@@ -262,6 +495,38 @@ feast(const feast_eigensolver_params<double>& params,
     auto M0 = params.subspace_size;
     auto r = (params.max_eigval - params.min_eigval)/2.0;
 
+    std::array<std::complex<double>, 8> Z, phase;
+    for (size_t e = 0; e < 8; e++) {
+        auto theta_e = -(M_PI/2.)*(xs[e]-1.);
+        auto mid = (params.max_eigval + params.min_eigval)/2.0;
+        phase[e] = std::exp( std::complex<double>(0.0, theta_e) );
+        Z[e] = mid + r*phase[e];
+    }
+
+    auto shifted = [&](size_t e) {
+        csm lhs = Z[e]*B - std::complex<double>(1.0, 0.0)*A;
+        lhs.makeCompressed();
+        return lhs;
+    };
+
+    const bool concurrent = Shifts::concurrent and params.parallel_contour;
+    const size_t num_threads = concurrent ? 0 : 1;
+
+    /* Factorize the shifted matrices once for all the iterations */
+    Shifts shifts;
+    if ( not shifts.analyze(shifted(0)) )
+        return feast_status::inner_solver_problem;
+
+    std::array<bool, 8> factorized;
+    auto factorize = [&](size_t e, size_t) {
+        factorized[e] = shifts.factorize(e, shifted(e));
+    };
+    parallel_for(0, 8, factorize, num_threads);
+
+    for (auto f : factorized)
+        if (not f)
+            return feast_status::inner_solver_problem;
+
     rdm Y = rdm::Random(N, M0);
     double trace_prev = 0.0;
     for (size_t iter = 0; iter < params.max_iter; iter++) {        
@@ -269,34 +534,17 @@ feast(const feast_eigensolver_params<double>& params,
         rdm Q = rdm::Zero(N, M0);
         
         /* Subspace projection */
-        for (size_t e = 0; e < 8; e++) {
-            auto x_e = xs[e];
-            auto theta_e = -(M_PI/2.)*(x_e-1.);
-            auto mid = (params.max_eigval + params.min_eigval)/2.0;
-            auto Z_e = mid + r*std::exp( std::complex<double>(0.0, theta_e) );
-            csm lhs = Z_e*B - std::complex<double>(1.0, 0.0)*A;
-            
-            cdm Qe;
-            switch(params.fis) {
-                case feast_inner_solver::eigen_sparselu: {
-                    Eigen::SparseLU<csm> solver;
-                    solver.compute(lhs);
-                    if(solver.info() != Eigen::Success) {
-                        std::cout << "FEAST: SparseLU failed" << std::endl;
-                        return feast_status::inner_solver_problem;
-                    }
-                    Qe = solver.solve(Yc);
-                } break;
-
-                case feast_inner_solver::mumps: {
-                    Qe = mumps_lu(lhs, Yc);
-                }
-            }
-
-            cdm T = r * std::exp(std::complex<double>(0.0, theta_e)) * Qe;
-            auto omega_e = omegas[e];
-            Q = Q - (omega_e/2.0)*T.real();
-        }
+        std::array<rdm, 8> Qs;
+        auto contour_point = [&](size_t e, size_t) {
+            cdm Qe = shifts.solve(e, Yc);
+            cdm T = r * phase[e] * Qe;
+            Qs[e] = (omegas[e]/2.0)*T.real();
+        };
+        parallel_for(0, 8, contour_point, num_threads);
+
+        /* Sum in a fixed order to get the same result with any number of threads */
+        for (size_t e = 0; e < 8; e++)
+            Q = Q - Qs[e];
 
         /* Form matrices for reduced problem */
         rdm Aq = Q.transpose() * A * Q;
@@ -378,6 +626,26 @@ feast(const feast_eigensolver_params<double>& params,
     return feast_status::did_not_converge;
 }
 
+} // namespace priv
+
+feast_status
+feast(const feast_eigensolver_params<double>& params,
+    const Eigen::SparseMatrix<double>& A,
+    const Eigen::SparseMatrix<double>& B,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& eigvecs,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& eigvals)
+{
+    switch(params.fis) {
+        case feast_inner_solver::eigen_sparselu:
+            return priv::feast<priv::feast_sparselu_shifts>(params, A, B, eigvecs, eigvals);
+
+        case feast_inner_solver::mumps:
+            return priv::feast<priv::feast_mumps_shifts>(params, A, B, eigvecs, eigvals);
+    }
+
+    return feast_status::invalid_input;
+}
+
 template<int _Options, typename _Index>
 int
 generalized_eigenvalue_solver(feast_eigensolver_params<double>& params,
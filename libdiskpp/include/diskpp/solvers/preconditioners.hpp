@@ -0,0 +1,333 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/solvers/sparse_kernels.hpp"
+
+namespace disk { namespace solvers {
+
+/* Preconditioners for the conjugate gradient. All of them have the same
+ * interface:
+ *
+ *   bool compute(const Eigen::SparseMatrix<T>& A);
+ *   void apply(const dynamic_vector<T>& r, dynamic_vector<T>& z) const;
+ *
+ * compute() is called by the user once, before the solver, and apply()
+ * computes z = P^{-1} r at each iteration. Any class with this interface
+ * can be passed to conjugated_gradient(). A preconditioner that works in
+ * parallel can also provide
+ *
+ *   void apply(const dynamic_vector<T>& r, dynamic_vector<T>& z,
+ *              size_t num_threads) const;
+ *
+ * which the solver calls with its own number of threads. */
+
+/* P = I */
+template<typename T>
+class identity_preconditioner
+{
+public:
+    bool
+    compute(const Eigen::SparseMatrix<T>&)
+    {
+        return true;
+    }
+
+    void
+    apply(const dynamic_vector<T>& r, dynamic_vector<T>& z) const
+    {
+        z = r;
+    }
+};
+
+/* P = diag(A) */
+template<typename T>
+class jacobi_preconditioner
+{
+    dynamic_vector<T>   m_inv_diag;
+
+public:
+    jacobi_preconditioner()
+    {}
+
+    jacobi_preconditioner(const Eigen::SparseMatrix<T>& A)
+    {
+        compute(A);
+    }
+
+    bool
+    compute(const Eigen::SparseMatrix<T>& A)
+    {
+        m_inv_diag = A.diagonal();
+        for (Eigen::Index i = 0; i < m_inv_diag.size(); i++)
+        {
+            if (m_inv_diag(i) == T(0))
+                return false;
+            m_inv_diag(i) = T(1)/m_inv_diag(i);
+        }
+
+        return true;
+    }
+
+    void
+    apply(const dynamic_vector<T>& r, dynamic_vector<T>& z) const
+    {
+        z = m_inv_diag.cwiseProduct(r);
+    }
+};
+
+/* P = blockdiag(A). The blocks are contiguous ranges of unknowns, for
+ * example the face blocks of a statically condensed HHO system, which have
+ * scalar_basis_size(face_degree, DIM-1) unknowns each. The blocks are
+ * inverted in compute(). */
+template<typename T>
+class block_jacobi_preconditioner
+{
+    std::vector<size_t>             m_offsets;
+    size_t                          m_block_size;
+    std::vector<dynamic_matrix<T>>  m_inv_blocks;
+
+    void
+    make_offsets(size_t N)
+    {
+        m_offsets.clear();
+        for (size_t ofs = 0; ofs < N; ofs += m_block_size)
+            m_offsets.push_back(ofs);
+        m_offsets.push_back(N);
+    }
+
+public:
+    /* Blocks of uniform size, the last one can be smaller */
+    block_jacobi_preconditioner(size_t block_size)
+        : m_block_size(block_size)
+    {
+        assert(block_size > 0);
+    }
+
+    /* Block i is [offsets[i], offsets[i+1]) */
+    block_jacobi_preconditioner(const std::vector<size_t>& offsets)
+        : m_offsets(offsets), m_block_size(0)
+    {
+        assert(offsets.size() > 1);
+    }
+
+    bool
+    compute(const Eigen::SparseMatrix<T>& A)
+    {
+        if (m_block_size > 0)
+            make_offsets(A.rows());
+
+        if (m_offsets.front() != 0 or m_offsets.back() != size_t(A.rows()))
+            return false;
+
+        const size_t num_blocks = m_offsets.size() - 1;
+        m_inv_blocks.resize(num_blocks);
+
+        bool success = true;
+        for (size_t blk = 0; blk < num_blocks; blk++)
+        {
+            const size_t ofs = m_offsets[blk];
+            const size_t size = m_offsets[blk+1] - ofs;
+
+            dynamic_matrix<T> D = dynamic_matrix<T>::Zero(size, size);
+            for (size_t j = 0; j < size; j++)
+            {
+                for (typename Eigen::SparseMatrix<T>::InnerIterator it(A, ofs+j); it; ++it)
+                {
+                    if (size_t(it.row()) >= ofs and size_t(it.row()) < ofs+size)
+                        D(it.row()-ofs, j) = it.value();
+                }
+            }
+
+            Eigen::LLT<dynamic_matrix<T>> llt(D);
+            if (llt.info() == Eigen::Success)
+            {
+                m_inv_blocks[blk] = llt.solve(dynamic_matrix<T>::Identity(size, size));
+                continue;
+            }
+
+            Eigen::FullPivLU<dynamic_matrix<T>> lu(D);
+            if (not lu.isInvertible())
+                success = false;
+
+            m_inv_blocks[blk] = lu.inverse();
+        }
+
+        return success;
+    }
+
+    /* The blocks are split among num_threads threads (0: default_num_threads()) */
+    void
+    apply(const dynamic_vector<T>& r, dynamic_vector<T>& z, size_t num_threads = 0) const
+    {
+        assert(m_offsets.back() == size_t(r.size()));
+        z.resize(r.size());
+
+        auto apply_blocks = [&](size_t begin, size_t end, size_t) {
+            for (size_t blk = begin; blk < end; blk++)
+            {
+                const size_t ofs = m_offsets[blk];
+                const size_t size = m_offsets[blk+1] - ofs;
+                z.segment(ofs, size) = m_inv_blocks[blk] * r.segment(ofs, size);
+            }
+        };
+
+        /* The threshold of the kernels is in entries, not in blocks */
+        const size_t num_blocks = m_inv_blocks.size();
+        const size_t grain = parallel_kernels_threshold * num_blocks / std::max<size_t>(r.size(), 1);
+        priv::parallel_ranges(num_blocks, priv::kernel_threads(num_threads), apply_blocks, grain);
+    }
+};
+
+/* Incomplete Cholesky factorization with no fill-in: P = L*L^T, where L has
+ * the pattern of the lower triangular part of A. If the factorization
+ * breaks down because of a nonpositive pivot, it is restarted on
+ * A + alpha*diag(A), increasing alpha each time. */
+template<typename T>
+class ic0_preconditioner
+{
+    typedef Eigen::SparseMatrix<T>  sparse_matrix_type;
+
+    sparse_matrix_type  m_L;
+    T                   m_shift;
+
+    bool
+    factorize(const sparse_matrix_type& A, T alpha)
+    {
+        m_L = A.template triangularView<Eigen::Lower>();
+        m_L.makeCompressed();
+
+        const auto N = m_L.cols();
+        const auto *outer = m_L.outerIndexPtr();
+        const auto *inner = m_L.innerIndexPtr();
+        auto *vals = m_L.valuePtr();
+
+        /* The first entry of each column must be the diagonal */
+        for (decltype(m_L.cols()) k = 0; k < N; k++)
+        {
+            if (outer[k] == outer[k+1] or inner[outer[k]] != k)
+                return false;
+            vals[outer[k]] *= (T(1) + alpha);
+        }
+
+        /* pos[i]: position of the entry in row i of the current column */
+        std::vector<int> pos(N, -1);
+
+        for (decltype(m_L.cols()) k = 0; k < N; k++)
+        {
+            const auto k_begin = outer[k];
+            const auto k_end = outer[k+1];
+
+            if (not (vals[k_begin] > T(0)))
+                return false;
+
+            const T d = std::sqrt(vals[k_begin]);
+            vals[k_begin] = d;
+            for (auto p = k_begin+1; p < k_end; p++)
+                vals[p] /= d;
+
+            /* Update the columns j > k using the entries of column k,
+             * dropping the contributions outside the pattern. */
+            for (auto p = k_begin+1; p < k_end; p++)
+            {
+                const auto j = inner[p];
+                for (auto q = outer[j]; q < outer[j+1]; q++)
+                    pos[inner[q]] = q;
+
+                for (auto pp = p; pp < k_end; pp++)
+                {
+                    const auto q = pos[inner[pp]];
+                    if (q >= 0)
+                        vals[q] -= vals[pp] * vals[p];
+                }
+
+                for (auto q = outer[j]; q < outer[j+1]; q++)
+                    pos[inner[q]] = -1;
+            }
+        }
+
+        return true;
+    }
+
+public:
+    ic0_preconditioner()
+        : m_shift(0)
+    {}
+
+    ic0_preconditioner(const sparse_matrix_type& A)
+        : m_shift(0)
+    {
+        compute(A);
+    }
+
+    bool
+    compute(const sparse_matrix_type& A)
+    {
+        m_shift = 0;
+        if ( factorize(A, m_shift) )
+            return true;
+
+        for (m_shift = 1e-3; m_shift < 1e3; m_shift *= 10)
+            if ( factorize(A, m_shift) )
+                return true;
+
+        m_L.resize(0,0);
+        return false;
+    }
+
+    /* Relative diagonal shift used to complete the factorization */
+    T
+    shift(void) const
+    {
+        return m_shift;
+    }
+
+    void
+    apply(const dynamic_vector<T>& r, dynamic_vector<T>& z) const
+    {
+        z = m_L.template triangularView<Eigen::Lower>().solve(r);
+        m_L.transpose().template triangularView<Eigen::Upper>().solveInPlace(z);
+    }
+};
+
+/* User-supplied preconditioner, for example an algebraic multigrid cycle.
+ * fun(r, z) must compute z = P^{-1} r. */
+template<typename T>
+class function_preconditioner
+{
+    std::function<void(const dynamic_vector<T>&, dynamic_vector<T>&)>   m_fun;
+
+public:
+    template<typename Function>
+    function_preconditioner(const Function& fun)
+        : m_fun(fun)
+    {}
+
+    bool
+    compute(const Eigen::SparseMatrix<T>&)
+    {
+        return true;
+    }
+
+    void
+    apply(const dynamic_vector<T>& r, dynamic_vector<T>& z) const
+    {
+        m_fun(r, z);
+    }
+};
+
+} // namespace solvers
+} // namespace disk
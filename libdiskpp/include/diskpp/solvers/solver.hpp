@@ -22,13 +22,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "sol/sol.hpp"
 #include "diskpp/common/eigen.hpp"
+#include "diskpp/solvers/sparse_kernels.hpp"
+#include "diskpp/solvers/preconditioners.hpp"
+#include "diskpp/solvers/amg.hpp"
 
 #ifdef HAVE_AGMG
     #include "agmg.hpp"
 #endif
 
+#ifdef HAVE_MUMPS
+    #include "mumps.hpp"
+#endif
+
 #ifdef HAVE_INTEL_MKL
     //#include "feast.hpp"
 #endif
@@ -40,6 +57,7 @@ init_lua(sol::state& lua)
 {
     lua["solver"] = lua.create_table();
     lua["solver"]["cg"] = lua.create_table();
+    lua["solver"]["amg"] = lua.create_table();
 
 #ifdef HAVE_INTEL_MKL
     lua["solver"]["pardiso"] = lua.create_table();
@@ -47,12 +65,49 @@ init_lua(sol::state& lua)
 
 }
 
+enum class conjugated_gradient_status {
+    converged,
+    max_iter_reached,
+    diverged,
+    breakdown,
+    invalid_input
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, const conjugated_gradient_status& cgs)
+{
+    switch (cgs) {
+        case conjugated_gradient_status::converged:
+            os << "converged";
+            break;
+
+        case conjugated_gradient_status::max_iter_reached:
+            os << "max_iter_reached";
+            break;
+
+        case conjugated_gradient_status::diverged:
+            os << "diverged";
+            break;
+
+        case conjugated_gradient_status::breakdown:
+            os << "breakdown";
+            break;
+
+        case conjugated_gradient_status::invalid_input:
+            os << "invalid_input";
+            break;
+    }
+
+    return os;
+}
+
 template<typename T>
 struct conjugated_gradient_params
 {
     T               rr_tol;
     T               rr_max;
     size_t          max_iter;
+    size_t          num_threads; /* 0: default_num_threads() */
     bool            verbose;
     bool            save_iteration_history;
     bool            use_initial_guess;
@@ -61,55 +116,114 @@ struct conjugated_gradient_params
     conjugated_gradient_params() : rr_tol(1e-8),
                                    rr_max(20),
                                    max_iter(100),
+                                   num_threads(0),
                                    verbose(false),
                                    save_iteration_history(false),
                                    use_initial_guess(false) {}
 };
 
-// TODO: return false and some kind of error in case of non convergence.
 template<typename T>
-bool
+struct conjugated_gradient_result
+{
+    conjugated_gradient_status  status;
+    size_t                      iterations;
+    T                           relative_residual;
+
+    conjugated_gradient_result()
+        : status(conjugated_gradient_status::invalid_input),
+          iterations(0), relative_residual(0)
+    {}
+
+    bool converged(void) const
+    {
+        return status == conjugated_gradient_status::converged;
+    }
+};
+
+/* Preconditioned conjugate gradient. The preconditioner must be already
+ * computed, see preconditioners.hpp for the interface. The products and
+ * the vector updates are multithreaded on large systems; the matrix is
+ * copied in compressed row format for that. The iteration stops when
+ * the residual, relative to the initial one, is below rr_tol (converged)
+ * or after max_iter iterations (2N if zero). The divergence test uses the
+ * residual in the norm induced by the preconditioner, sqrt(r^T P^{-1} r),
+ * whose relative value must stay below rr_max: the euclidean norm of the
+ * residual of a preconditioned CG is not monotone and can grow a lot in
+ * the first iterations.
+ * A nonpositive d^T A d means that A or the preconditioner are not SPD
+ * (breakdown). */
+template<typename T, typename Preconditioner>
+conjugated_gradient_result<T>
 conjugated_gradient(const conjugated_gradient_params<T>& cgp,
                     const Eigen::SparseMatrix<T>& A,
                     const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
-                    Eigen::Matrix<T, Eigen::Dynamic, 1>& x)
+                    Eigen::Matrix<T, Eigen::Dynamic, 1>& x,
+                    const Preconditioner& pc)
 {
+    using vector_type = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+    conjugated_gradient_result<T> ret;
+
     if ( A.rows() != A.cols() )
     {
         if (cgp.verbose)
             std::cout << "[CG solver] A square matrix is required" << std::endl;
 
-        return false;
+        return ret;
     }
 
     size_t N = A.cols();
 
-    if (b.size() != N)
+    if (size_t(b.size()) != N)
     {
         if (cgp.verbose)
             std::cout << "[CG solver] Wrong size of RHS vector" << std::endl;
 
-        return false;
+        return ret;
     }
 
-    if (x.size() != N)
+    if (cgp.use_initial_guess and size_t(x.size()) != N)
     {
         if (cgp.verbose)
             std::cout << "[CG solver] Wrong size of solution vector" << std::endl;
 
-        return false;
+        return ret;
     }
 
     if (!cgp.use_initial_guess)
-        x = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(N);
+        x = vector_type::Zero(N);
+
+    const size_t nt = priv::kernel_threads(cgp.num_threads);
+
+    std::optional<parallel_sparse_matrix<T>> pA;
+    if (nt > 1 and size_t(A.nonZeros()) >= parallel_kernels_threshold)
+        pA.emplace(A, nt);
+
+    auto spmv = [&](const vector_type& v, vector_type& Av) {
+        if (pA)
+            pA->multiply(v, Av);
+        else
+            Av = A*v;
+    };
+
+    auto precondition = [&](const vector_type& v, vector_type& Pv) {
+        if constexpr ( requires { pc.apply(v, Pv, nt); } )
+            pc.apply(v, Pv, nt);
+        else
+            pc.apply(v, Pv);
+    };
 
     size_t                      iter = 0;
-    T                           nr, nr0;
-    T                           alpha, beta, rho;
+    T                           nr, nr0, rho0;
+    T                           alpha, beta, rho, rho_prev, dy;
 
-    Eigen::Matrix<T, Eigen::Dynamic, 1> d(N), r(N), r0(N), y(N);
+    vector_type d(N), r(N), z(N), y(N);
 
-    r0 = d = r = b - A*x;
+    spmv(x, y);
+    r = b - y;
+    precondition(r, z);
+    d = z;
+    rho = rho0 = parallel_dot(r, z, nt);
     nr = nr0 = r.norm();
 
     std::ofstream iter_hist_ofs;
@@ -118,8 +232,22 @@ conjugated_gradient(const conjugated_gradient_params<T>& cgp,
 
     auto max_iter = cgp.max_iter == 0 ? 2*N : cgp.max_iter;
 
-    while ( nr/nr0 > cgp.rr_tol && iter < max_iter && nr/nr0 < cgp.rr_max )
+    /* Zero initial residual: x is already the solution */
+    if (nr0 == T(0))
+    {
+        nr0 = 1.0;
+        rho0 = 1.0;
+    }
+
+    ret.status = conjugated_gradient_status::max_iter_reached;
+    while ( nr/nr0 > cgp.rr_tol && iter < max_iter )
     {
+        if ( !(std::sqrt(std::abs(rho/rho0)) < cgp.rr_max) )
+        {
+            ret.status = conjugated_gradient_status::diverged;
+            break;
+        }
+
         if (cgp.verbose)
         {
             std::cout << "                                                 \r";
@@ -131,18 +259,33 @@ conjugated_gradient(const conjugated_gradient_params<T>& cgp,
         if (cgp.save_iteration_history)
             iter_hist_ofs << nr/nr0 << std::endl;
 
-        y = A*d;
-        rho = r.dot(r);
-        alpha = rho/d.dot(y);
-        x = x + alpha * d;
-        r = r - alpha * y;
-        beta = r.dot(r)/rho;
-        d = r + beta * d;
+        spmv(d, y);
+        dy = parallel_dot(d, y, nt);
+        if ( !(dy > T(0)) )
+        {
+            ret.status = conjugated_gradient_status::breakdown;
+            break;
+        }
 
-        nr = r.norm();
+        alpha = rho/dy;
+        parallel_axpy(alpha, d, x, nt);
+        parallel_axpy(-alpha, y, r, nt);
+        nr = std::sqrt( parallel_dot(r, r, nt) );
         iter++;
+
+        precondition(r, z);
+        rho_prev = rho;
+        rho = parallel_dot(r, z, nt);
+        beta = rho/rho_prev;
+        parallel_xpby(z, beta, d, nt);
     }
 
+    if (nr/nr0 <= cgp.rr_tol)
+        ret.status = conjugated_gradient_status::converged;
+
+    ret.iterations = iter;
+    ret.relative_residual = nr/nr0;
+
     if (cgp.save_iteration_history)
     {
         iter_hist_ofs << nr/nr0 << std::endl;
@@ -150,9 +293,56 @@ conjugated_gradient(const conjugated_gradient_params<T>& cgp,
     }
 
     if (cgp.verbose)
-        std::cout << " -> Iteration " << iter << ", rr = " << nr/nr0 << std::endl;
+    {
+        std::cout << " -> Iteration " << iter << ", rr = " << nr/nr0;
+        std::cout << ", " << ret.status << std::endl;
+    }
 
-    return true;
+    return ret;
+}
+
+/* Unpreconditioned conjugate gradient, returns true if it converged */
+template<typename T>
+bool
+conjugated_gradient(const conjugated_gradient_params<T>& cgp,
+                    const Eigen::SparseMatrix<T>& A,
+                    const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+                    Eigen::Matrix<T, Eigen::Dynamic, 1>& x)
+{
+    identity_preconditioner<T> pc;
+    return conjugated_gradient(cgp, A, b, x, pc).converged();
+}
+
+template<typename T>
+amg_params<T>
+amg_params_from_lua(sol::state& lua)
+{
+    amg_params<T> ap;
+
+    ap.block_size           = lua["solver"]["amg"]["block_size"].get_or(1);
+    ap.strength_threshold   = lua["solver"]["amg"]["strength_threshold"].get_or(0.08);
+    ap.coarse_size          = lua["solver"]["amg"]["coarse_size"].get_or(1000);
+    ap.smoother_degree      = lua["solver"]["amg"]["smoother_degree"].get_or(3);
+    ap.num_threads          = lua["solver"]["amg"]["num_threads"].get_or(0);
+    ap.rr_tol               = lua["solver"]["amg"]["rr_tol"].get_or(1e-8);
+    ap.max_iter             = lua["solver"]["amg"]["max_iter"].get_or(100);
+    ap.verbose              = lua["solver"]["amg"]["verbose"].get_or(false);
+
+    return ap;
+}
+
+template<typename T>
+bool
+amg_multigrid_solver(sol::state& lua,
+                     const Eigen::SparseMatrix<T>& A,
+                     const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+                     Eigen::Matrix<T, Eigen::Dynamic, 1>& x)
+{
+    amg_solver<T> amg( amg_params_from_lua<T>(lua) );
+    if ( !amg.compute(A) )
+        return false;
+
+    return amg.solve(A, b, x);
 }
 
 template<typename T>
@@ -165,9 +355,10 @@ conjugated_gradient(sol::state& lua,
     conjugated_gradient_params<T> cgp;
 
     cgp.max_iter    = lua["solver"]["cg"]["max_iter"].get_or(1000);
-    cgp.rr_tol      = lua["sover"]["cg"]["rr_tol"].get_or(1e-8);
+    cgp.rr_tol      = lua["solver"]["cg"]["rr_tol"].get_or(1e-8);
     cgp.rr_max      = lua["solver"]["cg"]["rr_max"].get_or(20.0);
     cgp.verbose     = lua["solver"]["cg"]["verbose"].get_or(false);
+    cgp.num_threads = lua["solver"]["cg"]["num_threads"].get_or(0);
 
     auto iter_hist_filename = lua["solver"]["cg"]["hist_file"];
     if (iter_hist_filename.valid())
@@ -176,7 +367,46 @@ conjugated_gradient(sol::state& lua,
         cgp.history_filename = iter_hist_filename;
     }
 
-    return conjugated_gradient(cgp, A, b, x);
+    /* Preconditioner: none, jacobi, block_jacobi, ic0 or amg */
+    std::string pc_type = lua["solver"]["cg"]["preconditioner"].get_or(std::string("none"));
+
+    auto solve = [&](auto& pc) {
+        if ( !pc.compute(A) )
+        {
+            std::cout << "[CG solver] Preconditioner setup failed" << std::endl;
+            return false;
+        }
+
+        return conjugated_gradient(cgp, A, b, x, pc).converged();
+    };
+
+    if (pc_type == "jacobi")
+    {
+        jacobi_preconditioner<T> pc;
+        return solve(pc);
+    }
+
+    if (pc_type == "block_jacobi")
+    {
+        size_t block_size = lua["solver"]["cg"]["block_size"].get_or(1);
+        block_jacobi_preconditioner<T> pc(block_size);
+        return solve(pc);
+    }
+
+    if (pc_type == "ic0")
+    {
+        ic0_preconditioner<T> pc;
+        return solve(pc);
+    }
+
+    if (pc_type == "amg")
+    {
+        amg_solver<T> pc( amg_params_from_lua<T>(lua) );
+        return solve(pc);
+    }
+
+    identity_preconditioner<T> pc;
+    return solve(pc);
 }
 
 #ifdef HAVE_INTEL_MKL
@@ -294,6 +524,344 @@ mkl_pardiso(sol::state& lua,
 
 #endif /* HAVE_INTEL_MKL */
 
+/* Direct solvers that keep the factorization */
+enum class factorization_type {
+    sparse_lu,      /* Eigen::SparseLU */
+    sparse_ldlt,    /* Eigen::SimplicialLDLT, symmetric matrices only */
+    pardiso_lu,     /* needs HAVE_INTEL_MKL */
+    pardiso_ldlt,   /* needs HAVE_INTEL_MKL */
+    mumps           /* needs HAVE_MUMPS */
+};
+
+namespace priv {
+
+template<typename T>
+class factorization_backend
+{
+public:
+    virtual ~factorization_backend() {}
+    virtual bool analyze(const Eigen::SparseMatrix<T>&) = 0;
+    virtual bool factorize(const Eigen::SparseMatrix<T>&) = 0;
+    virtual bool solve(const dynamic_matrix<T>&, dynamic_matrix<T>&) = 0;
+};
+
+/* Any Eigen sparse solver with analyzePattern() and factorize() */
+template<typename T, typename Solver>
+class eigen_factorization_backend : public factorization_backend<T>
+{
+    Solver  m_solver;
+
+public:
+    bool
+    analyze(const Eigen::SparseMatrix<T>& A)
+    {
+        /* SparseLU has no info() before factorize(), errors show up there */
+        m_solver.analyzePattern(A);
+        return true;
+    }
+
+    bool
+    factorize(const Eigen::SparseMatrix<T>& A)
+    {
+        m_solver.factorize(A);
+        return m_solver.info() == Eigen::Success;
+    }
+
+    bool
+    solve(const dynamic_matrix<T>& B, dynamic_matrix<T>& X)
+    {
+        X = m_solver.solve(B);
+        return m_solver.info() == Eigen::Success;
+    }
+};
+
+#ifdef HAVE_MUMPS
+template<typename T>
+class mumps_factorization_backend : public factorization_backend<T>
+{
+    typename mumps_priv::mumps_types<T>::MUMPS_STRUC_C  m_id;
+    std::vector<int>                                    m_irn, m_jcn;
+    std::vector<T>                                      m_vals;
+
+public:
+    mumps_factorization_backend()
+    {
+        m_id.job = -1;
+        m_id.par = 1;
+        m_id.sym = 0;
+        m_id.comm_fortran = -987654; /* MPI_COMM_WORLD, see mumps.hpp */
+        mumps_priv::call_mumps(&m_id);
+
+        m_id.icntl[0] = -1;
+        m_id.icntl[1] = -1;
+        m_id.icntl[2] = -1;
+        m_id.icntl[3] = 0;
+    }
+
+    mumps_factorization_backend(const mumps_factorization_backend&) = delete;
+    mumps_factorization_backend& operator=(const mumps_factorization_backend&) = delete;
+
+    ~mumps_factorization_backend()
+    {
+        m_id.job = -2;
+        mumps_priv::call_mumps(&m_id);
+    }
+
+    bool
+    analyze(const Eigen::SparseMatrix<T>& A)
+    {
+        m_irn.resize(A.nonZeros());
+        m_jcn.resize(A.nonZeros());
+        for (int j = 0; j < A.outerSize(); j++)
+        {
+            for (int k = A.outerIndexPtr()[j]; k < A.outerIndexPtr()[j+1]; k++)
+            {
+                m_irn[k] = A.innerIndexPtr()[k] + 1;
+                m_jcn[k] = j + 1;
+            }
+        }
+
+        m_id.n = A.rows();
+        m_id.nz = A.nonZeros();
+        m_id.irn = m_irn.data();
+        m_id.jcn = m_jcn.data();
+        m_id.job = 1;
+        mumps_priv::call_mumps(&m_id);
+        return m_id.info[0] >= 0;
+    }
+
+    bool
+    factorize(const Eigen::SparseMatrix<T>& A)
+    {
+        m_vals.assign(A.valuePtr(), A.valuePtr() + A.nonZeros());
+        m_id.a = mumps_priv::mumps_cast_from<T>(m_vals.data());
+        m_id.job = 2;
+        mumps_priv::call_mumps(&m_id);
+        return m_id.info[0] >= 0;
+    }
+
+    bool
+    solve(const dynamic_matrix<T>& B, dynamic_matrix<T>& X)
+    {
+        X = B;
+        m_id.rhs = mumps_priv::mumps_cast_from<T>(X.data());
+        m_id.nrhs = X.cols();
+        m_id.lrhs = X.rows();
+        m_id.job = 3;
+        mumps_priv::call_mumps(&m_id);
+        return m_id.info[0] >= 0;
+    }
+};
+#endif /* HAVE_MUMPS */
+
+} // namespace priv
+
+/* Direct solver that caches the symbolic and the numeric factorizations.
+ * factorize() compares the matrix with the one factorized last time: if
+ * it is the same nothing is done, if only the values changed the symbolic
+ * analysis is reused, otherwise everything is recomputed. This is meant
+ * for time stepping and nonlinear loops, where the same matrix is solved
+ * many times and each step should cost only the triangular solves:
+ *
+ *   factorized_solver<T> solver;
+ *   for (each step) {
+ *       solver.factorize(LHS);  // free if LHS did not change
+ *       x = solver.solve(rhs);
+ *   }
+ *
+ * The comparison costs a pass over the nonzeros of the matrix and the
+ * solver keeps a copy of them. solve() accepts multiple right hand sides
+ * as the columns of a matrix. */
+template<typename T>
+class factorized_solver
+{
+    typedef Eigen::SparseMatrix<T>      sparse_matrix_type;
+
+    factorization_type                                  m_type;
+    std::unique_ptr<priv::factorization_backend<T>>     m_backend;
+    sparse_matrix_type                                  m_A;
+    bool                                                m_factorized;
+    size_t                                              m_num_analyses;
+    size_t                                              m_num_factorizations;
+
+    std::unique_ptr<priv::factorization_backend<T>>
+    make_backend(void) const
+    {
+        using namespace priv;
+
+        switch (m_type)
+        {
+            case factorization_type::sparse_lu:
+                return std::make_unique<eigen_factorization_backend<T,
+                    Eigen::SparseLU<sparse_matrix_type>>>();
+
+            case factorization_type::sparse_ldlt:
+                return std::make_unique<eigen_factorization_backend<T,
+                    Eigen::SimplicialLDLT<sparse_matrix_type>>>();
+
+#ifdef HAVE_INTEL_MKL
+            case factorization_type::pardiso_lu:
+                return std::make_unique<eigen_factorization_backend<T,
+                    Eigen::PardisoLU<sparse_matrix_type>>>();
+
+            case factorization_type::pardiso_ldlt:
+                return std::make_unique<eigen_factorization_backend<T,
+                    Eigen::PardisoLDLT<sparse_matrix_type>>>();
+#endif /* HAVE_INTEL_MKL */
+
+#ifdef HAVE_MUMPS
+            case factorization_type::mumps:
+                return std::make_unique<mumps_factorization_backend<T>>();
+#endif /* HAVE_MUMPS */
+
+            default:
+                return nullptr;
+        }
+    }
+
+    bool
+    same_pattern(const sparse_matrix_type& A) const
+    {
+        if (A.rows() != m_A.rows() or A.cols() != m_A.cols() or A.nonZeros() != m_A.nonZeros())
+            return false;
+
+        return std::equal(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1, m_A.outerIndexPtr()) and
+               std::equal(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros(), m_A.innerIndexPtr());
+    }
+
+    bool
+    same_values(const sparse_matrix_type& A) const
+    {
+        return std::equal(A.valuePtr(), A.valuePtr() + A.nonZeros(), m_A.valuePtr());
+    }
+
+public:
+    /* The default is the best backend available: Pardiso, MUMPS, SparseLU */
+    factorized_solver()
+#if defined(HAVE_INTEL_MKL)
+        : factorized_solver(factorization_type::pardiso_lu)
+#elif defined(HAVE_MUMPS)
+        : factorized_solver(factorization_type::mumps)
+#else
+        : factorized_solver(factorization_type::sparse_lu)
+#endif
+    {}
+
+    factorized_solver(factorization_type type)
+        : m_type(type), m_factorized(false), m_num_analyses(0), m_num_factorizations(0)
+    {}
+
+    factorized_solver(const factorized_solver&) = delete;
+    factorized_solver& operator=(const factorized_solver&) = delete;
+
+    /* True if the backend is compiled in */
+    static bool
+    available(factorization_type type)
+    {
+        switch (type)
+        {
+            case factorization_type::sparse_lu:
+            case factorization_type::sparse_ldlt:
+                return true;
+#ifdef HAVE_INTEL_MKL
+            case factorization_type::pardiso_lu:
+            case factorization_type::pardiso_ldlt:
+                return true;
+#endif /* HAVE_INTEL_MKL */
+#ifdef HAVE_MUMPS
+            case factorization_type::mumps:
+                return true;
+#endif /* HAVE_MUMPS */
+            default:
+                return false;
+        }
+    }
+
+    factorization_type type(void) const { return m_type; }
+
+    /* Factorize A, reusing as much as possible of the previous factorization */
+    bool
+    factorize(const sparse_matrix_type& A_in)
+    {
+        sparse_matrix_type A_tmp;
+        const sparse_matrix_type *A = &A_in;
+        if (not A_in.isCompressed())
+        {
+            A_tmp = A_in;
+            A_tmp.makeCompressed();
+            A = &A_tmp;
+        }
+
+        if (m_factorized and same_pattern(*A) and same_values(*A))
+            return true;
+
+        bool analyze = not (m_backend and same_pattern(*A));
+        m_factorized = false;
+
+        if (analyze)
+        {
+            m_backend = make_backend();
+            if (not m_backend)
+            {
+                std::cout << "[factorized_solver] Backend not available in this build" << std::endl;
+                return false;
+            }
+
+            if (not m_backend->analyze(*A))
+            {
+                std::cout << "[factorized_solver] Symbolic analysis failed" << std::endl;
+                m_backend.reset();
+                return false;
+            }
+            m_num_analyses++;
+        }
+
+        m_A = *A;
+
+        if (not m_backend->factorize(m_A))
+        {
+            std::cout << "[factorized_solver] Numeric factorization failed" << std::endl;
+            return false;
+        }
+        m_num_factorizations++;
+        m_factorized = true;
+
+        return true;
+    }
+
+    /* Solve for all the columns of B with the current factorization */
+    template<typename Derived>
+    dynamic_matrix<T>
+    solve(const Eigen::MatrixBase<Derived>& B)
+    {
+        if (not m_factorized)
+            throw std::logic_error("factorized_solver: solve() without a factorization");
+
+        dynamic_matrix<T> X;
+        if (not m_backend->solve(B, X))
+            throw std::runtime_error("factorized_solver: solve failed");
+
+        return X;
+    }
+
+    /* Same interface of the other solvers of this file */
+    bool
+    solve(const sparse_matrix_type& A,
+          const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+          Eigen::Matrix<T, Eigen::Dynamic, 1>& x)
+    {
+        if (not factorize(A))
+            return false;
+
+        x = solve(b);
+        return true;
+    }
+
+    bool factorized(void) const { return m_factorized; }
+    size_t num_analyses(void) const { return m_num_analyses; }
+    size_t num_factorizations(void) const { return m_num_factorizations; }
+};
+
 template<typename T>
 bool
 linear_solver(sol::state& lua,
@@ -311,6 +879,9 @@ linear_solver(sol::state& lua,
         return mkl_pardiso(lua, A, b, x);
 #endif /* HAVE_INTEL_MKL */
 
+    else if ( solver_type == "amg" )
+        return amg_multigrid_solver(lua, A, b, x);
+
 #ifdef HAVE_AGMG
     else if ( solver_type == "agmg" )
         return agmg_multigrid_solver(lua, A, b, x);
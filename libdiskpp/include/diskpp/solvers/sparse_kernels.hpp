@@ -0,0 +1,171 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "diskpp/common/eigen.hpp"
+#include "diskpp/common/parallel.hpp"
+
+namespace disk { namespace solvers {
+
+/* Multithreaded kernels for the iterative solvers. They run on the
+ * threads of kernels_thread_pool(), started once, because a CG or an AMG
+ * cycle calls them several times per iteration. Each thread gets at least
+ * this number of entries, otherwise the synchronization would cost more
+ * than the work itself. */
+static const size_t parallel_kernels_threshold = 20000;
+
+inline thread_pool&
+kernels_thread_pool(void)
+{
+    static thread_pool pool;
+    return pool;
+}
+
+namespace priv {
+
+/* Split [0, n) in num_chunks contiguous ranges and call fun(begin, end, chunk)
+ * on each of them, concurrently. The ranges have at least grain entries. */
+template<typename Function>
+void
+parallel_ranges(size_t n, size_t num_chunks, const Function& fun,
+                size_t grain = parallel_kernels_threshold)
+{
+    num_chunks = std::min(num_chunks, n / std::max<size_t>(grain, 1));
+    if (num_chunks < 2)
+    {
+        fun(size_t(0), n, size_t(0));
+        return;
+    }
+
+    auto run = [&](size_t chunk) {
+        fun((n * chunk) / num_chunks, (n * (chunk+1)) / num_chunks, chunk);
+    };
+    kernels_thread_pool().run(num_chunks, run);
+}
+
+inline size_t
+kernel_threads(size_t num_threads)
+{
+    return (num_threads == 0) ? default_num_threads() : num_threads;
+}
+
+} // namespace priv
+
+/* Compressed row copy of a sparse matrix for the multithreaded product with
+ * a vector. The rows are split among the threads so that each thread gets
+ * approximately the same number of nonzeros. */
+template<typename T>
+class parallel_sparse_matrix
+{
+    typedef Eigen::SparseMatrix<T, Eigen::RowMajor>     matrix_type;
+
+    matrix_type             m_A;
+    std::vector<size_t>     m_row_splits;
+
+public:
+    parallel_sparse_matrix(const Eigen::SparseMatrix<T>& A, size_t num_threads = 0)
+        : m_A(A)
+    {
+        m_A.makeCompressed();
+
+        size_t nt = priv::kernel_threads(num_threads);
+        nt = std::max<size_t>(1, std::min<size_t>(nt, m_A.nonZeros() / parallel_kernels_threshold));
+
+        m_row_splits.push_back(0);
+        const auto *outer = m_A.outerIndexPtr();
+        for (size_t t = 1; t < nt; t++)
+        {
+            size_t target = (m_A.nonZeros() * t) / nt;
+            auto it = std::lower_bound(outer + m_row_splits.back(), outer + m_A.rows(), target);
+            m_row_splits.push_back(std::distance(outer, it));
+        }
+        m_row_splits.push_back(m_A.rows());
+    }
+
+    size_t rows(void) const { return m_A.rows(); }
+    size_t cols(void) const { return m_A.cols(); }
+    size_t num_threads(void) const { return m_row_splits.size() - 1; }
+
+    /* y = A*x */
+    void
+    multiply(const dynamic_vector<T>& x, dynamic_vector<T>& y) const
+    {
+        assert(size_t(x.size()) == cols());
+        y.resize(rows());
+
+        const auto *outer = m_A.outerIndexPtr();
+        const auto *inner = m_A.innerIndexPtr();
+        const auto *vals = m_A.valuePtr();
+
+        auto rows_product = [&](size_t t) {
+            for (size_t i = m_row_splits[t]; i < m_row_splits[t+1]; i++)
+            {
+                T acc = 0.0;
+                for (auto k = outer[i]; k < outer[i+1]; k++)
+                    acc += vals[k] * x(inner[k]);
+                y(i) = acc;
+            }
+        };
+        kernels_thread_pool().run(num_threads(), rows_product);
+    }
+};
+
+/* Dot product. The partial sums are added in a fixed order, therefore the
+ * result depends on the number of threads but not on the scheduling. */
+template<typename T>
+T
+parallel_dot(const dynamic_vector<T>& x, const dynamic_vector<T>& y, size_t num_threads = 0)
+{
+    assert(x.size() == y.size());
+    const size_t nt = priv::kernel_threads(num_threads);
+
+    std::vector<T> partial(nt, T(0));
+    auto dot = [&](size_t begin, size_t end, size_t chunk) {
+        partial[chunk] = x.segment(begin, end-begin).dot( y.segment(begin, end-begin) );
+    };
+    priv::parallel_ranges(x.size(), nt, dot);
+
+    T ret = 0.0;
+    for (auto& p : partial)
+        ret += p;
+    return ret;
+}
+
+/* y = y + a*x */
+template<typename T>
+void
+parallel_axpy(const T& a, const dynamic_vector<T>& x, dynamic_vector<T>& y, size_t num_threads = 0)
+{
+    assert(x.size() == y.size());
+    auto axpy = [&](size_t begin, size_t end, size_t) {
+        y.segment(begin, end-begin) += a * x.segment(begin, end-begin);
+    };
+    priv::parallel_ranges(x.size(), priv::kernel_threads(num_threads), axpy);
+}
+
+/* y = x + b*y */
+template<typename T>
+void
+parallel_xpby(const dynamic_vector<T>& x, const T& b, dynamic_vector<T>& y, size_t num_threads = 0)
+{
+    assert(x.size() == y.size());
+    auto xpby = [&](size_t begin, size_t end, size_t) {
+        y.segment(begin, end-begin) = x.segment(begin, end-begin) + b * y.segment(begin, end-begin);
+    };
+    priv::parallel_ranges(x.size(), priv::kernel_threads(num_threads), xpby);
+}
+
+} // namespace solvers
+} // namespace disk
@@ -134,8 +134,12 @@ mapped_file::map(const std::string& name)
 bool
 mapped_file::unmap(void)
 {
+    if (!m_is_open)
+        return false;
+
     munmap((void *)m_addr, m_length);
     ::close(m_fd);
+    m_is_open = false;
     return true;
 }
 
@@ -169,3 +173,10 @@ mapped_file::mem()
 {
     return m_start;
 }
+
+/* Size of the mapped file, in bytes */
+size_t
+mapped_file::size() const
+{
+    return m_is_open ? m_length : 0;
+}
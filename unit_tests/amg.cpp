@@ -0,0 +1,174 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Solve condensed HHO diffusion systems with the smoothed aggregation AMG,
+ * standalone and as preconditioner of the conjugate gradient. Check the
+ * solution against a direct solver and check that the number of iterations
+ * stays bounded when the mesh is refined. A matrix that cannot be
+ * coarsened must stop the hierarchy, also with blocks of unknowns. */
+
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho"
+#include "diskpp/solvers/solver.hpp"
+
+using namespace disk;
+using namespace disk::solvers;
+
+template<typename Mesh>
+auto
+make_system(const Mesh& msh, const hho_degree_info& hdi)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+
+    auto f = [](const point_type& pt) { return std::sin(M_PI * pt.x()) * std::sin(M_PI * pt.y()); };
+
+    scalar_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere([](const point_type&) { return 0.0; });
+
+    auto assm = make_scalar_primal_hho_assembler(msh, hdi, bnd);
+    for (auto& cl : msh)
+    {
+        auto cb = make_scalar_monomial_basis(msh, cl, hdi.cell_degree());
+        auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+        auto stab = make_scalar_hho_stabilization(msh, cl, gr.first, hdi);
+        dynamic_matrix<T> A = gr.second + stab;
+        dynamic_vector<T> rhs = make_rhs(msh, cl, cb, f);
+        auto [lhs, lrhs] = make_scalar_static_condensation(msh, cl, hdi, A, rhs);
+        assm.assemble(msh, cl, bnd, lhs, lrhs);
+    }
+    assm.finalize();
+
+    return std::make_pair(assm.LHS, assm.RHS);
+}
+
+/* Returns the number of PCG iterations, 0 on failure */
+template<typename Mesh>
+size_t
+test_amg(const Mesh& msh, size_t degree)
+{
+    using T = typename Mesh::coordinate_type;
+
+    hho_degree_info hdi(degree, degree);
+    auto [A, b] = make_system(msh, hdi);
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<T>> ldlt(A);
+    dynamic_vector<T> ref = ldlt.solve(b);
+
+    amg_params<T> ap;
+    ap.block_size = scalar_basis_size(hdi.face_degree(), Mesh::dimension-1);
+    ap.coarse_size = 200;
+    ap.rr_tol = 1e-10;
+    ap.max_iter = 500;
+
+    amg_solver<T> amg(ap);
+    if ( not amg.compute(A) or amg.num_levels() < 2 )
+        return 0;
+
+    /* Standalone */
+    dynamic_vector<T> x;
+    if ( not amg.solve(A, b, x) or (x - ref).norm() > 1e-7 * ref.norm() )
+        return 0;
+
+    /* Preconditioner */
+    conjugated_gradient_params<T> cgp;
+    cgp.rr_tol = 1e-10;
+    cgp.max_iter = 500;
+    auto res = conjugated_gradient(cgp, A, b, x, amg);
+    if ( not res.converged() or (x - ref).norm() > 1e-7 * ref.norm() )
+        return 0;
+
+    return res.iterations;
+}
+
+template<typename Mesh>
+Mesh
+make_mesh(size_t refinements)
+{
+    Mesh msh;
+    auto mesher = disk::make_simple_mesher(msh);
+    for (size_t i = 0; i < refinements; i++)
+        mesher.refine();
+    return msh;
+}
+
+template<typename Mesh>
+bool
+test_mesh(size_t refinements, const char *name)
+{
+    auto msh_coarse = make_mesh<Mesh>(refinements);
+    auto msh_fine = make_mesh<Mesh>(refinements+1);
+
+    bool success = true;
+    for (size_t degree = 0; degree < 3; degree++)
+    {
+        size_t it_coarse = test_amg(msh_coarse, degree);
+        size_t it_fine = test_amg(msh_fine, degree);
+
+        /* Iterations must not grow like the condition number */
+        bool ok = it_coarse > 0 and it_fine > 0 and it_fine <= 2*it_coarse;
+        if (not ok)
+        {
+            std::cout << "  degree " << degree << ": " << it_coarse << " and ";
+            std::cout << it_fine << " iterations" << std::endl;
+        }
+        success = success and ok;
+    }
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+/* Uncoupled 2x2 blocks: each node is its own aggregate */
+bool
+test_stagnation(void)
+{
+    using T = double;
+
+    const size_t num_nodes = 1000;
+    std::vector<Eigen::Triplet<T>> triplets;
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        triplets.push_back( Eigen::Triplet<T>(2*i, 2*i, 2.0) );
+        triplets.push_back( Eigen::Triplet<T>(2*i, 2*i+1, -1.0) );
+        triplets.push_back( Eigen::Triplet<T>(2*i+1, 2*i, -1.0) );
+        triplets.push_back( Eigen::Triplet<T>(2*i+1, 2*i+1, 2.0) );
+    }
+    Eigen::SparseMatrix<T> A(2*num_nodes, 2*num_nodes);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    amg_params<T> ap;
+    ap.block_size = 2;
+    ap.coarse_size = 10;
+
+    amg_solver<T> amg(ap);
+    bool success = amg.compute(A) and amg.num_levels() == 1;
+
+    dynamic_vector<T> b = dynamic_vector<T>::Ones(2*num_nodes);
+    dynamic_vector<T> x;
+    success = success and amg.solve(A, b, x) and (A*x - b).norm() < 1e-10 * b.norm();
+
+    std::cout << "stagnation: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+    success = test_mesh<disk::simplicial_mesh<T, 2>>(4, "triangles") and success;
+    success = test_mesh<disk::simplicial_mesh<T, 3>>(2, "tetrahedra") and success;
+    success = test_stagnation() and success;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Test for the precomputed sparsity pattern of the assemblers: the system
+ * assembled in place must be identical to the one built via triplets, also
+ * when it is assembled more than once. */
+
+#include <iostream>
+#include <algorithm>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho_slapl.hpp"
+#include "diskpp/methods/hho"
+
+using namespace disk;
+
+template<typename T>
+bool
+bitwise_equal(const Eigen::SparseMatrix<T>& A, const Eigen::SparseMatrix<T>& B)
+{
+    if (A.nonZeros() != B.nonZeros())
+        return false;
+
+    return std::equal(A.valuePtr(), A.valuePtr() + A.nonZeros(), B.valuePtr()) and
+           std::equal(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros(), B.innerIndexPtr()) and
+           std::equal(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1, B.outerIndexPtr());
+}
+
+template<typename Mesh>
+bool
+test_basic_condensed_assembler(const Mesh& msh)
+{
+    using namespace disk::hho::slapl;
+    using T = typename hho_space<Mesh>::scalar_type;
+
+    degree_info di(1);
+
+    auto ref = make_assembler(msh, di);
+    auto assm = make_assembler(msh, di);
+    assm.initialize_pattern(msh);
+
+    bool success = true;
+    for (size_t iter = 0; iter < 2; iter++)
+    {
+        assm.initialize();
+        for (auto& cl : msh)
+        {
+            auto [R, A] = local_operator(msh, cl, di);
+            auto S = local_stabilization(msh, cl, di, R);
+            dynamic_matrix<T> lhs = A + S;
+            dynamic_vector<T> rhs = dynamic_vector<T>::Ones(lhs.rows());
+            auto phiT = typename hho_space<Mesh>::cell_basis_type(msh, cl, di.cell);
+            auto [lhsc, rhsc] = disk::hho::schur(lhs, rhs, phiT);
+
+            if (iter == 0)
+                ref.assemble(msh, cl, lhsc, rhsc);
+            assm.assemble(msh, cl, lhsc, rhsc);
+        }
+        if (iter == 0)
+            ref.finalize();
+        assm.finalize();
+
+        bool ok = bitwise_equal(ref.LHS, assm.LHS) and (ref.RHS == assm.RHS);
+        if (not ok)
+            std::cout << "  basic_condensed_assembler: mismatch at iteration " << iter << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_diffusion_condensed_assembler(const Mesh& msh)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+
+    hho_degree_info hdi(1, 1);
+
+    auto f = [](const point_type& pt) { return std::sin(M_PI * pt.x()); };
+
+    scalar_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere(f);
+
+    auto ref = make_diffusion_assembler(msh, hdi, bnd);
+    auto assm = make_diffusion_assembler(msh, hdi, bnd);
+    assm.initialize_pattern(msh);
+
+    bool success = true;
+    for (size_t iter = 0; iter < 2; iter++)
+    {
+        assm.initialize();
+        for (auto& cl : msh)
+        {
+            auto cb = make_scalar_monomial_basis(msh, cl, hdi.cell_degree());
+            auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+            auto stab = make_scalar_hho_stabilization(msh, cl, gr.first, hdi);
+            dynamic_matrix<T> A = gr.second + stab;
+            dynamic_vector<T> rhs = make_rhs(msh, cl, cb, f);
+            auto [lhsc, rhsc] = make_scalar_static_condensation(msh, cl, hdi, A, rhs);
+
+            if (iter == 0)
+                ref.assemble(msh, cl, bnd, lhsc, rhsc);
+            assm.assemble(msh, cl, bnd, lhsc, rhsc);
+        }
+        if (iter == 0)
+            ref.finalize();
+        assm.finalize();
+
+        bool ok = bitwise_equal(ref.LHS, assm.LHS) and (ref.RHS == assm.RHS);
+        if (not ok)
+            std::cout << "  diffusion_condensed_assembler: mismatch at iteration " << iter << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_vector_mechanics_hho_assembler(const Mesh& msh)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+    using vec_type = static_vector<T, Mesh::dimension>;
+
+    hho_degree_info hdi(1, 1);
+
+    auto f = [](const point_type& pt) -> vec_type { return vec_type::Constant(pt.x()); };
+
+    vector_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere(f);
+
+    vector_mechanics_hho_assembler<Mesh> ref(msh, hdi, bnd);
+    vector_mechanics_hho_assembler<Mesh> assm(msh, hdi, bnd);
+    assm.initialize_pattern(msh, bnd);
+
+    const auto fbs = vector_basis_size(hdi.face_degree(), Mesh::dimension - 1, Mesh::dimension);
+    std::vector<dynamic_vector<T>> sol_F(msh.faces_size(), dynamic_vector<T>::Zero(fbs));
+
+    bool success = true;
+    for (size_t iter = 0; iter < 2; iter++)
+    {
+        assm.initialize();
+        for (auto& cl : msh)
+        {
+            auto gr = make_vector_hho_symmetric_laplacian(msh, cl, hdi);
+            auto stab = make_vector_hho_stabilization(msh, cl, gr.first, hdi);
+            dynamic_matrix<T> A = gr.second + stab;
+            dynamic_vector<T> rhs = dynamic_vector<T>::Ones(A.rows());
+            auto [lhsc, rhsc] = make_vector_static_condensation(msh, cl, hdi, A, rhs);
+
+            if (iter == 0)
+                ref.assemble_nonlinear(msh, cl, bnd, lhsc, rhsc, sol_F);
+            assm.assemble_nonlinear(msh, cl, bnd, lhsc, rhsc, sol_F);
+        }
+        if (iter == 0)
+            ref.finalize();
+        assm.finalize();
+
+        bool ok = bitwise_equal(ref.LHS, assm.LHS) and (ref.RHS == assm.RHS);
+        if (not ok)
+            std::cout << "  vector_mechanics_hho_assembler: mismatch at iteration " << iter << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+    bool success = true;
+
+    std::cout << "Simplicial 2D" << std::endl;
+    simplicial_mesh<T,2> msh2;
+    auto mesher2 = make_simple_mesher(msh2);
+    mesher2.refine();
+    mesher2.refine();
+    success &= test_basic_condensed_assembler(msh2);
+    success &= test_diffusion_condensed_assembler(msh2);
+    success &= test_vector_mechanics_hho_assembler(msh2);
+
+    std::cout << "Simplicial 3D" << std::endl;
+    simplicial_mesh<T,3> msh3;
+    auto mesher3 = make_simple_mesher(msh3);
+    mesher3.refine();
+    success &= test_basic_condensed_assembler(msh3);
+    success &= test_diffusion_condensed_assembler(msh3);
+    success &= test_vector_mechanics_hho_assembler(msh3);
+
+    return success ? 0 : 1;
+}
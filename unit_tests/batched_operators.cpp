@@ -0,0 +1,214 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that the local operators built with the batched products of
+ * bases_batched.hpp are the same, up to roundoff, as the ones built with
+ * a rank-1 update per quadrature point: mass and stiffness matrices and
+ * the scalar HHO Laplacian, with and without diffusion tensor and face
+ * projection. */
+
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho"
+
+using namespace disk;
+
+template<typename T>
+bool
+close(const dynamic_matrix<T>& A, const dynamic_matrix<T>& B, T tol = 1e-11)
+{
+    return A.rows() == B.rows() and A.cols() == B.cols() and
+           (A - B).norm() <= tol * std::max(T(1), B.norm());
+}
+
+/* Mass and stiffness matrices with one rank-1 update per quadrature point */
+template<typename Mesh, typename Basis>
+auto
+reference_mass(const Mesh& msh, const typename Mesh::cell_type& cl, const Basis& basis)
+{
+    using T = typename Mesh::coordinate_type;
+
+    dynamic_matrix<T> ret = dynamic_matrix<T>::Zero(basis.size(), basis.size());
+    for (auto& qp : integrate(msh, cl, 2*basis.degree()))
+    {
+        const auto phi = basis.eval_functions(qp.point());
+        ret += qp.weight() * phi * phi.transpose();
+    }
+
+    return ret;
+}
+
+template<typename Mesh, typename Basis>
+auto
+reference_stiffness(const Mesh& msh, const typename Mesh::cell_type& cl, const Basis& basis)
+{
+    using T = typename Mesh::coordinate_type;
+
+    dynamic_matrix<T> ret = dynamic_matrix<T>::Zero(basis.size(), basis.size());
+    for (auto& qp : integrate(msh, cl, 2*(basis.degree()-1)))
+    {
+        const auto dphi = basis.eval_gradients(qp.point());
+        ret += qp.weight() * dphi * dphi.transpose();
+    }
+
+    return ret;
+}
+
+/* Scalar HHO Laplacian with one rank-1 update per quadrature point */
+template<bool use_diffusion_tensor, bool use_face_projection, typename Mesh>
+auto
+reference_laplacian(const Mesh& msh, const typename Mesh::cell_type& cl, const hho_degree_info& hdi,
+    const diffusion_tensor<Mesh>& diff_tens)
+{
+    using T = typename Mesh::coordinate_type;
+    const size_t DIM = Mesh::dimension;
+
+    typedef dynamic_matrix<T>       matrix_type;
+    typedef dynamic_vector<T>       vector_type;
+    typedef Matrix<T, Dynamic, DIM> gradient_type;
+
+    const auto rd = hdi.reconstruction_degree();
+    const auto cd = hdi.cell_degree();
+    const auto fd = hdi.face_degree();
+
+    const auto rb = make_scalar_monomial_basis(msh, cl, rd);
+    const auto cb = make_scalar_monomial_basis(msh, cl, cd);
+
+    const auto rbs = rb.size();
+    const auto cbs = cb.size();
+    const auto fbs = scalar_basis_size(fd, DIM-1);
+    const auto fcs = faces(msh, cl);
+
+    auto r_kdphi = [&](const auto& pt) {
+        gradient_type ret = rb.eval_gradients(pt).block(1, 0, rbs-1, DIM);
+        if constexpr (use_diffusion_tensor)
+            ret = ret * diff_tens.transpose();
+        return ret;
+    };
+
+    matrix_type gr_lhs = matrix_type::Zero(rbs-1, rbs-1);
+    matrix_type gr_rhs = matrix_type::Zero(rbs-1, cbs + fcs.size()*fbs);
+
+    for (auto& qp : integrate(msh, cl, 2*(rd-1)))
+    {
+        gradient_type r_dphi = rb.eval_gradients(qp.point()).block(1, 0, rbs-1, DIM);
+        gradient_type c_dphi = cb.eval_gradients(qp.point());
+        gr_lhs += qp.weight() * r_kdphi(qp.point()) * r_dphi.transpose();
+        gr_rhs.block(0, 0, rbs-1, cbs) += qp.weight() * r_kdphi(qp.point()) * c_dphi.transpose();
+    }
+
+    size_t offset = cbs;
+    for (auto& fc : fcs)
+    {
+        const auto n  = normal(msh, cl, fc);
+        const auto fb = make_scalar_monomial_basis(msh, fc, fd);
+
+        matrix_type MF = matrix_type::Zero(fbs, fbs);
+        matrix_type TF = matrix_type::Zero(fbs, cbs);
+        matrix_type FR = matrix_type::Zero(rbs-1, fbs);
+        matrix_type CR = matrix_type::Zero(rbs-1, cbs);
+        for (auto& qp : integrate(msh, fc, rd + std::max(cd, fd)))
+        {
+            vector_type r_dphi_n = r_kdphi(qp.point()) * n;
+            vector_type c_phi = cb.eval_functions(qp.point());
+            vector_type f_phi = fb.eval_functions(qp.point());
+
+            MF += qp.weight() * f_phi * f_phi.transpose();
+            TF += qp.weight() * f_phi * c_phi.transpose();
+            FR += qp.weight() * r_dphi_n * f_phi.transpose();
+            CR += qp.weight() * r_dphi_n * c_phi.transpose();
+        }
+
+        gr_rhs.block(0, offset, rbs-1, fbs) += FR;
+        if constexpr (use_face_projection)
+            gr_rhs.block(0, 0, rbs-1, cbs) -= FR * MF.ldlt().solve(TF);
+        else
+            gr_rhs.block(0, 0, rbs-1, cbs) -= CR;
+
+        offset += fbs;
+    }
+
+    matrix_type oper = gr_lhs.ldlt().solve(gr_rhs);
+    matrix_type data = gr_rhs.transpose() * oper;
+
+    return std::pair(oper, data);
+}
+
+/* The operators come out of a linear solve and on affine cells the volume
+ * term is taken from the tabulated basis, so the tolerance is looser. */
+template<typename Pair1, typename Pair2>
+bool
+close_operators(const Pair1& a, const Pair2& b)
+{
+    using T = typename Pair2::first_type::Scalar;
+    return close(a.first, b.first, T(1e-9)) and close(a.second, b.second, T(1e-9));
+}
+
+template<typename Mesh>
+bool
+test_operators(const Mesh& msh, const char *name)
+{
+    /* Anisotropic, non diagonal tensor */
+    diffusion_tensor<Mesh> K = diffusion_tensor<Mesh>::Identity();
+    K(0,0) = 3.0;
+    K(0,1) = K(1,0) = 0.5;
+
+    bool success = true;
+    for (size_t k = 0; k < 4; k++)
+    {
+        hho_degree_info hdi(k, k);
+        for (auto& cl : msh)
+        {
+            auto sb = make_scalar_monomial_basis(msh, cl, k+1);
+            success = success and close(make_mass_matrix(msh, cl, sb), reference_mass(msh, cl, sb));
+            success = success and close(make_stiffness_matrix(msh, cl, sb), reference_stiffness(msh, cl, sb));
+
+            auto vb = make_vector_monomial_basis(msh, cl, k+1);
+            success = success and close(make_mass_matrix(msh, cl, vb), reference_mass(msh, cl, vb));
+
+            diffusion_tensor<Mesh> I = diffusion_tensor<Mesh>::Zero();
+            success = success and close_operators(make_scalar_hho_laplacian(msh, cl, hdi),
+                                                  reference_laplacian<false, false>(msh, cl, hdi, I));
+            success = success and close_operators(make_scalar_hho_laplacian(msh, cl, hdi, K),
+                                                  reference_laplacian<true, false>(msh, cl, hdi, K));
+            success = success and close_operators(make_shl_face_proj(msh, cl, hdi),
+                                                  reference_laplacian<false, true>(msh, cl, hdi, I));
+            success = success and close_operators(make_shl_face_proj(msh, cl, hdi, K),
+                                                  reference_laplacian<true, true>(msh, cl, hdi, K));
+        }
+    }
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    mesher_tri.refine();
+    success = test_operators(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    success = test_operators(msh_tet, "tetrahedra") and success;
+
+    disk::generic_mesh<T, 2> msh_hex;
+    auto mesher_hex = disk::make_fvca5_hex_mesher(msh_hex);
+    mesher_hex.make_level(1);
+    success = test_operators(msh_hex, "hexagons") and success;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Write the state saved by the Newton solver (time steps, solution vectors
+ * and internal variables of the quadrature points) in a checkpoint file,
+ * change it while the file is written, and check that the file contains the
+ * state at the time of the writing. Files that do not match the current
+ * computation, or that are truncated, must be refused. */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "diskpp/mechanics/NewtonSolver/Checkpoint.hpp"
+#include "diskpp/mechanics/NewtonSolver/TimeManager.hpp"
+#include "diskpp/mechanics/behaviors/laws/law_qp_state.hpp"
+
+using namespace disk;
+using namespace disk::mechanics;
+
+template<typename T>
+struct state
+{
+    ListOfTimeStep<T>                 steps;
+    std::vector<dynamic_vector<T>>    solution;
+    QPStateStore<T>                   qps;
+
+    state(size_t num_vectors, size_t num_qp)
+        : steps(std::vector<std::pair<T, int>>{{0.5, 4}, {1.0, 8}}), qps(true)
+    {
+        for (size_t i = 0; i < num_vectors; i++)
+            solution.push_back( dynamic_vector<T>::Zero(i % 7) );
+        qps.add(num_qp);
+    }
+
+    /* some converged steps: the state depends on the value of the step */
+    void advance(size_t num_steps, T value)
+    {
+        for (size_t s = 0; s < num_steps; s++)
+        {
+            steps.removeCurrentTimeStep();
+            for (auto& v : solution)
+                v.setConstant(value + s);
+            for (size_t qp = 0; qp < qps.size(); qp++)
+            {
+                T *es = qps.elasticStrainWrite(qp);
+                for (size_t k = 0; k < QPStateStore<T>::strain_size; k++)
+                    es[k] = value * qp + k + s;
+                qps.equivalentPlasticStrainWrite(qp) = value + qp;
+                qps.isPlasticWrite(qp) = (qp + s) % 2;
+            }
+            qps.update();
+        }
+        steps.splitCurrentTimeStep();
+    }
+
+    void save(CheckpointOutput& out) const
+    {
+        steps.save(out);
+        out.write(solution);
+        qps.save(out);
+    }
+
+    void load(CheckpointInput& in)
+    {
+        steps.load(in);
+        in.read(solution);
+        qps.load(in);
+    }
+};
+
+template<typename T>
+bool
+equal(const state<T>& a, const state<T>& b)
+{
+    bool eq = a.steps.numberOfTimeStepRealized() == b.steps.numberOfTimeStepRealized();
+    eq = eq and a.steps.numberOfRemainingTimeStep() == b.steps.numberOfRemainingTimeStep();
+    eq = eq and a.steps.getCurrentTimeStep().end_time() == b.steps.getCurrentTimeStep().end_time();
+    eq = eq and a.steps.getCurrentTimeStep().level() == b.steps.getCurrentTimeStep().level();
+
+    for (size_t i = 0; i < a.solution.size(); i++)
+        eq = eq and a.solution[i] == b.solution[i];
+
+    for (size_t qp = 0; qp < a.qps.size(); qp++)
+    {
+        for (size_t k = 0; k < QPStateStore<T>::strain_size; k++)
+            eq = eq and a.qps.elasticStrain(qp)[k] == b.qps.elasticStrain(qp)[k];
+        eq = eq and a.qps.equivalentPlasticStrain(qp) == b.qps.equivalentPlasticStrain(qp);
+        eq = eq and a.qps.isPlastic(qp) == b.qps.isPlastic(qp);
+    }
+    return eq;
+}
+
+/* Return true if reading the file in s throws */
+template<typename T>
+bool
+refused(const std::string& filename, state<T>& s)
+{
+    try
+    {
+        CheckpointReader reader(filename);
+        auto in = reader.payload();
+        s.load(in);
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main(void)
+{
+    using T = double;
+    const std::string filename = "checkpoint_test.bin";
+
+    bool success = true;
+
+    state<T> s(1000, 5000);
+    s.advance(3, 1.0);
+
+    CheckpointWriter writer;
+    writer.write(filename, [&](CheckpointOutput& out) { s.save(out); });
+
+    /* the computation goes on while the file is written */
+    state<T> ref = s;
+    s.advance(2, 7.0);
+    writer.wait();
+
+    state<T> restart(1000, 5000);
+    auto read = [&]() {
+        CheckpointReader reader(filename);
+        auto in = reader.payload();
+        restart.load(in);
+        return in.end();
+    };
+    success = success and read() and equal(ref, restart) and not equal(s, restart);
+
+    /* the second checkpoint replaces the first one */
+    writer.write(filename, [&](CheckpointOutput& out) { s.save(out); });
+    writer.wait();
+    success = success and read() and equal(s, restart);
+
+    /* the restarted computation continues like the original one */
+    s.advance(1, 3.0);
+    restart.advance(1, 3.0);
+    success = success and equal(s, restart);
+
+    /* different number of quadrature points */
+    state<T> other(1000, 4000);
+    success = success and refused(filename, other);
+
+    /* truncated file */
+    std::vector<char> bytes;
+    {
+        std::ifstream ifs(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ofs.write(bytes.data(), bytes.size() / 2);
+    }
+    success = success and refused(filename, restart);
+
+    std::remove(filename.c_str());
+
+    std::cout << "checkpoint: " << (success ? "PASS" : "FAIL") << " (";
+    std::cout << bytes.size() << " bytes)" << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Solve a condensed HHO diffusion system with the conjugate gradient and
+ * the different preconditioners, serial and multithreaded, and compare
+ * with a direct solver. The multithreaded kernels and the thread pool
+ * they run on are checked separately on vectors large enough to be split. */
+
+#include <iostream>
+#include <stdexcept>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho"
+#include "diskpp/solvers/solver.hpp"
+
+using namespace disk;
+using namespace disk::solvers;
+
+template<typename Mesh>
+auto
+make_system(const Mesh& msh, const hho_degree_info& hdi)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+
+    auto f = [](const point_type& pt) { return std::sin(M_PI * pt.x()) * std::sin(M_PI * pt.y()); };
+
+    scalar_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere([](const point_type&) { return 0.0; });
+
+    auto assm = make_scalar_primal_hho_assembler(msh, hdi, bnd);
+    for (auto& cl : msh)
+    {
+        auto cb = make_scalar_monomial_basis(msh, cl, hdi.cell_degree());
+        auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+        auto stab = make_scalar_hho_stabilization(msh, cl, gr.first, hdi);
+        dynamic_matrix<T> A = gr.second + stab;
+        dynamic_vector<T> rhs = make_rhs(msh, cl, cb, f);
+        auto [lhs, lrhs] = make_scalar_static_condensation(msh, cl, hdi, A, rhs);
+        assm.assemble(msh, cl, bnd, lhs, lrhs);
+    }
+    assm.finalize();
+
+    return std::make_pair(assm.LHS, assm.RHS);
+}
+
+template<typename T, typename Preconditioner>
+bool
+test_cg(const char *name, const Eigen::SparseMatrix<T>& A, const dynamic_vector<T>& b,
+        const dynamic_vector<T>& ref, Preconditioner& pc, size_t& iterations)
+{
+    if ( not pc.compute(A) )
+    {
+        std::cout << "  " << name << ": preconditioner setup failed" << std::endl;
+        return false;
+    }
+
+    conjugated_gradient_params<T> cgp;
+    cgp.rr_tol = 1e-10;
+    cgp.max_iter = 0;
+
+    bool success = true;
+    for (size_t nt : {1, 4})
+    {
+        cgp.num_threads = nt;
+        dynamic_vector<T> x;
+        auto res = conjugated_gradient(cgp, A, b, x, pc);
+        T err = (x - ref).norm() / ref.norm();
+        bool ok = res.converged() and err < 1e-8;
+        if (not ok)
+        {
+            std::cout << "  " << name << " with " << nt << " threads: ";
+            std::cout << res.status << ", error " << err << std::endl;
+        }
+        success = success and ok;
+        iterations = res.iterations;
+    }
+
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_mesh(const Mesh& msh, const char *name)
+{
+    using T = typename Mesh::coordinate_type;
+
+    hho_degree_info hdi(1, 1);
+    auto [A, b] = make_system(msh, hdi);
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<T>> ldlt(A);
+    dynamic_vector<T> ref = ldlt.solve(b);
+
+    bool success = true;
+    size_t it_none, it_jacobi, it_block, it_ic0;
+
+    identity_preconditioner<T> none;
+    success = test_cg("none", A, b, ref, none, it_none) and success;
+
+    jacobi_preconditioner<T> jacobi;
+    success = test_cg("jacobi", A, b, ref, jacobi, it_jacobi) and success;
+
+    block_jacobi_preconditioner<T> block(scalar_basis_size(hdi.face_degree(), Mesh::dimension-1));
+    success = test_cg("block_jacobi", A, b, ref, block, it_block) and success;
+
+    ic0_preconditioner<T> ic0;
+    success = test_cg("ic0", A, b, ref, ic0, it_ic0) and success;
+
+    /* IC(0) must actually help */
+    success = success and it_ic0 < it_none and it_ic0 < it_jacobi and it_ic0 < it_block;
+
+    /* Non-convergence must be reported */
+    conjugated_gradient_params<T> cgp;
+    cgp.rr_tol = 1e-14;
+    cgp.max_iter = 2;
+    dynamic_vector<T> x;
+    auto res = conjugated_gradient(cgp, A, b, x, none);
+    success = success and res.status == conjugated_gradient_status::max_iter_reached;
+    success = success and not conjugated_gradient(cgp, A, b, x);
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << " (iterations: ";
+    std::cout << it_none << " none, " << it_jacobi << " jacobi, " << it_block;
+    std::cout << " block_jacobi, " << it_ic0 << " ic0)" << std::endl;
+    return success;
+}
+
+bool
+test_kernels(void)
+{
+    using T = double;
+
+    const size_t N = 5*parallel_kernels_threshold + 3;
+    dynamic_vector<T> x = dynamic_vector<T>::LinSpaced(N, -1.0, 2.0);
+    dynamic_vector<T> y = dynamic_vector<T>::LinSpaced(N, 3.0, -0.5);
+
+    std::vector<Eigen::Triplet<T>> triplets;
+    for (size_t i = 0; i < N; i++)
+    {
+        triplets.push_back( Eigen::Triplet<T>(i, i, 4.0) );
+        if (i > 0)
+            triplets.push_back( Eigen::Triplet<T>(i, i-1, -1.0) );
+    }
+    Eigen::SparseMatrix<T> A(N, N);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const dynamic_vector<T> Ax = A*x;
+
+    bool success = true;
+    for (size_t nt : {1, 2, 4})
+    {
+        /* Repeated, so that the threads of the pool are reused */
+        for (size_t rep = 0; rep < 3; rep++)
+        {
+            success = success and std::abs(parallel_dot(x, y, nt) - x.dot(y)) < 1e-10 * N;
+
+            dynamic_vector<T> z = y;
+            parallel_axpy(T(2), x, z, nt);
+            success = success and (z - (y + 2*x)).norm() < 1e-12 * z.norm();
+
+            z = y;
+            parallel_xpby(x, T(-3), z, nt);
+            success = success and (z - (x - 3*y)).norm() < 1e-12 * z.norm();
+
+            parallel_sparse_matrix<T> pA(A, nt);
+            pA.multiply(x, z);
+            success = success and (z - Ax).norm() < 1e-12 * Ax.norm();
+        }
+    }
+
+    /* A loop started from a task runs serially, without deadlocking */
+    std::vector<size_t> counts(4, 0);
+    kernels_thread_pool().run(4, [&](size_t task) {
+        kernels_thread_pool().run(3, [&](size_t) { counts[task]++; });
+    });
+    success = success and counts == std::vector<size_t>(4, 3);
+
+    /* The exception of a worker is rethrown by the caller */
+    bool caught = false;
+    try
+    {
+        kernels_thread_pool().run(4, [](size_t task) {
+            if (task == 3)
+                throw std::runtime_error("task failure");
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    success = success and caught;
+
+    std::cout << "kernels: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    success = test_kernels() and success;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    for (size_t i = 0; i < 4; i++)
+        mesher_tri.refine();
+    success = test_mesh(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    for (size_t i = 0; i < 2; i++)
+        mesher_tet.refine();
+    success = test_mesh(msh_tet, "tetrahedra") and success;
+
+    return success ? 0 : 1;
+}
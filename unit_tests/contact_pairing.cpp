@@ -0,0 +1,331 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Pair the top face of the unit square/cube with its bottom face and check
+ * the projections of the bounding volume hierarchy against a search over
+ * all the master faces, before and after moving the mesh. Small motions
+ * must only refit the tree, large distortions must rebuild it. The cube is
+ * meshed with tetrahedra and with hexahedra, whose quadrangular faces are
+ * split in triangles around their barycenter. */
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <tuple>
+
+#include "diskpp/loaders/loader.hpp"
+#include "diskpp/mechanics/contact/contact_pairing.hpp"
+#include "diskpp/mesh/meshgen.hpp"
+
+using namespace disk;
+
+/* Boundary id of the faces where the last coordinate is equal to c */
+template<typename Mesh>
+size_t
+boundary_at(const Mesh& msh, typename Mesh::coordinate_type c)
+{
+    for (auto& fc : faces(msh))
+    {
+        auto bar = barycenter(msh, fc);
+        if (msh.is_boundary(fc) and std::abs(bar[Mesh::dimension - 1] - c) < 1e-12)
+            return msh.boundary_info(fc).id();
+    }
+    return -1;
+}
+
+/* Distance of p to the closest master face, by looking at all of them */
+template<typename Mesh, typename Nodes>
+typename Mesh::coordinate_type
+brute_force(const Mesh& msh, size_t master_id, const Nodes& nodes, const typename Nodes::value_type& p)
+{
+    using T = typename Mesh::coordinate_type;
+
+    T best = std::numeric_limits<T>::max();
+    for (auto& fc : faces(msh))
+    {
+        if (not msh.is_boundary(fc) or msh.boundary_info(fc).id() != master_id)
+            continue;
+
+        auto ptids = fc.point_ids();
+        const size_t nv = ptids.size();
+        if constexpr (Mesh::dimension == 2)
+        {
+            static_vector<T, 2> bar;
+            auto q = mechanics::closest_point_segment(p, nodes[ptids[0]], nodes[ptids[1]], bar);
+            best = std::min(best, (p - q).norm());
+        }
+        else if (nv == 3)
+        {
+            static_vector<T, 3> bar;
+            auto q = mechanics::closest_point_triangle(p, nodes[ptids[0]], nodes[ptids[1]], nodes[ptids[2]], bar);
+            best = std::min(best, (p - q).norm());
+        }
+        else
+        {
+            /* the triangles joining the barycenter to the edges */
+            static_vector<T, 3> center = static_vector<T, 3>::Zero();
+            for (size_t k = 0; k < nv; k++)
+                center += nodes[ptids[k]];
+            center /= T(nv);
+
+            static_vector<T, 3> bar;
+            for (size_t k = 0; k < nv; k++)
+            {
+                auto q = mechanics::closest_point_triangle(p, center, nodes[ptids[k]], nodes[ptids[(k+1)%nv]], bar);
+                best = std::min(best, (p - q).norm());
+            }
+        }
+    }
+    return best;
+}
+
+template<typename Mesh>
+bool
+test_mesh(const Mesh& msh, const char *name)
+{
+    using T = typename Mesh::coordinate_type;
+    const size_t DIM = Mesh::dimension;
+    using vector_type = static_vector<T, DIM>;
+    using point_type = point<T, DIM>;
+
+    const size_t master_id = boundary_at(msh, 0.0);
+    const size_t slave_id = boundary_at(msh, 1.0);
+
+    mechanics::ContactPairing<Mesh> pairing(msh, master_id, slave_id, 2);
+
+    eigen_compatible_stdvector<vector_type> ref_nodes;
+    for (auto itor = msh.points_begin(); itor != msh.points_end(); itor++)
+        ref_nodes.push_back( (*itor).to_vector() );
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<T> dist(-0.2, 1.2);
+
+    /* projections of random points, compared to the search over all the faces */
+    auto check_projections = [&](const eigen_compatible_stdvector<vector_type>& nodes) {
+        T err = 0.0;
+        for (size_t i = 0; i < 200; i++)
+        {
+            vector_type p;
+            for (size_t d = 0; d < DIM; d++)
+                p(d) = dist(gen);
+
+            auto proj = pairing.project( point_type(p) );
+            if (not proj.found)
+                return T(1);
+
+            T d_ref = brute_force(msh, master_id, nodes, p);
+            err = std::max(err, std::abs(proj.distance - d_ref));
+            err = std::max(err, std::abs((p - proj.master_point.to_vector()).norm() - d_ref));
+        }
+        return err;
+    };
+
+    auto move = [&](auto u) {
+        eigen_compatible_stdvector<vector_type> disp, nodes;
+        for (auto& x : ref_nodes)
+        {
+            disp.push_back( u(x) );
+            nodes.push_back( x + u(x) );
+        }
+        pairing.updateDisplacement(disp);
+        return nodes;
+    };
+
+    bool success = true;
+
+    T err_ref = check_projections(ref_nodes);
+    success = success and err_ref < 1e-12;
+
+    /* small motion of the whole body: only refits */
+    auto nodes = move([](const vector_type& x) {
+        vector_type u = vector_type::Zero();
+        for (size_t d = 0; d < DIM; d++)
+            u(d) = 0.01 * std::sin(3 * x(0) + d) * std::cos(2 * x(DIM - 1));
+        return u;
+    });
+    T err_small = check_projections(nodes);
+    success = success and err_small < 1e-12;
+    success = success and pairing.numberOfBuilds() == 1 and pairing.numberOfRefits() == 1;
+
+    /* the top face goes under the bottom face: the normal gap is 0.5 everywhere */
+    nodes = move([](const vector_type& x) {
+        vector_type u = vector_type::Zero();
+        u(DIM - 1) = -1.5 * x(DIM - 1);
+        return u;
+    });
+    auto pairs = pairing.pairSlaveFaces();
+    T err_gap = 0.0, slave_area = 0.0;
+    for (auto& pr : pairs)
+    {
+        err_gap = std::max(err_gap, std::abs(pr.gap - 0.5));
+        err_gap = std::max(err_gap, (pr.master.normal + vector_type::Unit(DIM - 1)).norm());
+        slave_area += pr.weight;
+    }
+    success = success and not pairs.empty() and err_gap < 1e-12 and std::abs(slave_area - 1.0) < 1e-12;
+    success = success and pairing.numberOfBuilds() == 1;
+
+    /* a strong oscillation of the bottom face: rebuild */
+    nodes = move([](const vector_type& x) {
+        vector_type u = vector_type::Zero();
+        u(0) = 0.5 * std::sin(40 * x(0)) * (1 - x(DIM - 1));
+        if constexpr (DIM == 3)
+            u(1) = 0.5 * std::cos(40 * x(1)) * (1 - x(DIM - 1));
+        return u;
+    });
+    T err_large = check_projections(nodes);
+    success = success and err_large < 1e-12 and pairing.numberOfBuilds() == 2;
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << " (";
+    std::cout << pairing.numberOfMasterFaces() << " master faces, errors " << err_ref << " ";
+    std::cout << err_small << " " << err_gap << " " << err_large << ", ";
+    std::cout << pairing.numberOfBuilds() << " builds, " << pairing.numberOfRefits() << " refits)" << std::endl;
+    return success;
+}
+
+/* Write the unit cube split in n^3 hexahedra in the poly3d format, with the
+ * faces at z = 0 in group 1 and the faces at z = 1 in group 2. The vertices
+ * of the faces are ordered along their boundary. */
+void
+write_hexahedra(const char *filename, size_t n)
+{
+    auto node = [&](size_t i, size_t j, size_t k) { return i + (n+1)*(j + (n+1)*k); };
+
+    std::map<std::array<size_t, 2>, size_t> edges;
+    auto edge = [&](size_t a, size_t b) {
+        std::array<size_t, 2> key = {std::min(a, b), std::max(a, b)};
+        return edges.try_emplace(key, edges.size()).first->second;
+    };
+
+    std::vector<std::array<size_t, 4>> faces;
+    std::map<std::array<size_t, 4>, size_t> face_ids;
+    std::vector<size_t> bottom, top;
+    auto face = [&](const std::array<size_t, 4>& vts) {
+        auto key = vts;
+        std::sort(key.begin(), key.end());
+        auto [itor, inserted] = face_ids.try_emplace(key, faces.size());
+        if (inserted)
+        {
+            faces.push_back(vts);
+            for (size_t k = 0; k < 4; k++)
+                edge(vts[k], vts[(k+1)%4]);
+        }
+        return itor->second;
+    };
+
+    std::vector<std::array<size_t, 8>> vol_nodes;
+    std::vector<std::array<size_t, 6>> vol_faces;
+    for (size_t k = 0; k < n; k++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t p0 = node(i, j, k),   p1 = node(i+1, j, k);
+                const size_t p2 = node(i+1, j+1, k), p3 = node(i, j+1, k);
+                const size_t p4 = node(i, j, k+1), p5 = node(i+1, j, k+1);
+                const size_t p6 = node(i+1, j+1, k+1), p7 = node(i, j+1, k+1);
+
+                vol_nodes.push_back({p0, p1, p2, p3, p4, p5, p6, p7});
+                vol_faces.push_back({face({p0, p3, p2, p1}), face({p4, p5, p6, p7}),
+                                     face({p0, p1, p5, p4}), face({p3, p7, p6, p2}),
+                                     face({p0, p4, p7, p3}), face({p1, p2, p6, p5})});
+                if (k == 0)
+                    bottom.push_back(vol_faces.back()[0]);
+                if (k == n-1)
+                    top.push_back(vol_faces.back()[1]);
+            }
+        }
+    }
+
+    std::ofstream ofs(filename);
+    ofs << "**BeginMesh\n*Dimension 3\n*Version 1\n";
+    ofs << "*Nodes " << (n+1)*(n+1)*(n+1) << "\n";
+    for (size_t k = 0; k <= n; k++)
+        for (size_t j = 0; j <= n; j++)
+            for (size_t i = 0; i <= n; i++)
+                ofs << node(i, j, k) << " " << double(i)/n << " " << double(j)/n << " " << double(k)/n << "\n";
+
+    ofs << "*Edges->Nodes " << edges.size() << "\n";
+    for (auto& [vts, id] : edges)
+        ofs << id << " 2 " << vts[0] << " " << vts[1] << "\n";
+
+    ofs << "*Faces->Nodes " << faces.size() << "\n";
+    for (size_t f = 0; f < faces.size(); f++)
+        ofs << f << " 4 " << faces[f][0] << " " << faces[f][1] << " " << faces[f][2] << " " << faces[f][3] << "\n";
+
+    ofs << "*Faces->Edges " << faces.size() << "\n";
+    for (size_t f = 0; f < faces.size(); f++)
+    {
+        ofs << f << " 4";
+        for (size_t k = 0; k < 4; k++)
+            ofs << " " << edge(faces[f][k], faces[f][(k+1)%4]);
+        ofs << "\n";
+    }
+
+    ofs << "*Faces->Groups 2\n";
+    for (auto [name, id, list] : {std::tuple("bottom", 1, &bottom), std::tuple("top", 2, &top)})
+    {
+        ofs << name << " " << id << " " << list->size();
+        for (auto f : *list)
+            ofs << " " << f;
+        ofs << "\n";
+    }
+
+    ofs << "*Volumes->Nodes " << vol_nodes.size() << "\n";
+    for (size_t v = 0; v < vol_nodes.size(); v++)
+    {
+        ofs << v << " 8";
+        for (auto p : vol_nodes[v])
+            ofs << " " << p;
+        ofs << "\n";
+    }
+
+    ofs << "*Volumes->Faces " << vol_faces.size() << "\n";
+    for (size_t v = 0; v < vol_faces.size(); v++)
+    {
+        ofs << v << " 6";
+        for (auto f : vol_faces[v])
+            ofs << " " << f;
+        ofs << "\n";
+    }
+    ofs << "**EndMesh\n";
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    for (size_t i = 0; i < 4; i++)
+        mesher_tri.refine();
+    success = test_mesh(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    for (size_t i = 0; i < 2; i++)
+        mesher_tet.refine();
+    success = test_mesh(msh_tet, "tetrahedra") and success;
+
+    write_hexahedra("contact_pairing.poly3d", 8);
+    disk::generic_mesh<T, 3> msh_hex;
+    success = disk::load_mesh_poly3d<T>("contact_pairing.poly3d", msh_hex) and success;
+    success = test_mesh(msh_hex, "hexahedra") and success;
+    std::remove(disk::mesh_cache_filename<disk::generic_mesh<T, 3>>("contact_pairing.poly3d").c_str());
+    std::remove("contact_pairing.poly3d");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that factorized_solver reuses the factorization when the matrix
+ * does not change, redoes only the numeric part when the values change
+ * and everything when the pattern changes. */
+
+#include <iostream>
+
+#include "diskpp/solvers/solver.hpp"
+
+using namespace disk;
+using namespace disk::solvers;
+
+template<typename T>
+Eigen::SparseMatrix<T>
+make_laplacian(size_t N, T diag)
+{
+    std::vector<Eigen::Triplet<T>> triplets;
+    for (size_t i = 0; i < N; i++)
+    {
+        triplets.push_back( Eigen::Triplet<T>(i, i, diag) );
+        if (i > 0)
+            triplets.push_back( Eigen::Triplet<T>(i, i-1, -1.0) );
+        if (i < N-1)
+            triplets.push_back( Eigen::Triplet<T>(i, i+1, -1.0) );
+    }
+
+    Eigen::SparseMatrix<T> A(N, N);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+template<typename T>
+bool
+check_solution(const Eigen::SparseMatrix<T>& A, const dynamic_matrix<T>& B, const dynamic_matrix<T>& X)
+{
+    Eigen::SparseLU<Eigen::SparseMatrix<T>> lu(A);
+    dynamic_matrix<T> ref = lu.solve(B);
+    return X.rows() == ref.rows() and X.cols() == ref.cols() and
+           (X - ref).norm() <= 1e-12 * ref.norm();
+}
+
+template<typename T>
+bool
+test_solver(factorization_type type, const char *name)
+{
+    const size_t N = 500;
+
+    factorized_solver<T> solver(type);
+    bool success = true;
+
+    dynamic_matrix<T> B = dynamic_matrix<T>::Random(N, 3);
+
+    /* First factorization */
+    auto A = make_laplacian<T>(N, 4.0);
+    success = success and solver.factorize(A);
+    success = success and check_solution(A, B, solver.solve(B));
+
+    /* Same matrix: nothing to do */
+    success = success and solver.factorize(A);
+    dynamic_vector<T> b = B.col(0);
+    success = success and check_solution<T>(A, b, solver.solve(b));
+    success = success and solver.num_analyses() == 1 and solver.num_factorizations() == 1;
+
+    /* Same pattern, new values: numeric factorization only */
+    A = make_laplacian<T>(N, 3.0);
+    success = success and solver.factorize(A);
+    success = success and check_solution(A, B, solver.solve(B));
+    success = success and solver.num_analyses() == 1 and solver.num_factorizations() == 2;
+
+    /* New pattern: analysis and factorization */
+    Eigen::SparseMatrix<T> A2 = A;
+    A2.insert(0, N-1) = -0.5;
+    A2.insert(N-1, 0) = -0.5;
+    success = success and solver.factorize(A2);
+    success = success and check_solution(A2, B, solver.solve(B));
+    success = success and solver.num_analyses() == 2 and solver.num_factorizations() == 3;
+
+    /* Convenience interface */
+    dynamic_vector<T> x;
+    success = success and solver.solve(A, b, x);
+    success = success and check_solution<T>(A, b, x);
+    success = success and solver.num_analyses() == 3 and solver.num_factorizations() == 4;
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+    success = test_solver<T>(factorization_type::sparse_lu, "sparse_lu") and success;
+    success = test_solver<T>(factorization_type::sparse_ldlt, "sparse_ldlt") and success;
+#ifdef HAVE_INTEL_MKL
+    success = test_solver<T>(factorization_type::pardiso_lu, "pardiso_lu") and success;
+    success = test_solver<T>(factorization_type::pardiso_ldlt, "pardiso_ldlt") and success;
+#endif
+#ifdef HAVE_MUMPS
+    success = test_solver<T>(factorization_type::mumps, "mumps") and success;
+#endif
+
+    return success ? 0 : 1;
+}
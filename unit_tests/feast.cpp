@@ -0,0 +1,171 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that feast() gives the same eigenpairs when the factorizations of
+ * the shifted matrices are kept across the subspace iterations, with the
+ * contour points solved in sequence or concurrently, as when the shifted
+ * matrices are factorized again at each solve. The eigenvalues are also
+ * compared with the ones of a dense solver. */
+
+#include <iostream>
+#include <cstdlib>
+
+#include "sol/sol.hpp"
+#include "diskpp/common/eigen.hpp"
+
+/* feast.hpp uses the mumps_lu() of the applications for the MUMPS inner
+ * solver. The test runs only SparseLU, this one just lets the header build. */
+template<typename T, typename Matrix>
+Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>
+mumps_lu(const Eigen::SparseMatrix<T>& A, const Matrix& b)
+{
+    Eigen::SparseLU<Eigen::SparseMatrix<T>> lu(A);
+    return lu.solve(b);
+}
+
+#include "diskpp/solvers/feast.hpp"
+
+using namespace disk;
+
+using rdv = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using rdm = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+/* The shifted matrices factorized at each solve, without reuse */
+class refactorizing_shifts
+{
+    std::array<priv::feast_csm, 8>  m_lhs;
+
+public:
+    static const bool concurrent = false;
+
+    bool
+    analyze(const priv::feast_csm&)
+    {
+        return true;
+    }
+
+    bool
+    factorize(size_t e, const priv::feast_csm& lhs)
+    {
+        m_lhs[e] = lhs;
+        return true;
+    }
+
+    priv::feast_cdm
+    solve(size_t e, const priv::feast_cdm& rhs)
+    {
+        Eigen::SparseLU<priv::feast_csm> lu(m_lhs[e]);
+        return lu.solve(rhs);
+    }
+};
+
+/* 1D finite elements: stiffness and mass matrices on (0,1) */
+void
+make_problem(size_t N, Eigen::SparseMatrix<double>& K, Eigen::SparseMatrix<double>& M)
+{
+    using triplet_type = Eigen::Triplet<double>;
+
+    const size_t aN = N-1;
+    const double h = 1./N;
+
+    std::vector<triplet_type> tK, tM;
+    for (size_t i = 0; i < aN; i++)
+    {
+        if (i > 0)
+        {
+            tK.push_back( triplet_type(i-1, i, -1.0/h) );
+            tM.push_back( triplet_type(i-1, i,  h/6.0) );
+        }
+
+        tK.push_back( triplet_type(i, i, 2.0/h) );
+        tM.push_back( triplet_type(i, i, 4.0*h/6.0) );
+
+        if (i < aN-1)
+        {
+            tK.push_back( triplet_type(i+1, i, -1.0/h) );
+            tM.push_back( triplet_type(i+1, i,  h/6.0) );
+        }
+    }
+
+    K.resize(aN, aN);
+    M.resize(aN, aN);
+    K.setFromTriplets(tK.begin(), tK.end());
+    M.setFromTriplets(tM.begin(), tM.end());
+}
+
+/* Same eigenvalues, same eigenvectors up to the sign */
+bool
+same_eigenpairs(const rdv& vals_a, const rdm& vecs_a, const rdv& vals_b, const rdm& vecs_b)
+{
+    if (vals_a.size() != vals_b.size() or vecs_a.cols() != vecs_b.cols())
+        return false;
+
+    for (Eigen::Index i = 0; i < vals_a.size(); i++)
+    {
+        if ( std::abs(vals_a(i) - vals_b(i)) > 1e-9 * std::abs(vals_a(i)) )
+            return false;
+
+        auto cosine = vecs_a.col(i).dot(vecs_b.col(i)) / (vecs_a.col(i).norm() * vecs_b.col(i).norm());
+        if ( std::abs(std::abs(cosine) - 1.0) > 1e-8 )
+            return false;
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    const size_t N = 200;
+
+    Eigen::SparseMatrix<double> K, M;
+    make_problem(N, K, M);
+
+    feast_eigensolver_params<double> fep;
+    fep.verbose = false;
+    fep.tolerance = 10;
+    fep.min_eigval = 1;
+    fep.max_eigval = 500;
+    fep.subspace_size = 14;
+    fep.max_iter = 50;
+    fep.fis = feast_inner_solver::eigen_sparselu;
+
+    /* Same random initial subspace for all the runs */
+    const unsigned int seed = 42;
+
+    rdm ref_vecs, vecs, par_vecs;
+    rdv ref_vals, vals, par_vals;
+
+    std::srand(seed);
+    auto ref_status = priv::feast<refactorizing_shifts>(fep, K, M, ref_vecs, ref_vals);
+
+    std::srand(seed);
+    auto status = feast(fep, K, M, vecs, vals);
+
+    fep.parallel_contour = true;
+    std::srand(seed);
+    auto par_status = feast(fep, K, M, par_vecs, par_vals);
+
+    /* Eigenvalues in [1, 500]: (k*pi)^2 for k = 1, ..., 7 */
+    Eigen::GeneralizedSelfAdjointEigenSolver<rdm> es(rdm(K), rdm(M), Eigen::EigenvaluesOnly);
+    const rdv dense_vals = es.eigenvalues().head(7);
+
+    bool success = ref_status == feast_status::success and status == feast_status::success and
+                   par_status == feast_status::success;
+
+    success = success and vals.size() == 7 and (vals - dense_vals).norm() < 1e-9 * dense_vals.norm();
+    success = success and same_eigenpairs(ref_vals, ref_vecs, vals, vecs);
+
+    /* The contributions of the contour points are summed in a fixed order */
+    success = success and par_vals == vals and par_vecs == vecs;
+
+    std::cout << "FEAST factorization reuse: " << (success ? "PASS" : "FAIL") << std::endl;
+
+    return success ? 0 : 1;
+}
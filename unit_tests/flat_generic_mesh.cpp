@@ -0,0 +1,423 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that a generic mesh with flat connectivity behaves exactly as the
+ * generic mesh it was created from: same elements, geometry, quadratures
+ * and HHO systems. The same is checked for the flat meshes filled directly
+ * by the FVCA5, FVCA6 and medit loaders, read from the file and from the
+ * mesh cache. */
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "diskpp/loaders/loader.hpp"
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/geometry/geometry.hpp"
+#include "diskpp/methods/hho_slapl.hpp"
+#include "diskpp/methods/hho"
+
+template<typename Mesh>
+auto
+assemble_laplacian(const Mesh& msh)
+{
+    using namespace disk::hho::slapl;
+    using T = typename hho_space<Mesh>::scalar_type;
+
+    degree_info di(1);
+    auto assm = make_assembler(msh, di);
+    for (auto& cl : msh)
+    {
+        auto [R, A] = local_operator(msh, cl, di);
+        auto S = local_stabilization(msh, cl, di, R);
+        disk::dynamic_matrix<T> lhs = A + S;
+        disk::dynamic_vector<T> rhs = disk::dynamic_vector<T>::Ones(lhs.rows());
+        auto phiT = typename hho_space<Mesh>::cell_basis_type(msh, cl, di.cell);
+        auto [lhsc, rhsc] = disk::hho::schur(lhs, rhs, phiT);
+        assm.assemble(msh, cl, lhsc, rhsc);
+    }
+    assm.finalize();
+
+    return std::pair(assm.LHS, assm.RHS);
+}
+
+template<typename T, size_t DIM>
+bool
+same_point(const disk::point<T,DIM>& a, const disk::point<T,DIM>& b)
+{
+    return (a - b).to_vector().norm() == 0.0;
+}
+
+template<typename GenericMesh, typename FlatMesh>
+bool
+compare(const GenericMesh& gmsh, const FlatMesh& fmsh)
+{
+    if (gmsh.cells_size() != fmsh.cells_size() or gmsh.faces_size() != fmsh.faces_size())
+        return false;
+
+    for (size_t i = 0; i < gmsh.cells_size(); i++)
+    {
+        auto gcl = gmsh[i];
+        auto fcl = fmsh[i];
+
+        if (fmsh.lookup(fcl) != i)
+            return false;
+
+        auto gpts = points(gmsh, gcl);
+        auto fpts = points(fmsh, fcl);
+        if (gpts.size() != fpts.size())
+            return false;
+        for (size_t j = 0; j < gpts.size(); j++)
+            if (not same_point(gpts[j], fpts[j]))
+                return false;
+
+        auto gfcs_id = faces_id(gmsh, gcl);
+        auto ffcs_id = faces_id(fmsh, fcl);
+        if (gfcs_id.size() != ffcs_id.size())
+            return false;
+        for (size_t j = 0; j < gfcs_id.size(); j++)
+            if (size_t(gfcs_id[j]) != size_t(ffcs_id[j]))
+                return false;
+
+        if (measure(gmsh, gcl) != measure(fmsh, fcl))
+            return false;
+
+        auto gfcs = faces(gmsh, gcl);
+        auto ffcs = faces(fmsh, fcl);
+        for (size_t j = 0; j < gfcs.size(); j++)
+        {
+            if (fmsh.lookup(ffcs[j]) != gmsh.lookup(gfcs[j]))
+                return false;
+            if (measure(gmsh, gfcs[j]) != measure(fmsh, ffcs[j]))
+                return false;
+        }
+
+        auto gqps = disk::integrate(gmsh, gcl, 4);
+        auto fqps = disk::integrate(fmsh, fcl, 4);
+        if (gqps.size() != fqps.size())
+            return false;
+        for (size_t j = 0; j < gqps.size(); j++)
+            if (not same_point(gqps[j].point(), fqps[j].point()) or gqps[j].weight() != fqps[j].weight())
+                return false;
+    }
+
+    auto [gA, gb] = assemble_laplacian(gmsh);
+    auto [fA, fb] = assemble_laplacian(fmsh);
+    if ((gA - fA).norm() != 0.0 or gb != fb)
+        return false;
+
+    return true;
+}
+
+/* Write the polygonal mesh msh in the medit and FVCA5 formats */
+template<typename T>
+void
+write_2d_files(const disk::generic_mesh<T, 2>& msh)
+{
+    auto s = msh.backend_storage();
+
+    /* Both formats list the polygons grouped by number of vertices */
+    std::map<size_t, std::vector<size_t>> by_size;
+    for (size_t i = 0; i < s->surfaces.size(); i++)
+        by_size[s->surfaces[i].point_ids().size()].push_back(i);
+
+    std::vector<size_t> bnd;
+    for (size_t i = 0; i < s->edges.size(); i++)
+        if (s->boundary_info[i].is_boundary())
+            bnd.push_back(i);
+
+    const char *medit_names[] = {"", "", "", "Triangles", "Quadrilaterals", "Pentagons", "Hexagons"};
+    const char *fvca5_names[] = {"", "", "", "triangles", "quadrangles", "pentagons", "hexagons"};
+
+    std::ofstream medit("flat_generic_mesh.medit2d");
+    medit.precision(17);
+    medit << "MeshVersionFormatted 2\nDimension 3\nVertices\n" << s->points.size() << "\n";
+    for (auto& pt : s->points)
+        medit << pt.x() << " " << pt.y() << " 0 0\n";
+    for (auto& [n, polys] : by_size)
+    {
+        medit << medit_names[n] << "\n" << polys.size() << "\n";
+        for (auto i : polys)
+        {
+            for (auto ptid : s->surfaces[i].point_ids())
+                medit << ptid+1 << " ";
+            medit << i%3 << "\n";
+        }
+    }
+    medit << "Edges\n" << bnd.size() << "\n";
+    for (auto i : bnd)
+    {
+        auto ptids = s->edges[i].point_ids();
+        medit << ptids[1]+1 << " " << ptids[0]+1 << " " << s->boundary_info[i].id() << "\n";
+    }
+    medit << "End\n";
+
+    /* FVCA5 lists the neighbours of the edges, with the polygons numbered
+     * in the order they appear in the file */
+    std::vector<size_t> poly_num(s->surfaces.size());
+    size_t num = 1;
+    for (auto& [n, polys] : by_size)
+        for (auto i : polys)
+            poly_num[i] = num++;
+
+    std::vector<std::array<size_t, 2>> neighbours(s->edges.size(), {0, 0});
+    for (size_t i = 0; i < s->surfaces.size(); i++)
+    {
+        auto& poly = s->surfaces[i];
+        for (auto itor = poly.subelement_id_begin(); itor != poly.subelement_id_end(); itor++)
+        {
+            auto& nb = neighbours[size_t(*itor)];
+            nb[nb[0] == 0 ? 0 : 1] = poly_num[i];
+        }
+    }
+
+    std::ofstream fvca5("flat_generic_mesh.typ1");
+    fvca5.precision(17);
+    fvca5 << "vertices\n" << s->points.size() << "\n";
+    for (auto& pt : s->points)
+        fvca5 << pt.x() << " " << pt.y() << "\n";
+    for (auto& [n, polys] : by_size)
+    {
+        fvca5 << fvca5_names[n] << "\n" << polys.size() << "\n";
+        for (auto i : polys)
+        {
+            for (auto ptid : s->surfaces[i].point_ids())
+                fvca5 << " " << ptid+1;
+            fvca5 << "\n";
+        }
+    }
+    fvca5 << "edges of the boundary\n" << bnd.size() << "\n";
+    for (auto i : bnd)
+    {
+        auto ptids = s->edges[i].point_ids();
+        fvca5 << ptids[1]+1 << " " << ptids[0]+1 << "\n";
+    }
+    /* In reverse order, the loader must sort them */
+    fvca5 << "all edges\n" << s->edges.size() << "\n";
+    for (size_t i = s->edges.size(); i-- > 0;)
+    {
+        auto ptids = s->edges[i].point_ids();
+        fvca5 << ptids[0]+1 << " " << ptids[1]+1 << " ";
+        fvca5 << neighbours[i][0] << " " << neighbours[i][1] << "\n";
+    }
+}
+
+/* Write the tetrahedral mesh msh in the medit and FVCA6 formats. The
+ * elements are written in reverse order, the loaders must sort them. */
+template<typename T>
+void
+write_3d_files(const disk::simplicial_mesh<T, 3>& msh)
+{
+    auto s = msh.backend_storage();
+    const size_t nv = s->volumes.size(), nf = s->surfaces.size(), ne = s->edges.size();
+
+    std::map<std::array<size_t, 2>, size_t> edge_num;
+    for (size_t i = 0; i < ne; i++)
+    {
+        auto ptids = s->edges[i].point_ids();
+        edge_num[{ptids[0], ptids[1]}] = i;
+    }
+
+    std::map<std::array<size_t, 3>, size_t> face_num;
+    for (size_t i = 0; i < nf; i++)
+    {
+        auto ptids = s->surfaces[i].point_ids();
+        face_num[{ptids[0], ptids[1], ptids[2]}] = i;
+    }
+
+    auto face_edges = [&](size_t i) {
+        auto ptids = s->surfaces[i].point_ids();
+        std::array<size_t, 3> ret;
+        for (size_t j = 0; j < 3; j++)
+        {
+            std::array<size_t, 2> key = {ptids[j], ptids[(j+1)%3]};
+            std::sort(key.begin(), key.end());
+            ret[j] = ne-1-edge_num.at(key);
+        }
+        return ret;
+    };
+
+    std::vector<size_t> face_count(nf, 0);
+    auto vol_faces = [&](size_t i) {
+        auto ptids = s->volumes[i].point_ids();
+        std::array<size_t, 4> ret;
+        for (size_t j = 0; j < 4; j++)
+        {
+            std::array<size_t, 3> key;
+            for (size_t k = 0, l = 0; k < 4; k++)
+                if (k != j)
+                    key[l++] = ptids[k];
+            ret[j] = nf-1-face_num.at(key);
+        }
+        return ret;
+    };
+
+    for (size_t i = 0; i < nv; i++)
+        for (auto fid : vol_faces(i))
+            face_count[fid]++;
+
+    auto write = [&](std::ostream& os, size_t base, const char *vol_faces_kw,
+                     const char *vol_vts_kw, const char *face_edges_kw) {
+        os << "Vertices\n" << s->points.size() << "\n";
+        for (auto& pt : s->points)
+            os << pt.x() << " " << pt.y() << " " << pt.z() << "\n";
+        os << vol_faces_kw << "\n" << nv << "\n";
+        for (size_t i = nv; i-- > 0;)
+        {
+            os << 4;
+            for (auto fid : vol_faces(i))
+                os << " " << fid+base;
+            os << "\n";
+        }
+        os << vol_vts_kw << "\n" << nv << "\n";
+        for (size_t i = nv; i-- > 0;)
+        {
+            os << 4;
+            for (auto ptid : s->volumes[i].point_ids())
+                os << " " << ptid+base;
+            os << "\n";
+        }
+        os << face_edges_kw << "\n" << nf << "\n";
+        for (size_t i = nf; i-- > 0;)
+        {
+            os << 3;
+            for (auto eid : face_edges(i))
+                os << " " << eid+base;
+            os << "\n";
+        }
+        os << "Faces->Vertices\n" << nf << "\n";
+        for (size_t i = nf; i-- > 0;)
+        {
+            os << 3;
+            for (auto ptid : s->surfaces[i].point_ids())
+                os << " " << ptid+base;
+            os << "\n";
+        }
+        /* The boundary faces, used as such only by medit */
+        os << "Faces->Control volumes\n" << std::count(face_count.begin(), face_count.end(), 1) << "\n";
+        for (size_t i = 0; i < nf; i++)
+            if (face_count[i] == 1)
+                os << i+base << " " << 1+i%6 << "\n";
+        os << "Edges\n" << ne << "\n";
+        for (size_t i = ne; i-- > 0;)
+        {
+            auto ptids = s->edges[i].point_ids();
+            os << ptids[1] << " " << ptids[0] << "\n";
+        }
+    };
+
+    std::ofstream medit("flat_generic_mesh.medit3d");
+    medit.precision(17);
+    medit << "MeshVersionFormatted 2\nDimension 3\n";
+    write(medit, 0, "Volumes->Faces", "Volumes->Vertices", "Faces->Edges");
+
+    std::ofstream fvca6("flat_generic_mesh.msh");
+    fvca6.precision(17);
+    for (size_t i = 0; i < 16; i++)
+        fvca6 << "header line " << i << "\n";
+    write(fvca6, 1, "Volumes->faces", "Volumes->Verticess", "Faces->Edgess");
+}
+
+/* Load the file in a generic and in a flat mesh and compare them. The
+ * first round reads the file and each mesh writes its own cache, the second
+ * round reads the caches. */
+template<size_t DIM, typename LoadFunction>
+bool
+test_loader(const char *name, const std::string& filename, LoadFunction load)
+{
+    using flat_mesh_type = disk::flat_generic_mesh<double, DIM>;
+    using generic_mesh_type = disk::generic_mesh<double, DIM>;
+
+    const auto flat_cache = disk::mesh_cache_filename<flat_mesh_type>(filename);
+    const auto generic_cache = disk::mesh_cache_filename<generic_mesh_type>(filename);
+
+    bool success = flat_cache != generic_cache;
+
+    std::remove(flat_cache.c_str());
+    std::remove(generic_cache.c_str());
+    for (auto round : {"file", "cache"})
+    {
+        flat_mesh_type fmsh;
+        generic_mesh_type gmsh;
+        bool ok = load(filename.c_str(), fmsh) and load(filename.c_str(), gmsh);
+        ok = ok and gmsh.cells_size() > 0 and compare(gmsh, fmsh);
+        ok = ok and std::filesystem::exists(flat_cache) and std::filesystem::exists(generic_cache);
+        std::cout << name << " loader, " << round << ": " << (ok ? "PASS" : "FAIL") << std::endl;
+        success = success and ok;
+    }
+
+    std::remove(flat_cache.c_str());
+    std::remove(generic_cache.c_str());
+    std::remove(filename.c_str());
+    return success;
+}
+
+bool
+test_loaders(void)
+{
+    using T = double;
+
+    disk::generic_mesh<T, 2> msh2d;
+    auto mesher2d = disk::make_fvca5_hex_mesher(msh2d);
+    mesher2d.make_level(2);
+    write_2d_files(msh2d);
+
+    disk::simplicial_mesh<T, 3> msh3d;
+    auto mesher3d = disk::make_simple_mesher(msh3d);
+    mesher3d.refine();
+    write_3d_files(msh3d);
+
+    bool success = true;
+
+    success &= test_loader<2>("FVCA5", "flat_generic_mesh.typ1", [](const char *filename, auto& msh) {
+        return disk::load_mesh_fvca5_2d<T>(filename, msh);
+    });
+    success &= test_loader<2>("medit 2D", "flat_generic_mesh.medit2d", [](const char *filename, auto& msh) {
+        return disk::load_mesh_medit<T>(filename, msh);
+    });
+    success &= test_loader<3>("FVCA6", "flat_generic_mesh.msh", [](const char *filename, auto& msh) {
+        return disk::load_mesh_fvca6_3d<T>(filename, msh);
+    });
+    success &= test_loader<3>("medit 3D", "flat_generic_mesh.medit3d", [](const char *filename, auto& msh) {
+        return disk::load_mesh_medit<T>(filename, msh);
+    });
+
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    for (size_t level = 1; level < 4; level++)
+    {
+        disk::generic_mesh<T, 2> gmsh;
+        auto mesher = disk::make_fvca5_hex_mesher(gmsh);
+        mesher.make_level(level);
+
+        disk::flat_generic_mesh<T, 2> fmsh;
+        disk::make_flat_mesh(gmsh, fmsh);
+
+        bool ok = compare(gmsh, fmsh);
+        std::cout << "hexagons, level " << level << ": " << (ok ? "PASS" : "FAIL") << std::endl;
+        success = success and ok;
+    }
+
+    success = test_loaders() and success;
+
+    return success ? 0 : 1;
+}
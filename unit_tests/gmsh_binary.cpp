@@ -0,0 +1,167 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Write snapshots of a grid of triangles with a field at points inside the
+ * triangles through GmshAsyncWriter, change the field after each snapshot
+ * is queued, and read the binary Gmsh files back: each file must contain
+ * the field at the time of its snapshot. */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "diskpp/output/gmshBinary.hpp"
+
+using namespace disk;
+
+/* Snapshot of a n x n grid, two triangles per square, and a node at the
+ * barycenter of each triangle with the field value */
+GmshBinaryData
+snapshot(size_t n, const std::vector<double>& field)
+{
+    GmshBinaryData data;
+    data.reserveNodes((n + 1) * (n + 1) + 2 * n * n);
+    data.reserveElements(GMSH_TRIANGLE, 2 * n * n);
+    for (size_t j = 0; j <= n; j++)
+        for (size_t i = 0; i <= n; i++)
+            data.addNode(std::array<double, 3>{double(i) / n, double(j) / n, 0.0});
+
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            const int p0 = j * (n + 1) + i + 1;
+            const int t0[3] = {p0, p0 + 1, p0 + int(n) + 2};
+            const int t1[3] = {p0, p0 + int(n) + 2, p0 + int(n) + 1};
+            data.addElement(GMSH_TRIANGLE, t0);
+            data.addElement(GMSH_TRIANGLE, t1);
+        }
+    }
+
+    const int first = data.numberOfNodes() + 1;
+    auto& values = data.addNodeView("field", 1, first, 2 * n * n);
+    for (size_t k = 0; k < 2 * n * n; k++)
+    {
+        const int node = data.addNode(std::array<double, 3>{0.5, 0.5, 0.0});
+        data.addElement(GMSH_POINT, &node);
+        values[k] = field[k];
+    }
+    return data;
+}
+
+/* Read the field of a file written by snapshot(), return false if the
+ * file is not as expected */
+bool
+read_field(const std::string& filename, size_t n, std::vector<double>& field)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const std::string d = ss.str();
+
+    const size_t num_nodes = (n + 1) * (n + 1) + 2 * n * n;
+    const size_t num_elems = 4 * n * n;
+
+    std::ostringstream head;
+    head << "$MeshFormat\n2.2 1 8\n";
+    if (d.compare(0, head.str().size(), head.str()) != 0)
+        return false;
+
+    std::ostringstream nodes;
+    nodes << "$Nodes\n" << num_nodes << "\n";
+    size_t pos = d.find(nodes.str());
+    if (pos == std::string::npos)
+        return false;
+    pos += nodes.str().size() + num_nodes * (sizeof(int) + 3 * sizeof(double));
+    if (d.compare(pos, 11, "\n$EndNodes\n") != 0)
+        return false;
+
+    std::ostringstream elems;
+    elems << "$Elements\n" << num_elems << "\n";
+    pos = d.find(elems.str(), pos);
+    if (pos == std::string::npos)
+        return false;
+    pos += elems.str().size() + 2 * 3 * sizeof(int) + 2 * n * n * 6 * sizeof(int) + 2 * n * n * 4 * sizeof(int);
+    if (d.compare(pos, 14, "\n$EndElements\n") != 0)
+        return false;
+
+    std::ostringstream view;
+    view << "$NodeData\n1\n\"field\"\n1\n0.0\n3\n0\n1\n" << 2 * n * n << "\n";
+    pos = d.find(view.str(), pos);
+    if (pos == std::string::npos)
+        return false;
+    pos += view.str().size();
+
+    field.resize(2 * n * n);
+    for (size_t k = 0; k < 2 * n * n; k++)
+    {
+        int node;
+        std::memcpy(&node, d.data() + pos, sizeof(int));
+        std::memcpy(&field[k], d.data() + pos + sizeof(int), sizeof(double));
+        pos += sizeof(int) + sizeof(double);
+        if (node != int((n + 1) * (n + 1) + k + 1))
+            return false;
+    }
+    return d.compare(pos, 14, "\n$EndNodeData\n") == 0;
+}
+
+int main(void)
+{
+    const size_t n = 20;
+    const size_t num_files = 4;
+
+    bool success = true;
+
+    std::vector<std::vector<double>> expected;
+    {
+        GmshAsyncWriter writer;
+        std::vector<double> field(2 * n * n);
+        for (size_t f = 0; f < num_files; f++)
+        {
+            for (size_t k = 0; k < field.size(); k++)
+                field[k] = f * 1000.0 + k;
+            expected.push_back(field);
+
+            writer.write("gmsh_binary_" + std::to_string(f) + ".msh", snapshot(n, field));
+
+            /* the field changes while the file is written */
+            std::fill(field.begin(), field.end(), -1.0);
+        }
+        writer.wait();
+    }
+
+    for (size_t f = 0; f < num_files; f++)
+    {
+        const std::string filename = "gmsh_binary_" + std::to_string(f) + ".msh";
+        std::vector<double> field;
+        success = success and read_field(filename, n, field) and field == expected[f];
+        std::remove(filename.c_str());
+    }
+
+    /* errors of the writer thread are given to the caller */
+    bool error = false;
+    try
+    {
+        GmshAsyncWriter writer;
+        writer.write("/nonexistent_directory/gmsh_binary.msh", GmshBinaryData());
+        writer.wait();
+    }
+    catch (const std::runtime_error&)
+    {
+        error = true;
+    }
+    success = success and error;
+
+    std::cout << "gmsh binary: " << (success ? "PASS" : "FAIL") << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check the conversion of indices to ident_raw_t, which must refuse the
+ * indices that do not fit, and the identifiers of a mesh. The ident_raw_32
+ * target builds it with DISKPP_32BIT_INDICES. */
+
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/geometry/geometry.hpp"
+
+template<typename I>
+bool
+refused(I val)
+{
+    try {
+        disk::to_ident_raw(val);
+    }
+    catch (const std::overflow_error&) {
+        return true;
+    }
+    return false;
+}
+
+bool
+refused(const std::vector<size_t>& ids)
+{
+    try {
+        disk::convert_to<disk::point_identifier<2>>(ids);
+    }
+    catch (const std::overflow_error&) {
+        return true;
+    }
+    return false;
+}
+
+template<typename Id, typename I>
+bool
+refused_id(I val)
+{
+    try {
+        Id id(val);
+    }
+    catch (const std::overflow_error&) {
+        return true;
+    }
+    return false;
+}
+
+bool
+test_conversion(void)
+{
+    using id_type = disk::identifier<int, disk::ident_raw_t, 0>;
+
+    bool success = true;
+    success = success and disk::to_ident_raw(0) == 0;
+    success = success and disk::to_ident_raw(size_t(42)) == 42;
+    success = success and disk::to_ident_raw(disk::ident_raw_max) == disk::ident_raw_max;
+    success = success and refused(-1);
+    success = success and refused(int64_t(-1));
+
+    /* the largest index survives the round trip through an identifier */
+    id_type id(disk::to_ident_raw(disk::ident_raw_max));
+    success = success and size_t(disk::ident_raw_t(id)) == disk::ident_raw_max;
+
+#ifdef DISKPP_32BIT_INDICES
+    static_assert(sizeof(id_type) == sizeof(uint32_t));
+    success = success and refused(disk::ident_raw_max + 1);
+    success = success and refused(size_t(1) << 32);
+    success = success and refused(std::vector<size_t>{0, size_t(1) << 31});
+
+    /* the identifiers check the indices of other types, not narrow them */
+    success = success and size_t(disk::ident_raw_t(id_type(size_t(42)))) == 42;
+    success = success and refused_id<id_type>(size_t(1) << 32);
+    success = success and refused_id<id_type>(-1);
+#endif
+
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_mesh(Mesh& msh)
+{
+    auto mesher = disk::make_simple_mesher(msh);
+    for (size_t i = 0; i < 3; i++)
+        mesher.refine();
+
+    size_t cell_i = 0;
+    for (auto& cl : msh)
+    {
+        if (msh.lookup(cl) != cell_i)
+            return false;
+
+        auto fcs = faces(msh, cl);
+        auto tab_id = msh.face_ids(cell_i);
+        for (size_t i = 0; i < fcs.size(); i++)
+            if (msh.lookup(fcs[i]) != tab_id[i])
+                return false;
+
+        cell_i++;
+    }
+
+    return cell_i == msh.cells_size();
+}
+
+int main(void)
+{
+    using T = double;
+
+    disk::simplicial_mesh<T,2> msh_tri;
+    disk::cartesian_mesh<T,2> msh_quad;
+    disk::simplicial_mesh<T,3> msh_tet;
+
+    bool success = test_conversion();
+    success = success and test_mesh(msh_tri);
+    success = success and test_mesh(msh_quad);
+    success = success and test_mesh(msh_tet);
+
+    std::cout << "ident_raw: " << (success ? "PASS" : "FAIL") << " (";
+    std::cout << 8*sizeof(disk::ident_raw_t) << " bit)" << std::endl;
+
+    return success ? 0 : 1;
+}
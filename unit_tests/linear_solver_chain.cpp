@@ -0,0 +1,196 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check the choice of the linear solver in the Newton iterations: the
+ * requested solver is tried first, then the direct solvers of the build,
+ * the unavailable ones are skipped and the failure of all of them is
+ * reported. The last tests run the chain on real solvers: a CG that does
+ * not converge falls back to a direct solver, a singular matrix makes all
+ * the solvers fail. */
+
+#include <iostream>
+#include <vector>
+
+#include "diskpp/mechanics/NewtonSolver/NewtonSolverParameters.hpp"
+#include "diskpp/solvers/solver.hpp"
+
+using namespace disk;
+
+using LST = LinearSolverType;
+
+bool
+test_chain(void)
+{
+    bool success = true;
+
+    const std::vector<LST> from_cg = {LST::ITERATIVE_CG, LST::PARDISO, LST::MUMPS, LST::SPARSE_LU};
+    success = success and linear_solver_chain(LST::ITERATIVE_CG) == from_cg;
+
+    const std::vector<LST> from_lu = {LST::SPARSE_LU, LST::PARDISO, LST::MUMPS};
+    success = success and linear_solver_chain(LST::SPARSE_LU) == from_lu;
+
+    const std::vector<LST> from_mumps = {LST::MUMPS, LST::PARDISO, LST::SPARSE_LU};
+    success = success and linear_solver_chain(LST::MUMPS) == from_mumps;
+
+    std::cout << "linear_solver_chain: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+bool
+test_fallback(void)
+{
+    bool success = true;
+
+    std::vector<LST> tried;
+    auto record = [&](bool result) {
+        return [&tried, result](LST ls) {
+            tried.push_back(ls);
+            return result;
+        };
+    };
+    auto all = [](LST) { return true; };
+    auto no_pardiso = [](LST ls) { return ls != LST::PARDISO and ls != LST::MUMPS; };
+
+    /* The requested solver works: nothing else is tried */
+    auto solved = solve_with_fallback(LST::ITERATIVE_CG, all, record(true));
+    success = success and solved == LST::ITERATIVE_CG and tried == std::vector<LST>{LST::ITERATIVE_CG};
+
+    /* The unavailable solvers are skipped */
+    tried.clear();
+    solved = solve_with_fallback(LST::PARDISO, no_pardiso, record(true));
+    success = success and solved == LST::SPARSE_LU and tried == std::vector<LST>{LST::SPARSE_LU};
+
+    /* The solvers fail one after the other */
+    tried.clear();
+    solved = solve_with_fallback(LST::ITERATIVE_CG, all, [&](LST ls) {
+        tried.push_back(ls);
+        return ls == LST::SPARSE_LU;
+    });
+    const std::vector<LST> expected = {LST::ITERATIVE_CG, LST::PARDISO, LST::MUMPS, LST::SPARSE_LU};
+    success = success and solved == LST::SPARSE_LU and tried == expected;
+
+    /* All of them fail */
+    tried.clear();
+    solved = solve_with_fallback(LST::SPARSE_LDLT, all, record(false));
+    success = success and not solved and tried.size() == 4;
+
+    std::cout << "solve_with_fallback: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+/* The solvers of NewtonIteration applied to A x = b */
+struct chain_solver
+{
+    const Eigen::SparseMatrix<double>& A;
+    const dynamic_vector<double>&      b;
+    dynamic_vector<double>             x;
+    size_t                             cg_max_iter;
+
+    static bool
+    available(LST ls)
+    {
+        if (ls == LST::ITERATIVE_CG)
+            return true;
+        return solvers::factorized_solver<double>::available(factorization(ls));
+    }
+
+    static solvers::factorization_type
+    factorization(LST ls)
+    {
+        switch (ls)
+        {
+            case LST::PARDISO: return solvers::factorization_type::pardiso_lu;
+            case LST::MUMPS: return solvers::factorization_type::mumps;
+            case LST::SPARSE_LDLT: return solvers::factorization_type::sparse_ldlt;
+            default: return solvers::factorization_type::sparse_lu;
+        }
+    }
+
+    bool
+    operator()(LST ls)
+    {
+        x = dynamic_vector<double>::Zero(b.size());
+        if (ls == LST::ITERATIVE_CG)
+        {
+            solvers::conjugated_gradient_params<double> cgp;
+            cgp.rr_tol   = 1e-10;
+            cgp.max_iter = cg_max_iter;
+            solvers::identity_preconditioner<double> pc;
+            return solvers::conjugated_gradient(cgp, A, b, x, pc).converged();
+        }
+
+        solvers::factorized_solver<double> solver(factorization(ls));
+        if (!solver.factorize(A))
+            return false;
+        x = solver.solve(b);
+        return x.allFinite();
+    }
+};
+
+Eigen::SparseMatrix<double>
+make_laplacian(size_t N, double diag)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t i = 0; i < N; i++)
+    {
+        triplets.push_back( Eigen::Triplet<double>(i, i, diag) );
+        if (i > 0)
+            triplets.push_back( Eigen::Triplet<double>(i, i-1, -1.0) );
+        if (i < N-1)
+            triplets.push_back( Eigen::Triplet<double>(i, i+1, -1.0) );
+    }
+
+    Eigen::SparseMatrix<double> A(N, N);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+bool
+test_real_solvers(void)
+{
+    bool success = true;
+    const size_t N = 200;
+
+    const Eigen::SparseMatrix<double> A = make_laplacian(N, 2.0);
+    const dynamic_vector<double> b = dynamic_vector<double>::Ones(N);
+
+    /* CG converges */
+    chain_solver converging{A, b, {}, 2*N};
+    auto solved = solve_with_fallback(LST::ITERATIVE_CG, chain_solver::available, converging);
+    success = success and solved == LST::ITERATIVE_CG and (A*converging.x - b).norm() < 1e-8 * b.norm();
+
+    /* Five CG iterations are not enough: a direct solver takes over */
+    chain_solver stalling{A, b, {}, 5};
+    solved = solve_with_fallback(LST::ITERATIVE_CG, chain_solver::available, stalling);
+    success = success and solved and *solved != LST::ITERATIVE_CG and
+              (A*stalling.x - b).norm() < 1e-10 * b.norm();
+
+    /* Singular matrix: every solver fails */
+    Eigen::SparseMatrix<double> Z(N, N);
+    Z.setIdentity();
+    Z.coeffRef(N/2, N/2) = 0.0;
+    chain_solver singular{Z, b, {}, 2*N};
+    solved = solve_with_fallback(LST::SPARSE_LU, chain_solver::available, singular);
+    success = success and not solved;
+
+    std::cout << "fallback on real solvers: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    bool success = true;
+
+    success &= test_chain();
+    success &= test_fallback();
+    success &= test_real_solvers();
+
+    return success ? 0 : 1;
+}
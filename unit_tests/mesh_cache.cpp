@@ -0,0 +1,210 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Save meshes in the binary cache and load them back: the storage must be
+ * identical. Caches that do not match the source file, the mesh type or
+ * that are truncated must be refused. Then load a Netgen file twice, the
+ * second time from the cache written by the loader. */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "diskpp/loaders/loader.hpp"
+#include "diskpp/mesh/meshgen.hpp"
+
+template<typename Element>
+bool
+same_elements(const std::vector<Element>& a, const std::vector<Element>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if ( not (a[i] == b[i]) )
+            return false;
+
+        auto pa = a[i].point_ids();
+        auto pb = b[i].point_ids();
+        if ( not std::equal(pa.begin(), pa.end(), pb.begin(), pb.end()) )
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+same_storage(const Mesh& ma, const Mesh& mb)
+{
+    auto a = ma.backend_storage();
+    auto b = mb.backend_storage();
+
+    if (a->points.size() != b->points.size())
+        return false;
+    for (size_t i = 0; i < a->points.size(); i++)
+        for (size_t d = 0; d < Mesh::dimension; d++)
+            if (a->points[i][d] != b->points[i][d])
+                return false;
+
+    bool same = same_elements(a->nodes, b->nodes) and same_elements(a->edges, b->edges);
+    if constexpr (Mesh::dimension > 1)
+        same = same and same_elements(a->surfaces, b->surfaces);
+    if constexpr (Mesh::dimension > 2)
+        same = same and same_elements(a->volumes, b->volumes);
+
+    same = same and a->boundary_info.size() == b->boundary_info.size();
+    for (size_t i = 0; same and i < a->boundary_info.size(); i++)
+    {
+        auto& ba = a->boundary_info[i];
+        auto& bb = b->boundary_info[i];
+        same = ba.id() == bb.id() and ba.tag() == bb.tag() and
+               ba.is_boundary() == bb.is_boundary() and ba.is_internal() == bb.is_internal();
+    }
+
+    same = same and a->subdomain_info.size() == b->subdomain_info.size();
+    for (size_t i = 0; same and i < a->subdomain_info.size(); i++)
+        same = a->subdomain_info[i].id() == b->subdomain_info[i].id() and
+               a->subdomain_info[i].tag() == b->subdomain_info[i].tag();
+
+    return same;
+}
+
+void
+write_file(const std::string& filename, const std::string& contents)
+{
+    std::ofstream ofs(filename);
+    ofs << contents;
+}
+
+template<typename Mesh>
+bool
+test_roundtrip(Mesh& msh, const char *name)
+{
+    const std::string source = "mesh_cache_test.txt";
+    write_file(source, name);
+
+    Mesh loaded;
+    bool success = disk::save_mesh_cache(source, msh) and
+                   disk::load_mesh_cache(source, loaded) and
+                   same_storage(msh, loaded);
+
+    /* The lookups work on the loaded mesh without sorting it */
+    size_t cell_i = 0;
+    for (auto itor = loaded.cells_begin(); itor != loaded.cells_end(); itor++, cell_i++)
+        success = success and loaded.lookup(*itor) == cell_i;
+
+    /* Another mesh type, also with the cache of Mesh under its name */
+    using other_mesh_type = disk::simplicial_mesh<float, 2>;
+    const auto cache = disk::mesh_cache_filename<Mesh>(source);
+    const auto other_cache = disk::mesh_cache_filename<other_mesh_type>(source);
+    success = success and cache != other_cache;
+    other_mesh_type other;
+    success = success and not disk::load_mesh_cache(source, other);
+    std::filesystem::copy_file(cache, other_cache, std::filesystem::copy_options::overwrite_existing);
+    success = success and not disk::load_mesh_cache(source, other);
+    std::remove(other_cache.c_str());
+
+    /* Truncated cache */
+    auto size = std::filesystem::file_size(cache);
+    std::filesystem::resize_file(cache, size - 1);
+    Mesh truncated;
+    success = success and not disk::load_mesh_cache(source, truncated);
+
+    /* Modified source */
+    disk::save_mesh_cache(source, msh);
+    write_file(source, std::string(name) + " modified");
+    Mesh stale;
+    success = success and not disk::load_mesh_cache(source, stale);
+    success = success and stale.cells_size() == 0;
+
+    std::remove(cache.c_str());
+    std::remove(source.c_str());
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+const char *netgen_square =
+    "4\n0 0\n1 0\n1 1\n0 1\n"
+    "2\n1 1 2 3\n1 1 3 4\n"
+    "4\n1 1 2\n2 2 3\n3 3 4\n4 4 1\n";
+
+const char *netgen_squares =
+    "6\n0 0\n1 0\n1 1\n0 1\n2 0\n2 1\n"
+    "4\n1 1 2 3\n1 1 3 4\n1 2 5 6\n1 2 6 3\n"
+    "6\n1 1 2\n1 2 5\n2 5 6\n3 6 3\n3 3 4\n4 4 1\n";
+
+bool
+test_loader(void)
+{
+    const std::string source = "mesh_cache_test.mesh2d";
+    const auto cache = disk::mesh_cache_filename<disk::simplicial_mesh<double, 2>>(source);
+    write_file(source, netgen_square);
+
+    /* First load: from the text file, writes the cache */
+    disk::simplicial_mesh<double, 2> msh_text;
+    bool success = disk::load_mesh_netgen(source.c_str(), msh_text);
+    success = success and std::filesystem::exists(cache);
+
+    /* Second load: from the cache */
+    disk::simplicial_mesh<double, 2> msh_cache;
+    success = success and disk::load_mesh_netgen(source.c_str(), msh_cache);
+    success = success and same_storage(msh_text, msh_cache) and msh_cache.cells_size() == 2;
+
+    /* The cache of a modified file is not used, and it is rewritten */
+    write_file(source, netgen_squares);
+    disk::simplicial_mesh<double, 2> msh_new;
+    success = success and disk::load_mesh_netgen(source.c_str(), msh_new);
+    success = success and msh_new.cells_size() == 4;
+    disk::simplicial_mesh<double, 2> msh_new_cache;
+    success = success and disk::load_mesh_cache(source, msh_new_cache);
+    success = success and same_storage(msh_new, msh_new_cache);
+
+    std::remove(cache.c_str());
+    std::remove(source.c_str());
+
+    std::cout << "netgen loader: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    mesher_tri.refine();
+    mesher_tri.refine();
+    success = test_roundtrip(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    mesher_tet.refine();
+    success = test_roundtrip(msh_tet, "tetrahedra") and success;
+
+    disk::cartesian_mesh<T, 2> msh_quad;
+    auto mesher_quad = disk::make_simple_mesher(msh_quad);
+    mesher_quad.refine();
+    success = test_roundtrip(msh_quad, "quadrangles") and success;
+
+    disk::generic_mesh<T, 2> msh_hex;
+    auto mesher_hex = disk::make_fvca5_hex_mesher(msh_hex);
+    mesher_hex.make_level(2);
+    success = test_roundtrip(msh_hex, "hexagons") and success;
+
+    success = test_loader() and success;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that the indexed lookup of cells and faces and the cell-to-face
+ * incidence table agree with the binary search on the element vectors, also
+ * after the storage shared by several copies of a mesh is modified. */
+
+#include <algorithm>
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/geometry/geometry.hpp"
+
+template<typename Mesh>
+bool
+test_lookup(const Mesh& msh)
+{
+    size_t cell_i = 0;
+    for (auto itor = msh.cells_begin(); itor != msh.cells_end(); itor++, cell_i++)
+    {
+        if (msh.lookup(*itor) != cell_i)
+            return false;
+
+        auto fcs = faces(msh, *itor);
+        auto fcs_id = faces_id(msh, *itor);
+        auto tab_id = msh.face_ids(cell_i);
+        if (fcs.size() != fcs_id.size() or fcs.size() != tab_id.size())
+            return false;
+
+        for (size_t i = 0; i < fcs.size(); i++)
+        {
+            auto fi = disk::find_element_id(msh.faces_begin(), msh.faces_end(), fcs[i]);
+            if (not fi.first)
+                return false;
+
+            if (msh.lookup(fcs[i]) != fi.second or fcs_id[i] != fi.second or tab_id[i] != fi.second)
+                return false;
+        }
+    }
+
+    size_t face_i = 0;
+    for (auto itor = msh.faces_begin(); itor != msh.faces_end(); itor++, face_i++)
+        if (msh.lookup(*itor) != face_i or offset(msh, *itor) != face_i)
+            return false;
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+test_refined(Mesh& msh, const char *name)
+{
+    auto mesher = disk::make_simple_mesher(msh);
+    bool success = true;
+    for (size_t i = 0; i < 3; i++)
+    {
+        /* The lookup tables must follow the refinement */
+        mesher.refine();
+        success = success and test_lookup(msh);
+    }
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+/* Modify the storage through a copy of the mesh without changing the number
+ * of elements: the other copies share the storage and must not use stale
+ * lookup tables. */
+template<typename Mesh>
+bool
+test_shared_copies(Mesh& msh, const char *name)
+{
+    Mesh copy = msh;
+    bool success = test_lookup(msh);
+    auto version = msh.geometry_version();
+
+    std::reverse(copy.cells_begin(), copy.cells_end());
+    auto& subdomain_info = copy.backend_storage()->subdomain_info;
+    std::reverse(subdomain_info.begin(), subdomain_info.end());
+    copy.reset_lookup_tables();
+
+    success = success and msh.geometry_version() != version and test_lookup(msh);
+    success = success and msh.lookup(*msh.cells_begin()) == 0;
+
+    std::cout << name << ", shared copies: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    success = test_refined(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    success = test_refined(msh_tet, "tetrahedra") and success;
+
+    disk::cartesian_mesh<T, 2> msh_quad;
+    success = test_refined(msh_quad, "quadrangles") and success;
+
+    success = test_shared_copies(msh_tri, "triangles") and success;
+    success = test_shared_copies(msh_tet, "tetrahedra") and success;
+
+    disk::generic_mesh<T, 2> msh_hex;
+    auto mesher = disk::make_fvca5_hex_mesher(msh_hex);
+    mesher.make_level(2);
+    bool hex_success = test_lookup(msh_hex);
+    std::cout << "hexagons: " << (hex_success ? "PASS" : "FAIL") << std::endl;
+    success = hex_success and success;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that consecutive points of the Hilbert curve are neighbours. Then
+ * shuffle meshes and renumber them along the Hilbert curve and with RCM:
+ * cells and faces must keep their geometry, their boundary and subdomain
+ * information and their incidence, the lookups must work on the renumbered
+ * mesh and the faces of the cells must get closer. Renumbered meshes must
+ * still be refined correctly, and a renumbering done through a copy of a
+ * mesh must be seen by the other copies. */
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/mesh/mesh_renumbering.hpp"
+#include "diskpp/geometry/geometry.hpp"
+
+template<size_t DIM>
+bool
+test_hilbert_curve(size_t bits)
+{
+    const size_t side = size_t(1) << bits;
+    size_t num_points = 1;
+    for (size_t d = 0; d < DIM; d++)
+        num_points *= side;
+
+    std::map<uint64_t, std::array<uint32_t, DIM>> curve;
+    for (size_t i = 0; i < num_points; i++)
+    {
+        std::array<uint32_t, DIM> X;
+        size_t rem = i;
+        for (size_t d = 0; d < DIM; d++)
+        {
+            X[d] = rem % side;
+            rem /= side;
+        }
+        curve[ disk::priv::hilbert_key<DIM>(X, bits) ] = X;
+    }
+
+    bool success = curve.size() == num_points and curve.rbegin()->first == num_points-1;
+
+    for (auto itor = std::next(curve.begin()); success and itor != curve.end(); itor++)
+    {
+        auto& a = std::prev(itor)->second;
+        auto& b = itor->second;
+        size_t dist = 0;
+        for (size_t d = 0; d < DIM; d++)
+            dist += (a[d] > b[d]) ? a[d] - b[d] : b[d] - a[d];
+        success = dist == 1;
+    }
+
+    std::cout << "Hilbert curve " << DIM << "D: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+template<typename Point>
+bool
+same_point(const Point& a, const Point& b)
+{
+    return (a - b).to_vector().norm() < 1e-12;
+}
+
+template<typename Mesh>
+struct mesh_snapshot
+{
+    typedef typename Mesh::point_type   point_type;
+
+    std::vector<point_type>             cell_centers, face_centers;
+    std::vector<double>                 cell_measures, face_measures;
+    std::vector<std::vector<size_t>>    cell_faces;
+    std::vector<disk::boundary_descriptor>      boundary_info;
+    std::vector<disk::subdomain_descriptor>     subdomain_info;
+    double                              face_spread;
+
+    mesh_snapshot(const Mesh& msh)
+        : boundary_info(msh.backend_storage()->boundary_info),
+          subdomain_info(msh.backend_storage()->subdomain_info),
+          face_spread(0.0)
+    {
+        for (size_t i = 0; i < msh.cells_size(); i++)
+        {
+            auto cl = msh[i];
+            cell_centers.push_back( barycenter(msh, cl) );
+            cell_measures.push_back( measure(msh, cl) );
+
+            auto fids = msh.face_ids(i);
+            cell_faces.push_back( std::vector<size_t>(fids.begin(), fids.end()) );
+            auto [fmin, fmax] = std::minmax_element(fids.begin(), fids.end());
+            face_spread += double(*fmax - *fmin)/msh.cells_size();
+        }
+
+        for (auto itor = msh.faces_begin(); itor != msh.faces_end(); itor++)
+        {
+            face_centers.push_back( barycenter(msh, *itor) );
+            face_measures.push_back( measure(msh, *itor) );
+        }
+    }
+};
+
+template<typename Mesh>
+bool
+check_lookups(const Mesh& msh)
+{
+    for (size_t i = 0; i < msh.cells_size(); i++)
+    {
+        auto cl = msh[i];
+        if (msh.lookup(cl) != i)
+            return false;
+
+        auto fcs = faces(msh, cl);
+        auto fcs_id = faces_id(msh, cl);
+        auto tab_id = msh.face_ids(i);
+        if (fcs.size() != fcs_id.size() or fcs.size() != tab_id.size())
+            return false;
+
+        for (size_t j = 0; j < fcs.size(); j++)
+            if (msh.lookup(fcs[j]) != tab_id[j] or size_t(fcs_id[j]) != tab_id[j])
+                return false;
+    }
+
+    size_t face_i = 0;
+    for (auto itor = msh.faces_begin(); itor != msh.faces_end(); itor++, face_i++)
+        if (msh.lookup(*itor) != face_i)
+            return false;
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+test_renumbering(Mesh& msh, const char *name, disk::renumbering_method method)
+{
+    using snapshot = mesh_snapshot<Mesh>;
+
+    /* Start from a mesh numbered at random */
+    std::mt19937 rng(42);
+    disk::mesh_permutation shuffle;
+    shuffle.cells.resize(msh.cells_size());
+    shuffle.faces.resize(msh.faces_size());
+    shuffle.points.resize(msh.points_size());
+    for (auto vec : {&shuffle.cells, &shuffle.faces, &shuffle.points})
+    {
+        std::iota(vec->begin(), vec->end(), 0);
+        std::shuffle(vec->begin(), vec->end(), rng);
+    }
+    disk::permute_mesh(msh, shuffle);
+
+    const snapshot before(msh);
+    const auto num_boundary = msh.boundary_faces_size();
+    bool success = check_lookups(msh);
+
+    auto perm = disk::renumber_mesh(msh, method);
+    const snapshot after(msh);
+
+    success = success and perm.cells.size() == msh.cells_size() and
+                   perm.faces.size() == msh.faces_size() and
+                   perm.points.size() == msh.points_size() and
+                   msh.boundary_faces_size() == num_boundary;
+
+    for (size_t i = 0; success and i < msh.cells_size(); i++)
+    {
+        auto old_i = perm.cells[i];
+        success = same_point(after.cell_centers[i], before.cell_centers[old_i]) and
+                  std::abs(after.cell_measures[i] - before.cell_measures[old_i]) < 1e-12;
+
+        if (not before.subdomain_info.empty())
+            success = success and after.subdomain_info[i].id() == before.subdomain_info[old_i].id();
+
+        std::vector<size_t> old_faces;
+        for (auto& fid : after.cell_faces[i])
+            old_faces.push_back( perm.faces[fid] );
+        std::sort(old_faces.begin(), old_faces.end());
+        auto expected = before.cell_faces[old_i];
+        std::sort(expected.begin(), expected.end());
+        success = success and old_faces == expected;
+    }
+
+    for (size_t i = 0; success and i < msh.faces_size(); i++)
+    {
+        auto old_i = perm.faces[i];
+        auto& ba = after.boundary_info[i];
+        auto& bb = before.boundary_info[old_i];
+        success = same_point(after.face_centers[i], before.face_centers[old_i]) and
+                  std::abs(after.face_measures[i] - before.face_measures[old_i]) < 1e-12 and
+                  ba.is_boundary() == bb.is_boundary() and ba.id() == bb.id();
+    }
+
+    success = success and check_lookups(msh) and after.face_spread < before.face_spread;
+
+    std::cout << name << (method == disk::renumbering_method::hilbert ? ", Hilbert: " : ", RCM: ");
+    std::cout << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_mesh(const Mesh& msh, const char *name)
+{
+    bool success = true;
+    for (auto method : {disk::renumbering_method::hilbert, disk::renumbering_method::rcm})
+    {
+        /* Fresh copy of the storage for each method */
+        Mesh copy;
+        *copy.backend_storage() = *msh.backend_storage();
+        success = test_renumbering(copy, name, method) and success;
+    }
+
+    return success;
+}
+
+/* Sorted centers of the cells, rounded to compare different numberings */
+template<typename Mesh>
+std::vector<std::array<double, Mesh::dimension>>
+cell_centers(const Mesh& msh)
+{
+    std::vector<std::array<double, Mesh::dimension>> ret;
+    for (auto& cl : msh)
+    {
+        auto bar = barycenter(msh, cl);
+        std::array<double, Mesh::dimension> c;
+        for (size_t d = 0; d < Mesh::dimension; d++)
+            c[d] = std::round(bar[d]*1e9)/1e9;
+        ret.push_back(c);
+    }
+
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+/* Refine a renumbered mesh: the mesher must find the faces of the cells
+ * although they are not sorted anymore. The result must be the mesh
+ * obtained without renumbering. */
+template<typename Mesh>
+bool
+test_refine_renumbered(const char *name)
+{
+    Mesh ref, msh;
+    auto mesher_ref = disk::make_simple_mesher(ref);
+    auto mesher = disk::make_simple_mesher(msh);
+    mesher_ref.refine();
+    mesher.refine();
+
+    disk::renumber_mesh(msh, disk::renumbering_method::hilbert);
+
+    bool success = true;
+    try {
+        mesher_ref.refine();
+        mesher.refine();
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        success = false;
+    }
+
+    success = success and msh.cells_size() == ref.cells_size() and
+              msh.faces_size() == ref.faces_size() and
+              msh.points_size() == ref.points_size() and
+              check_lookups(msh);
+
+    /* The splitting of the tetrahedra depends on the order of their
+     * vertices: in 3D the cells are not the same, only their volume is */
+    if constexpr (Mesh::dimension == 2)
+        success = success and cell_centers(msh) == cell_centers(ref);
+
+    double measure_msh = 0.0, measure_ref = 0.0;
+    for (auto& cl : msh)
+        measure_msh += measure(msh, cl);
+    for (auto& cl : ref)
+        measure_ref += measure(ref, cl);
+    success = success and std::abs(measure_msh - measure_ref) < 1e-12;
+
+    for (auto& id : ref.boundary_id_list())
+        success = success and msh.boundary_faces_size(id) == ref.boundary_faces_size(id);
+
+    std::cout << name << ", refinement after renumbering: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+/* Renumber a mesh through one of its copies: the copies share the storage,
+ * so all of them must see the new numbering. */
+bool
+test_shared_copies(void)
+{
+    disk::simplicial_mesh<double, 2> msh;
+    auto mesher = disk::make_simple_mesher(msh);
+    mesher.refine();
+    mesher.refine();
+
+    auto copy = msh;
+    bool success = check_lookups(msh);
+
+    disk::renumber_mesh(copy, disk::renumbering_method::rcm);
+
+    success = success and check_lookups(msh);
+    size_t cell_i = 0;
+    for (auto itor = msh.cells_begin(); itor != msh.cells_end(); itor++, cell_i++)
+        success = success and offset(msh, *itor) == cell_i;
+
+    std::cout << "shared copies: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+bool
+test_invalid_permutation(void)
+{
+    disk::simplicial_mesh<double, 2> msh;
+    auto mesher = disk::make_simple_mesher(msh);
+    mesher.refine();
+
+    disk::mesh_permutation perm;
+    perm.cells.assign(msh.cells_size(), 0);
+
+    bool success = false;
+    try {
+        disk::permute_mesh(msh, perm);
+    }
+    catch (const std::invalid_argument&) {
+        success = true;
+    }
+
+    std::cout << "invalid permutation: " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    success = test_hilbert_curve<2>(5) and success;
+    success = test_hilbert_curve<3>(4) and success;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    for (size_t i = 0; i < 4; i++)
+        mesher_tri.refine();
+    success = test_mesh(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    for (size_t i = 0; i < 2; i++)
+        mesher_tet.refine();
+    success = test_mesh(msh_tet, "tetrahedra") and success;
+
+    disk::cartesian_mesh<T, 2> msh_quad;
+    auto mesher_quad = disk::make_simple_mesher(msh_quad);
+    for (size_t i = 0; i < 4; i++)
+        mesher_quad.refine();
+    success = test_mesh(msh_quad, "quadrangles") and success;
+
+    disk::generic_mesh<T, 2> msh_hex;
+    auto mesher_hex = disk::make_fvca5_hex_mesher(msh_hex);
+    mesher_hex.make_level(3);
+    success = test_mesh(msh_hex, "hexagons") and success;
+
+    success = test_refine_renumbered<disk::simplicial_mesh<T, 2>>("triangles") and success;
+    success = test_refine_renumbered<disk::simplicial_mesh<T, 3>>("tetrahedra") and success;
+    success = test_refine_renumbered<disk::cartesian_mesh<T, 2>>("quadrangles") and success;
+
+    success = test_shared_copies() and success;
+    success = test_invalid_permutation() and success;
+
+    return success ? 0 : 1;
+}
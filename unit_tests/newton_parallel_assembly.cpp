@@ -0,0 +1,93 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Test for the multithreaded assembly of the Newton solver: the cell
+ * systems are added to the global system in the order of the cells, so a
+ * plasticity computation with several threads must give bitwise the same
+ * iterations and displacements as the serial one. */
+
+#include <iostream>
+
+#include "diskpp/boundary_conditions/boundary_conditions.hpp"
+#include "diskpp/mechanics/NewtonSolver/NewtonSolver.hpp"
+#include "diskpp/mechanics/behaviors/laws/behaviorlaws.hpp"
+#include "diskpp/mesh/meshgen.hpp"
+
+using namespace disk;
+
+struct run_result
+{
+    bool   convergence;
+    size_t iterations;
+    double l2_norm, h1_norm;
+};
+
+template<typename Mesh>
+run_result
+run(const Mesh& msh, int num_threads)
+{
+    using T           = typename Mesh::coordinate_type;
+    using point_type  = typename Mesh::point_type;
+    using result_type = static_vector<T, 2>;
+
+    MaterialData<T> md;
+    md.setMu(70, 0.3);
+    md.setLambda(70, 0.3);
+    md.setK(0.0);
+    md.setH(0.135);
+    md.setSigma_y0(0.243);
+
+    NewtonSolverParameter<T> rp;
+    rp.setFaceDegree(1);
+    rp.setCellDegree(1);
+    rp.setGradDegree(1);
+    rp.setStabilizationParameter(2.0);
+    rp.setNumThreads(num_threads);
+    rp.m_time_step.front() = std::make_pair(1.0, 4);
+
+    auto zero = [](const point_type&) -> result_type { return result_type{0, 0}; };
+    auto load = [](const point_type& p) -> result_type { return result_type{2.0, 2.0 * p.x()}; };
+
+    vector_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere(zero);
+
+    mechanics::NewtonSolver<Mesh> nl(msh, bnd, rp);
+    nl.addBehavior(DeformationMeasure::SMALL_DEF, LawType::LINEAR_HARDENING);
+    nl.addMaterialData(md);
+    nl.initial_guess(zero);
+
+    auto si = nl.compute(load);
+
+    return run_result{nl.convergence(), si.m_iter, nl.compute_l2_displacement_error(zero),
+                      nl.compute_H1_error(zero)};
+}
+
+int main(void)
+{
+    simplicial_mesh<double, 2> msh;
+    auto mesher = make_simple_mesher(msh);
+    for (size_t i = 0; i < 2; i++)
+        mesher.refine();
+
+    const auto serial = run(msh, 1);
+
+    bool success = serial.convergence and serial.iterations > 0;
+    for (int num_threads : {2, 4})
+    {
+        const auto parallel = run(msh, num_threads);
+        success = success and parallel.convergence == serial.convergence and
+                  parallel.iterations == serial.iterations and parallel.l2_norm == serial.l2_norm and
+                  parallel.h1_norm == serial.h1_norm;
+    }
+
+    std::cout << "Newton assembly with 1, 2 and 4 threads: " << (success ? "PASS" : "FAIL") << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Store random operators in OperatorStore with all the combinations of the
+ * options and check that they are read back correctly. */
+
+#include <iostream>
+
+#include "diskpp/mechanics/NewtonSolver/OperatorStore.hpp"
+
+using namespace disk;
+using namespace disk::mechanics;
+
+template<typename T>
+bool
+test_store(bool symmetric, bool single_precision)
+{
+    const size_t num_ops = 2000;
+
+    std::vector<dynamic_matrix<T>> ref;
+    OperatorStore<T> store(symmetric, single_precision);
+    store.reserve(num_ops);
+    for (size_t i = 0; i < num_ops; i++)
+    {
+        const size_t rows = 5 + i % 40;
+        const size_t cols = symmetric ? rows : 3 + i % 17;
+        dynamic_matrix<T> M = dynamic_matrix<T>::Random(rows, cols);
+        if (symmetric)
+            M = (M + M.transpose()).eval();
+
+        ref.push_back(M);
+        store.push_back(M);
+    }
+
+    const T tol = single_precision ? 1e-6 : 0.0;
+
+    bool success = (store.size() == num_ops);
+    dynamic_matrix<T> buffer;
+    for (size_t i = 0; i < num_ops; i++)
+    {
+        const auto M = store.get(i, buffer);
+        success = success and M.rows() == ref[i].rows() and M.cols() == ref[i].cols();
+        success = success and (M - ref[i]).norm() <= tol * ref[i].norm();
+    }
+
+    success = success and store.at(7) == store[7];
+
+    /* Without the compact options the operators are mapped in the pool, one
+     * after the other, and the buffer is not used */
+    const bool compact = symmetric or single_precision;
+    success = success and (store.get(3, buffer).data() == buffer.data()) == compact;
+    if (not compact)
+    {
+        const auto M3 = store.get(3);
+        const auto M4 = store.get(4);
+        success = success and M3.data() == store.get(3, buffer).data();
+        success = success and M4.data() == M3.data() + M3.size();
+    }
+
+    /* symmetric and float storage must actually save memory */
+    if (symmetric or single_precision)
+        success = success and store.memory() < store.memoryDynamicMatrices();
+
+    std::cout << "symmetric " << symmetric << ", single precision " << single_precision;
+    std::cout << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+    for (bool symmetric : {false, true})
+        for (bool single_precision : {false, true})
+            success = test_store<T>(symmetric, single_precision) and success;
+
+    return success ? 0 : 1;
+}
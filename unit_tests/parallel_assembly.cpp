@@ -0,0 +1,150 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Test for the multithreaded assembly: the system obtained with different
+ * numbers of threads must be bitwise identical to the serial one. */
+
+#include <iostream>
+#include <algorithm>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho"
+
+using namespace disk;
+
+template<typename T>
+bool
+bitwise_equal(const Eigen::SparseMatrix<T>& A, const Eigen::SparseMatrix<T>& B)
+{
+    if (A.nonZeros() != B.nonZeros())
+        return false;
+
+    return std::equal(A.valuePtr(), A.valuePtr() + A.nonZeros(), B.valuePtr()) and
+           std::equal(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros(), B.innerIndexPtr());
+}
+
+template<typename Mesh>
+bool
+test_scalar_assembly(const Mesh& msh)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+
+    hho_degree_info hdi(1, 1);
+
+    auto f = [](const point_type& pt) { return std::sin(M_PI * pt.x()); };
+
+    scalar_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere(f);
+
+    auto local_contrib = [&](const typename Mesh::cell_type& cl) {
+        auto cb = make_scalar_monomial_basis(msh, cl, hdi.cell_degree());
+        auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+        auto stab = make_scalar_hho_stabilization(msh, cl, gr.first, hdi);
+        dynamic_matrix<T> A = gr.second + stab;
+        dynamic_vector<T> rhs = make_rhs(msh, cl, cb, f);
+        return make_scalar_static_condensation(msh, cl, hdi, A, rhs);
+    };
+
+    auto serial = make_scalar_primal_hho_assembler(msh, hdi, bnd);
+    for (auto& cl : msh)
+    {
+        auto [lhs, rhs] = local_contrib(cl);
+        serial.assemble(msh, cl, bnd, lhs, rhs);
+    }
+    serial.finalize();
+
+    bool success = true;
+    for (size_t nt : {1, 2, 3, 8})
+    {
+        auto parallel = make_scalar_primal_hho_assembler(msh, hdi, bnd);
+        parallel.assemble(msh, bnd, local_contrib, nt);
+        parallel.finalize();
+
+        bool ok = bitwise_equal(serial.LHS, parallel.LHS) and (serial.RHS == parallel.RHS);
+        if (not ok)
+            std::cout << "  Scalar assembly differs with " << nt << " threads" << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_vector_assembly(const Mesh& msh)
+{
+    using T = typename Mesh::coordinate_type;
+    using point_type = typename Mesh::point_type;
+    using vec_type = static_vector<T, Mesh::dimension>;
+
+    hho_degree_info hdi(1, 1);
+
+    auto f = [](const point_type& pt) -> vec_type { return vec_type::Constant(pt.y()); };
+
+    vector_boundary_conditions<Mesh> bnd(msh);
+    bnd.addDirichletEverywhere(f);
+
+    auto local_contrib = [&](const typename Mesh::cell_type& cl) {
+        auto cb = make_vector_monomial_basis(msh, cl, hdi.cell_degree());
+        auto gr = make_vector_hho_symmetric_laplacian(msh, cl, hdi);
+        auto stab = make_vector_hho_stabilization(msh, cl, gr.first, hdi);
+        dynamic_matrix<T> A = gr.second + stab;
+        dynamic_vector<T> rhs = dynamic_vector<T>::Zero(A.rows());
+        rhs.head(cb.size()) = make_rhs(msh, cl, cb, f);
+        return make_vector_static_condensation(msh, cl, hdi, A, rhs);
+    };
+
+    auto serial = make_vector_primal_hho_assembler(msh, hdi, bnd);
+    for (auto& cl : msh)
+    {
+        auto [lhs, rhs] = local_contrib(cl);
+        serial.assemble(msh, cl, bnd, lhs, rhs);
+    }
+    serial.finalize();
+
+    bool success = true;
+    for (size_t nt : {1, 2, 3, 8})
+    {
+        auto parallel = make_vector_primal_hho_assembler(msh, hdi, bnd);
+        parallel.assemble(msh, bnd, local_contrib, 0, nt);
+        parallel.finalize();
+
+        bool ok = bitwise_equal(serial.LHS, parallel.LHS) and (serial.RHS == parallel.RHS);
+        if (not ok)
+            std::cout << "  Vector assembly differs with " << nt << " threads" << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+    bool success = true;
+
+    std::cout << "Simplicial 2D" << std::endl;
+    simplicial_mesh<T,2> msh2;
+    auto mesher2 = make_simple_mesher(msh2);
+    mesher2.refine();
+    mesher2.refine();
+    success &= test_scalar_assembly(msh2);
+    success &= test_vector_assembly(msh2);
+
+    std::cout << "Simplicial 3D" << std::endl;
+    simplicial_mesh<T,3> msh3;
+    auto mesher3 = make_simple_mesher(msh3);
+    mesher3.refine();
+    success &= test_scalar_assembly(msh3);
+    success &= test_vector_assembly(msh3);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check the parallel sort and record parser used by the loaders against
+ * their sequential versions, and the scanner of the text formats. The data
+ * is large enough to be split among the threads requested with
+ * DISKPP_NUM_THREADS. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "diskpp/loaders/loader.hpp"
+
+bool
+test_sort(void)
+{
+    const size_t n = 10*disk::priv::min_parallel_chunk + 17;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> dist(0, n/4);
+
+    std::vector<std::pair<size_t, size_t>> v(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = std::make_pair(dist(gen), i);
+
+    auto comp = [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return a.first < b.first or (a.first == b.first and a.second > b.second);
+    };
+
+    auto expected = v;
+    std::sort(expected.begin(), expected.end(), comp);
+    disk::priv::parallel_sort(v.begin(), v.end(), comp);
+
+    std::vector<size_t> u(n);
+    for (size_t i = 0; i < n; i++)
+        u[i] = dist(gen);
+
+    auto expected_u = u;
+    disk::priv::sort_uniq(expected_u);
+    disk::priv::parallel_sort_uniq(u);
+
+    return v == expected and u == expected_u;
+}
+
+bool
+test_parse(void)
+{
+    const size_t n = 5*disk::priv::min_parallel_chunk + 3;
+
+    /* Records with variable width, some blank lines and trailing spaces */
+    std::stringstream ss;
+    ss << n << "\n";
+    for (size_t i = 0; i < n; i++)
+    {
+        ss << "  " << 3*i << " " << 0.5*i << ((i % 7 == 0) ? "   \n\n" : "\n");
+    }
+    ss << "End\n";
+    const std::string text = ss.str();
+
+    char *ptr;
+    const char *data = text.c_str();
+    size_t num_records = strtot<size_t>(data, &ptr);
+
+    std::vector<size_t> ids(num_records);
+    std::vector<double> vals(num_records);
+    auto parse = [&](size_t i, const char *str, char **endptr) {
+        ids[i] = strtot<size_t>(str, endptr);
+        vals[i] = strtot<double>(*endptr, endptr);
+    };
+
+    const char *end = disk::priv::parallel_parse_records(ptr, data + text.size(),
+        num_records, parse);
+
+    bool success = num_records == n;
+    for (size_t i = 0; success and i < n; i++)
+        success = ids[i] == 3*i and vals[i] == 0.5*i;
+
+    while (std::isspace(*end))
+        end++;
+
+    return success and std::string(end) == "End\n";
+}
+
+/* Two records per line: the parallel split is wrong and the section must
+ * be parsed again sequentially */
+bool
+test_fallback(void)
+{
+    const size_t n = 6*disk::priv::min_parallel_chunk;
+
+    std::stringstream ss;
+    for (size_t i = 0; i < n; i += 2)
+        ss << i << " " << i+1 << "\n";
+    const std::string text = ss.str();
+
+    std::vector<size_t> vals(n);
+    auto parse = [&](size_t i, const char *str, char **endptr) {
+        vals[i] = strtot<size_t>(str, endptr);
+    };
+
+    const char *data = text.c_str();
+    auto end = disk::priv::parallel_parse_records(data, data + text.size(), n, parse);
+
+    bool success = std::string(end) == "\n";
+    for (size_t i = 0; success and i < n; i++)
+        success = vals[i] == i;
+
+    return success;
+}
+
+bool
+test_scanner(void)
+{
+    const size_t n = 3*disk::priv::min_parallel_chunk;
+
+    std::stringstream ss;
+    ss << "Header line\n\nValues " << n << "\n";
+    for (size_t i = 0; i < n; i++)
+        ss << 0.25*i << ((i == n-10) ? " x\n" : "\n");
+    ss << "End\n";
+    const std::string text = ss.str();
+
+    disk::priv::text_scanner ts(text.c_str(), text.c_str() + text.size());
+
+    bool success = ts.line() == "Header line";
+    success = success and ts.expect("Values");
+
+    size_t num_records;
+    success = success and ts.read(num_records) and num_records == n;
+
+    /* The record with an extra word stops the parsing */
+    std::vector<double> vals(n);
+    auto parse = [&](size_t i, const char *str, char **endptr) {
+        char *ptr = const_cast<char *>(str);
+        bool ok = disk::priv::read_value(&ptr, vals[i]);
+        *endptr = ptr;
+        return ok;
+    };
+
+    success = success and not ts.records(n, parse);
+    success = success and ts.failed_record() == n-9;
+    success = success and ts.record_line_number(ts.failed_record()) == n-9+4;
+
+    return success and not ts.at_end() and ts.word() == "x";
+}
+
+/* The same two triangles in the medit and FVCA5 formats */
+bool
+test_loaders(void)
+{
+    {
+        std::ofstream ofs("parallel_loader.medit2d");
+        ofs << "MeshVersionFormatted 2\nDimension 3\n";
+        ofs << "Vertices\n4\n0 0 0 0\n1 0 0 0\n1 1 0 0\n0 1 0 0\n";
+        ofs << "Triangles\n2\n1 2 3 0\n1 3 4 0\n";
+        ofs << "Edges\n4\n1 2 1\n2 3 2\n3 4 3\n4 1 4\nEnd\n";
+    }
+
+    {
+        std::ofstream ofs("parallel_loader.typ1");
+        ofs << "vertices\n4\n0 0\n1 0\n1 1\n0 1\n";
+        ofs << "triangles\n2\n1 2 3\n1 3 4\n";
+        ofs << "edges of the boundary\n4\n1 2\n2 3\n3 4\n4 1\n";
+        ofs << "all edges\n5\n1 2 1 0\n2 3 1 0\n3 4 2 0\n4 1 2 0\n1 3 1 2\n";
+    }
+
+    disk::generic_mesh<double, 2> msh_medit, msh_fvca5;
+    bool success = disk::load_mesh_medit("parallel_loader.medit2d", msh_medit);
+    success = success and disk::load_mesh_fvca5_2d("parallel_loader.typ1", msh_fvca5);
+
+    for (auto msh : {&msh_medit, &msh_fvca5})
+    {
+        success = success and msh->cells_size() == 2 and msh->faces_size() == 5;
+        success = success and msh->boundary_faces_size() == 4;
+    }
+
+    std::remove(disk::mesh_cache_filename<disk::generic_mesh<double, 2>>("parallel_loader.medit2d").c_str());
+    std::remove(disk::mesh_cache_filename<disk::generic_mesh<double, 2>>("parallel_loader.typ1").c_str());
+    std::remove("parallel_loader.medit2d");
+    std::remove("parallel_loader.typ1");
+
+    return success;
+}
+
+/* Write the unit square split in n^2 quadrangles in the poly2d format, with
+ * all the boundary edges in one group */
+void
+write_poly2d(const char *filename, size_t n)
+{
+    auto node = [&](size_t i, size_t j) { return i + (n+1)*j; };
+    auto hedge = [&](size_t i, size_t j) { return i + n*j; };
+    auto vedge = [&](size_t i, size_t j) { return n*(n+1) + i + (n+1)*j; };
+
+    std::ofstream ofs(filename);
+    ofs << "**BeginMesh\n*Dimension 2\n*Version 1\n";
+
+    ofs << "*Nodes " << (n+1)*(n+1) << "\n";
+    for (size_t j = 0; j <= n; j++)
+        for (size_t i = 0; i <= n; i++)
+            ofs << node(i, j) << " " << double(i)/n << " " << double(j)/n << " 0\n";
+
+    ofs << "*Edges->Nodes " << 2*n*(n+1) << "\n";
+    for (size_t j = 0; j <= n; j++)
+        for (size_t i = 0; i < n; i++)
+            ofs << hedge(i, j) << " 2 " << node(i, j) << " " << node(i+1, j) << "\n";
+    for (size_t j = 0; j < n; j++)
+        for (size_t i = 0; i <= n; i++)
+            ofs << vedge(i, j) << " 2 " << node(i, j) << " " << node(i, j+1) << "\n";
+
+    ofs << "*Edges->Groups 1\nboundary 1 " << 4*n;
+    for (size_t k = 0; k < n; k++)
+        ofs << " " << hedge(k, 0) << " " << hedge(k, n) << " " << vedge(0, k) << " " << vedge(n, k);
+    ofs << "\n";
+
+    ofs << "*Faces->Nodes " << n*n << "\n";
+    for (size_t j = 0; j < n; j++)
+        for (size_t i = 0; i < n; i++)
+            ofs << i + n*j << " 4 " << node(i, j) << " " << node(i+1, j) << " "
+                << node(i+1, j+1) << " " << node(i, j+1) << "\n";
+
+    ofs << "*Faces->Edges " << n*n << "\n";
+    for (size_t j = 0; j < n; j++)
+        for (size_t i = 0; i < n; i++)
+            ofs << i + n*j << " 4 " << hedge(i, j) << " " << vedge(i+1, j) << " "
+                << hedge(i, j+1) << " " << vedge(i, j) << "\n";
+
+    ofs << "**EndMesh\n";
+}
+
+/* The poly loader gives the same mesh with one and more threads, the
+ * nodes and edges sections are large enough to be split */
+bool
+test_poly(void)
+{
+    using mesh_type = disk::generic_mesh<double, 2>;
+
+    const size_t n = 200;
+    const char *filename = "parallel_loader.poly2d";
+    write_poly2d(filename, n);
+
+    mesh_type msh_seq, msh_par;
+    setenv("DISKPP_NUM_THREADS", "1", 1);
+    bool success = disk::load_mesh_poly2d<double>(filename, msh_seq);
+    std::remove(disk::mesh_cache_filename<mesh_type>(filename).c_str());
+
+    setenv("DISKPP_NUM_THREADS", "4", 1);
+    success = disk::load_mesh_poly2d<double>(filename, msh_par) and success;
+    std::remove(disk::mesh_cache_filename<mesh_type>(filename).c_str());
+    std::remove(filename);
+
+    success = success and msh_seq.cells_size() == n*n and msh_par.cells_size() == n*n;
+    success = success and msh_seq.faces_size() == 2*n*(n+1) and msh_par.faces_size() == 2*n*(n+1);
+    success = success and msh_seq.boundary_faces_size() == 4*n and msh_par.boundary_faces_size() == 4*n;
+    if (not success)
+        return false;
+
+    for (size_t i = 0; i < msh_seq.cells_size(); i++)
+    {
+        auto pts_seq = points(msh_seq, *(msh_seq.cells_begin() + i));
+        auto pts_par = points(msh_par, *(msh_par.cells_begin() + i));
+        if (pts_seq.size() != 4 or pts_par.size() != 4)
+            return false;
+
+        for (size_t k = 0; k < 4; k++)
+            if ( (pts_seq[k] - pts_par[k]).to_vector().norm() != 0.0 )
+                return false;
+    }
+
+    for (size_t i = 0; i < msh_seq.faces_size(); i++)
+        if (msh_seq.is_boundary(*(msh_seq.faces_begin() + i)) != msh_par.is_boundary(*(msh_par.faces_begin() + i)))
+            return false;
+
+    return true;
+}
+
+int main(void)
+{
+    bool success = true;
+
+    for (auto nt : {"1", "3", "4"})
+    {
+        setenv("DISKPP_NUM_THREADS", nt, 1);
+        success = test_sort() and success;
+        success = test_parse() and success;
+        success = test_fallback() and success;
+        success = test_scanner() and success;
+    }
+
+    success = test_loaders() and success;
+    success = test_poly() and success;
+
+    std::cout << "parallel loader: " << (success ? "PASS" : "FAIL") << std::endl;
+
+    return success ? 0 : 1;
+}
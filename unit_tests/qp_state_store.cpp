@@ -0,0 +1,175 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Write the internal variables of QPStateStore over some steps and check
+ * that the previous and current steps are read back correctly after each
+ * buffer swap, including the points that are not written in a step, and
+ * after the writes of a step are discarded by a rollback. */
+
+#include <iostream>
+
+#include "diskpp/mechanics/behaviors/laws/law_qp_state.hpp"
+
+using namespace disk;
+
+/* Value of the variables of a point at a step */
+template<typename T>
+T
+value(size_t qp, size_t step, size_t comp)
+{
+    return T(1000 * step + 10 * qp + comp);
+}
+
+/* Points written at a step: all at the first step, then one over step+1 */
+bool
+written(size_t qp, size_t step)
+{
+    return step == 0 or qp % (step + 1) == 0;
+}
+
+template<typename T>
+bool
+test_store(bool plastic)
+{
+    using store_type = QPStateStore<T>;
+    const size_t num_qp = 100;
+    const size_t num_steps = 5;
+
+    store_type store(plastic);
+    bool success = store.add(num_qp / 2) == 0;
+    success = success and store.add(num_qp - num_qp / 2) == num_qp / 2;
+    success = success and store.size() == num_qp and store.hasPlasticVariables() == plastic;
+
+    /* new points are zero */
+    for (size_t qp = 0; qp < num_qp; qp++)
+        for (size_t k = 0; k < store_type::strain_size; k++)
+            success = success and store.elasticStrain(qp)[k] == T(0);
+
+    /* last step at which each point was written */
+    std::vector<size_t> last(num_qp, 0);
+    for (size_t step = 0; step < num_steps; step++)
+    {
+        for (size_t qp = 0; qp < num_qp; qp++)
+        {
+            if ( not written(qp, step) )
+                continue;
+
+            T *es = store.elasticStrainWrite(qp);
+            for (size_t k = 0; k < store_type::strain_size; k++)
+                es[k] = value<T>(qp, step, k);
+
+            if (plastic)
+            {
+                T *ps = store.plasticStrainWrite(qp);
+                for (size_t k = 0; k < store_type::strain_size; k++)
+                    ps[k] = -value<T>(qp, step, k);
+                store.equivalentPlasticStrainWrite(qp) = value<T>(qp, step, 0);
+                store.isPlasticWrite(qp) = (qp + step) % 2;
+            }
+        }
+
+        for (size_t qp = 0; qp < num_qp; qp++)
+        {
+            /* the current step is the last written value */
+            const size_t curr = written(qp, step) ? step : last[qp];
+            for (size_t k = 0; k < store_type::strain_size; k++)
+                success = success and store.elasticStrain(qp)[k] == value<T>(qp, curr, k);
+
+            if (plastic)
+            {
+                success = success and store.plasticStrain(qp)[0] == -value<T>(qp, curr, 0);
+                success = success and store.equivalentPlasticStrain(qp) == value<T>(qp, curr, 0);
+                success = success and store.isPlastic(qp) == bool((qp + curr) % 2);
+            }
+
+            /* the previous step is not modified by the writes */
+            if (step > 0)
+            {
+                success = success and store.elasticStrainPrev(qp)[1] == value<T>(qp, last[qp], 1);
+                if (plastic)
+                    success = success and store.equivalentPlasticStrainPrev(qp) == value<T>(qp, last[qp], 0);
+            }
+
+            last[qp] = curr;
+        }
+
+        store.update();
+
+        /* after the swap the previous and current steps are equal */
+        for (size_t qp = 0; qp < num_qp; qp++)
+            success = success and store.elasticStrainPrev(qp)[2] == value<T>(qp, last[qp], 2) and
+                      store.elasticStrain(qp)[2] == value<T>(qp, last[qp], 2);
+    }
+
+    return success;
+}
+
+/* A step is computed, discarded, then computed again on half of the points */
+template<typename T>
+bool
+test_rollback(void)
+{
+    using store_type = QPStateStore<T>;
+    const size_t num_qp = 50;
+
+    store_type store(true);
+    store.add(num_qp);
+
+    auto write = [&](size_t qp, size_t step) {
+        store.elasticStrainWrite(qp)[0] = value<T>(qp, step, 0);
+        store.equivalentPlasticStrainWrite(qp) = value<T>(qp, step, 1);
+        store.isPlasticWrite(qp) = 1;
+    };
+
+    for (size_t qp = 0; qp < num_qp; qp++)
+        write(qp, 0);
+    store.update();
+
+    for (size_t qp = 0; qp < num_qp; qp++)
+        write(qp, 1);
+    store.rollback();
+
+    bool success = true;
+    for (size_t qp = 0; qp < num_qp; qp++)
+        success = success and store.elasticStrain(qp)[0] == value<T>(qp, 0, 0) and
+                  store.equivalentPlasticStrain(qp) == value<T>(qp, 0, 1);
+
+    for (size_t qp = 0; qp < num_qp; qp += 2)
+        write(qp, 2);
+    store.update();
+
+    for (size_t qp = 0; qp < num_qp; qp++)
+    {
+        const size_t step = (qp % 2 == 0) ? 2 : 0;
+        success = success and store.elasticStrainPrev(qp)[0] == value<T>(qp, step, 0) and
+                  store.equivalentPlasticStrainPrev(qp) == value<T>(qp, step, 1) and
+                  store.elasticStrain(qp)[0] == value<T>(qp, step, 0);
+    }
+
+    return success;
+}
+
+int main(void)
+{
+    bool success = true;
+
+    for (bool plastic : {false, true})
+    {
+        bool ok = test_store<double>(plastic);
+        std::cout << (plastic ? "plastic" : "elastic") << ": " << (ok ? "PASS" : "FAIL") << std::endl;
+        success = success and ok;
+    }
+
+    bool ok = test_rollback<double>();
+    std::cout << "rollback: " << (ok ? "PASS" : "FAIL") << std::endl;
+    success = success and ok;
+
+    return success ? 0 : 1;
+}
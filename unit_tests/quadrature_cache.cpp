@@ -0,0 +1,128 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that the quadratures stored in the quadrature_cache are the same
+ * computed by integrate(), that the operators built with the cache are the
+ * same and that the cache follows the transformations of the mesh. */
+
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/methods/hho"
+#include "diskpp/common/parallel.hpp"
+#include "diskpp/quadratures/quadrature_cache.hpp"
+
+using namespace disk;
+
+template<typename QPs1, typename QPs2>
+bool
+same_quadrature(const QPs1& qps1, const QPs2& qps2)
+{
+    if (qps1.size() != qps2.size())
+        return false;
+
+    for (size_t i = 0; i < qps1.size(); i++)
+    {
+        auto qp1 = qps1[i];
+        auto qp2 = qps2[i];
+        if ((qp1.point() - qp2.point()).to_vector().norm() != 0.0 or qp1.weight() != qp2.weight())
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+test_quadratures(const Mesh& msh, const quadrature_cache<Mesh>& qc)
+{
+    for (size_t degree = 0; degree < 5; degree++)
+    {
+        for (auto& cl : msh)
+        {
+            if (not same_quadrature(integrate(msh, cl, degree), qc.integrate(cl, degree)))
+                return false;
+
+            for (auto& fc : faces(msh, cl))
+                if (not same_quadrature(integrate(msh, fc, degree), qc.integrate(fc, degree)))
+                    return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+test_operators(const Mesh& msh, const quadrature_cache<Mesh>& qc)
+{
+    hho_degree_info hdi(1, 1);
+
+    std::vector<char> ok(msh.cells_size(), 0);
+    auto check = [&](size_t cell_i, size_t) {
+        auto cl = msh[cell_i];
+        auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+        auto gr_c = make_scalar_hho_laplacian(msh, cl, hdi, qc);
+        auto stab = make_scalar_hho_stabilization(msh, cl, gr.first, hdi);
+        auto stab_c = make_scalar_hho_stabilization(msh, cl, gr_c.first, hdi, qc);
+        auto hdg = make_scalar_hdg_stabilization(msh, cl, hdi);
+        auto hdg_c = make_scalar_hdg_stabilization(msh, cl, hdi, qc);
+        ok[cell_i] = gr.first == gr_c.first and gr.second == gr_c.second and
+                     stab == stab_c and hdg == hdg_c;
+    };
+
+    /* The cache is filled concurrently by the workers */
+    parallel_for(0, msh.cells_size(), check, 4);
+
+    return std::all_of(ok.begin(), ok.end(), [](char c) { return c; });
+}
+
+template<typename Mesh>
+bool
+test_cache(Mesh& msh, const char *name)
+{
+    using point_type = typename Mesh::point_type;
+
+    quadrature_cache<Mesh> qc(msh);
+
+    bool success = test_quadratures(msh, qc) and test_operators(msh, qc);
+
+    /* The cache must notice that the geometry changed */
+    msh.transform([](const point_type& pt) { return pt * 2.0; });
+    success = success and test_quadratures(msh, qc);
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    mesher_tri.refine();
+    mesher_tri.refine();
+    success = test_cache(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    mesher_tet.refine();
+    success = test_cache(msh_tet, "tetrahedra") and success;
+
+    disk::generic_mesh<T, 2> msh_hex;
+    auto mesher_hex = disk::make_fvca5_hex_mesher(msh_hex);
+    mesher_hex.make_level(2);
+    success = test_cache(msh_hex, "hexagons") and success;
+
+    return success ? 0 : 1;
+}
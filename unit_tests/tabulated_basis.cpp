@@ -0,0 +1,181 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Check that the basis tabulated on the reference element gives the same
+ * values, gradients, mass and stiffness matrices of the plain basis, and that
+ * the HHO laplacian built with it matches the one built with quadratures. */
+
+#include <iostream>
+
+#include "diskpp/mesh/meshgen.hpp"
+#include "diskpp/bases/bases.hpp"
+#include "diskpp/bases/bases_tabulated.hpp"
+#include "diskpp/methods/hho"
+
+using namespace disk;
+
+template<typename T>
+bool
+close(const dynamic_matrix<T>& A, const dynamic_matrix<T>& B, T tol = 1e-11)
+{
+    return (A - B).norm() <= tol * std::max(T(1), B.norm());
+}
+
+/* Stiffness matrix computed with the quadrature of the cell */
+template<typename Mesh, typename Basis>
+dynamic_matrix<typename Mesh::coordinate_type>
+quadrature_stiffness_matrix(const Mesh& msh, const typename Mesh::cell_type& cl, const Basis& cb)
+{
+    using T = typename Mesh::coordinate_type;
+
+    dynamic_matrix<T> ret = dynamic_matrix<T>::Zero(cb.size(), cb.size());
+    for (auto& qp : integrate(msh, cl, 2 * cb.degree()))
+    {
+        const auto dphi = cb.eval_gradients(qp.point());
+        ret += qp.weight() * dphi * dphi.transpose();
+    }
+
+    return ret;
+}
+
+template<typename Mesh>
+bool
+test_tabulation(const Mesh& msh, size_t degree, bool use_inertia_axes)
+{
+    using T = typename Mesh::coordinate_type;
+
+    tabulated_scalar_basis<Mesh> tab(degree);
+
+    for (auto& cl : msh)
+    {
+        auto cb = make_scalar_monomial_basis(msh, cl, degree, use_inertia_axes);
+
+        if (not tab.is_affine(msh, cl))
+            return false;
+
+        const auto qps_mass = integrate(msh, cl, 2 * degree);
+        if (not close(tab.mass_matrix(msh, cl, cb), make_mass_matrix(cb, qps_mass)))
+            return false;
+
+        const auto stiff = quadrature_stiffness_matrix(msh, cl, cb);
+        if (not close(tab.stiffness_matrix(msh, cl, cb), stiff))
+            return false;
+
+        /* The operator builders take the tabulated path */
+        if (not close(make_mass_matrix(msh, cl, cb), make_mass_matrix(cb, qps_mass)))
+            return false;
+
+        if (not close(make_stiffness_matrix(msh, cl, cb), stiff))
+            return false;
+
+        auto qps = tab.quadrature(msh, cl);
+        dynamic_matrix<T> phi = tab.eval_functions(msh, cl, cb);
+        std::array<dynamic_matrix<T>, Mesh::dimension> dphi;
+        for (size_t d = 0; d < Mesh::dimension; d++)
+            dphi[d] = tab.eval_gradients(msh, cl, cb, d);
+
+        T meas = 0.0;
+        for (size_t q = 0; q < qps.size(); q++)
+        {
+            meas += qps[q].weight();
+            dynamic_matrix<T> ref_phi = cb.eval_functions(qps[q].point()).transpose();
+            if (not close(dynamic_matrix<T>(phi.row(q)), ref_phi))
+                return false;
+
+            auto ref_dphi = cb.eval_gradients(qps[q].point());
+            for (size_t d = 0; d < Mesh::dimension; d++)
+                if (not close(dynamic_matrix<T>(dphi[d].row(q)), dynamic_matrix<T>(ref_dphi.col(d).transpose())))
+                    return false;
+        }
+
+        if (std::abs(meas - measure(msh, cl)) > 1e-12 * measure(msh, cl))
+            return false;
+    }
+
+    return true;
+}
+
+/* The HHO laplacian with the default basis is built with the tables, with
+ * a reconstruction basis scaled on the inertia axes it falls back to the
+ * quadratures. The stiffness of the reconstruction in terms of the cell and
+ * face unknowns does not depend on the reconstruction basis, it comes out
+ * of a linear solve so the tolerance is looser. */
+template<typename Mesh>
+bool
+test_laplacian(const Mesh& msh, size_t degree)
+{
+    using T = typename Mesh::coordinate_type;
+
+    hho_degree_info hdi(degree);
+
+    diffusion_tensor<Mesh> diff_tens = diffusion_tensor<Mesh>::Identity();
+    diff_tens(0, 0) = 3.0;
+    diff_tens(1, 0) = diff_tens(0, 1) = 0.5;
+
+    for (auto& cl : msh)
+    {
+        auto rb = make_scalar_monomial_basis(msh, cl, hdi.reconstruction_degree(), true);
+
+        const auto gr = make_scalar_hho_laplacian(msh, cl, hdi);
+        const auto gr_ref = priv::make_scalar_hho_laplacian<false, false>(msh, cl, hdi, rb, diff_tens);
+        if (not close(dynamic_matrix<T>(gr.second), dynamic_matrix<T>(gr_ref.second), 1e-9))
+            return false;
+
+        const auto grd = make_scalar_hho_laplacian(msh, cl, hdi, diff_tens);
+        const auto grd_ref = priv::make_scalar_hho_laplacian<true, false>(msh, cl, hdi, rb, diff_tens);
+        if (not close(dynamic_matrix<T>(grd.second), dynamic_matrix<T>(grd_ref.second), 1e-9))
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Mesh>
+bool
+test_mesh(const Mesh& msh, const char *name)
+{
+    bool success = true;
+    for (size_t degree = 0; degree < 4; degree++)
+    {
+        success = test_tabulation(msh, degree, false) and success;
+        success = test_tabulation(msh, degree, true) and success;
+        success = test_laplacian(msh, degree) and success;
+    }
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    disk::make_simple_mesher(msh_tri).refine();
+    success = test_mesh(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    disk::make_simple_mesher(msh_tet).refine();
+    success = test_mesh(msh_tet, "tetrahedra") and success;
+
+    disk::cartesian_mesh<T, 2> msh_quad;
+    disk::make_simple_mesher(msh_quad).refine();
+    success = test_mesh(msh_quad, "quadrangles") and success;
+
+    /* There is no simple mesher for hexahedra, use a single anisotropic
+     * element away from the origin. */
+    disk::cartesian_mesh<T, 3> msh_hex;
+    disk::make_single_element_mesh(msh_hex, disk::point<T, 3>{0.3, -0.2, 0.5}, 0.5, 0.25, 2.0);
+    success = test_mesh(msh_hex, "hexahedra") and success;
+
+    return success ? 0 : 1;
+}
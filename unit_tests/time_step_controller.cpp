@@ -0,0 +1,107 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Run a model of the load stepping of the Newton solver, where the error of
+ * the Newton's method converges quadratically with a constant proportional
+ * to the length of the time step and to the stiffness of the problem, which
+ * is larger on a part of the loading. The time steps adapted by TimeStepController must
+ * cover the loading, keep the times given by the user and need less
+ * iterations than the time steps split in two after each failure. */
+
+#include <cmath>
+#include <iostream>
+
+#include "diskpp/mechanics/NewtonSolver/TimeManager.hpp"
+
+using namespace disk::mechanics;
+
+struct run_info
+{
+    bool   success;
+    size_t steps, iterations;
+};
+
+/* Stiffness of the model problem at time t */
+double
+stiffness(double t)
+{
+    return (t > 0.4 && t < 0.6) ? 200.0 : 10.0;
+}
+
+run_info
+run(bool adapt)
+{
+    const size_t iter_max = 10;
+    const double epsilon = 1e-6;
+
+    ListOfTimeStep<double> steps(std::vector<std::pair<double, int>>{{0.5, 10}, {1.0, 10}});
+    TimeStepController<double> controller;
+
+    run_info info{true, 0, 0};
+    double time = 0.0;
+    bool half_reached = false;
+    while (not steps.empty())
+    {
+        const auto step = steps.getCurrentTimeStep();
+        const double dt = step.end_time() - step.start_time();
+        if (std::abs(step.start_time() - time) > 1e-14 or dt <= 0.0)
+            return run_info{false, 0, 0};
+
+        /* constant of the quadratic convergence */
+        const double C = stiffness(step.end_time()) * dt;
+
+        std::vector<double> errors;
+        double err = 1.0;
+        size_t iter = 0;
+        for (; iter < iter_max and err > epsilon; iter++)
+        {
+            errors.push_back(err);
+            err = std::min(1e10, C * err * err);
+        }
+        info.iterations += iter;
+
+        if (err > epsilon)
+        {
+            if (step.level() + 1 > 10)
+                return run_info{false, 0, 0};
+
+            if (adapt)
+                steps.splitCurrentTimeStep(controller.ratioAfterFailure(errors, iter_max, epsilon));
+            else
+                steps.splitCurrentTimeStep();
+            continue;
+        }
+
+        time = step.end_time();
+        half_reached = half_reached or std::abs(time - 0.5) < 1e-14;
+        steps.removeCurrentTimeStep();
+        info.steps++;
+
+        if (adapt and not steps.empty())
+            steps.resizeCurrentTimeStep(controller.ratioAfterConvergence(iter) * dt);
+    }
+
+    info.success = std::abs(time - 1.0) < 1e-14 and half_reached;
+    return info;
+}
+
+int main(void)
+{
+    const auto fixed = run(false);
+    const auto adapted = run(true);
+
+    bool success = fixed.success and adapted.success and adapted.iterations < fixed.iterations;
+
+    std::cout << "time steps: " << (success ? "PASS" : "FAIL") << " (split: " << fixed.steps;
+    std::cout << " steps, " << fixed.iterations << " iterations; adapted: " << adapted.steps;
+    std::cout << " steps, " << adapted.iterations << " iterations)" << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/*
+ * DISK++, a template library for DIscontinuous SKeletal methods.
+ *
+ * Matteo Cicuttin (C) 2024
+ * matteo.cicuttin@polito.it
+ *
+ * Politecnico di Torino - DISMA
+ * Dipartimento di Matematica
+ */
+
+/* Evaluate the von Mises plasticity laws over some load steps with random
+ * strains, point by point with compute_whole() and with the batched kernels,
+ * and check that the stresses, the tangent moduli and the internal
+ * variables are the same, and that both reject a plastic strain which is
+ * not deviatoric. The copies of a law must have their own internal
+ * variables. */
+
+#include <iostream>
+#include <stdexcept>
+
+#include "diskpp/mechanics/behaviors/laws/behaviorlaws.hpp"
+#include "diskpp/mesh/meshgen.hpp"
+
+using namespace disk;
+
+template<typename Law, typename Mesh>
+bool
+test_law(const Mesh& msh, const MaterialData<typename Mesh::coordinate_type>& data, const char *name)
+{
+    using T = typename Mesh::coordinate_type;
+    using static_matrix_type = static_matrix<T, Mesh::dimension, Mesh::dimension>;
+    using static_tensor_type = static_tensor<T, Mesh::dimension>;
+
+    const size_t degree = 2;
+    const size_t num_steps = 4;
+
+    Law law_ref(msh, degree);
+    Law law_batch(msh, degree);
+
+    T max_err = 0.0;
+    size_t num_plastic = 0;
+    for (size_t step = 1; step <= num_steps; step++)
+    {
+        for (size_t cell_id = 0; cell_id < msh.cells_size(); cell_id++)
+        {
+            auto& cell_ref = law_ref.getCellQPs(cell_id);
+            auto& cell_batch = law_batch.getCellQPs(cell_id);
+
+            /* a strain which increases with the steps, plus some noise */
+            eigen_compatible_stdvector<static_matrix_type> strains;
+            for (int i = 0; i < cell_ref.getNumberOfQP(); i++)
+            {
+                static_matrix_type eps = static_matrix_type::Random() * T(2e-3);
+                eps = T(step) * (eps + eps.transpose()).eval() + static_matrix_type::Random() * T(1e-4);
+                strains.push_back( (eps + eps.transpose()) / T(2) );
+            }
+
+            /* two evaluations, as in two Newton iterations */
+            for (size_t iter = 0; iter < 2; iter++)
+            {
+                eigen_compatible_stdvector<static_matrix_type> stresses;
+                eigen_compatible_stdvector<static_tensor_type> Ceps;
+                cell_batch.compute_whole_batch(strains, data, stresses, Ceps);
+
+                for (int i = 0; i < cell_ref.getNumberOfQP(); i++)
+                {
+                    auto& qp_ref = cell_ref.getQP(i);
+                    auto& qp_batch = cell_batch.getQP(i);
+
+                    const auto [stress, Cep] = qp_ref.compute_whole(strains[i], data);
+
+                    const T scale = data.getMu();
+                    max_err = std::max(max_err, (stress - stresses[i]).norm() / scale);
+                    max_err = std::max(max_err, (Cep - Ceps[i]).norm() / scale);
+                    max_err = std::max(max_err, (qp_ref.getElasticStrain() - qp_batch.getElasticStrain()).norm());
+                    max_err = std::max(max_err, (qp_ref.getPlasticStrain() - qp_batch.getPlasticStrain()).norm());
+                    max_err = std::max(max_err, std::abs(qp_ref.getEquivalentPlasticStrain() -
+                                                         qp_batch.getEquivalentPlasticStrain()));
+                    if (qp_ref.is_plastic() != qp_batch.is_plastic())
+                        max_err = 1.0;
+                    if (iter == 1 and qp_ref.is_plastic())
+                        num_plastic++;
+                }
+            }
+        }
+
+        law_ref.update();
+        law_batch.update();
+    }
+
+    /* corrupt the plastic strain of the first point, the state ids of the
+     * first cell start from 0 */
+    bool throws_ref = false, throws_batch = false;
+    for (auto law : {&law_ref, &law_batch})
+    {
+        law->getState().plasticStrainWrite(0)[0] += T(1e-3);
+        law->update();
+    }
+
+    auto& cell_ref = law_ref.getCellQPs(0);
+    auto& cell_batch = law_batch.getCellQPs(0);
+    eigen_compatible_stdvector<static_matrix_type> strains(cell_ref.getNumberOfQP(), static_matrix_type::Zero());
+    try {
+        cell_ref.getQP(0).compute_whole(strains[0], data);
+    }
+    catch (const std::invalid_argument&) {
+        throws_ref = true;
+    }
+
+    try {
+        eigen_compatible_stdvector<static_matrix_type> stresses;
+        eigen_compatible_stdvector<static_tensor_type> Ceps;
+        cell_batch.compute_whole_batch(strains, data, stresses, Ceps);
+    }
+    catch (const std::invalid_argument&) {
+        throws_batch = true;
+    }
+
+    /* the test must actually exercise the plastic correction */
+    bool success = max_err < 1e-12 and num_plastic > 0 and throws_ref and throws_batch;
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << " (error " << max_err;
+    std::cout << ", " << num_plastic << " plastic evaluations)" << std::endl;
+    return success;
+}
+
+/* The copies of a law do not share the internal variables, and their
+ * quadrature points read and write their own store */
+template<typename Mesh>
+bool
+test_copy(const Mesh& msh, const MaterialData<typename Mesh::coordinate_type>& data, const char *name)
+{
+    using T = typename Mesh::coordinate_type;
+    using Law = IsotropicHardeningVMis<Mesh>;
+    using static_matrix_type = static_matrix<T, Mesh::dimension, Mesh::dimension>;
+    using static_tensor_type = static_tensor<T, Mesh::dimension>;
+
+    Law law(msh, 2);
+    law.getState().elasticStrainWrite(0)[0] = T(1);
+    law.update();
+
+    Law copy(law);
+    Law assigned;
+    assigned = law;
+
+    copy.getState().elasticStrainWrite(0)[0] = T(2);
+    copy.update();
+    assigned.rollback();
+
+    bool success = law.getState().elasticStrainPrev(0)[0] == T(1);
+    success = success and copy.getState().elasticStrainPrev(0)[0] == T(2);
+    success = success and assigned.getState().elasticStrainPrev(0)[0] == T(1);
+    success = success and law.getCellQPs(0).getQP(0).getElasticStrain()(0, 0) == T(1);
+    success = success and copy.getCellQPs(0).getQP(0).getElasticStrain()(0, 0) == T(2);
+
+    /* a computation on the copy leaves the law untouched */
+    auto& cell_copy = copy.getCellQPs(0);
+    eigen_compatible_stdvector<static_matrix_type> strains(cell_copy.getNumberOfQP(), static_matrix_type::Identity());
+    eigen_compatible_stdvector<static_matrix_type> stresses;
+    eigen_compatible_stdvector<static_tensor_type> Ceps;
+    cell_copy.compute_whole_batch(strains, data, stresses, Ceps);
+
+    success = success and copy.getState().elasticStrain(0)[0] != T(2);
+    success = success and law.getState().elasticStrain(0)[0] == T(1);
+
+    std::cout << name << ": " << (success ? "PASS" : "FAIL") << std::endl;
+    return success;
+}
+
+template<typename Mesh>
+bool
+test_mesh(const Mesh& msh, const char *name)
+{
+    using T = typename Mesh::coordinate_type;
+
+    MaterialData<T> data;
+    data.setMu(70, 0.3);
+    data.setLambda(70, 0.3);
+    data.setK(0.5);
+    data.setH(0.135);
+    data.setSigma_y0(0.243);
+    data.addCurvePoint(0.0, 0.243);
+    data.addCurvePoint(0.001, 0.3);
+    data.addCurvePoint(0.01, 0.35);
+    data.addCurvePoint(1.0, 0.5);
+
+    bool success = true;
+    std::string n = name;
+    success = test_law<LinearIsotropicAndKinematicHardening<Mesh>>(msh, data, (n + " linear hardening").c_str()) and success;
+    success = test_law<IsotropicHardeningVMis<Mesh>>(msh, data, (n + " nonlinear hardening").c_str()) and success;
+    success = test_copy(msh, data, (n + " copies").c_str()) and success;
+    return success;
+}
+
+int main(void)
+{
+    using T = double;
+
+    bool success = true;
+
+    disk::simplicial_mesh<T, 2> msh_tri;
+    auto mesher_tri = disk::make_simple_mesher(msh_tri);
+    for (size_t i = 0; i < 2; i++)
+        mesher_tri.refine();
+    success = test_mesh(msh_tri, "triangles") and success;
+
+    disk::simplicial_mesh<T, 3> msh_tet;
+    auto mesher_tet = disk::make_simple_mesher(msh_tet);
+    mesher_tet.refine();
+    success = test_mesh(msh_tet, "tetrahedra") and success;
+
+    return success ? 0 : 1;
+}